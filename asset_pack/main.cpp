@@ -0,0 +1,317 @@
+/***************************************************************************
+ *   Copyright (C) 2005 by Eryk Klebanski                                  *
+ *   rixment@gmail.com                                                     *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+
+#include "GcadAssetPack.h"
+#include "GcadStdIos.h"
+#ifdef WIN32
+  #include "GcadDriveElementsEnumeratorWin32.h"
+#else
+  #include "GcadDriveElementsEnumeratorPosix.h"
+#endif
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace Gcad::Platform;
+using namespace Gcad::Utilities;
+
+typedef AssetPack::UInt32  UInt32;
+
+#ifdef WIN32
+  typedef DriveElementsEnumeratorWin32  NativeElementsEnumerator;
+#else
+  typedef DriveElementsEnumeratorPosix  NativeElementsEnumerator;
+#endif
+
+/**
+  @brief
+    Plik umieszczany w paczce - nazwa wpisu (sciezka oddzielana znakiem
+    '\\', taka jak tworzona przez DataFileResourceManager), oraz sciezka
+    pliku zrodlowego
+*/
+struct PackedFile {
+  string  name_;
+  string  sourcePath_;
+
+  bool operator <(const PackedFile& rhs) const {
+    return name_ < rhs.name_;
+  }
+};
+
+typedef vector<PackedFile> PackedFiles;
+
+string&
+toLower(string* str)
+{
+  for(size_t i=0; i<str->size(); ++i)
+    (*str)[i] = tolower( (*str)[i] );
+  return *str;
+}
+
+void
+traverseDirectories(const string&  rootDir,
+                    const string&  extension,
+                    PackedFiles*   files)
+{
+  NativeElementsEnumerator elementsEnumerator(rootDir);
+  const string SEPARATOR(1, elementsEnumerator.getPathSeparator());
+
+  typedef NativeElementsEnumerator::ItorAutoPtr ElemsItor;
+
+  for(ElemsItor elemItor(elementsEnumerator.getItor());
+    elemItor->isValid();
+    elemItor->moveToNextElement())
+  {
+    const string ELEMENT_NAME = elemItor->getElementName();
+
+    if(elemItor->isDirectory()) {
+      if( ELEMENT_NAME != "." && ELEMENT_NAME != ".." )
+        traverseDirectories(rootDir + SEPARATOR + ELEMENT_NAME, extension, files);
+    }
+    else 
+    {
+      string fileName = ELEMENT_NAME;
+      ::toLower( &fileName );
+
+      if( extension.empty() || 
+        ( fileName.size() >= extension.size() &&
+          fileName.compare(fileName.size() - extension.size(),
+            extension.size(), extension) == 0 ) )
+      {
+        // Nazwy wpisow zawsze oddziela znak '\\' (ResourceArchive),
+        // niezaleznie od separatora sciezek systemu
+        PackedFile file;
+        file.sourcePath_ = rootDir + SEPARATOR + ELEMENT_NAME;
+        file.name_       = file.sourcePath_;
+        std::replace(file.name_.begin(), file.name_.end(), 
+          SEPARATOR[0], '\\');
+        files->push_back(file);
+      }
+    }
+  }
+}
+
+size_t
+alignOffset(size_t offset)
+{
+  return (offset + AssetPack::ALIGNMENT - 1) & 
+    ~static_cast<size_t>(AssetPack::ALIGNMENT - 1);
+}
+
+bool
+fileSize(const string& path, size_t* size)
+{
+  ifstream input(path.c_str(), ios_base::binary);
+  if( !input )
+    return false;
+
+  input.seekg(0, ios_base::end);
+  const streamoff FILE_SIZE = input.tellg();
+  *size = FILE_SIZE > 0 ? static_cast<size_t>(FILE_SIZE) : 0;
+  return !input.fail();
+}
+
+bool
+readFile(const string& path, vector<char>* data)
+{
+  size_t size = 0;
+  if( !fileSize(path, &size) )
+    return false;
+
+  ifstream input(path.c_str(), ios_base::binary);
+  data->resize(size);
+  if( !data->empty() )
+    input.read(&(*data)[0], data->size());
+
+  return !input.fail();
+}
+
+void
+writePadding(ofstream& output, size_t offset)
+{
+  const char ZEROS[AssetPack::ALIGNMENT] = { 0 };
+  const size_t PADDING = alignOffset(offset) - offset;
+  output.write(ZEROS, PADDING);
+}
+
+bool
+writePack(PackedFiles& files, const string& outputFile)
+{
+  // Spis jest sortowany wedlug nazw (wyliczanie katalogow), a tablica
+  // mieszajaca zajmuje co najmniej dwukrotnosc liczby wpisow - przy takim
+  // wypelnieniu wyszukiwanie konczy sie zwykle pierwszym sondowaniem
+
+  sort(files.begin(), files.end());
+
+  for(size_t file = 1; file < files.size(); ++file)
+    if( files[file].name_ == files[file - 1].name_ ) {
+      cout << "Duplicated entry: " << files[file].name_ << endl;
+      return false;
+    }
+
+  UInt32 slotsCount = 1;
+  while( slotsCount < 2 * files.size() )
+    slotsCount *= 2;
+
+  vector<AssetPack::Entry> entries(files.size());
+  vector<UInt32>           slots(slotsCount, 0);
+  string                   names;
+
+  for(size_t file = 0; file < files.size(); ++file)
+  {
+    AssetPack::Entry& entry = entries[file];
+    const string& NAME = files[file].name_;
+
+    entry.nameHash_   = AssetPack::hashName(NAME.data(), NAME.size());
+    entry.nameOffset_ = static_cast<UInt32>(names.size());
+    entry.nameLength_ = static_cast<UInt32>(NAME.size());
+    entry.dataOffset_ = 0;
+    entry.dataSize_   = 0;
+    entry.reserved_   = 0;
+    names += NAME;
+
+    UInt32 slot = entry.nameHash_ & (slotsCount - 1);
+    while( slots[slot] != 0 )
+      slot = (slot + 1) & (slotsCount - 1);
+    slots[slot] = static_cast<UInt32>(file + 1);
+  }
+
+  AssetPack::Header header;
+  copy("GPAK", "GPAK" + 4, header.magic_);
+  header.version_       = AssetPack::VERSION;
+  header.entriesCount_  = static_cast<UInt32>(files.size());
+  header.slotsCount_    = slotsCount;
+  header.entriesOffset_ = static_cast<UInt32>(alignOffset(sizeof(header)));
+  header.slotsOffset_   = static_cast<UInt32>(header.entriesOffset_ + 
+    entries.size() * sizeof(AssetPack::Entry));
+  header.namesOffset_   = static_cast<UInt32>(header.slotsOffset_ +
+    slots.size() * sizeof(UInt32));
+  header.namesSize_     = static_cast<UInt32>(names.size());
+
+  // Dane kolejnych plikow sa wyrownane do granicy ALIGNMENT bajtow
+
+  size_t dataOffset = alignOffset(header.namesOffset_ + names.size());
+
+  for(size_t file = 0; file < files.size(); ++file)
+  {
+    size_t size = 0;
+    if( !fileSize(files[file].sourcePath_, &size) ) {
+      cout << "Unable to read: " << files[file].sourcePath_ << endl;
+      return false;
+    }
+
+    if( dataOffset + size > 0xFFFFFFFFu ) {
+      cout << "Pack exceeds 4 GB limit" << endl;
+      return false;
+    }
+
+    entries[file].dataOffset_ = static_cast<UInt32>(dataOffset);
+    entries[file].dataSize_   = static_cast<UInt32>(size);
+    dataOffset = alignOffset(dataOffset + size);
+  }
+
+  ofstream output(outputFile.c_str(), ios_base::binary);
+  if( !output ) {
+    cout << "Unable to create: " << outputFile << endl;
+    return false;
+  }
+
+  writeIntoStdStream(output, header, 1);
+  writePadding(output, sizeof(header));
+  if( !entries.empty() )
+    writeIntoStdStream(output, entries[0], entries.size());
+  writeIntoStdStream(output, slots[0], slots.size());
+  output.write(names.data(), names.size());
+  writePadding(output, header.namesOffset_ + names.size());
+
+  for(size_t file = 0; file < files.size(); ++file)
+  {
+    vector<char> data;
+    if( !readFile(files[file].sourcePath_, &data) ||
+      data.size() != entries[file].dataSize_ )
+    {
+      cout << "File changed while packing: " << files[file].sourcePath_ <<
+        endl;
+      return false;
+    }
+
+    cout << "Packing: " << files[file].name_ << endl;
+
+    if( !data.empty() )
+      output.write(&data[0], data.size());
+    writePadding(output, entries[file].dataOffset_ + data.size());
+  }
+
+  return !output.fail();
+}
+
+void
+usePatternPrint()
+{
+  cout << 
+    "Example:\n"
+    "  AssetPack root_directory output_pack [extension]\n"
+    "    Packs all files of the directory tree (optionally only files\n"
+    "    with given extension, e.g. .sh2) into output_pack\n" << endl;
+  cout <<
+    "Program description:\n"
+    "  Entries are named with paths relative to the working directory,\n"
+    "exactly as given root_directory followed by '\\' separated names, so\n"
+    "DataFileResourceManager can load them with loadResourcesFromTree\n"
+    "(root_directory) after setResourceArchive. All values are 32-bit,\n"
+    "stored in native byte order.\n" << endl;
+  cout <<
+    "Data layout of pack:\n"
+    "*header: char[4] \"GPAK\", version, entries count, hash slots count,\n"
+    " entries offset, hash slots offset, names offset, names size\n"
+    "*entries sorted by name: name hash (FNV-1a), name offset, name length,\n"
+    " data offset, data size, reserved\n"
+    "*hash slots (linear probing): entry index + 1, 0 - empty slot\n"
+    "*entries names\n"
+    "*entries data, each aligned to " << AssetPack::ALIGNMENT << 
+    " bytes" << endl;
+}
+
+int main(int argc, char* argv[])
+{
+  if(argc < 3) {
+    usePatternPrint();
+    return EXIT_SUCCESS;
+  }
+
+  string extension = argc > 3 ? argv[3] : "";
+  ::toLower( &extension );
+
+  PackedFiles files;
+  traverseDirectories(argv[1], extension, &files);
+
+  if( !writePack(files, argv[2]) ) {
+    cout << "FAIL!" << endl;
+    return EXIT_FAILURE;
+  }
+
+  cout << files.size() << " files packed into " << argv[2] << endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,92 @@
+/***************************************************************************
+ *   Copyright (C) 2005 by Eryk Klebanski                                  *
+ *   rixment@gmail.com                                                     *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+
+#ifndef _GCAD_BENCHALLOCATIONS_H_
+#define _GCAD_BENCHALLOCATIONS_H_
+
+#include <cstdlib>
+#include <new>
+
+// Specyfikacje wyjatkow zastepowanych operatorow musza byc zgodne
+// z deklaracjami naglowka <new> - dynamiczne specyfikacje zostaly
+// usuniete z jezyka w standardzie C++17
+#if __cplusplus >= 201103L || ( defined( _MSC_VER ) && _MSC_VER >= 1600 )
+  #define GCAD_BENCH_THROW_BAD_ALLOC
+  #define GCAD_BENCH_NO_THROW noexcept
+#else
+  #define GCAD_BENCH_THROW_BAD_ALLOC throw( std::bad_alloc )
+  #define GCAD_BENCH_NO_THROW throw()
+#endif
+
+// Operatory nie sa rozwijane w miejscu wywolania - w przeciwnym razie
+// kompilator GCC zestawia przydzial operatorem new ze zwolnieniem
+// funkcja free i zglasza ostrzezenie -Wmismatched-new-delete
+#ifdef __GNUC__
+  #define GCAD_BENCH_NO_INLINE __attribute__(( noinline ))
+#else
+  #define GCAD_BENCH_NO_INLINE
+#endif
+
+/**
+  @brief
+    Liczniki przydzialow pamieci operatorem new (rowniez przez kontenery
+    biblioteki standardowej). Naglowek zastepuje globalne operatory new
+    i delete, dlatego moze go dolaczyc jedynie jedna jednostka kompilacji
+    programu pomiarowego
+*/
+struct BenchAllocations {
+  static size_t  count_;  /**< Liczba przydzialow */
+  static size_t  bytes_;  /**< Liczba przydzielonych bajtow */
+};
+
+size_t BenchAllocations::count_ = 0;
+size_t BenchAllocations::bytes_ = 0;
+
+GCAD_BENCH_NO_INLINE
+void*
+operator new( size_t size ) GCAD_BENCH_THROW_BAD_ALLOC
+{
+  ++BenchAllocations::count_;
+  BenchAllocations::bytes_ += size;
+
+  void* memory = malloc( size == 0 ? 1 : size );
+  if( memory == 0 )
+    throw std::bad_alloc();
+  return memory;
+}
+
+GCAD_BENCH_NO_INLINE
+void
+operator delete( void* memory ) GCAD_BENCH_NO_THROW
+{
+  free( memory );
+}
+
+#ifdef __cpp_sized_deallocation
+GCAD_BENCH_NO_INLINE
+void
+operator delete( void* memory, size_t ) GCAD_BENCH_NO_THROW
+{
+  free( memory );
+}
+#endif
+
+#endif
@@ -0,0 +1,101 @@
+/***************************************************************************
+ *   Copyright (C) 2005 by Eryk Klebanski                                  *
+ *   rixment@gmail.com                                                     *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+
+#ifndef _GCAD_BENCHSTOPWATCH_H_
+#define _GCAD_BENCHSTOPWATCH_H_
+
+#ifdef WIN32
+  #include <windows.h>
+#else
+  #include <time.h>
+#endif
+
+/**
+  @brief
+    Pomiar czasu rzeczywistego (zegar monotoniczny) wykorzystywany przez
+    programy pomiarowe katalogu bench. Pomiar rozpoczyna konstruktor,
+    badz metoda restart()
+*/
+class BenchStopwatch {
+ public:
+   BenchStopwatch() { restart(); }
+
+   void restart() { start_ = now(); }
+
+   /**
+     @brief
+       Czas, ktory uplynal od rozpoczecia pomiaru, w sekundach
+   */
+   double seconds() const { return now() - start_; }
+
+   /**
+     @brief
+       Czas, ktory uplynal od rozpoczecia pomiaru, w milisekundach
+   */
+   double milliseconds() const { return seconds() * 1000.0; }
+
+ private:
+   static double now()
+   {
+   #ifdef WIN32
+     LARGE_INTEGER frequency;
+     LARGE_INTEGER counter;
+     QueryPerformanceFrequency( &frequency );
+     QueryPerformanceCounter( &counter );
+     return static_cast< double >( counter.QuadPart ) / 
+       static_cast< double >( frequency.QuadPart );
+   #else
+     timespec time;
+     clock_gettime( CLOCK_MONOTONIC, &time );
+     return time.tv_sec + time.tv_nsec * 1e-9;
+   #endif
+   }
+
+ private:
+   double  start_;
+};
+
+/**
+  @brief
+    Zmienna przechowujaca wyniki pomiarow (patrz benchKeep)
+*/
+template< typename T >
+struct BenchSink {
+  static volatile T  value_;
+};
+
+template< typename T >
+volatile T BenchSink< T >::value_;
+
+/**
+  @brief
+    Zapobiega usunieciu przez kompilator obliczen, ktorych wynik nie
+    jest dalej wykorzystywany
+*/
+template< typename T >
+inline
+void
+benchKeep( const T& value )
+{
+  BenchSink< T >::value_ = value;
+}
+
+#endif
@@ -0,0 +1,254 @@
+/***************************************************************************
+ *   Copyright (C) 2005 by Eryk Klebanski                                  *
+ *   rixment@gmail.com                                                     *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+
+
+#include "GcadConcurrentMemoryAlloc.h"
+#include "GcadThread.h"
+#include "../BenchStopwatch.h"
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+using namespace Gcad::Platform;
+using namespace Gcad::Utilities;
+
+/**
+  @brief
+    Pomiar skalowania puli ConcurrentMemoryAlloc wraz z liczba watkow.
+    Dla kazdej liczby watkow (od 1 do N) mierzona jest przepustowosc
+    dwoch obciazen:
+      - local: przydzial i zwolnienie losowych obiektow zbioru zywych
+        obiektow watku
+      - remote: obiekty przydzielone przez watek zwalnia jego sasiad
+        (zwolnienia z innego watku niz przydzielajacy)
+    Punktem odniesienia jest globalny operator new/delete
+*/
+
+const int  LIVE_OBJECTS       = 256;
+const int  LOCAL_ITERATIONS   = 2000000;
+const int  REMOTE_ROUNDS      = 4000;
+
+typedef ConcurrentMemoryAlloc< 1 << 17, 64 >  ObjectMemAlloc;
+
+struct PooledObject : public ObjectMemAlloc {
+  char  data_[ 48 ];
+};
+
+struct HeapObject {
+  char  data_[ 48 ];
+};
+
+/**
+  @brief
+    Bariera watkow - kazdy przebieg obciazenia remote rozdziela faze
+    przydzialu od fazy zwolnien
+*/
+class Barrier {
+ public:
+   explicit Barrier(unsigned int threadsCount)
+     : threadsCount_(threadsCount)
+     , waiting_(0)
+     , generation_(0)
+   {}
+
+   void wait()
+   {
+     MutexLock lock(mutex_);
+     const unsigned int GENERATION = generation_;
+
+     if( ++waiting_ == threadsCount_ ) {
+       waiting_ = 0;
+       ++generation_;
+       released_.notifyAll();
+       return;
+     }
+
+     while( generation_ == GENERATION )
+       released_.wait(mutex_);
+   }
+
+ private:
+   Mutex              mutex_;
+   ConditionVariable  released_;
+   unsigned int       threadsCount_;
+   unsigned int       waiting_;
+   unsigned int       generation_;
+};
+
+/**
+  @brief
+    Stan wspolny watkow jednego pomiaru
+*/
+template<typename OBJECT>
+struct Workload {
+  unsigned int                         threadsCount_;
+  Barrier*                             barrier_;
+  std::vector< std::vector<OBJECT*> >  slots_;  /**< Obiekty watkow */
+};
+
+template<typename OBJECT>
+struct WorkerArgument {
+  Workload<OBJECT>*  workload_;
+  unsigned int       index_;
+};
+
+void
+flushCache(PooledObject*)
+{
+  ObjectMemAlloc::flushThreadCache();
+}
+
+void
+flushCache(HeapObject*)
+{
+}
+
+template<typename OBJECT>
+void
+localChurn(void* argument)
+{
+  const WorkerArgument<OBJECT>* ARG = 
+    static_cast< WorkerArgument<OBJECT>* >(argument);
+
+  OBJECT* live[ LIVE_OBJECTS ];
+  for(int i=0; i<LIVE_OBJECTS; ++i)
+    live[i] = new OBJECT;
+
+  unsigned int random = 2463534242u + ARG->index_;
+  for(int i=0; i<LOCAL_ITERATIONS; ++i) {
+    random ^= random << 13;
+    random ^= random >> 17;
+    random ^= random << 5;
+
+    OBJECT*& slot = live[ random % LIVE_OBJECTS ];
+    delete slot;
+    slot = new OBJECT;
+    slot->data_[0] = static_cast<char>(i);
+  }
+
+  for(int i=0; i<LIVE_OBJECTS; ++i)
+    delete live[i];
+
+  flushCache(static_cast<OBJECT*>(0));
+}
+
+template<typename OBJECT>
+void
+remoteChurn(void* argument)
+{
+  const WorkerArgument<OBJECT>* ARG = 
+    static_cast< WorkerArgument<OBJECT>* >(argument);
+  Workload<OBJECT>& workload = *ARG->workload_;
+
+  std::vector<OBJECT*>& own = workload.slots_[ ARG->index_ ];
+  std::vector<OBJECT*>& neighbour = 
+    workload.slots_[ (ARG->index_ + 1) % workload.threadsCount_ ];
+
+  for(int round=0; round<REMOTE_ROUNDS; ++round) {
+    for(int i=0; i<LIVE_OBJECTS; ++i)
+      own[i] = new OBJECT;
+
+    workload.barrier_->wait();
+
+    for(int i=0; i<LIVE_OBJECTS; ++i)
+      delete neighbour[i];
+
+    workload.barrier_->wait();
+  }
+
+  flushCache(static_cast<OBJECT*>(0));
+}
+
+/**
+  @brief
+    Uruchomienie threadsCount watkow wykonujacych routine i zwrocenie
+    przepustowosci w milionach operacji (przydzial + zwolnienie) na sekunde
+*/
+template<typename OBJECT>
+double
+run(Thread::Routine  routine,
+    unsigned int     threadsCount,
+    double           operationsPerThread)
+{
+  Barrier barrier(threadsCount);
+
+  Workload<OBJECT> workload;
+  workload.threadsCount_ = threadsCount;
+  workload.barrier_      = &barrier;
+  workload.slots_.assign(threadsCount, std::vector<OBJECT*>(LIVE_OBJECTS));
+
+  std::vector< WorkerArgument<OBJECT> > arguments(threadsCount);
+  std::vector<Thread*> threads;
+
+  BenchStopwatch stopwatch;
+
+  for(unsigned int i=0; i<threadsCount; ++i) {
+    arguments[i].workload_ = &workload;
+    arguments[i].index_    = i;
+    threads.push_back(new Thread(routine, &arguments[i]));
+  }
+
+  for(unsigned int i=0; i<threadsCount; ++i) {
+    threads[i]->join();
+    delete threads[i];
+  }
+
+  return operationsPerThread * threadsCount / stopwatch.seconds() / 1e6;
+}
+
+int main(int argc, char* argv[])
+{
+  const unsigned int MAX_THREADS = argc > 1 ? 
+    static_cast<unsigned int>(atoi(argv[1])) : Thread::hardwareConcurrency();
+
+  if( MAX_THREADS == 0 ) {
+    cout << "Example:\n  ConcurrentAllocBench [max_threads]" << endl;
+    return EXIT_FAILURE;
+  }
+
+  const double LOCAL_OPERATIONS  = LOCAL_ITERATIONS;
+  const double REMOTE_OPERATIONS = 
+    static_cast<double>(REMOTE_ROUNDS) * LIVE_OBJECTS;
+
+  cout << "Throughput in millions of alloc/free pairs per second\n"
+       << setw(8) << "threads" 
+       << setw(14) << "local pool" << setw(14) << "local heap"
+       << setw(14) << "remote pool" << setw(14) << "remote heap" << endl;
+
+  cout << fixed << setprecision(2);
+
+  for(unsigned int threads=1; threads<=MAX_THREADS; ++threads) {
+    cout << setw(8) << threads
+         << setw(14) << run<PooledObject>(
+              &localChurn<PooledObject>, threads, LOCAL_OPERATIONS)
+         << setw(14) << run<HeapObject>(
+              &localChurn<HeapObject>, threads, LOCAL_OPERATIONS)
+         << setw(14) << run<PooledObject>(
+              &remoteChurn<PooledObject>, threads, REMOTE_OPERATIONS)
+         << setw(14) << run<HeapObject>(
+              &remoteChurn<HeapObject>, threads, REMOTE_OPERATIONS)
+         << endl;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,257 @@
+/***************************************************************************
+ *   Copyright (C) 2005 by Eryk Klebanski                                  *
+ *   rixment@gmail.com                                                     *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+
+#include "GcadDriveElementsEnumeratorPosix.h"
+#include "../BenchStopwatch.h"
+#include <cstdio>
+#include <cstdlib>
+#include <dirent.h>
+#include <fcntl.h>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace std;
+using namespace Gcad::Platform;
+
+/**
+  @brief
+    Czas rekurencyjnego przegladania syntetycznego drzewa 100 tysiecy
+    plikow: enumerator DriveElementsEnumeratorPosix (porcje wpisow
+    getdents64, rodzaj elementu z pola d_type), funkcja readdir z polem
+    d_type, oraz funkcja readdir z wywolaniem stat dla kazdego wpisu
+    (sposob nie korzystajacy z d_type). Drzewo jest przegladane
+    w dwoch ukladach: jeden katalog ze wszystkimi plikami, oraz
+    DIRS_COUNT katalogow po FILES_COUNT / DIRS_COUNT plikow
+
+  @remark
+    Pomiary obejmuja jedynie przegladanie wpisow znajdujacych sie
+    w pamieci podrecznej systemu (usuniecie jej wymaga uprawnien
+    administratora). Program przyjmuje opcjonalnie katalog, w ktorym
+    tworzone jest drzewo (domyslnie katalog biezacy)
+*/
+
+const int  FILES_COUNT           = 100000;
+const int  DIRS_COUNT            = 100;
+const int  REPEATS_COUNT         = 5;
+
+/**
+  @brief
+    Wynik przegladania drzewa
+*/
+struct WalkResult {
+  WalkResult() 
+    : files_(0)
+    , directories_(0)
+  {}
+
+  size_t  files_;
+  size_t  directories_;
+};
+
+bool isDotEntry(const char* name)
+{
+  return name[0] == '.' && 
+    (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'));
+}
+
+void walkEnumerator(DriveElementsEnumeratorPosix&  enumerator,
+                    const std::string&             path,
+                    WalkResult*                    result)
+{
+  // Podkatalogi sa przegladane po zakonczeniu iteracji - enumerator
+  // przeglada jeden katalog w danej chwili, tak jak menadzer zasobow
+  // (loadResourcesFromTree)
+
+  std::vector<std::string> subdirectories;
+
+  enumerator.setDirectory(path);
+  for(DriveElementsEnumerator::ItorAutoPtr itor(enumerator.getItor()); 
+    itor->isValid(); itor->moveToNextElement())
+  {
+    const std::string NAME = itor->getElementName();
+    if( itor->isDirectory() ) {
+      if( !isDotEntry(NAME.c_str()) ) {
+        subdirectories.push_back(path + '/' + NAME);
+        ++result->directories_;
+      }
+    }
+    else
+      ++result->files_;
+  }
+
+  for(size_t i=0; i<subdirectories.size(); ++i)
+    walkEnumerator(enumerator, subdirectories[i], result);
+}
+
+void walkReaddir(const std::string& path, bool useStat, WalkResult* result)
+{
+  std::vector<std::string> subdirectories;
+
+  DIR* directory = opendir(path.c_str());
+  if( directory == 0 )
+    return;
+
+  while( dirent* entry = readdir(directory) ) {
+    if( isDotEntry(entry->d_name) )
+      continue;
+
+    const std::string ENTRY_PATH = path + '/' + entry->d_name;
+    bool isDirectory = false;
+
+    if( useStat ) {
+      struct stat status;
+      isDirectory = stat(ENTRY_PATH.c_str(), &status) == 0 && 
+        S_ISDIR(status.st_mode);
+    }
+    else
+      isDirectory = (entry->d_type == DT_DIR);
+
+    if( isDirectory ) {
+      subdirectories.push_back(ENTRY_PATH);
+      ++result->directories_;
+    }
+    else
+      ++result->files_;
+  }
+  closedir(directory);
+
+  for(size_t i=0; i<subdirectories.size(); ++i)
+    walkReaddir(subdirectories[i], useStat, result);
+}
+
+/**
+  @brief
+    Utworzenie drzewa FILES_COUNT pustych plikow w dirsCount katalogach
+    (zero - wszystkie pliki w katalogu root)
+  @return
+    Sciezki utworzonych plikow i katalogow, w kolejnosci umozliwiajacej
+    ich usuniecie
+*/
+std::vector<std::string> createTree(const std::string& root, int dirsCount)
+{
+  std::vector<std::string> entries;
+  std::vector<std::string> directories;
+
+  mkdir(root.c_str(), 0755);
+  for(int dir=0; dir<dirsCount; ++dir) {
+    ostringstream path;
+    path << root << "/models" << dir;
+    mkdir(path.str().c_str(), 0755);
+    directories.push_back(path.str());
+  }
+
+  for(int file=0; file<FILES_COUNT; ++file) {
+    ostringstream path;
+    if( dirsCount > 0 )
+      path << directories[file % dirsCount];
+    else
+      path << root;
+    path << "/model" << file << ".md2";
+
+    const int DESCRIPTOR = open(path.str().c_str(), O_CREAT | O_WRONLY, 0644);
+    if( DESCRIPTOR < 0 ) {
+      cerr << "cannot create " << path.str() << endl;
+      exit(EXIT_FAILURE);
+    }
+    close(DESCRIPTOR);
+    entries.push_back(path.str());
+  }
+
+  entries.insert(entries.end(), directories.begin(), directories.end());
+  entries.push_back(root);
+  return entries;
+}
+
+void removeTree(const std::vector<std::string>& entries)
+{
+  for(size_t i=0; i<entries.size(); ++i)
+    remove(entries[i].c_str());
+}
+
+/**
+  @brief
+    Najkrotszy czas przegladania drzewa jednym ze sposobow
+    (0 - enumerator, 1 - readdir z d_type, 2 - readdir ze stat)
+*/
+double measureWalk(const std::string& root, int method, WalkResult* result)
+{
+  DriveElementsEnumeratorPosix enumerator;
+  double best = 0.0;
+
+  for(int repeat=0; repeat<REPEATS_COUNT; ++repeat) {
+    *result = WalkResult();
+
+    BenchStopwatch stopwatch;
+    if( method == 0 )
+      walkEnumerator(enumerator, root, result);
+    else
+      walkReaddir(root, method == 2, result);
+    const double MILLISECONDS = stopwatch.milliseconds();
+
+    if( repeat == 0 || MILLISECONDS < best )
+      best = MILLISECONDS;
+  }
+  return best;
+}
+
+int main(int argc, char* argv[])
+{
+  const char* METHODS[] = { 
+    "enumerator (getdents64)", "readdir + d_type", "readdir + stat" };
+  const int LAYOUTS[] = { 0, DIRS_COUNT };
+
+  const std::string ROOT = std::string(argc > 1 ? argv[1] : ".") + 
+    "/enumerate_tree";
+
+  cout << FILES_COUNT << " files (best of " << REPEATS_COUNT << ", warm cache)\n"
+       << setw(12) << "layout" << setw(26) << "method" << setw(12) << "ms" 
+       << setw(14) << "ns/entry" << setw(10) << "files" << endl;
+  cout << fixed << setprecision(2);
+
+  for(size_t layout=0; layout<sizeof(LAYOUTS) / sizeof(LAYOUTS[0]); ++layout) {
+    const std::vector<std::string> ENTRIES = createTree(ROOT, LAYOUTS[layout]);
+
+    ostringstream layoutName;
+    if( LAYOUTS[layout] == 0 )
+      layoutName << "flat";
+    else
+      layoutName << LAYOUTS[layout] << " dirs";
+
+    for(int method=0; method<3; ++method) {
+      WalkResult result;
+      const double MILLISECONDS = measureWalk(ROOT, method, &result);
+      cout << setw(12) << layoutName.str() << setw(26) << METHODS[method]
+           << setw(12) << MILLISECONDS
+           << setw(14) << MILLISECONDS * 1000000.0 / 
+                (result.files_ + result.directories_)
+           << setw(10) << result.files_ << endl;
+    }
+
+    removeTree(ENTRIES);
+  }
+
+  return EXIT_SUCCESS;
+}
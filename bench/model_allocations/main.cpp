@@ -0,0 +1,237 @@
+/***************************************************************************
+ *   Copyright (C) 2005 by Eryk Klebanski                                  *
+ *   rixment@gmail.com                                                     *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+
+#include "GcadMD2Data.h"
+#include "GcadMD2Animator.h"
+#include "GcadByteSpan.h"
+#include "../BenchAllocations.h"
+#include "../BenchStopwatch.h"
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace Gcad::Framework;
+using namespace Gcad::Utilities;
+
+/**
+  @brief
+    Liczba przydzialow pamieci, oraz liczba przydzielonych bajtow podczas
+    wczytywania modelu MD2 (ze strumienia i z obszaru pamieci), oraz
+    podczas animacji: interpolacja do nowego kontenera (auto_ptr), oraz
+    do kontenera wielokrotnie uzywanego przez wywolujacego. Model jest
+    generowany w pamieci - nie jest wymagany zaden plik
+*/
+
+const int  FRAMES_COUNT    = 198;
+const int  VERTICES_COUNT  = 500;
+const int  POLYGONS_COUNT  = 900;
+const int  LOADS_COUNT     = 50;
+const int  UPDATES_COUNT   = 20000;
+const float FRAME_TIME     = 0.016f;
+
+/**
+  @brief
+    Stan licznikow przydzialow w chwili utworzenia obiektu, oraz czas
+*/
+class AllocationsProbe {
+ public:
+   AllocationsProbe()
+     : allocations_(BenchAllocations::count_)
+     , bytes_(BenchAllocations::bytes_)
+   {}
+
+   size_t allocations() const 
+   { 
+     return BenchAllocations::count_ - allocations_; 
+   }
+
+   size_t bytes() const { return BenchAllocations::bytes_ - bytes_; }
+   double milliseconds() const { return stopwatch_.milliseconds(); }
+
+ private:
+   size_t          allocations_;
+   size_t          bytes_;
+   BenchStopwatch  stopwatch_;
+};
+
+void
+putInt(std::string* data, size_t offset, int value)
+{
+  memcpy(&(*data)[offset], &value, sizeof(value));
+}
+
+/**
+  @brief
+    Poprawny plik MD2: FRAMES_COUNT klatek po VERTICES_COUNT wierzcholkow,
+    VERTICES_COUNT koordynat tekstur, oraz POLYGONS_COUNT poligonow
+*/
+std::string
+synthesizeMD2()
+{
+  const int HEADER_SIZE       = 17 * sizeof(int);
+  const int FRAME_SIZE        = 40 + 4 * VERTICES_COUNT;
+  const int OFFSET_TEX_COORDS = HEADER_SIZE;
+  const int OFFSET_POLYS      = OFFSET_TEX_COORDS + VERTICES_COUNT * 4;
+  const int OFFSET_FRAMES     = OFFSET_POLYS + POLYGONS_COUNT * 12;
+  const int OFFSET_END        = OFFSET_FRAMES + FRAMES_COUNT * FRAME_SIZE;
+
+  std::string data(OFFSET_END, '\0');
+
+  const int HEADER[17] = {
+    'I' | ('D' << 8) | ('P' << 16) | ('2' << 24), 8,
+    256, 256, FRAME_SIZE, 0, VERTICES_COUNT, VERTICES_COUNT, 
+    POLYGONS_COUNT, 0, FRAMES_COUNT, 
+    HEADER_SIZE, OFFSET_TEX_COORDS, OFFSET_POLYS, OFFSET_FRAMES, 
+    OFFSET_END, OFFSET_END
+  };
+  memcpy(&data[0], HEADER, sizeof(HEADER));
+
+  for(int i=0; i<VERTICES_COUNT; ++i) {
+    const short TEX_COORD[2] = { short(i % 256), short(i / 2 % 256) };
+    memcpy(&data[OFFSET_TEX_COORDS + i * 4], TEX_COORD, sizeof(TEX_COORD));
+  }
+
+  for(int i=0; i<POLYGONS_COUNT; ++i) {
+    unsigned short polygon[6];
+    for(int corner=0; corner<3; ++corner) {
+      polygon[corner] = 
+        static_cast<unsigned short>((i + corner * 7) % VERTICES_COUNT);
+      polygon[corner + 3] = polygon[corner];
+    }
+    memcpy(&data[OFFSET_POLYS + i * 12], polygon, sizeof(polygon));
+  }
+
+  for(int frame=0; frame<FRAMES_COUNT; ++frame) {
+    const size_t FRAME_OFFSET = OFFSET_FRAMES + frame * FRAME_SIZE;
+    const float SCALE_TRANSLATE[6] = { 0.1f, 0.1f, 0.1f, 
+      -12.8f, -12.8f, float(frame) * 0.01f };
+    memcpy(&data[FRAME_OFFSET], SCALE_TRANSLATE, sizeof(SCALE_TRANSLATE));
+
+    for(int i=0; i<VERTICES_COUNT * 4; ++i)
+      data[FRAME_OFFSET + 40 + i] = char((i * 31 + frame * 3) & 0xff);
+  }
+
+  return data;
+}
+
+void
+printRow(const char* workload, const AllocationsProbe& probe, int count)
+{
+  cout << setw(18) << workload 
+       << setw(14) << double(probe.allocations()) / count
+       << setw(14) << double(probe.bytes()) / count / 1024.0
+       << setw(14) << probe.milliseconds() * 1000.0 / count << endl;
+}
+
+void
+loadWorkloads(const std::string& md2File)
+{
+  {
+    AllocationsProbe probe;
+    for(int i=0; i<LOADS_COUNT; ++i) {
+      std::istringstream input(md2File);
+      MD2Data model(input);
+      benchKeep(model.keyFramesCount());
+    }
+    printRow("load (istream)", probe, LOADS_COUNT);
+  }
+
+  {
+    AllocationsProbe probe;
+    for(int i=0; i<LOADS_COUNT; ++i) {
+      MD2Data model(ByteSpan(md2File.data(), md2File.size()));
+      benchKeep(model.keyFramesCount());
+    }
+    printRow("load (span)", probe, LOADS_COUNT);
+  }
+
+  MD2Data model(ByteSpan(md2File.data(), md2File.size()));
+  {
+    AllocationsProbe probe;
+    for(int i=0; i<LOADS_COUNT; ++i) {
+    #ifdef GCAD_HAS_RVALUE_REFERENCES
+      MD2Data moved(static_cast<MD2Data&&>(model));
+      model = static_cast<MD2Data&&>(moved);
+    #else
+      model.swap(model);
+    #endif
+      benchKeep(model.keyFramesCount());
+    }
+    printRow("move/swap", probe, LOADS_COUNT);
+  }
+}
+
+void
+animationWorkloads(const MD2Data& model)
+{
+  MD2Animator animator(model);
+  animator.setAnimation(MD2Animator::AS_RUN, MD2Animator::AT_LOOP);
+
+  {
+    AllocationsProbe probe;
+    for(int i=0; i<UPDATES_COUNT; ++i) {
+      animator.update(FRAME_TIME);
+      MD2Animator::VerticesKeyFrameAutoPtr vertices = 
+        animator.interpolatedVertices();
+      MD2Animator::NormalsKeyFrameAutoPtr normals = 
+        animator.interpolatedNormals();
+      benchKeep(vertices->size() + normals->size());
+    }
+    printRow("frame (auto_ptr)", probe, UPDATES_COUNT);
+  }
+
+  {
+    MD2Animator::VerticesKeyFrame vertices;
+    MD2Animator::NormalsKeyFrame  normals;
+
+    AllocationsProbe probe;
+    for(int i=0; i<UPDATES_COUNT; ++i) {
+      animator.update(FRAME_TIME);
+      animator.interpolatedVertices(&vertices);
+      animator.interpolatedNormals(&normals);
+      benchKeep(vertices.size() + normals.size());
+    }
+    printRow("frame (reused)", probe, UPDATES_COUNT);
+  }
+}
+
+int main()
+{
+  const std::string MD2_FILE = synthesizeMD2();
+
+  cout << "Model: " << FRAMES_COUNT << " frames, " << VERTICES_COUNT 
+       << " vertices, " << POLYGONS_COUNT << " polygons ("
+       << MD2_FILE.size() / 1024 << " KB)\n"
+       << setw(18) << "workload" << setw(14) << "allocs/op"
+       << setw(14) << "KB/op" << setw(14) << "us/op" << endl;
+
+  cout << fixed << setprecision(2);
+
+  loadWorkloads(MD2_FILE);
+  animationWorkloads(MD2Data(ByteSpan(MD2_FILE.data(), MD2_FILE.size())));
+
+  return EXIT_SUCCESS;
+}
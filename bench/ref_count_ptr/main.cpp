@@ -0,0 +1,331 @@
+/***************************************************************************
+ *   Copyright (C) 2005 by Eryk Klebanski                                  *
+ *   rixment@gmail.com                                                     *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+
+
+#include "GcadRefCountPtr.h"
+#include "GcadRefCounted.h"
+#include "GcadAnagramSet.h"
+#include "../BenchStopwatch.h"
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace Gcad::Utilities;
+
+/**
+  @brief
+    Porownanie kosztu kopiowania wskaznikow RefCountPtr z licznikami
+    przechowywanymi w globalnym slowniku (dawna realizacja, odtworzona
+    ponizej jako MapRefCountPtr), z licznikami umieszczonymi przy obiekcie
+    (osobny licznik, badz klasa bazowa RefCounted). Obciazenia:
+      - attach: przenoszenie wezlow miedzy rodzicami, tak jak
+        SceneGraph::Node::attach (wyszukanie, usuniecie, dolaczenie)
+      - anagrams: dodawanie, odczyt i usuwanie elementow AnagramSet
+      - copy: kopiowanie list potomkow wezla
+*/
+
+/**
+  @brief
+    Dawna realizacja RefCountPtr - licznik odniesien kazdego obiektu jest
+    przechowywany w statycznym slowniku std::map< T*, int >
+*/
+template<typename T>
+class MapRefCountPtr {
+ public:
+   MapRefCountPtr(T* pointer = 0)
+     : ptr_(pointer)
+   {
+     if( ptr_ ) {
+       if( refMap().count(ptr_) == 0 )
+         refMap()[ptr_] = 1;
+       else
+         ++refMap()[ptr_];
+     }
+   }
+
+   MapRefCountPtr(const MapRefCountPtr& that)
+   {
+     new(this) MapRefCountPtr(that.ptr_);
+   }
+
+   ~MapRefCountPtr()
+   {
+     typename std::map<T*, int>::iterator found = refMap().find(ptr_);
+     if( found != refMap().end() && --found->second == 0 ) {
+       delete ptr_;
+       ptr_ = 0;
+     }
+   }
+
+   MapRefCountPtr& operator =(const MapRefCountPtr& rhs)
+   {
+     if( ptr_ != rhs.ptr_ ) {
+       this->~MapRefCountPtr();
+       new(this) MapRefCountPtr(rhs.ptr_);
+     }
+     return *this;
+   }
+
+   T& operator *() const { return *ptr_; }
+   T* operator ->() const { return ptr_; }
+   T* get() const { return ptr_; }
+
+ private:
+   static std::map<T*, int>& refMap()
+   {
+     static std::map<T*, int> refPtrCounter;
+     return refPtrCounter;
+   }
+
+ private:
+   T*  ptr_;
+};
+
+template<typename T>
+bool
+operator ==(const MapRefCountPtr<T>& lhs, const MapRefCountPtr<T>& rhs)
+{
+  return lhs.get() == rhs.get();
+}
+
+struct MapNode {
+  typedef MapRefCountPtr<MapNode>  Ptr;
+
+  MapNode*          parent_;
+  std::vector<Ptr>  childs_;
+};
+
+struct CounterNode {
+  typedef RefCountPtr<CounterNode>  Ptr;
+
+  CounterNode*      parent_;
+  std::vector<Ptr>  childs_;
+};
+
+struct IntrusiveNode : public RefCounted {
+  typedef RefCountPtr<IntrusiveNode>  Ptr;
+
+  IntrusiveNode*    parent_;
+  std::vector<Ptr>  childs_;
+};
+
+const int  PARENTS_COUNT   = 100;
+const int  NODES_COUNT     = 10000;
+const int  ATTACH_MOVES    = 50000;
+const int  ANAGRAM_GROUPS  = 100;
+const int  ANAGRAM_ROUNDS  = 200000;
+const int  COPY_ROUNDS     = 2000;
+
+unsigned int random_ = 2463534242u;
+
+unsigned int
+nextRandom()
+{
+  random_ ^= random_ << 13;
+  random_ ^= random_ >> 17;
+  random_ ^= random_ << 5;
+  return random_;
+}
+
+/**
+  @brief
+    Przeniesienie wezla do nowego rodzica - kod SceneGraph::Node::attach
+*/
+template<typename NODE>
+void
+attach(NODE* node, NODE* newParent)
+{
+  typename std::vector<typename NODE::Ptr>::iterator founded = find(
+    node->parent_->childs_.begin(),
+    node->parent_->childs_.end(),
+    typename NODE::Ptr(node));
+  node->parent_->childs_.erase(founded);
+  node->parent_ = newParent;
+  node->parent_->childs_.push_back(node);
+}
+
+/**
+  @brief
+    Drzewo o dwoch poziomach: korzen, PARENTS_COUNT rodzicow oraz
+    NODES_COUNT wezlow rozlozonych rowno pomiedzy rodzicow. Tak jak
+    w SceneGraph (kolekcja anagramow), wezly sa dodatkowo wskazywane
+    z zewnatrz drzewa - przeniesienie nie usuwa wezla
+*/
+template<typename NODE>
+typename NODE::Ptr
+buildTree(std::vector<NODE*>*                parents, 
+          std::vector<typename NODE::Ptr>*   nodes)
+{
+  typename NODE::Ptr root(new NODE);
+  root->parent_ = 0;
+
+  for(int i=0; i<PARENTS_COUNT; ++i) {
+    NODE* parent = new NODE;
+    parent->parent_ = root.get();
+    root->childs_.push_back(parent);
+    parents->push_back(parent);
+  }
+
+  for(int i=0; i<NODES_COUNT; ++i) {
+    const typename NODE::Ptr NODE_PTR(new NODE);
+    NODE_PTR->parent_ = (*parents)[ i % PARENTS_COUNT ];
+    NODE_PTR->parent_->childs_.push_back(NODE_PTR);
+    nodes->push_back(NODE_PTR);
+  }
+
+  return root;
+}
+
+template<typename NODE>
+double
+attachWorkload()
+{
+  std::vector<NODE*>               parents;
+  std::vector<typename NODE::Ptr>  nodes;
+  typename NODE::Ptr root = buildTree(&parents, &nodes);
+
+  random_ = 2463534242u;
+  BenchStopwatch stopwatch;
+
+  for(int i=0; i<ATTACH_MOVES; ++i) {
+    attach(nodes[ nextRandom() % NODES_COUNT ].get(), 
+      parents[ nextRandom() % PARENTS_COUNT ]);
+  }
+
+  return stopwatch.milliseconds();
+}
+
+template<typename NODE>
+double
+copyWorkload()
+{
+  std::vector<NODE*>               parents;
+  std::vector<typename NODE::Ptr>  nodes;
+  typename NODE::Ptr root = buildTree(&parents, &nodes);
+
+  BenchStopwatch stopwatch;
+  size_t copied = 0;
+
+  for(int i=0; i<COPY_ROUNDS; ++i) {
+    const std::vector<typename NODE::Ptr> CHILDS(
+      parents[ i % PARENTS_COUNT ]->childs_);
+    copied += CHILDS.size();
+  }
+
+  benchKeep(copied);
+  return stopwatch.milliseconds();
+}
+
+/**
+  @brief
+    Slowa bedace permutacjami ANAGRAM_GROUPS losowych wyrazow bazowych -
+    kazdy anagram grupuje wiele slow, wiec usuniecie elementu przesuwa
+    (kopiuje) pozostale elementy grupy
+*/
+std::vector<std::string>
+anagramWords()
+{
+  std::vector<std::string> words;
+
+  for(int group=0; group<ANAGRAM_GROUPS; ++group) {
+    std::string word;
+    for(int letter=0; letter<9; ++letter)
+      word += static_cast<char>('a' + nextRandom() % 26);
+
+    std::sort(word.begin(), word.end());
+    for(int i=0; i<NODES_COUNT / ANAGRAM_GROUPS && 
+      std::next_permutation(word.begin(), word.end()); ++i)
+    {
+      words.push_back(word);
+    }
+  }
+
+  return words;
+}
+
+template<typename NODE>
+double
+anagramsWorkload(const std::vector<std::string>& words)
+{
+  AnagramSet<typename NODE::Ptr> anagrams;
+  for(size_t i=0; i<words.size(); ++i) {
+    typename NODE::Ptr node(new NODE);
+    node->parent_ = 0;
+    anagrams.add(words[i], node);
+  }
+
+  random_ = 2463534242u;
+  BenchStopwatch stopwatch;
+
+  for(int i=0; i<ANAGRAM_ROUNDS; ++i) {
+    const std::string& WORD = words[ nextRandom() % words.size() ];
+    const typename NODE::Ptr NODE_PTR = anagrams.getElement(WORD);
+    anagrams.remove(WORD);
+    anagrams.add(WORD, NODE_PTR);
+  }
+
+  return stopwatch.milliseconds();
+}
+
+void
+printRow(const char* workload, double mapTime, double counterTime, 
+         double intrusiveTime)
+{
+  cout << setw(10) << workload << setw(12) << mapTime;
+
+  if( counterTime < 0.0 )
+    cout << setw(12) << "-";
+  else
+    cout << setw(12) << counterTime;
+
+  cout << setw(12) << intrusiveTime
+       << setw(10) << mapTime / intrusiveTime << "x" << endl;
+}
+
+int main()
+{
+  const std::vector<std::string> WORDS = anagramWords();
+
+  cout << "Time in milliseconds (" << NODES_COUNT << " nodes, " 
+       << WORDS.size() << " words)\n"
+       << setw(10) << "workload" << setw(12) << "std::map" 
+       << setw(12) << "counter" << setw(12) << "intrusive"
+       << setw(11) << "speedup" << endl;
+
+  cout << fixed << setprecision(2);
+
+  // Utworzenie wskaznika z adresu this (attach) wymaga licznika
+  // przechowywanego przez obiekt - dla osobnego licznika brak pomiaru
+  printRow("attach", attachWorkload<MapNode>(), -1.0, 
+    attachWorkload<IntrusiveNode>());
+  printRow("anagrams", anagramsWorkload<MapNode>(WORDS), 
+    anagramsWorkload<CounterNode>(WORDS), 
+    anagramsWorkload<IntrusiveNode>(WORDS));
+  printRow("copy", copyWorkload<MapNode>(), copyWorkload<CounterNode>(),
+    copyWorkload<IntrusiveNode>());
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,395 @@
+/***************************************************************************
+ *   Copyright (C) 2005 by Eryk Klebanski                                  *
+ *   rixment@gmail.com                                                     *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+
+#include "GcadDataFileResourceManager.h"
+#include "GcadDriveElementsEnumerator.h"
+#include "GcadTimeInformation.h"
+#include "../BenchAllocations.h"
+#include "../BenchStopwatch.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <istream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef WIN32
+  #include <direct.h>
+  #include <windows.h>
+#else
+  #include <sys/stat.h>
+  #include <time.h>
+  #include <unistd.h>
+#endif
+
+using namespace std;
+using namespace Gcad::Platform;
+
+/**
+  @brief
+    Koszt odwolania do zasobu DataFileResourceManager przy rozkladzie
+    Zipfa. Program korzysta jedynie z interfejsu wspolnego dla dawnej
+    wersji menadzera (std::set uporzadkowany wedlug priorytetu i czasu
+    ostatniego dostepu, oraz std::map uchwytow) i obecnej (lista kazdego
+    priorytetu i tablica indeksowana uchwytem), dlatego moze zostac
+    skompilowany z naglowkami obu wersji. Obciazenia:
+      - touch: wszystkie zasoby sa wczytane, odwolanie (pobranie i dereferencja
+        uchwytu) jedynie aktualizuje porzadek zasobow
+      - evict: limit pamieci pozwala na wczytanie CAPACITY zasobow -
+        odwolanie do zasobu niewczytanego wczytuje go z pliku i zwalnia
+        najdluzej nieuzywany zasob (wszystkie zasoby maja domyslny
+        priorytet). Dawny menadzer nie egzekwowal limitu pamieci, wiec
+        zasoby nie byly zwalniane
+
+  @remark
+    Dawny menadzer laczy katalog z nazwa pliku stala "\\", dlatego 
+    enumerator programu (VectorEnumerator) nie zmienia separatora - 
+    w systemach POSIX nazwy plikow katalogu DATA_DIR maja postac 
+    "pool\\resource<n>.res". Program tworzy katalog DATA_DIR w katalogu
+    biezacym i usuwa go po pomiarach
+
+  @remark
+    Dawna metoda SharedResource::update wstawiala kopie posrednika,
+    a nastepnie usuwala odwzorowanie jego uchwytu (rowniez nowe) - 
+    kolejne odwolanie do zasobu konczylo sie bledem. Pomiar dawnej 
+    wersji wymaga zamiany kolejnosci wywolan insertResource 
+    i removeResource w tej metodzie
+*/
+
+const size_t  RESOURCES_COUNT       = 10000;
+const size_t  ACCESSES_COUNT        = 500000;
+const size_t  CAPACITY              = 1000;
+const size_t  RESOURCE_SIZE         = 256;
+const char    DATA_DIR[]            = "resource_eviction.data";
+const char    POOL_DIR[]            = "resource_eviction.data/pool";
+
+/**
+  @brief
+    Zegar systemowy w mikrosekundach - odczytywany przez dawny menadzer
+    przy kazdym odwolaniu (TimeInformation::getSystemTime). Dawny 
+    porzadek zasobow nie rozroznial elementow o rownym czasie dostepu 
+    (zasob byl tracony), dlatego zwracany czas jest scisle rosnacy
+*/
+class MonotonicTime : public TimeInformation {
+ public:
+   MonotonicTime()
+     : lastTime_(0)
+   {}
+
+   virtual size_t getSystemTime() const
+   {
+   #ifdef WIN32
+     LARGE_INTEGER counter;
+     QueryPerformanceCounter(&counter);
+     size_t time = static_cast<size_t>(counter.QuadPart);
+   #else
+     timespec now;
+     clock_gettime(CLOCK_MONOTONIC, &now);
+     size_t time = now.tv_sec * 1000000 + now.tv_nsec / 1000;
+   #endif
+     if( time <= lastTime_ )
+       time = lastTime_ + 1;
+     lastTime_ = time;
+     return time;
+   }
+
+   virtual size_t getTicksCountPerSec() const
+   {
+   #ifdef WIN32
+     LARGE_INTEGER frequency;
+     QueryPerformanceFrequency(&frequency);
+     return static_cast<size_t>(frequency.QuadPart);
+   #else
+     return 1000000;
+   #endif
+   }
+
+ private:
+   mutable size_t  lastTime_;
+};
+
+/**
+  @brief
+    Zasob przechowujacy zawartosc pliku. Licznik loads_ okresla liczbe
+    wczytan - odwolanie, ktore nie wczytuje zasobu, jest trafieniem
+*/
+class BlobResource {
+ public:
+   BlobResource(std::istream& input)
+   {
+     char buffer[RESOURCE_SIZE];
+     while( input.read(buffer, sizeof(buffer)) || input.gcount() > 0 )
+       data_.insert(data_.end(), buffer, buffer + input.gcount());
+     ++loads_;
+   }
+
+   size_t getByteSize() const { return data_.size(); }
+
+   static size_t  loads_;
+
+ private:
+   std::vector<char>  data_;
+};
+
+size_t BlobResource::loads_ = 0;
+
+typedef DataFileResourceManager<BlobResource>  BlobManager;
+
+/**
+  @brief
+    Enumerator jednego katalogu o zadanej liscie plikow - menadzer nie
+    odczytuje zawartosci katalogu z systemu plikow
+*/
+class VectorEnumerator : public DriveElementsEnumerator {
+ public:
+   VectorEnumerator(const std::vector<std::string>& names)
+     : names_(names)
+   {}
+
+   virtual DriveElementsEnumerator* clone() const 
+   { 
+     return new VectorEnumerator(*this); 
+   }
+
+   virtual ItorAutoPtr getItor() const 
+   { 
+     return ItorAutoPtr(new VectorItor(directory_ == POOL_DIR ? 
+       names_ : noNames_)); 
+   }
+
+   virtual void setDirectory(const std::string& directory) 
+   { 
+     directory_ = directory; 
+   }
+
+ private:
+   class VectorItor : public Itor {
+    public:
+      VectorItor(const std::vector<std::string>& names)
+        : names_(names)
+        , position_(0)
+      {}
+
+      virtual bool isDirectory() const { return false; }
+      virtual std::string getElementName() const { return names_[position_]; }
+      virtual bool moveToNextElement() { ++position_; return isValid(); }
+      virtual bool isValid() const { return position_ < names_.size(); }
+      virtual void moveToBegin() { position_ = 0; }
+
+    private:
+      const std::vector<std::string>&  names_;
+      size_t                           position_;
+   };
+
+ private:
+   std::vector<std::string>  names_;
+   std::vector<std::string>  noNames_;
+   std::string               directory_;
+};
+
+/**
+  @brief
+    Dopasowanie plikow zasobow (rozszerzenie .res)
+*/
+class ResMatcher : public DataFileResourceManagerBase::ElementMatcher {
+ public:
+   virtual bool match(const std::string& element) const
+   {
+     return element.size() > 4 && 
+            element.compare(element.size() - 4, 4, ".res") == 0;
+   }
+};
+
+void makeDirectory(const std::string& path)
+{
+#ifdef WIN32
+  _mkdir(path.c_str());
+#else
+  mkdir(path.c_str(), 0755);
+#endif
+}
+
+void removeDirectory(const std::string& path)
+{
+#ifdef WIN32
+  _rmdir(path.c_str());
+#else
+  rmdir(path.c_str());
+#endif
+}
+
+unsigned int random_ = 2463534242u;
+
+unsigned int
+nextRandom()
+{
+  random_ ^= random_ << 13;
+  random_ ^= random_ >> 17;
+  random_ ^= random_ << 5;
+  return random_;
+}
+
+/**
+  @brief
+    Utworzenie RESOURCES_COUNT plikow zasobow
+  @return
+    Nazwy plikow (bez katalogu)
+*/
+std::vector<std::string> createResources()
+{
+  std::vector<std::string> names;
+  std::vector<char> data(RESOURCE_SIZE);
+
+  makeDirectory(DATA_DIR);
+  makeDirectory(POOL_DIR);
+  for(size_t i=0; i<RESOURCES_COUNT; ++i) {
+    ostringstream name;
+    name << "resource" << i << ".res";
+
+    for(size_t j=0; j<RESOURCE_SIZE; ++j)
+      data[j] = static_cast<char>(nextRandom());
+
+    const std::string PATH = std::string(POOL_DIR) + "\\" + name.str();
+    FILE* output = fopen(PATH.c_str(), "wb");
+    if( output == 0 ) {
+      cerr << "cannot create " << PATH << endl;
+      exit(EXIT_FAILURE);
+    }
+    fwrite(&data[0], 1, RESOURCE_SIZE, output);
+    fclose(output);
+
+    names.push_back(name.str());
+  }
+  return names;
+}
+
+void removeResources(const std::vector<std::string>& names)
+{
+  for(size_t i=0; i<names.size(); ++i)
+    remove((std::string(POOL_DIR) + "\\" + names[i]).c_str());
+  removeDirectory(POOL_DIR);
+  removeDirectory(DATA_DIR);
+}
+
+/**
+  @brief
+    Sekwencja indeksow zasobow o rozkladzie Zipfa z wykladnikiem 
+    exponent. Kolejnosc popularnosci zasobow jest losowa
+*/
+std::vector<size_t>
+zipfAccesses(double exponent)
+{
+  std::vector<double> cumulative(RESOURCES_COUNT);
+  double sum = 0.0;
+  for(size_t rank=0; rank<RESOURCES_COUNT; ++rank) {
+    sum += 1.0 / pow(double(rank + 1), exponent);
+    cumulative[rank] = sum;
+  }
+
+  std::vector<size_t> resourceOfRank(RESOURCES_COUNT);
+  for(size_t i=0; i<RESOURCES_COUNT; ++i)
+    resourceOfRank[i] = i;
+  for(size_t i=RESOURCES_COUNT; i>1; --i)
+    std::swap(resourceOfRank[i - 1], resourceOfRank[ nextRandom() % i ]);
+
+  std::vector<size_t> accesses(ACCESSES_COUNT);
+  for(size_t i=0; i<ACCESSES_COUNT; ++i) {
+    const double POINT = sum * (nextRandom() / 4294967296.0);
+    const size_t RANK = std::upper_bound(cumulative.begin(), 
+      cumulative.end(), POINT) - cumulative.begin();
+    accesses[i] = resourceOfRank[ std::min(RANK, RESOURCES_COUNT - 1) ];
+  }
+
+  return accesses;
+}
+
+/**
+  @brief
+    Przebieg sekwencji odwolan przez menadzera o limicie pamieci 
+    memoryMaximum. Przed pomiarem wszystkie zasoby sa wczytywane 
+    (z limitem - pozostaje w pamieci jedynie czesc z nich). Uchwyt
+    jest pobierany przy kazdym odwolaniu - zasob, do ktorego klient
+    posiada uchwyt, nie moze zostac zwolniony
+*/
+void
+accessWorkload(const char*                      name,
+               double                           exponent,
+               size_t                           memoryMaximum,
+               const std::vector<std::string>&  names,
+               const std::vector<size_t>&       accesses)
+{
+  BlobManager manager(new VectorEnumerator(names), new MonotonicTime);
+  manager.setElementMatcher(new ResMatcher);
+  manager.setMemoryMaximum(memoryMaximum);
+  manager.loadResourcesFromDir(POOL_DIR);
+
+  for(size_t i=0; i<names.size(); ++i) {
+    BlobManager::Handle handle = manager.getResource(names[i], POOL_DIR);
+    benchKeep(handle->getByteSize());
+  }
+
+  const size_t LOADS = BlobResource::loads_;
+  const size_t ALLOCATIONS = BenchAllocations::count_;
+  BenchStopwatch stopwatch;
+
+  for(size_t i=0; i<accesses.size(); ++i)
+    benchKeep(manager.getResource(names[ accesses[i] ], POOL_DIR)->getByteSize());
+
+  const double NANOSECONDS = stopwatch.seconds() * 1e9 / accesses.size();
+  const size_t MISSES = BlobResource::loads_ - LOADS;
+
+  cout << setw(8) << exponent << setw(8) << name 
+       << setw(12) << NANOSECONDS
+       << setw(14) << double(BenchAllocations::count_ - ALLOCATIONS) / accesses.size()
+       << setw(12) << 100.0 * (accesses.size() - MISSES) / accesses.size() 
+       << "%" << endl;
+}
+
+int main()
+{
+  const double EXPONENTS[] = { 0.8, 1.0, 1.2 };
+
+  const std::vector<std::string> NAMES = createResources();
+
+  cout << RESOURCES_COUNT << " resources of " << RESOURCE_SIZE << " bytes, " 
+       << ACCESSES_COUNT << " accesses (evict: " << CAPACITY << " loaded)\n"
+       << setw(8) << "zipf s" << setw(8) << "load" 
+       << setw(12) << "ns/access" << setw(14) << "allocs/access" 
+       << setw(13) << "hit rate" << endl;
+
+  cout << fixed << setprecision(2);
+
+  for(size_t i=0; i<sizeof(EXPONENTS) / sizeof(EXPONENTS[0]); ++i) {
+    const std::vector<size_t> ACCESSES = zipfAccesses(EXPONENTS[i]);
+
+    accessWorkload("touch", EXPONENTS[i], 
+      2 * RESOURCES_COUNT * RESOURCE_SIZE, NAMES, ACCESSES);
+    accessWorkload("evict", EXPONENTS[i], 
+      CAPACITY * RESOURCE_SIZE, NAMES, ACCESSES);
+  }
+
+  removeResources(NAMES);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,171 @@
+/***************************************************************************
+ *   Copyright (C) 2005 by Eryk Klebanski                                  *
+ *   rixment@gmail.com                                                     *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+
+#include "GcadMemoryAlloc.h"
+#include "GcadSegregatedMemoryAlloc.h"
+#include "../BenchStopwatch.h"
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <vector>
+
+using namespace std;
+using namespace Gcad::Utilities;
+
+/**
+  @brief
+    Koszt operacji puli o przeszukiwaniu liniowym (MemoryAlloc - pierwszy
+    pasujacy obszar listy wolnych obszarow) oraz puli z listami wolnych
+    obszarow podzielonymi na klasy wielkosci (SegregatedMemoryAlloc).
+    Obie pule odtwarzaja ten sam losowy slad przydzialow i zwolnien:
+    kazda operacja wskazuje losowe miejsce tablicy LIVE_SLOTS obiektow -
+    puste miejsce jest wypelniane przydzialem losowej wielkosci, a zajete
+    zwalniane. Liczba miejsc okresla wypelnienie puli, a tym samym
+    dlugosc list wolnych obszarow
+*/
+
+const int     POOL_SEGMENTS         = 1 << 16;
+const int     SEGMENT_SIZE          = 16;
+const size_t  MIN_REQUEST           = 8;
+const size_t  MAX_REQUEST           = 256;
+const int     OPERATIONS_COUNT      = 200000;
+
+typedef MemoryAlloc< POOL_SEGMENTS, SEGMENT_SIZE >            FirstFitPool;
+typedef SegregatedMemoryAlloc< POOL_SEGMENTS, SEGMENT_SIZE >  SegregatedPool;
+
+unsigned int random_ = 2463534242u;
+
+unsigned int
+nextRandom()
+{
+  random_ ^= random_ << 13;
+  random_ ^= random_ >> 17;
+  random_ ^= random_ << 5;
+  return random_;
+}
+
+/**
+  @brief
+    Operacja sladu - miejsce tablicy obiektow, oraz wielkosc przydzialu
+    (wykorzystywana, gdy miejsce jest puste)
+*/
+struct TraceOperation {
+  int     slot_;
+  size_t  bytes_;
+};
+
+typedef std::vector< TraceOperation >  Trace;
+
+Trace
+createTrace(int liveSlots)
+{
+  Trace trace( OPERATIONS_COUNT );
+  for( int i = 0; i < OPERATIONS_COUNT; ++i ) {
+    trace[ i ].slot_  = static_cast< int >( nextRandom() % liveSlots );
+    trace[ i ].bytes_ = MIN_REQUEST + 
+      nextRandom() % ( MAX_REQUEST - MIN_REQUEST + 1 );
+  }
+  return trace;
+}
+
+/**
+  @brief
+    Wynik odtworzenia sladu
+*/
+struct ReplayResult {
+  double  nanosecondsPerOperation_;
+  int     failures_;   /**< Przydzialy zakonczone bad_alloc */
+  size_t  freeRuns_;   /**< Wolne obszary po zakonczeniu sladu */
+};
+
+template< typename POOL >
+ReplayResult
+replay(const Trace& trace, int liveSlots)
+{
+  POOL::purgeMemory();
+
+  std::vector< void* > slots( liveSlots, static_cast< void* >( 0 ) );
+  ReplayResult result;
+  result.failures_ = 0;
+
+  BenchStopwatch stopwatch;
+  for( Trace::const_iterator operation = trace.begin();
+    operation != trace.end(); ++operation )
+  {
+    void*& slot = slots[ operation->slot_ ];
+    if( slot == 0 ) {
+      try {
+        slot = POOL::operator new( operation->bytes_ );
+      }
+      catch( std::bad_alloc& ) {
+        ++result.failures_;
+      }
+    }
+    else {
+      POOL::operator delete( slot );
+      slot = 0;
+    }
+  }
+  result.nanosecondsPerOperation_ = 
+    stopwatch.seconds() * 1e9 / trace.size();
+
+  result.freeRuns_ = POOL::statistics().freeRuns_;
+
+  for( size_t i = 0; i < slots.size(); ++i )
+    POOL::operator delete( slots[ i ] );
+
+  return result;
+}
+
+void
+printRow(int liveSlots, const char* pool, const ReplayResult& result)
+{
+  cout << setw(8) << liveSlots << setw(14) << pool
+       << setw(12) << result.nanosecondsPerOperation_
+       << setw(12) << result.freeRuns_
+       << setw(10) << result.failures_ << endl;
+}
+
+int
+main()
+{
+  const int LIVE_SLOTS[] = { 256, 1024, 4096, 6144 };
+
+  cout << "Pool: " << POOL_SEGMENTS << " segments of " << SEGMENT_SIZE
+       << " bytes, requests " << MIN_REQUEST << "-" << MAX_REQUEST 
+       << " bytes, " << OPERATIONS_COUNT << " operations\n"
+       << setw(8) << "slots" << setw(14) << "pool" << setw(12) << "ns/op"
+       << setw(12) << "free runs" << setw(10) << "failures" << endl;
+
+  cout << fixed << setprecision(1);
+
+  for( size_t i = 0; i < sizeof( LIVE_SLOTS ) / sizeof( LIVE_SLOTS[ 0 ] ); ++i ) {
+    const Trace TRACE = createTrace( LIVE_SLOTS[ i ] );
+
+    printRow( LIVE_SLOTS[ i ], "first-fit", 
+      replay< FirstFitPool >( TRACE, LIVE_SLOTS[ i ] ) );
+    printRow( LIVE_SLOTS[ i ], "segregated", 
+      replay< SegregatedPool >( TRACE, LIVE_SLOTS[ i ] ) );
+  }
+
+  return EXIT_SUCCESS;
+}
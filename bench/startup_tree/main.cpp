@@ -0,0 +1,327 @@
+/***************************************************************************
+ *   Copyright (C) 2005 by Eryk Klebanski                                  *
+ *   rixment@gmail.com                                                     *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+
+#include "GcadBatchFileReader.h"
+#include "GcadDataFileResourceManager.h"
+#include "GcadTimeInformation.h"
+#include "../BenchStopwatch.h"
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef WIN32
+  #include "GcadDriveElementsEnumeratorWin32.h"
+  #include <direct.h>
+  #include <windows.h>
+#else
+  #include "GcadDriveElementsEnumeratorPosix.h"
+  #include <fcntl.h>
+  #include <sys/stat.h>
+  #include <time.h>
+  #include <unistd.h>
+#endif
+
+using namespace std;
+using namespace Gcad::Platform;
+
+/**
+  @brief
+    Czas pozyskania wszystkich zasobow syntetycznego drzewa plikow przez
+    DataFileResourceManager::acquireResourcesFromTree: odczyt kolejnych
+    plikow blokujacymi strumieniami std::ifstream, oraz odczyt jedna
+    partia czytnika BatchFileReader (pula watkow, badz io_uring, gdy
+    biblioteka zostala skompilowana z definicja GCAD_IO_URING).
+    Przebiegi "cold" usuwaja przed pomiarem pliki drzewa z pamieci
+    podrecznej systemu (posix_fadvise) - odpowiada to rozruchowi
+    serwera, przebiegi "warm" mierza koszt samego przetwarzania
+
+  @remark
+    Program przyjmuje opcjonalnie katalog, w ktorym tworzone jest drzewo
+    (domyslnie katalog biezacy). Drzewo jest usuwane po pomiarach
+*/
+
+const int     DIRS_COUNT            = 100;
+const int     FILES_PER_DIR         = 100;
+const size_t  MIN_FILE_SIZE         = 512;
+const size_t  MAX_FILE_SIZE         = 16 * 1024;
+const int     REPEATS_COUNT         = 3;
+
+unsigned int random_ = 2463534242u;
+
+unsigned int nextRandom()
+{
+  random_ ^= random_ << 13;
+  random_ ^= random_ >> 17;
+  random_ ^= random_ << 5;
+  return random_;
+}
+
+/**
+  @brief
+    Zegar wymagany przez menadzera (czas dostepu do zasobow)
+*/
+class BenchTime : public TimeInformation {
+ public:
+   virtual size_t getSystemTime() const 
+   { 
+     return static_cast<size_t>(stopwatch_.seconds() * 1000000.0); 
+   }
+
+   virtual size_t getTicksCountPerSec() const { return 1000000; }
+
+ private:
+   BenchStopwatch  stopwatch_;
+};
+
+/**
+  @brief
+    Zasob przechowujacy zawartosc pliku - koszt przetwarzania jest
+    pomijalny wobec kosztu odczytu
+*/
+class BlobResource {
+ public:
+   BlobResource(std::istream& input)
+   {
+     char buffer[4096];
+     while( input.read(buffer, sizeof(buffer)) || input.gcount() > 0 )
+       data_.insert(data_.end(), buffer, buffer + input.gcount());
+   }
+
+   size_t getByteSize() const { return data_.size(); }
+
+ private:
+   std::vector<char>  data_;
+};
+
+typedef DataFileResourceManager<BlobResource>  BlobManager;
+
+/**
+  @brief
+    Dopasowanie plikow zasobow drzewa (rozszerzenie .md2)
+*/
+class MD2Matcher : public DataFileResourceManagerBase::ElementMatcher {
+ public:
+   virtual bool match(const std::string& element) const
+   {
+     return element.size() > 4 && 
+            element.compare(element.size() - 4, 4, ".md2") == 0;
+   }
+};
+
+void makeDirectory(const std::string& path)
+{
+#ifdef WIN32
+  _mkdir(path.c_str());
+#else
+  mkdir(path.c_str(), 0755);
+#endif
+}
+
+void removeDirectory(const std::string& path)
+{
+#ifdef WIN32
+  _rmdir(path.c_str());
+#else
+  rmdir(path.c_str());
+#endif
+}
+
+/**
+  @brief
+    Utworzenie drzewa DIRS_COUNT katalogow po FILES_PER_DIR plikow
+    o losowej wielkosci
+  @return
+    Sciezki utworzonych plikow
+*/
+std::vector<std::string> createTree(const std::string& root, size_t* bytes)
+{
+  std::vector<std::string> files;
+  std::vector<char> data(MAX_FILE_SIZE);
+  *bytes = 0;
+
+  makeDirectory(root);
+  for(int dir=0; dir<DIRS_COUNT; ++dir) {
+    ostringstream dirPath;
+    dirPath << root << "/models" << dir;
+    makeDirectory(dirPath.str());
+
+    for(int file=0; file<FILES_PER_DIR; ++file) {
+      ostringstream path;
+      path << dirPath.str() << "/model" << file << ".md2";
+
+      const size_t SIZE = MIN_FILE_SIZE + 
+        nextRandom() % (MAX_FILE_SIZE - MIN_FILE_SIZE + 1);
+      for(size_t i=0; i<SIZE; ++i)
+        data[i] = static_cast<char>(nextRandom());
+
+      FILE* output = fopen(path.str().c_str(), "wb");
+      if( output == 0 ) {
+        cerr << "cannot create " << path.str() << endl;
+        exit(EXIT_FAILURE);
+      }
+      fwrite(&data[0], 1, SIZE, output);
+      fclose(output);
+
+      files.push_back(path.str());
+      *bytes += SIZE;
+    }
+  }
+  return files;
+}
+
+void removeTree(const std::string& root, const std::vector<std::string>& files)
+{
+  for(size_t i=0; i<files.size(); ++i)
+    remove(files[i].c_str());
+  for(int dir=0; dir<DIRS_COUNT; ++dir) {
+    ostringstream dirPath;
+    dirPath << root << "/models" << dir;
+    removeDirectory(dirPath.str());
+  }
+  removeDirectory(root);
+}
+
+/**
+  @brief
+    Usuniecie plikow z pamieci podrecznej systemu
+  @return
+    Wartosc false, gdy platforma nie udostepnia takiej mozliwosci
+*/
+bool dropCache(const std::vector<std::string>& files)
+{
+#if defined( WIN32 ) || !defined( POSIX_FADV_DONTNEED )
+  (void)files;
+  return false;
+#else
+  for(size_t i=0; i<files.size(); ++i) {
+    const int DESCRIPTOR = open(files[i].c_str(), O_RDONLY);
+    if( DESCRIPTOR < 0 )
+      return false;
+    fdatasync(DESCRIPTOR);
+    const int RESULT = posix_fadvise(DESCRIPTOR, 0, 0, POSIX_FADV_DONTNEED);
+    close(DESCRIPTOR);
+    if( RESULT != 0 )
+      return false;
+  }
+  return true;
+#endif
+}
+
+BlobManager* createManager()
+{
+#ifdef WIN32
+  BlobManager* manager = 
+    new BlobManager(new DriveElementsEnumeratorWin32, new BenchTime);
+#else
+  BlobManager* manager = 
+    new BlobManager(new DriveElementsEnumeratorPosix, new BenchTime);
+#endif
+  manager->setElementMatcher(new MD2Matcher);
+  manager->setMemoryMaximum(static_cast<size_t>(-1));
+  return manager;
+}
+
+/**
+  @brief
+    Pomiar jednego przebiegu: skanowanie drzewa i pozyskanie wszystkich
+    zasobow (reader rowny zero - odczyt strumieniami std::ifstream)
+  @return
+    Czas w milisekundach
+*/
+double acquireTree(const std::string& root, BatchFileReader* reader,
+                   size_t* loadedBytes)
+{
+  std::auto_ptr<BlobManager> manager( createManager() );
+
+  BenchStopwatch stopwatch;
+  if( reader != 0 )
+    manager->acquireResourcesFromTree(root, *reader);
+  else
+    manager->acquireResourcesFromTree(root);
+  const double MILLISECONDS = stopwatch.milliseconds();
+
+  *loadedBytes = manager->getUsedMemory();
+  return MILLISECONDS;
+}
+
+void measure(const char*                      name,
+             const std::string&               root,
+             const std::vector<std::string>&  files,
+             BatchFileReader*                 reader,
+             bool                             cold)
+{
+  double best = 0.0;
+  size_t loadedBytes = 0;
+
+  for(int repeat=0; repeat<REPEATS_COUNT; ++repeat) {
+    if( cold )
+      dropCache(files);
+    const double MILLISECONDS = acquireTree(root, reader, &loadedBytes);
+    if( repeat == 0 || MILLISECONDS < best )
+      best = MILLISECONDS;
+  }
+
+  cout << setw(24) << name << setw(7) << (cold ? "cold" : "warm")
+       << setw(12) << best 
+       << setw(14) << best * 1000.0 / files.size()
+       << setw(12) << loadedBytes / (1024.0 * 1024.0) << endl;
+}
+
+int main(int argc, char* argv[])
+{
+  const std::string ROOT = std::string(argc > 1 ? argv[1] : ".") + 
+    "/startup_tree";
+
+  size_t treeBytes = 0;
+  const std::vector<std::string> FILES = createTree(ROOT, &treeBytes);
+  const bool COLD = dropCache(FILES);
+
+  std::auto_ptr<BatchFileReader> threaded( createThreadedBatchFileReader() );
+  std::auto_ptr<BatchFileReader> platform( createBatchFileReader() );
+  const std::string PLATFORM_NAME = 
+    std::string("batch (") + platform->backendName() + ")";
+
+  cout << FILES.size() << " files in " << DIRS_COUNT << " directories, "
+       << fixed << setprecision(2) << treeBytes / (1024.0 * 1024.0) 
+       << " MB (best of " << REPEATS_COUNT << ")\n"
+       << setw(24) << "reader" << setw(7) << "cache" << setw(12) << "ms"
+       << setw(14) << "us/file" << setw(12) << "MB loaded" << endl;
+
+  for(int pass=0; pass<2; ++pass) {
+    const bool COLD_PASS = (pass == 0);
+    if( COLD_PASS && !COLD ) {
+      cout << "(page cache cannot be dropped - cold rows skipped)" << endl;
+      continue;
+    }
+    measure("ifstream (per file)", ROOT, FILES, 0, COLD_PASS);
+    measure("batch (threads)", ROOT, FILES, threaded.get(), COLD_PASS);
+    if( PLATFORM_NAME != "batch (threads)" )
+      measure(PLATFORM_NAME.c_str(), ROOT, FILES, platform.get(), COLD_PASS);
+  }
+
+  removeTree(ROOT, FILES);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,333 @@
+/***************************************************************************
+ *   Copyright (C) 2005 by Eryk Klebanski                                  *
+ *   rixment@gmail.com                                                     *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+
+#include "GcadSymbolTST.h"
+#include "../BenchStopwatch.h"
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace Gcad::Utilities;
+
+/**
+  @brief
+    Czas wyszukiwania sciezek zasobow: dawne drzewo trynarne (kazdy wezel
+    przydzielany osobno, odtworzone ponizej jako PointerTST), std::map,
+    SymbolTST, oraz SymbolTST po wywolaniu freeze(). Sciezki przypominaja
+    drzewo zasobow gry - wspolne przedrostki katalogow, numerowane nazwy
+    i kilka rozszerzen. Tablice sa budowane w kolejnosci przegladania
+    katalogow, a wyszukiwania odbywaja sie w losowej kolejnosci, osobno
+    dla sciezek odwzorowanych (hit) i nieodwzorowanych (miss)
+*/
+
+/**
+  @brief
+    Uklad wezlow dawnej realizacji SymbolTST (trzy wskazniki, uchwyt
+    i znak w kazdym osobno przydzielonym wezle), oraz jej rekurencyjne
+    wyszukiwanie (checkId). Dawne wstawianie kopiowalo poddrzewa przy
+    kazdym przypisaniu ValuePtr - tutaj zostalo zastapione iteracyjnym,
+    budujacym drzewo o identycznym ksztalcie
+*/
+class PointerTST {
+ public:
+   PointerTST()
+     : head_(0)
+     , handlePool_(0)
+     , nodesCount_(0)
+   {}
+
+   ~PointerTST() { destroy(head_); }
+
+   size_t getHandle(const std::string& identifier)
+   {
+     Node** node = &head_;
+     size_t charIndex = 0;
+
+     for(;;) {
+       const char SYMBOL = charIndex < identifier.size() ?
+         identifier[charIndex] : '\0';
+
+       if( *node == 0 ) {
+         *node = new Node(SYMBOL);
+         ++nodesCount_;
+       }
+
+       if( charIndex == identifier.size() ) {
+         if( (*node)->handle_ == NO_HANDLE )
+           (*node)->handle_ = handlePool_++;
+         return (*node)->handle_;
+       }
+
+       if( SYMBOL < (*node)->symbol_ )
+         node = &(*node)->left_;
+       else if( SYMBOL == (*node)->symbol_ ) {
+         node = &(*node)->middle_;
+         ++charIndex;
+       }
+       else
+         node = &(*node)->right_;
+     }
+   }
+
+   bool isIdMapped(const std::string& identifier) const
+   {
+     return checkId(identifier, 0, head_);
+   }
+
+   size_t nodesCount() const { return nodesCount_; }
+
+ private:
+   static const size_t NO_HANDLE = static_cast<size_t>(-1);
+
+   struct Node {
+     Node(char symbol)
+       : left_(0)
+       , middle_(0)
+       , right_(0)
+       , handle_(NO_HANDLE)
+       , symbol_(symbol)
+     {}
+
+     Node*   left_;
+     Node*   middle_;
+     Node*   right_;
+     size_t  handle_;
+     char    symbol_;
+   };
+
+   static bool checkId(const std::string& identifier, size_t charIndex,
+                       const Node* node)
+   {
+     if( node == 0 )
+       return false;
+
+     if( charIndex == identifier.size() && node->handle_ != NO_HANDLE )
+       return true;
+
+     const char SYMBOL = charIndex < identifier.size() ?
+       identifier[charIndex] : '\0';
+
+     if( SYMBOL < node->symbol_ )
+       return checkId(identifier, charIndex, node->left_);
+     else if( SYMBOL == node->symbol_ )
+       return checkId(identifier, charIndex + 1, node->middle_);
+     else
+       return checkId(identifier, charIndex, node->right_);
+   }
+
+   static void destroy(Node* node)
+   {
+     if( node != 0 ) {
+       destroy(node->left_);
+       destroy(node->middle_);
+       destroy(node->right_);
+       delete node;
+     }
+   }
+
+ private:
+   PointerTST(const PointerTST&);
+   PointerTST& operator =(const PointerTST&);
+
+ private:
+   Node*   head_;
+   size_t  handlePool_;
+   size_t  nodesCount_;
+};
+
+const int  DIRECTORIES_COUNT  = 400;
+const int  FILES_PER_DIR      = 100;
+const int  LOOKUP_ROUNDS      = 10;
+
+unsigned int random_ = 2463534242u;
+
+unsigned int
+nextRandom()
+{
+  random_ ^= random_ << 13;
+  random_ ^= random_ >> 17;
+  random_ ^= random_ << 5;
+  return random_;
+}
+
+/**
+  @brief
+    Sciezki w postaci "data\\models\\monsters\\ogre017\\ogre017_skin03.pcx"
+*/
+std::vector<std::string>
+assetPaths()
+{
+  const char* ROOTS[] = { "data\\models\\", "data\\textures\\", 
+    "data\\sounds\\", "mods\\ctf\\models\\" };
+  const char* CATEGORIES[] = { "monsters\\", "weapons\\", "players\\", 
+    "items\\", "world\\" };
+  const char* NAMES[] = { "ogre", "soldier", "tank", "rocket", "crate", 
+    "medkit", "berserk", "gladiator" };
+  const char* PARTS[] = { "_frame", "_skin", "_lod", "_anim" };
+  const char* EXTENSIONS[] = { ".md2", ".md3", ".pcx", ".wav", ".ms3d" };
+
+  std::vector<std::string> paths;
+
+  for(int dir=0; dir<DIRECTORIES_COUNT; ++dir) {
+    std::ostringstream directory;
+    directory << ROOTS[dir % 4] << CATEGORIES[dir / 4 % 5] 
+              << NAMES[dir / 20 % 8] << setw(3) << setfill('0') << dir 
+              << "\\";
+
+    for(int file=0; file<FILES_PER_DIR; ++file) {
+      std::ostringstream path;
+      path << directory.str() << NAMES[dir / 20 % 8] << PARTS[file % 4] 
+           << setw(2) << setfill('0') << file / 4 
+           << EXTENSIONS[(dir + file) % 5];
+      paths.push_back(path.str());
+    }
+  }
+
+  return paths;
+}
+
+/**
+  @brief
+    Sciezki nieodwzorowane - zmieniony ostatni znak nazwy pliku
+*/
+std::vector<std::string>
+missingPaths(const std::vector<std::string>& paths)
+{
+  std::vector<std::string> missing(paths);
+  for(size_t i=0; i<missing.size(); ++i)
+    missing[i][ missing[i].size() - 1 ] = '~';
+  return missing;
+}
+
+std::vector<std::string>
+shuffled(const std::vector<std::string>& paths)
+{
+  std::vector<std::string> result(paths);
+  for(size_t i=result.size(); i>1; --i)
+    std::swap(result[i - 1], result[ nextRandom() % i ]);
+  return result;
+}
+
+template<typename TABLE>
+double
+lookupTime(const TABLE& table, const std::vector<std::string>& paths)
+{
+  BenchStopwatch stopwatch;
+  size_t found = 0;
+
+  for(int round=0; round<LOOKUP_ROUNDS; ++round) {
+    for(size_t i=0; i<paths.size(); ++i)
+      found += table.isIdMapped(paths[i]);
+  }
+
+  benchKeep(found);
+  return stopwatch.milliseconds() * 1e6 / 
+    (double(LOOKUP_ROUNDS) * paths.size());
+}
+
+/**
+  @brief
+    Interfejs isIdMapped() dla std::map
+*/
+struct PathMap : public std::map<std::string, size_t> {
+  bool isIdMapped(const std::string& path) const 
+  { 
+    return find(path) != end(); 
+  }
+};
+
+void
+printRow(const char* table, double buildTime, size_t nodesCount, 
+         double hitTime, double missTime)
+{
+  cout << setw(16) << table << setw(12) << buildTime;
+
+  if( nodesCount == 0 )
+    cout << setw(12) << "-";
+  else
+    cout << setw(12) << nodesCount;
+
+  cout << setw(12) << hitTime << setw(12) << missTime << endl;
+}
+
+int main()
+{
+  const std::vector<std::string> PATHS   = assetPaths();
+  const std::vector<std::string> HITS    = shuffled(PATHS);
+  const std::vector<std::string> MISSES  = shuffled(missingPaths(PATHS));
+
+  cout << PATHS.size() << " paths, lookup time in ns, build time in ms\n"
+       << setw(16) << "table" << setw(12) << "build" 
+       << setw(12) << "nodes" << setw(12) << "hit" 
+       << setw(12) << "miss" << endl;
+
+  cout << fixed << setprecision(2);
+
+  {
+    BenchStopwatch stopwatch;
+    PointerTST table;
+    for(size_t i=0; i<PATHS.size(); ++i)
+      table.getHandle(PATHS[i]);
+    const double BUILD_TIME = stopwatch.milliseconds();
+
+    printRow("pointer TST", BUILD_TIME, table.nodesCount(),
+      lookupTime(table, HITS), lookupTime(table, MISSES));
+  }
+
+  {
+    BenchStopwatch stopwatch;
+    PathMap table;
+    for(size_t i=0; i<PATHS.size(); ++i)
+      table.insert(std::make_pair(PATHS[i], i));
+    const double BUILD_TIME = stopwatch.milliseconds();
+
+    printRow("std::map", BUILD_TIME, 0,
+      lookupTime(table, HITS), lookupTime(table, MISSES));
+  }
+
+  {
+    BenchStopwatch stopwatch;
+    SymbolTST<char> table;
+    for(size_t i=0; i<PATHS.size(); ++i)
+      table.getHandle(PATHS[i]);
+    const double BUILD_TIME = stopwatch.milliseconds();
+
+    printRow("SymbolTST", BUILD_TIME, table.nodesCount(),
+      lookupTime(table, HITS), lookupTime(table, MISSES));
+
+    stopwatch.restart();
+    table.freeze();
+    const double FREEZE_TIME = stopwatch.milliseconds();
+
+    printRow("SymbolTST frozen", BUILD_TIME + FREEZE_TIME, 
+      table.nodesCount(), lookupTime(table, HITS), 
+      lookupTime(table, MISSES));
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,114 @@
+/***************************************************************************
+ *   Copyright (C) 2005 by Eryk Klebanski                                  *
+ *   rixment@gmail.com                                                     *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+
+#ifndef _GCAD_ARCHIVEELEMENTSENUMERATOR_H_
+#define _GCAD_ARCHIVEELEMENTSENUMERATOR_H_
+
+#include "GcadResourceArchive.h"
+#include "GcadDriveElementsEnumerator.h"
+#include <string>
+
+namespace Gcad {
+namespace Platform {
+
+/**
+  @brief
+    Realizacja interfejsu wyliczajaca zawartosc katalogow zapisanych
+    w archiwum (AssetPack, QuakePak) - bez wywolan systemowych. Katalogi
+    wynikaja z nazw wpisow archiwum (czesci sciezek oddzielone znakiem
+    '\\'), pusta nazwa katalogu oznacza korzen archiwum
+
+  @remark
+    Archiwum musi istniec (i pozostac otwarte) przez caly czas zycia
+    enumeratora oraz jego iteratorow. Elementy "." i ".." nie sa zwracane
+
+  @code
+    AssetPack pack;
+    pack.open( "models.gpak" );
+    Manager manager( new ArchiveElementsEnumerator( pack ), time );
+    manager.setResourceArchive( &pack );
+    manager.loadResourcesFromTree( "models" );
+  @endcode
+*/
+class GCAD_EXPORT ArchiveElementsEnumerator 
+  : public DriveElementsEnumerator 
+{
+ public:
+   /**
+     @brief
+       Realizacja klasy interfejsu iteratora elementow 
+       struktury hierarchicznej plik/katalog
+   */
+   class GCAD_EXPORT Itor 
+     : public DriveElementsEnumerator::Itor
+   {
+    private:
+      friend class ArchiveElementsEnumerator;
+      
+      Itor(const ArchiveElementsEnumerator& owner);
+    
+    public:      
+      virtual bool isDirectory() const;
+
+      virtual std::string getElementName() const;
+
+      virtual bool moveToNextElement();
+
+      virtual bool isValid() const;
+
+      virtual void moveToBegin();
+
+    private:
+      /**
+        @brief
+          Ustalenie elementu na podstawie wpisu o indeksie entry_
+      */
+      void readElement();
+    
+    private:
+      const ArchiveElementsEnumerator&  owner_;
+      std::string                       prefix_;
+      size_t                            entry_;
+      std::string                       element_;
+      bool                              directory_;
+      bool                              valid_;
+   };
+   
+   friend class Itor;
+
+   ArchiveElementsEnumerator(const ResourceArchive&  archive,
+                             const std::string&      directory = "");
+   
+   virtual ArchiveElementsEnumerator* clone() const;
+
+   virtual ItorAutoPtr getItor() const;
+
+   virtual void setDirectory(const std::string& newDirectory);
+   
+ private:
+   const ResourceArchive*  archive_;
+   std::string             baseDir_;
+};
+
+} // namespace Platform
+} // namespace Gcad
+
+#endif
@@ -0,0 +1,125 @@
+/***************************************************************************
+ *   Copyright (C) 2005 by Eryk Klebanski                                  *
+ *   rixment@gmail.com                                                     *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef _GCAD_ARENAALLOCATOR_H_
+#define _GCAD_ARENAALLOCATOR_H_
+
+#include "GcadFrameArena.h"
+#include <cstddef>
+#include <new>
+
+namespace Gcad {
+namespace Utilities {
+
+/**
+  @brief
+    Alokator zgodny z wymaganiami biblioteki standardowej, umieszczajacy
+    elementy kontenerow w obszarze FrameArena
+
+    Zwolnienie pamieci przez kontener nie odzyskuje jej - nastapi to
+    dopiero podczas resetu areny. Kontener musi zostac zniszczony (badz
+    przestac byc uzywany) przed wywolaniem FrameArena::reset()
+
+  @code
+    typedef ArenaAllocator< Vector3 >                 Vector3Allocator;
+    typedef std::vector< Vector3, Vector3Allocator >  TransientVertices;
+
+    TransientVertices vertices( Vector3Allocator( sceneGraph.getFrameArena() ) );
+  @endcode
+*/
+template< typename T >
+class ArenaAllocator {
+ public:
+   typedef T                 value_type;
+   typedef T*                pointer;
+   typedef const T*          const_pointer;
+   typedef T&                reference;
+   typedef const T&          const_reference;
+   typedef std::size_t       size_type;
+   typedef std::ptrdiff_t    difference_type;
+
+   template< typename U >
+   struct rebind {
+     typedef ArenaAllocator< U >  other;
+   };
+
+   explicit ArenaAllocator( FrameArena& arena ) throw()
+     : arena_( &arena )
+   {}
+
+   template< typename U >
+   ArenaAllocator( const ArenaAllocator< U >& other ) throw()
+     : arena_( &other.arena() )
+   {}
+
+   pointer address( reference value ) const { return &value; }
+   const_pointer address( const_reference value ) const { return &value; }
+
+   pointer allocate( size_type count, const void* = 0 )
+   {
+     return static_cast< pointer >( arena_->allocate( count * sizeof( T ) ) );
+   }
+
+   void deallocate( pointer, size_type ) {}
+
+   size_type max_size() const throw()
+   {
+     return static_cast< size_type >( -1 ) / sizeof( T );
+   }
+
+   void construct( pointer place, const T& value )
+   {
+     new( static_cast< void* >( place ) ) T( value );
+   }
+
+   void destroy( pointer place ) { place->~T(); }
+
+   /**
+     @brief
+       Arena, z ktorej pochodzi pamiec elementow
+   */
+   FrameArena& arena() const { return *arena_; }
+
+ private:
+   FrameArena*  arena_;
+};
+
+//
+template< typename T, typename U > inline
+bool
+operator ==( const ArenaAllocator< T >& lhs,
+             const ArenaAllocator< U >& rhs )
+{
+  return &lhs.arena() == &rhs.arena();
+}
+
+//
+template< typename T, typename U > inline
+bool
+operator !=( const ArenaAllocator< T >& lhs,
+             const ArenaAllocator< U >& rhs )
+{
+  return !( lhs == rhs );
+}
+
+} // namespace Utilities
+} // namespace Gcad
+
+#endif
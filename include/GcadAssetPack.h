@@ -0,0 +1,152 @@
+/***************************************************************************
+ *   Copyright (C) 2005 by Eryk Klebanski                                  *
+ *   rixment@gmail.com                                                     *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+
+#ifndef _GCAD_ASSETPACK_H_
+#define _GCAD_ASSETPACK_H_
+
+#include "GcadBase.h"
+#include "GcadByteSpan.h"
+#include "GcadMappedFile.h"
+#include "GcadResourceArchive.h"
+#include <cstddef>
+#include <string>
+
+namespace Gcad {
+namespace Platform {
+
+/**
+  @brief
+    Paczka zasobow - pojedynczy plik zawierajacy wiele plikow danych
+    (tworzony narzedziem asset_pack). Paczka jest odwzorowywana w pamieci
+    w calosci, wiec pobranie zawartosci wpisu nie wymaga wywolan systemowych
+
+    Uklad pliku (wartosci 32-bitowe, kolejnosc bajtow platformy):
+      - naglowek (Header)
+      - spis wpisow (Entry) posortowany wedlug nazw - umozliwia wyliczanie
+        zawartosci katalogow (ArchiveElementsEnumerator)
+      - tablica mieszajaca (adresowanie otwarte, sondowanie liniowe)
+        zawierajaca indeksy wpisow powiekszone o jeden (zero - wolne pole).
+        Liczba pol jest potega dwojki, co najmniej dwukrotnie wieksza
+        od liczby wpisow
+      - nazwy wpisow (bez znakow zerowych)
+      - dane wpisow, kazdy wyrownany do ALIGNMENT bajtow
+
+    Nazwy wpisow sa sciezkami oddzielanymi znakiem '\\' (ResourceArchive)
+
+  @remark
+    Obiekt nie jest kopiowalny. Widoki zwrocone przez find() oraz
+    entryBytes() sa wazne do czasu zamkniecia paczki
+*/
+class GCAD_EXPORT AssetPack : public ResourceArchive {
+ public:
+   typedef unsigned int  UInt32;
+
+   enum {
+     VERSION   = 1,
+     ALIGNMENT = 64
+   };
+
+   struct Header {
+     char    magic_[4];       /**< "GPAK" */
+     UInt32  version_;
+     UInt32  entriesCount_;
+     UInt32  slotsCount_;
+     UInt32  entriesOffset_;
+     UInt32  slotsOffset_;
+     UInt32  namesOffset_;
+     UInt32  namesSize_;
+   };
+
+   struct Entry {
+     UInt32  nameHash_;
+     UInt32  nameOffset_;     /**< Wzgledem poczatku obszaru nazw */
+     UInt32  nameLength_;
+     UInt32  dataOffset_;     /**< Wzgledem poczatku pliku */
+     UInt32  dataSize_;
+     UInt32  reserved_;
+   };
+
+   /**
+     @brief
+       Wartosc mieszajaca nazwy wpisu (FNV-1a)
+   */
+   static UInt32 hashName(const char* name, size_t length);
+
+   AssetPack();
+
+   /**
+     @brief
+       Odwzorowanie paczki path, poprzednia paczka zostaje zamknieta.
+       Sprawdzana jest poprawnosc naglowka, oraz zawieranie sie wszystkich
+       sekcji i wpisow w pliku
+
+     @return
+       Wartosc false, gdy pliku nie udalo sie odwzorowac, badz nie jest
+       on poprawna paczka
+   */
+   bool open(const std::string& path);
+
+   void close();
+
+   bool isOpen() const { return header_ != 0; }
+
+   virtual size_t entriesCount() const;
+
+   /**
+     @brief
+       Odnalezienie wpisu o nazwie name - jedno sondowanie tablicy
+       mieszajacej w typowym przypadku
+   */
+   virtual bool find(const std::string&    name, 
+                     Utilities::ByteSpan*  bytes) const;
+
+   virtual std::string entryName(size_t index) const;
+
+   virtual Utilities::ByteSpan entryBytes(size_t index) const;
+
+   /**
+     @brief
+       Wyszukiwanie binarne w posortowanym spisie wpisow
+   */
+   virtual size_t lowerBound(const std::string& name) const;
+
+ private:
+   bool validate();
+
+   int compareName(size_t index, const std::string& name) const;
+
+ private:
+   MappedFile     file_;
+   const Header*  header_;
+   const Entry*   entries_;
+   const UInt32*  slots_;
+   const char*    names_;
+
+ private:
+   // nie zaimplementowane
+   AssetPack(const AssetPack&);
+   AssetPack& operator =(const AssetPack&);
+};
+
+} // namespace Platform
+} // namespace Gcad
+
+#endif
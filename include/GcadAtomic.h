@@ -0,0 +1,186 @@
+/***************************************************************************
+ *   Copyright (C) 2005 by Eryk Klebanski                                  *
+ *   rixment@gmail.com                                                     *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef _GCAD_ATOMIC_H_
+#define _GCAD_ATOMIC_H_
+
+#ifdef _MSC_VER
+  #include <intrin.h>
+  #pragma intrinsic (_InterlockedIncrement)
+  #pragma intrinsic (_InterlockedDecrement)
+  #pragma intrinsic (_InterlockedExchangeAdd)
+  #pragma intrinsic (_InterlockedCompareExchange)
+  #pragma intrinsic (_InterlockedCompareExchange64)
+  #pragma intrinsic (_ReadWriteBarrier)
+#endif
+
+namespace Gcad {
+namespace Utilities {
+
+/**
+  @brief
+    Liczba calkowita 64 bitowa, wykorzystywana przez operacje atomowe
+    na wskaznikach ze znacznikiem (ang. tagged pointers)
+*/
+#ifdef _MSC_VER
+  typedef __int64  AtomicInt64;
+#else
+  __extension__ typedef long long  AtomicInt64;
+#endif
+
+/**
+  @brief
+    Atomowa inkrementacja. Zwracana jest wartosc po zmianie
+*/
+inline
+long
+atomicIncrement( volatile long* target )
+{
+#ifdef _MSC_VER
+  return _InterlockedIncrement( target );
+#else
+  return __sync_add_and_fetch( target, 1L );
+#endif
+}
+
+/**
+  @brief
+    Atomowa dekrementacja. Zwracana jest wartosc po zmianie
+*/
+inline
+long
+atomicDecrement( volatile long* target )
+{
+#ifdef _MSC_VER
+  return _InterlockedDecrement( target );
+#else
+  return __sync_sub_and_fetch( target, 1L );
+#endif
+}
+
+/**
+  @brief
+    Atomowe dodanie wartosci. Zwracana jest wartosc sprzed zmiany
+*/
+inline
+long
+atomicExchangeAdd( volatile long*  target,
+                   long            value )
+{
+#ifdef _MSC_VER
+  return _InterlockedExchangeAdd( target, value );
+#else
+  return __sync_fetch_and_add( target, value );
+#endif
+}
+
+/**
+  @brief
+    Atomowe porownanie i zamiana. Wartosc exchange zostaje zapisana,
+    jesli biezaca wartosc jest rowna comparand
+
+  @return
+    Wartosc sprzed operacji - rownosc z comparand oznacza powodzenie
+*/
+inline
+long
+atomicCompareExchange( volatile long*  target,
+                       long            exchange,
+                       long            comparand )
+{
+#ifdef _MSC_VER
+  return _InterlockedCompareExchange( target, exchange, comparand );
+#else
+  return __sync_val_compare_and_swap( target, comparand, exchange );
+#endif
+}
+
+/**
+  @brief
+    Atomowy odczyt wartosci (z pelna bariera pamieci)
+*/
+inline
+long
+atomicLoad( volatile long* target )
+{
+  return atomicCompareExchange( target, 0, 0 );
+}
+
+/**
+  @brief
+    Odczyt wartosci z semantyka nabycia (ang. acquire) - zapisy watku,
+    ktory opublikowal wartosc operacja atomowa, sa widoczne po jej
+    odczytaniu. W odroznieniu od atomicLoad odczyt nie zapisuje linii
+    pamieci podrecznej, wiec nie powoduje rywalizacji watkow czytajacych
+*/
+inline
+long
+atomicLoadAcquire( volatile long* target )
+{
+#ifdef _MSC_VER
+  // Odczyt zmiennej volatile posiada semantyke nabycia (/volatile:ms)
+  const long VALUE = *target;
+  _ReadWriteBarrier();
+  return VALUE;
+#elif defined(__ATOMIC_ACQUIRE)
+  return __atomic_load_n( target, __ATOMIC_ACQUIRE );
+#else
+  const long VALUE = *target;
+  __sync_synchronize();
+  return VALUE;
+#endif
+}
+
+/**
+  @brief
+    Atomowe porownanie i zamiana wartosci 64 bitowej
+
+  @see
+    atomicCompareExchange( volatile long*, long, long )
+*/
+inline
+AtomicInt64
+atomicCompareExchange64( volatile AtomicInt64*  target,
+                         AtomicInt64            exchange,
+                         AtomicInt64            comparand )
+{
+#ifdef _MSC_VER
+  return _InterlockedCompareExchange64( target, exchange, comparand );
+#else
+  return __sync_val_compare_and_swap( target, comparand, exchange );
+#endif
+}
+
+/**
+  @brief
+    Atomowy odczyt wartosci 64 bitowej (rowniez na architekturach
+    32 bitowych, na ktorych zwykly odczyt moze zostac rozdzielony)
+*/
+inline
+AtomicInt64
+atomicLoad64( volatile AtomicInt64* target )
+{
+  return atomicCompareExchange64( target, 0, 0 );
+}
+
+} // namespace Utilities
+} // namespace Gcad
+
+#endif
@@ -0,0 +1,52 @@
+/***************************************************************************
+ *   Copyright (C) 2005 by Eryk Klebanski                                  *
+ *   rixment@gmail.com                                                     *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef _GCAD_ATOMICREFARRAYCNTPTR_H_
+#define _GCAD_ATOMICREFARRAYCNTPTR_H_
+
+#include "GcadAtomicRefCountPtr.h"
+
+namespace Gcad {
+namespace Utilities {
+
+/**
+  @brief
+    Odmiana RefArrayCntPtr z licznikiem modyfikowanym operacjami atomowymi
+*/
+template<typename T>
+class AtomicRefArrayCntPtr : public AtomicRefCountPtr< T, DeleteArray<T> > {
+ public:
+   AtomicRefArrayCntPtr( T* pointer = 0 )
+     : AtomicRefCountPtr< T, DeleteArray<T> >(pointer)
+   {}
+   
+   AtomicRefArrayCntPtr( const AtomicRefArrayCntPtr& that )
+     : AtomicRefCountPtr< T, DeleteArray<T> >(that)
+   {}
+
+   T& operator [](size_t index) const {
+     return *( this->get() + index );
+   }
+};
+
+} // namespace Utilities
+} // namespace Gcad
+
+#endif
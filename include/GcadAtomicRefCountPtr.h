@@ -0,0 +1,324 @@
+/***************************************************************************
+ *   Copyright (C) 2005 by Eryk Klebanski                                  *
+ *   rixment@gmail.com                                                     *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef _GCAD_ATOMICREFCOUNTPTR_H_
+#define _GCAD_ATOMICREFCOUNTPTR_H_
+
+#include "GcadBase.h"
+#include "GcadAssertion.h"
+#include "GcadAtomic.h"
+#include "GcadDeletePolicy.h"
+#include <algorithm>
+
+namespace Gcad {
+namespace Utilities {
+
+template< typename T, typename DELETER > class WeakRefPtr;
+
+/**
+  @brief
+    Liczniki odniesien wspoldzielone przez AtomicRefCountPtr i WeakRefPtr
+
+    Pole weak_ zawiera liczbe slabych odniesien powiekszona o jeden,
+    dopoki istnieje choc jedno odniesienie silne - dzieki temu liczniki
+    sa zwalniane przez ostatni obiekt (silny, badz slaby), ktory z nich
+    korzysta
+*/
+struct AtomicRefCounts {
+  volatile long  strong_;
+  volatile long  weak_;
+};
+
+/**
+  @brief
+    Odmiana RefCountPtr z licznikiem modyfikowanym operacjami atomowymi
+
+    Kopiowanie i niszczenie roznych obiektow wskaznikow, odwolujacych sie
+    do tego samego zasobu, moze odbywac sie jednoczesnie w wielu watkach
+    (np. klatki MD2Data przetwarzane przez watki robocze). Wspolbiezna
+    modyfikacja jednego obiektu wskaznika wymaga zewnetrznej synchronizacji.
+    Liczniki sa przydzielane jednorazowo, podczas objecia zasobu kontrola,
+    i umozliwiaja tworzenie slabych odniesien (WeakRefPtr)
+
+  @param
+    T Typ instancji bedacej pod kontrola wskaznika
+
+  @param
+    DELETER Sposob zniszczenia obiektu (DeleteObject, DeleteArray)
+
+  @code
+    typedef AtomicRefCountPtr< MD2Data >  MD2DataPtr;
+    typedef WeakRefPtr< MD2Data >         MD2DataWeakPtr;
+
+    MD2DataPtr      model( new MD2Data( "tris.md2" ) );
+    MD2DataWeakPtr  cached( model );
+
+    // ... w innym watku
+    if( MD2DataPtr  locked = cached.lock() )
+      locked->keyFramesCount();
+  @endcode
+*/
+template< typename T,
+          typename DELETER = DeleteObject< T > >
+class AtomicRefCountPtr {
+ private:
+   typedef T* AtomicRefCountPtr::*  UnspecifiedBool;
+
+ public:
+   /** 
+     @brief 
+       Objecie kontrola obiektu utworzonego w stercie
+   */
+   AtomicRefCountPtr( T* pointer = 0 );
+
+   AtomicRefCountPtr( const AtomicRefCountPtr& that );
+
+#ifdef GCAD_HAS_RVALUE_REFERENCES
+   AtomicRefCountPtr( AtomicRefCountPtr&& that );
+   AtomicRefCountPtr& operator =( AtomicRefCountPtr&& rhs );
+#endif
+
+   ~AtomicRefCountPtr();
+
+   AtomicRefCountPtr& operator =( const AtomicRefCountPtr& rhs );
+   AtomicRefCountPtr& operator =( T* rhs );
+
+   T& operator *() const;
+   T* operator ->() const;
+   T* get() const { return ptr_; }
+
+   /**
+     @brief
+       Test niepustosci wskaznika (np. wyniku WeakRefPtr::lock())
+   */
+   operator UnspecifiedBool() const
+   {
+     return ptr_ != 0 ? &AtomicRefCountPtr::ptr_ : 0;
+   }
+
+   /**
+     @brief
+       Liczba silnych odniesien. Wartosc moze byc nieaktualna juz
+       w chwili zwrocenia, jesli z zasobu korzystaja inne watki
+   */
+   long referencesCount() const
+   {
+     return counts_ != 0 ? atomicLoad( &counts_->strong_ ) : 0;
+   }
+
+   void swap( AtomicRefCountPtr& that );
+
+ private:
+   friend class WeakRefPtr< T, DELETER >;
+
+   /**
+     @brief
+       Przejecie odniesienia uzyskanego przez WeakRefPtr::lock() -
+       licznik zostal juz zwiekszony
+   */
+   AtomicRefCountPtr( T*                pointer,
+                      AtomicRefCounts*  counts )
+     : ptr_( pointer )
+     , counts_( counts )
+   {}
+
+   void dispose();
+
+ private:
+   T*                ptr_;
+   AtomicRefCounts*  counts_;
+};
+
+
+//
+template< typename T, typename DELETER > inline
+void
+swap( AtomicRefCountPtr< T, DELETER >&  lhs,
+      AtomicRefCountPtr< T, DELETER >&  rhs )
+{
+  lhs.swap( rhs );
+}
+
+//
+template< typename T, typename DELETER > 
+bool
+operator ==( const AtomicRefCountPtr< T, DELETER >&  lhs,
+             const AtomicRefCountPtr< T, DELETER >&  rhs )
+{
+  return lhs.get() == rhs.get();
+}
+
+//
+template< typename T, typename DELETER > 
+bool
+operator !=( const AtomicRefCountPtr< T, DELETER >&  lhs,
+             const AtomicRefCountPtr< T, DELETER >&  rhs )
+{
+  return !( lhs == rhs );
+}
+
+//
+template< typename T, typename DELETER > 
+bool
+operator <( const AtomicRefCountPtr< T, DELETER >&  lhs,
+            const AtomicRefCountPtr< T, DELETER >&  rhs )
+{
+  return lhs.get() < rhs.get();
+}
+
+//
+template< typename T, typename DELETER > 
+AtomicRefCountPtr< T, DELETER >
+::AtomicRefCountPtr( T*  pointer )
+  : ptr_( pointer )
+  , counts_( 0 )
+{
+  if( ptr_ ) {
+    try {
+      counts_ = new AtomicRefCounts;
+    }
+    catch( ... ) {
+      DELETER::destroy( ptr_ );
+      throw;
+    }
+    counts_->strong_ = 1;
+    counts_->weak_   = 1;
+  }
+}
+
+//
+template< typename T, typename DELETER > 
+AtomicRefCountPtr< T, DELETER >
+::AtomicRefCountPtr( const AtomicRefCountPtr&  that )
+  : ptr_( that.ptr_ )
+  , counts_( that.counts_ )
+{
+  if( counts_ )
+    atomicIncrement( &counts_->strong_ );
+}
+
+#ifdef GCAD_HAS_RVALUE_REFERENCES
+//
+template< typename T, typename DELETER > 
+AtomicRefCountPtr< T, DELETER >
+::AtomicRefCountPtr( AtomicRefCountPtr&&  that )
+  : ptr_( that.ptr_ )
+  , counts_( that.counts_ )
+{
+  that.ptr_    = 0;
+  that.counts_ = 0;
+}
+
+//
+template< typename T, typename DELETER > 
+AtomicRefCountPtr< T, DELETER >& 
+AtomicRefCountPtr< T, DELETER >
+::operator =( AtomicRefCountPtr&& rhs )
+{
+  AtomicRefCountPtr( static_cast< AtomicRefCountPtr&& >( rhs ) ).swap( *this );
+  return *this;
+}
+#endif
+
+//
+template< typename T, typename DELETER > 
+AtomicRefCountPtr< T, DELETER >
+::~AtomicRefCountPtr()
+{
+  dispose();
+}
+
+//
+template< typename T, typename DELETER > 
+void
+AtomicRefCountPtr< T, DELETER >
+::dispose()
+{
+  // Ostatnie silne odniesienie niszczy obiekt i oddaje "wspolne" slabe
+  // odniesienie. Liczniki zwalnia ten, kto oddal ostatnie z nich
+  if( counts_ && atomicDecrement( &counts_->strong_ ) == 0 ) {
+    DELETER::destroy( ptr_ );
+
+    if( atomicDecrement( &counts_->weak_ ) == 0 )
+      delete counts_;
+  }
+  ptr_    = 0;
+  counts_ = 0;
+}
+
+//
+template< typename T, typename DELETER > 
+AtomicRefCountPtr< T, DELETER >& 
+AtomicRefCountPtr< T, DELETER >
+::operator =( const AtomicRefCountPtr& rhs )
+{
+  AtomicRefCountPtr( rhs ).swap( *this );
+  return *this;
+}
+
+//
+template< typename T, typename DELETER > 
+AtomicRefCountPtr< T, DELETER >& 
+AtomicRefCountPtr< T, DELETER >
+::operator =( T* rhs )
+{
+  if( ptr_ != 0 && ptr_ == rhs )
+    return *this;
+
+  AtomicRefCountPtr( rhs ).swap( *this );
+  return *this;
+}
+
+//
+template< typename T, typename DELETER > 
+T& 
+AtomicRefCountPtr< T, DELETER >
+::operator *() const
+{
+  assertion( ptr_ != 0, 
+    "Proba wyluskania pustego wskaznika" );
+  return *ptr_;
+}
+
+//
+template< typename T, typename DELETER > 
+T*
+AtomicRefCountPtr< T, DELETER > 
+::operator ->() const
+{
+  assertion( ptr_ != 0, 
+    "Proba wyluskania pustego wskaznika" );
+  return ptr_;
+}
+
+//
+template< typename T, typename DELETER > 
+void
+AtomicRefCountPtr< T, DELETER >
+::swap( AtomicRefCountPtr& that )
+{
+  std::swap( ptr_, that.ptr_ );
+  std::swap( counts_, that.counts_ );
+}
+
+} // namespace Utilities
+} // namespace Gcad
+
+#endif
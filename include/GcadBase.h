@@ -37,4 +37,16 @@
   #define GCAD_EXPORT
 #endif
 
+// Zmienne lokalne dla watku (jedynie typy POD o statycznej inicjalizacji)
+#ifdef _MSC_VER
+  #define GCAD_THREAD_LOCAL __declspec(thread)
+#else
+  #define GCAD_THREAD_LOCAL __thread
+#endif
+
+// Dostepnosc referencji do r-wartosci (semantyka przenoszenia)
+#if __cplusplus >= 201103L || ( defined( _MSC_VER ) && _MSC_VER >= 1600 )
+  #define GCAD_HAS_RVALUE_REFERENCES
+#endif
+
 #endif
\ No newline at end of file
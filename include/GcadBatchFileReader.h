@@ -0,0 +1,124 @@
+/***************************************************************************
+ *   Copyright (C) 2005 by Eryk Klebanski                                  *
+ *   rixment@gmail.com                                                     *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+
+#ifndef _GCAD_BATCHFILEREADER_H_
+#define _GCAD_BATCHFILEREADER_H_
+
+#include "GcadBase.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace Gcad {
+namespace Platform {
+
+/**
+  @brief
+    Interfejs wczytywania wielu plikow jednym zleceniem
+
+    Pliki partii (submit) sa odczytywane w calosci do buforow
+    przydzielonych przez obiekt czytnika. Wyniki sa odbierane w kolejnosci
+    zakonczenia odczytu (waitCompleted), dzieki czemu przetwarzanie danych
+    pierwszych plikow przebiega rownolegle z odczytem kolejnych
+
+  @remark
+    Dane wyniku pozostaja wazne do kolejnego wywolania waitCompleted, 
+    zlecenia kolejnej partii, badz zniszczenia czytnika - czytnik ponownie
+    wykorzystuje bufor odebranego wyniku, dzieki czemu pamiec czytnika 
+    zalezy od liczby jednoczesnie odczytywanych plikow, a nie od wielkosci
+    partii. Obiekt czytnika nie jest bezpieczny dla watkow - partie zleca
+    i odbiera ten sam watek
+
+  @code
+    std::auto_ptr< BatchFileReader > reader( createBatchFileReader() );
+    reader->submit( paths );
+
+    BatchFileReader::Completion completion;
+    while( reader->waitCompleted( &completion ) ) {
+      Utilities::MemoryInputStream input( completion.data_, completion.size_ );
+      // ... paths[ completion.request_ ]
+    }
+  @endcode
+*/
+class GCAD_EXPORT BatchFileReader {
+ public:
+   /**
+     @brief
+       Wynik odczytu jednego pliku partii
+   */
+   struct Completion {
+     size_t       request_;    /**< Indeks pliku w partii */
+     const char*  data_;       /**< Zawartosc pliku */
+     size_t       size_;       /**< Wielkosc pliku w bajtach */
+     bool         succeeded_;  /**< Plik zostal odczytany w calosci */
+   };
+
+   typedef std::vector< std::string >  Paths;
+
+   virtual ~BatchFileReader() {}
+
+   /**
+     @brief
+       Zlecenie odczytu plikow partii. Nieodebrane wyniki poprzedniej
+       partii zostaja porzucone, a jej bufory zwolnione
+   */
+   virtual void submit( const Paths& paths ) = 0;
+
+   /**
+     @brief
+       Oczekiwanie na zakonczenie odczytu kolejnego pliku partii
+
+     @return
+       Wartosc false, gdy wszystkie wyniki partii zostaly juz odebrane
+   */
+   virtual bool waitCompleted( Completion* completion ) = 0;
+
+   /**
+     @brief
+       Nazwa mechanizmu odczytu (np. "io_uring", "threads")
+   */
+   virtual const char* backendName() const = 0;
+};
+
+/**
+  @brief
+    Utworzenie czytnika najwydajniejszego dla platformy. W systemie Linux
+    (biblioteka skompilowana z definicja symbolu GCAD_IO_URING) odczyty
+    calej partii sa zlecane jadru przez io_uring. Jesli interfejs jest
+    niedostepny (starsze jadro, ograniczenia seccomp), badz na pozostalych
+    platformach, zwracany jest czytnik korzystajacy z puli watkow
+
+  @param threadsCount Liczba watkow czytnika zastepczego (zero - liczba
+    watkow sprzetowych)
+*/
+GCAD_EXPORT BatchFileReader* createBatchFileReader( unsigned int threadsCount = 0 );
+
+/**
+  @brief
+    Utworzenie czytnika odczytujacego pliki w threadsCount watkach
+    (zero - liczba watkow sprzetowych), niezaleznie od platformy
+*/
+GCAD_EXPORT BatchFileReader* createThreadedBatchFileReader( unsigned int threadsCount = 0 );
+
+} // namespace Platform
+} // namespace Gcad
+
+#endif
@@ -0,0 +1,66 @@
+/***************************************************************************
+ *   Copyright (C) 2005 by Eryk Klebanski                                  *
+ *   rixment@gmail.com                                                     *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef _GCAD_BYTESIZE_H_
+#define _GCAD_BYTESIZE_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace Gcad {
+namespace Utilities {
+
+/**
+  @brief
+    Wielkosc pamieci dynamicznej przydzielonej przez wektor (bez samego
+    obiektu kontenera, ktory jest liczony przez jego wlasciciela)
+
+  @remark
+    Uwzgledniana jest pojemnosc, a nie liczba elementow - rezerwa
+    wektora rowniez zajmuje pamiec. Elementy posiadajace wlasne dane
+    dynamiczne wymagaja dodatkowego zsumowania ich wielkosci
+*/
+template< typename T, typename ALLOCATOR > inline
+size_t
+dynamicByteSize( const std::vector< T, ALLOCATOR >&  container )
+{
+  return container.capacity() * sizeof( T );
+}
+
+/**
+  @brief
+    Wielkosc pamieci dynamicznej przydzielonej przez lancuch znakow
+
+  @remark
+    Wartosc jest gornym oszacowaniem - krotkie lancuchy moga byc
+    przechowywane wewnatrz obiektu (small string optimization)
+*/
+template< typename CHARACTER > inline
+size_t
+dynamicByteSize( const std::basic_string< CHARACTER >&  text )
+{
+  return ( text.capacity() + 1 ) * sizeof( CHARACTER );
+}
+
+} // namespace Utilities
+} // namespace Gcad
+
+#endif
@@ -0,0 +1,225 @@
+/***************************************************************************
+ *   Copyright (C) 2005 by Eryk Klebanski                                  *
+ *   rixment@gmail.com                                                     *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+
+#ifndef _GCAD_BYTESPAN_H_
+#define _GCAD_BYTESPAN_H_
+
+#include "GcadAssertion.h"
+#include "GcadException.h"
+#include "GcadStdIos.h"
+#include <cstddef>
+#include <cstring>
+
+namespace Gcad {
+namespace Utilities {
+
+/**
+  @brief
+    Niemodyfikowalny widok ciaglego obszaru bajtow (np. pliku
+    odwzorowanego w pamieci przez Platform::MappedFile). Obiekt nie jest
+    wlascicielem danych - ich kopiowanie nie nastepuje
+
+  @remark
+    Obszar musi istniec przez caly czas korzystania z widoku
+*/
+class ByteSpan {
+ public:
+   typedef unsigned char  Byte;
+
+   ByteSpan()
+     : data_( 0 )
+     , size_( 0 )
+   {}
+
+   ByteSpan( const void*  data,
+             size_t       bytesCount )
+     : data_( static_cast< const Byte* >( data ) )
+     , size_( bytesCount )
+   {}
+
+   const Byte* data() const { return data_; }
+   size_t size() const { return size_; }
+   bool empty() const { return size_ == 0; }
+
+   const Byte* begin() const { return data_; }
+   const Byte* end() const { return data_ + size_; }
+
+   /**
+     @brief
+       Sprawdzenie, czy zakres bytesCount bajtow rozpoczynajacy sie
+       od przesuniecia offset zawiera sie w widoku (odporne na
+       przepelnienie wartosci z uszkodzonych plikow)
+   */
+   bool contains( size_t offset, size_t bytesCount ) const
+   {
+     return offset <= size_ && bytesCount <= size_ - offset;
+   }
+
+   /**
+     @brief
+       Widok fragmentu obszaru
+   */
+   ByteSpan subspan( size_t offset, size_t bytesCount ) const
+   {
+     assertion( contains( offset, bytesCount ),
+       "ByteSpan::subspan(size_t, size_t): Zakres poza obszarem widoku!" );
+     return ByteSpan( data_ + offset, bytesCount );
+   }
+
+ private:
+   const Byte*  data_;
+   size_t       size_;
+};
+
+/**
+  @brief
+    Sekwencyjny odczyt danych z widoku ByteSpan, odpowiadajacy odczytowi
+    z binarnego strumienia std::istream (readFromStdStream). Proba odczytu
+    poza koncem obszaru konczy sie zgloszeniem wyjatku Overrun, zamiast
+    ustawienia stanu bledu strumienia
+
+  @code
+    ByteSpanReader reader( mappedFile.bytes() );
+    int framesCount;
+    reader.read( &framesCount );
+    reader.seek( OFFSET_FRAMES );
+  @endcode
+*/
+class ByteSpanReader {
+ public:
+   /**
+     @brief
+       Wyjatek zglaszany przy probie odczytu (badz ustawienia pozycji)
+       poza koncem obszaru danych
+   */
+   class GCAD_EXPORT Overrun : public Exception {
+     friend class ByteSpanReader;
+     Overrun()
+       : Exception( "ByteSpanReader: Odczyt poza koncem obszaru danych!" )
+     {}
+   };
+
+   explicit ByteSpanReader( const ByteSpan& span )
+     : span_( span )
+     , position_( 0 )
+   {}
+
+   /**
+     @brief
+       Skopiowanie elementsCount obiektow typu T spod biezacej pozycji.
+       Dane nie musza byc wyrownane
+
+     @exception
+       Overrun
+   */
+   template< typename T >
+   void read( T* destination, size_t elementsCount = 1 )
+   {
+     if( elementsCount > remaining() / sizeof( T ) )
+       throw Overrun();
+
+     const size_t BYTES_COUNT = sizeof( T ) * elementsCount;
+     memcpy( destination, span_.data() + position_, BYTES_COUNT );
+     position_ += BYTES_COUNT;
+   }
+
+   /**
+     @brief
+       Widok bytesCount bajtow spod biezacej pozycji (bez kopiowania),
+       pozycja zostaje przesunieta za udostepniony fragment
+
+     @exception
+       Overrun
+   */
+   ByteSpan view( size_t bytesCount )
+   {
+     if( bytesCount > remaining() )
+       throw Overrun();
+
+     const ByteSpan FRAGMENT( span_.data() + position_, bytesCount );
+     position_ += bytesCount;
+     return FRAGMENT;
+   }
+
+   /**
+     @exception
+       Overrun
+   */
+   void skip( size_t bytesCount )
+   {
+     if( bytesCount > remaining() )
+       throw Overrun();
+     position_ += bytesCount;
+   }
+
+   /**
+     @brief
+       Ustawienie pozycji wzgledem poczatku obszaru (odpowiednik seekg)
+
+     @exception
+       Overrun
+   */
+   void seek( size_t position )
+   {
+     if( position > span_.size() )
+       throw Overrun();
+     position_ = position;
+   }
+
+   size_t position() const { return position_; }
+   size_t remaining() const { return span_.size() - position_; }
+
+   const ByteSpan& span() const { return span_; }
+
+ private:
+   ByteSpan  span_;
+   size_t    position_;
+};
+
+/**
+  @brief
+    Jednolity odczyt ze strumienia binarnego, badz z widoku ByteSpan.
+    Pozwala zapisac parser formatu w postaci szablonu obslugujacego
+    oba zrodla danych
+*/
+template< typename T >
+void
+readFromSource( std::istream&  source,
+                T*             destination,
+                size_t         elementsCount = 1 )
+{
+  readFromStdStream( source, destination, elementsCount );
+}
+
+//
+template< typename T >
+void
+readFromSource( ByteSpanReader&  source,
+                T*               destination,
+                size_t           elementsCount = 1 )
+{
+  source.read( destination, elementsCount );
+}
+
+} // namespace Utilities
+} // namespace Gcad
+
+#endif
@@ -0,0 +1,182 @@
+/***************************************************************************
+ *   Copyright (C) 2005 by Eryk Klebanski                                  *
+ *   rixment@gmail.com                                                     *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef _GCAD_CHUNKEDMEMORYALLOC_H_
+#define _GCAD_CHUNKEDMEMORYALLOC_H_
+
+#include "GcadChunkedMemoryPool.h"
+#include <cstddef> // size_t
+#include <memory>  // std::bad_alloc
+
+namespace Gcad {
+namespace Utilities {
+
+/**
+  @brief
+    Odmiana szablonu MemoryAlloc rosnaca wraz z zapotrzebowaniem
+
+    Zamiast statycznej tablicy ELEM_COUNT * SEG_SIZE bajtow, klasy
+    pochodne korzystaja z puli ChunkedMemoryPool, ktora rezerwuje
+    przestrzen adresowa dla MAX_CHUNKS fragmentow, a pamiec fizyczna
+    pobiera dopiero w chwili zapotrzebowania. Wolne fragmenty moga byc
+    zwracane do systemu po uplywie czasu bezczynnosci (patrz pool())
+
+  @param
+    CHUNK_SEGMENTS Liczba segmentow przypadajacych na fragment. Wartosc
+    ogranicza rozmiar najwiekszego pojedynczego przydzialu
+
+  @param
+    SEG_SIZE Rozmiar segmentu wyrazony w bajtach
+
+  @param
+    MAX_CHUNKS Maksymalna liczba fragmentow
+
+  @param
+    PAGE_MODE Rodzaj stron pamieci wirtualnej
+
+  @remark
+    Pula jest statyczna dana funkcji pool(), wiec jest inicjalizowana
+    przed pierwszym uzyciem - wywolanie purgeMemory() nie jest wymagane
+
+  @code
+    typedef ChunkedMemoryAlloc< 4096, 32, 256 >  NodeMemAlloc;
+
+    class Node : public NodeMemAlloc {
+      // ...
+    };
+
+    Platform::TimeInformationWin32 time;
+    NodeMemAlloc::pool().setIdleRelease( &time, 5000 );
+  @endcode
+*/
+template< int                 CHUNK_SEGMENTS,
+          int                 SEG_SIZE   = sizeof( int ),
+          int                 MAX_CHUNKS = 64,
+          Platform::PageMode  PAGE_MODE  = Platform::STANDARD_PAGES >
+class ChunkedMemoryAlloc {
+ public:
+   /**
+     @brief
+       Zasloniecie globalnego operatora new w klasach pochodnych
+
+     @exception
+       std::bad_alloc Wyczerpanie wszystkich MAX_CHUNKS fragmentow, badz
+       zadanie przekraczajace rozmiar fragmentu
+   */
+   static void* operator new( size_t bytesCount ) throw( std::bad_alloc )
+   {
+     return pool().allocate( bytesCount );
+   }
+
+   /**
+     @brief
+       Zasloniecie globalnego operatora new[]
+   */
+   static void* operator new []( size_t bytesCount ) throw( std::bad_alloc )
+   {
+     return pool().allocate( bytesCount );
+   }
+
+   /**
+     @brief
+       Zasloniecie globalnego operatora delete
+   */
+   static void operator delete( void* memoryToRelease ) throw()
+   {
+     pool().deallocate( memoryToRelease );
+   }
+
+   /**
+     @brief
+       Zasloniecie globalnego operatora delete[]
+   */
+   static void operator delete []( void* memoryToRelease ) throw()
+   {
+     pool().deallocate( memoryToRelease );
+   }
+
+   /**
+     @brief
+       Przywrocenie stanu surowego pamieci - wszystkie fragmenty
+       zostaja zwrocone do systemu
+   */
+   static void purgeMemory() { pool().purge(); }
+
+   /**
+     @brief
+       Podany w bajtach rozmiar aktualnie zatwierdzonej pamieci
+   */
+   static int size()
+   {
+     return static_cast< int >( pool().committedBytes() );
+   }
+
+   /**
+     @brief
+       Ilosc bajtow przypadajaca na segment
+   */
+   static int bytesPerSegment() { return SEG_SIZE; }
+
+   /**
+     @brief
+       Liczba segmentow aktualnie zatwierdzonych fragmentow
+   */
+   static int segmentsCount()
+   {
+     return static_cast< int >( pool().committedChunksCount() ) *
+       CHUNK_SEGMENTS;
+   }
+
+   /**
+     @brief
+       Migawka biezacego stanu puli (patrz MemoryAllocStats)
+   */
+   static MemoryAllocStats statistics() { return pool().statistics(); }
+
+   /**
+     @brief
+       Pula obslugujaca klasy pochodne. Umozliwia konfiguracje
+       zwalniania fragmentow, oraz odczyt stanu pamieci
+   */
+   static ChunkedMemoryPool& pool()
+   {
+     static ChunkedMemoryPool chunkedPool(
+       SEG_SIZE, CHUNK_SEGMENTS, MAX_CHUNKS, PAGE_MODE );
+     return chunkedPool;
+   }
+
+ protected:
+   /**
+     @brief
+       Domyslny konstruktor, wywolywany podczas tworzenia
+       instancji klas pochodnych
+   */
+   ChunkedMemoryAlloc() {}
+
+ private:
+   // nie zaimplementowane
+   ChunkedMemoryAlloc( const ChunkedMemoryAlloc& );
+   ChunkedMemoryAlloc& operator =( const ChunkedMemoryAlloc& );
+};
+
+} // namespace Utilities
+} // namespace Gcad
+
+#endif
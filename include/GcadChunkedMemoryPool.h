@@ -0,0 +1,264 @@
+/***************************************************************************
+ *   Copyright (C) 2005 by Eryk Klebanski                                  *
+ *   rixment@gmail.com                                                     *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef _GCAD_CHUNKEDMEMORYPOOL_H_
+#define _GCAD_CHUNKEDMEMORYPOOL_H_
+
+#include "GcadBase.h"
+#include "GcadSegregatedFreeLists.h"
+#include "GcadMemoryAllocStats.h"
+#include "GcadVirtualMemory.h"
+#include <cstddef>
+#include <memory>  // std::bad_alloc
+#include <vector>
+
+namespace Gcad {
+
+namespace Platform {
+  class TimeInformation;
+}
+
+namespace Utilities {
+
+/**
+  @brief
+    Pula pamieci skladajaca sie z fragmentow (ang. chunks) zatwierdzanych
+    na zadanie wewnatrz jednego, zarezerwowanego zakresu adresow
+
+    Przestrzen adresowa calej puli (maxChunks fragmentow) jest
+    rezerwowana jednorazowo, podczas pierwszego przydzialu, bez
+    angazowania pamieci fizycznej. Kolejne fragmenty sa zatwierdzane
+    dopiero wtedy, gdy dotychczasowe nie sa w stanie zaspokoic zadania.
+    Dzieki temu pule nie musza byc wymiarowane na najgorszy przypadek.<br>
+    Kazdy fragment posiada wlasne listy wolnych obszarow
+    (SegregatedFreeLists), umieszczone na jego poczatku - zwrot fragmentu
+    do systemu zwalnia wiec rowniez jego metadane. Fragment, ktorego
+    wszystkie segmenty sa wolne dluzej niz zadany czas bezczynnosci,
+    zostaje zwrocony do systemu operacyjnego
+
+  @remark
+    Pojedynczy przydzial nie moze przekroczyc rozmiaru fragmentu
+*/
+class GCAD_EXPORT ChunkedMemoryPool {
+ public:
+   /**
+     @brief
+       Konstruktor puli. Zakres adresow nie jest jeszcze rezerwowany
+
+     @param bytesPerSegment Rozmiar segmentu wyrazony w bajtach
+     @param segmentsPerChunk Liczba segmentow przypadajacych na fragment
+     @param maxChunks Maksymalna liczba fragmentow (wielkosc rezerwacji)
+     @param pageMode Rodzaj stron pamieci. Jesli duze strony sa
+       niedostepne, fragmenty otrzymuja strony standardowe
+   */
+   ChunkedMemoryPool( size_t              bytesPerSegment,
+                      size_t              segmentsPerChunk,
+                      size_t              maxChunks,
+                      Platform::PageMode  pageMode = Platform::STANDARD_PAGES );
+
+   /**
+     @brief
+       Zwolnienie calego zarezerwowanego zakresu adresow
+   */
+   ~ChunkedMemoryPool();
+
+   /**
+     @brief
+       Przydzial ciaglego obszaru o wielkosci co najmniej bytesCount bajtow
+
+     @exception
+       std::bad_alloc Brak wolnego miejsca we wszystkich fragmentach,
+       oraz brak mozliwosci zatwierdzenia kolejnego
+   */
+   void* allocate( size_t bytesCount ) throw( std::bad_alloc );
+
+   /**
+     @brief
+       Zwrot obszaru przydzielonego metoda allocate(). Adresy nie
+       nalezace do puli sa ignorowane
+   */
+   void deallocate( void* memoryToRelease ) throw();
+
+   /**
+     @brief
+       Sprawdzenie, czy adres nalezy do zakresu zarezerwowanego przez pule
+   */
+   bool owns( const void* memory ) const;
+
+   /**
+     @brief
+       Ustawienie czasu, po ktorym calkowicie wolny fragment zostaje
+       zwrocony do systemu
+
+     @param timeInformation Zrodlo czasu systemowego. Wartosc zerowa
+       wylacza automatyczne zwalnianie fragmentow
+     @param idleMilliseconds Czas bezczynnosci wyrazony w milisekundach
+   */
+   void setIdleRelease( const Platform::TimeInformation*  timeInformation,
+                        size_t                            idleMilliseconds );
+
+   /**
+     @brief
+       Zwrot do systemu wolnych fragmentow, ktorych czas bezczynnosci
+       przekroczyl zadany limit. Metoda jest wywolywana automatycznie,
+       gdy zwolnienie pamieci oprozni fragment. Fragmenty oczekujace na
+       uplyw czasu bezczynnosci zwraca sie wywolujac ja cyklicznie 
+       (np. raz na klatke)
+   */
+   void releaseIdleChunks();
+
+   /**
+     @brief
+       Zwrot do systemu wszystkich calkowicie wolnych fragmentow,
+       niezaleznie od czasu ich bezczynnosci
+   */
+   void trimEmptyChunks();
+
+   /**
+     @brief
+       Przywrocenie stanu surowego - wszystkie fragmenty zostaja zwrocone
+       do systemu, a wszystkie przydzielone obszary uniewaznione
+   */
+   void purge();
+
+   /**
+     @brief
+       Ilosc bajtow przypadajaca na segment
+   */
+   size_t bytesPerSegment() const { return bytesPerSegment_; }
+
+   /**
+     @brief
+       Liczba segmentow przypadajacych na fragment
+   */
+   size_t segmentsPerChunk() const { return segmentsPerChunk_; }
+
+   /**
+     @brief
+       Maksymalna liczba fragmentow puli
+   */
+   size_t maxChunksCount() const { return chunks_.size(); }
+
+   /**
+     @brief
+       Liczba aktualnie zatwierdzonych fragmentow
+   */
+   size_t committedChunksCount() const { return committedChunks_; }
+
+   /**
+     @brief
+       Ilosc pamieci (w bajtach) zatwierdzonej przez pule
+   */
+   size_t committedBytes() const { return committedChunks_ * chunkBytes_; }
+
+   /**
+     @brief
+       Wielkosc zakresu adresow rezerwowanego przez pule
+   */
+   size_t reservedBytes() const { return chunks_.size() * chunkBytes_; }
+
+   /**
+     @brief
+       Migawka biezacego stanu puli (patrz MemoryAllocStats)
+
+     @remark
+       Fragmentacja dotyczy wylacznie fragmentow zatwierdzonych. Jesli
+       pula moze zatwierdzic kolejny fragment, najwiekszy wolny obszar
+       ma rozmiar calego fragmentu
+   */
+   MemoryAllocStats statistics() const;
+
+ private:
+   typedef SegregatedFreeLists<>  FreeLists;
+   typedef FreeLists::InfoNode    InfoNode;
+
+   /**
+     @brief
+       Stan fragmentu przechowywany poza zakresem zarezerwowanym, aby
+       byl dostepny rowniez dla fragmentow niezatwierdzonych
+   */
+   struct ChunkState {
+     bool    committed_;  /**< Fragment posiada pamiec fizyczna */
+     bool    empty_;      /**< Wszystkie segmenty fragmentu sa wolne */
+     size_t  emptySince_; /**< Czas systemowy zwolnienia ostatniego obszaru */
+   };
+
+   /**
+     @brief
+       Opozniona rezerwacja zakresu adresow (podczas pierwszego przydzialu)
+   */
+   void reserve() throw( std::bad_alloc );
+
+   char* chunkBase( size_t chunkIndex ) const;
+   char* chunkData( size_t chunkIndex ) const;
+   FreeLists& chunkFreeLists( size_t chunkIndex ) const;
+
+   /**
+     @brief
+       Zatwierdzenie fragmentu, oraz inicjalizacja jego metadanych
+   */
+   bool commitChunk( size_t chunkIndex );
+
+   /**
+     @brief
+       Zwrot pamieci fizycznej fragmentu do systemu
+   */
+   void decommitChunk( size_t chunkIndex );
+
+   /**
+     @brief
+       Proba przydzialu obszaru z zadanego fragmentu
+   */
+   void* takeFromChunk( size_t  chunkIndex,
+                        int     blockCount );
+
+   /**
+     @brief
+       Biezacy czas systemowy, badz zero w przypadku braku jego zrodla
+   */
+   size_t currentTime() const;
+
+ private:
+   size_t                            bytesPerSegment_;
+   size_t                            segmentsPerChunk_;
+   size_t                            chunkBytes_;
+   size_t                            dataOffset_;
+   Platform::PageMode                pageMode_;
+   char*                             reservation_;
+   size_t                            reservationBytes_;
+   char*                             chunksBegin_;
+   std::vector< ChunkState >         chunks_;
+   size_t                            committedChunks_;
+   size_t                            emptyChunks_;
+   size_t                            lastChunk_;
+   const Platform::TimeInformation*  timeInformation_;
+   size_t                            idleTicks_;
+   MemoryAllocCounters               counters_;
+
+ private:
+   // nie zaimplementowane
+   ChunkedMemoryPool( const ChunkedMemoryPool& );
+   ChunkedMemoryPool& operator =( const ChunkedMemoryPool& );
+};
+
+} // namespace Utilities
+} // namespace Gcad
+
+#endif
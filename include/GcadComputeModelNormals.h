@@ -103,22 +103,25 @@ class GCAD_EXPORT ComputeModelNormals {
      @param
        verticesKeyFrame Sprawdzajac typ argumentu mozemy dojsc do wniosku,
        iz argumentem wywolania jest referencja do zestawu wierzcholkow
-       konkretnej klatki kluczowej animacji
+       konkretnej klatki kluczowej animacji. Kontener moze korzystac
+       z dowolnego alokatora (patrz ModelDataAllocator)
 
      @param
        normalsFrame Argumentem jest wskaznik do zestawu normalnych 
        wierzcholkow. Po zakonczeniu wykonywania metody obiekt, ktorego 
        adres zostaje przekazany magazynowac bedzie skonstruowane
        wartosci determinujace normalne wierzcholkow.<br>
-       Funkcja korzysta z metody std::vector::swap(), czego implikacja
+       Funkcja korzysta z metody assign() kontenera, czego implikacja
        jest usuniecie zawartosci danych skojarzonych z kontenerem bedacym
        argumentem jej wywolania
    */
-   template< typename POLYGON_INDICES_ITOR >
-   void computeFrameNormals( POLYGON_INDICES_ITOR  begin,
-                             POLYGON_INDICES_ITOR  end,
-                             const VerticesFrame&  verticesKeyFrame,
-                             NormalsFrame*         normalsFrame );
+   template< typename POLYGON_INDICES_ITOR,
+             typename VERTICES_FRAME,
+             typename NORMALS_FRAME >
+   void computeFrameNormals( POLYGON_INDICES_ITOR   begin,
+                             POLYGON_INDICES_ITOR   end,
+                             const VERTICES_FRAME&  verticesKeyFrame,
+                             NORMALS_FRAME*         normalsFrame );
 
  private:
    /**
@@ -150,10 +153,10 @@ class GCAD_EXPORT ComputeModelNormals {
      @brief
        Hermetyzacja funkcji obliczenia normalnych poligonow
    */
-   template< typename POLYGON_INDICES_ITOR >
-   PolygonsNormalsSmartPtr computePolyNormals( POLYGON_INDICES_ITOR  begin,
-                                               POLYGON_INDICES_ITOR  end,
-                                               const VerticesFrame&  frame );
+   template< typename POLYGON_INDICES_ITOR, typename VERTICES_FRAME >
+   PolygonsNormalsSmartPtr computePolyNormals( POLYGON_INDICES_ITOR   begin,
+                                               POLYGON_INDICES_ITOR   end,
+                                               const VERTICES_FRAME&  frame );
 
    /**
      @brief
@@ -208,11 +211,13 @@ template< typename POLYGON_INDICES_ITOR > ComputeModelNormals
 }
 
 //
-template< typename POLYGON_INDICES_ITOR > void ComputeModelNormals
-::computeFrameNormals( POLYGON_INDICES_ITOR  begin,
-                       POLYGON_INDICES_ITOR  end,
-                       const VerticesFrame&  verticesKeyFrame,
-                       NormalsFrame*         normalsFrame )
+template< typename POLYGON_INDICES_ITOR,
+          typename VERTICES_FRAME,
+          typename NORMALS_FRAME > void ComputeModelNormals
+::computeFrameNormals( POLYGON_INDICES_ITOR   begin,
+                       POLYGON_INDICES_ITOR   end,
+                       const VERTICES_FRAME&  verticesKeyFrame,
+                       NORMALS_FRAME*         normalsFrame )
 {
   Gcad::Utilities::assertion( begin != end, 
     "Kolekcja indeksow do tablicy wierzcholkow nie moze byc pusta!" );
@@ -238,15 +243,15 @@ template< typename POLYGON_INDICES_ITOR > void ComputeModelNormals
   NormalsFrameSmartPtr  verticesNormals =
     computeAproximatedNormals( polygonsNormals );
  
-  normalsFrame->swap( *verticesNormals );
+  normalsFrame->assign( verticesNormals->begin(), verticesNormals->end() );
 }
 
 //
-template< typename POLYGON_INDICES_ITOR > 
+template< typename POLYGON_INDICES_ITOR, typename VERTICES_FRAME > 
 ComputeModelNormals::PolygonsNormalsSmartPtr ComputeModelNormals
-::computePolyNormals( POLYGON_INDICES_ITOR  begin,
-                      POLYGON_INDICES_ITOR  end,
-                      const VerticesFrame&  frame )
+::computePolyNormals( POLYGON_INDICES_ITOR   begin,
+                      POLYGON_INDICES_ITOR   end,
+                      const VERTICES_FRAME&  frame )
 {
   PolygonsNormalsSmartPtr  polygonsNormals = new PolygonsNormals;
   
@@ -0,0 +1,510 @@
+/***************************************************************************
+ *   Copyright (C) 2005 by Eryk Klebanski                                  *
+ *   rixment@gmail.com                                                     *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef _GCAD_CONCURRENTMEMORYALLOC_H_
+#define _GCAD_CONCURRENTMEMORYALLOC_H_
+
+#include "GcadBase.h"
+#include "GcadAtomic.h"
+#include "GcadThread.h"
+#include <cstddef> // size_t
+#include <new>     // ::operator new, std::bad_alloc
+
+namespace Gcad {
+namespace Utilities {
+
+/**
+  @brief
+    Odmiana szablonu MemoryAlloc przeznaczona do wspolbieznego uzycia
+    z wielu watkow
+
+    Kazdy watek posiada wlasna pamiec podreczna (ang. thread cache)
+    wolnych segmentow, wiec typowy przydzial i zwolnienie nie wymaga
+    zadnej synchronizacji. Pamiec podreczna jest uzupelniana, oraz
+    oprozniana porcjami (ang. batches) po BATCH_SIZE segmentow,
+    wymienianymi ze wspolnym stosem porcji. Stos jest zrealizowany
+    bez blokad (operacja porownania i zamiany na indeksie ze znacznikiem,
+    eliminujacym problem ABA). Segmenty nigdy nie przydzielone sa
+    wycinane z puli porcjami, za pomoca atomowego licznika.<br>
+    Zwolnienie obszaru w watku innym niz przydzielajacy jest poprawne -
+    segment trafia do pamieci podrecznej watku zwalniajacego
+
+  @param
+    ELEM_COUNT Liczba segmentow puli
+
+  @param
+    SEG_SIZE Rozmiar segmentu wyrazony w bajtach. Zadania wieksze od
+    segmentu sa obslugiwane przez globalny operator new
+
+  @param
+    BATCH_SIZE Liczba segmentow wymienianych jednorazowo ze wspolnym stosem
+
+  @remark
+    Segmenty przechowywane w pamieci podrecznej watku sa zwracane na
+    wspolny stos w chwili jego zakonczenia (Platform::atThreadExit).
+    Watek moze zwrocic je wczesniej metoda flushThreadCache(). Szablon
+    nie udostepnia metody purgeMemory() - pamieci podreczne pozostalych
+    watkow moga przechowywac segmenty puli
+
+  @code
+    typedef ConcurrentMemoryAlloc< 65536, 64 >  KeyFrameMemAlloc;
+
+    class KeyFrame : public KeyFrameMemAlloc {
+      // ...
+    };
+
+    // Procedura watku roboczego
+    void animate()
+    {
+      // ...
+      // Zwrot segmentow przed uspieniem watku (zakonczenie watku
+      // zwraca je samoczynnie)
+      KeyFrameMemAlloc::flushThreadCache();
+    }
+  @endcode
+*/
+template< int ELEM_COUNT,
+          int SEG_SIZE   = sizeof( int ),
+          int BATCH_SIZE = 32 >
+class ConcurrentMemoryAlloc {
+ public:
+   /**
+     @brief
+       Zasloniecie globalnego operatora new w klasach pochodnych
+
+     @exception
+       std::bad_alloc Wyczerpanie wszystkich segmentow puli
+   */
+   static void* operator new( size_t bytesCount ) throw( std::bad_alloc );
+
+   /**
+     @brief
+       Zasloniecie globalnego operatora new[]
+   */
+   static void* operator new []( size_t bytesCount ) throw( std::bad_alloc );
+
+   /**
+     @brief
+       Zasloniecie globalnego operatora delete
+   */
+   static void operator delete( void* memoryToRelease ) throw();
+
+   /**
+     @brief
+       Zasloniecie globalnego operatora delete[]
+   */
+   static void operator delete []( void* memoryToRelease ) throw();
+
+   /**
+     @brief
+       Zwrot wszystkich segmentow pamieci podrecznej biezacego watku
+       na wspolny stos (wykonywany rowniez przy zakonczeniu watku)
+   */
+   static void flushThreadCache();
+
+   /**
+     @brief
+       Podany w bajtach rozmiar calego bloku pamieci
+   */
+   static int size() { return ELEM_COUNT * SEG_SIZE; }
+
+   /**
+     @brief
+       Ilosc bajtow przypadajaca na segment
+   */
+   static int bytesPerSegment() { return SEG_SIZE; }
+
+   /**
+     @brief
+       Liczba segmentow, z ktorych sklada sie caly obszar dostepnej pamieci
+   */
+   static int segmentsCount() { return ELEM_COUNT; }
+
+ protected:
+   /**
+     @brief
+       Domyslny konstruktor, wywolywany podczas tworzenia
+       instancji klas pochodnych
+   */
+   ConcurrentMemoryAlloc() {}
+
+ private:
+   /**
+     @brief
+       Pamiec podreczna watku - lista segmentow sprzezona tablica next_
+   */
+   struct ThreadCache {
+     int   head_;        /**< Pierwszy segment (poprawny, gdy count_ > 0) */
+     int   count_;       /**< Liczba segmentow listy */
+     bool  registered_;  /**< Zarejestrowano oproznienie przy zakonczeniu
+                              watku (atThreadExit) */
+   };
+
+   enum { NO_SEGMENT = -1 };
+
+   /**
+     @brief
+       Pamiec podreczna biezacego watku. Pierwsze odwolanie watku
+       rejestruje jej oproznienie przy zakonczeniu watku
+   */
+   static ThreadCache& threadCache();
+
+   /**
+     @brief
+       Oproznienie pamieci podrecznej konczacego sie watku
+   */
+   static void threadExit( void* cache );
+
+   /**
+     @brief
+       Przeniesienie wszystkich segmentow pamieci podrecznej na wspolny stos
+   */
+   static void flushCache( ThreadCache& cache );
+
+   /**
+     @brief
+       Uzupelnienie pustej pamieci podrecznej porcja segmentow
+   */
+   static bool refill( ThreadCache& cache );
+
+   /**
+     @brief
+       Przeniesienie segmentsCount segmentow z pamieci podrecznej
+       na wspolny stos porcji
+   */
+   static void releaseBatch( ThreadCache&  cache,
+                             int           segmentsCount );
+
+   static void pushBatch( int firstSegment );
+   static int  popBatch();
+
+   static AtomicInt64 pack( int segment, AtomicInt64 tag );
+   static int indexOf( AtomicInt64 head );
+
+ private:
+   /**
+     @brief
+       Pamiec podreczna biezacego watku
+   */
+   static GCAD_THREAD_LOCAL ThreadCache  cache_;
+
+   /**
+     @brief
+       Wierzcholek wspolnego stosu porcji: znacznik w starszych 32 bitach,
+       indeks pierwszego segmentu porcji (+1) w mlodszych
+   */
+   static volatile AtomicInt64  central_;
+
+   /**
+     @brief
+       Liczba segmentow wycietych z puli
+   */
+   static volatile long  carved_;
+
+   /**
+     @brief
+       Laczniki segmentow pamieci podrecznej, oraz wnetrza porcji
+   */
+   static int  next_[ ELEM_COUNT ];
+
+   /**
+     @brief
+       Laczniki porcji na wspolnym stosie (indeksowane pierwszym segmentem).
+       Lacznik porcji zdjetej przez inny watek moze byc w tym czasie
+       zapisywany, wiec jest odczytywany atomowo
+   */
+   static volatile long  batchNext_[ ELEM_COUNT ];
+
+   /**
+     @brief
+       Liczba segmentow porcji (indeksowana pierwszym segmentem)
+   */
+   static int  batchCount_[ ELEM_COUNT ];
+
+   /**
+     @brief
+       Obszar pamieci przeznaczonej do wykorzystania
+       przez obiekty klas pochodnych
+   */
+   static char  memoryPool_[ ELEM_COUNT * SEG_SIZE ];
+
+ private:
+   // nie zaimplementowane
+   ConcurrentMemoryAlloc( const ConcurrentMemoryAlloc& );
+   ConcurrentMemoryAlloc& operator =( const ConcurrentMemoryAlloc& );
+};
+
+
+//
+template< int ELEM_COUNT, int SEG_SIZE, int BATCH_SIZE >
+GCAD_THREAD_LOCAL
+typename ConcurrentMemoryAlloc< ELEM_COUNT, SEG_SIZE, BATCH_SIZE >::ThreadCache
+ConcurrentMemoryAlloc< ELEM_COUNT, SEG_SIZE, BATCH_SIZE >
+::cache_ = { 0, 0, false };
+
+//
+template< int ELEM_COUNT, int SEG_SIZE, int BATCH_SIZE >
+volatile AtomicInt64 ConcurrentMemoryAlloc< ELEM_COUNT, SEG_SIZE, BATCH_SIZE >
+::central_ = 0;
+
+//
+template< int ELEM_COUNT, int SEG_SIZE, int BATCH_SIZE >
+volatile long ConcurrentMemoryAlloc< ELEM_COUNT, SEG_SIZE, BATCH_SIZE >
+::carved_ = 0;
+
+//
+template< int ELEM_COUNT, int SEG_SIZE, int BATCH_SIZE >
+int ConcurrentMemoryAlloc< ELEM_COUNT, SEG_SIZE, BATCH_SIZE >
+::next_[ ELEM_COUNT ] = { 0 };
+
+//
+template< int ELEM_COUNT, int SEG_SIZE, int BATCH_SIZE >
+volatile long ConcurrentMemoryAlloc< ELEM_COUNT, SEG_SIZE, BATCH_SIZE >
+::batchNext_[ ELEM_COUNT ] = { 0 };
+
+//
+template< int ELEM_COUNT, int SEG_SIZE, int BATCH_SIZE >
+int ConcurrentMemoryAlloc< ELEM_COUNT, SEG_SIZE, BATCH_SIZE >
+::batchCount_[ ELEM_COUNT ] = { 0 };
+
+//
+template< int ELEM_COUNT, int SEG_SIZE, int BATCH_SIZE >
+char ConcurrentMemoryAlloc< ELEM_COUNT, SEG_SIZE, BATCH_SIZE >
+::memoryPool_[ ELEM_COUNT * SEG_SIZE ] = { 0 };
+
+//
+template< int ELEM_COUNT, int SEG_SIZE, int BATCH_SIZE > inline
+AtomicInt64 ConcurrentMemoryAlloc< ELEM_COUNT, SEG_SIZE, BATCH_SIZE >
+::pack( int          segment,
+        AtomicInt64  tag )
+{
+  return ( tag << 32 ) | static_cast< unsigned int >( segment + 1 );
+}
+
+//
+template< int ELEM_COUNT, int SEG_SIZE, int BATCH_SIZE > inline
+int ConcurrentMemoryAlloc< ELEM_COUNT, SEG_SIZE, BATCH_SIZE >
+::indexOf( AtomicInt64 head )
+{
+  return static_cast< int >( head & 0xffffffff ) - 1;
+}
+
+//
+template< int ELEM_COUNT, int SEG_SIZE, int BATCH_SIZE >
+void ConcurrentMemoryAlloc< ELEM_COUNT, SEG_SIZE, BATCH_SIZE >
+::pushBatch( int firstSegment )
+{
+  for( ;; ) {
+    const AtomicInt64 HEAD = atomicLoad64( &central_ );
+    batchNext_[ firstSegment ] = indexOf( HEAD );
+
+    const AtomicInt64 NEW_HEAD = pack( firstSegment, ( HEAD >> 32 ) + 1 );
+    if( atomicCompareExchange64( &central_, NEW_HEAD, HEAD ) == HEAD )
+      return;
+  }
+}
+
+//
+template< int ELEM_COUNT, int SEG_SIZE, int BATCH_SIZE >
+int ConcurrentMemoryAlloc< ELEM_COUNT, SEG_SIZE, BATCH_SIZE >
+::popBatch()
+{
+  for( ;; ) {
+    const AtomicInt64 HEAD = atomicLoad64( &central_ );
+    const int FIRST_SEGMENT = indexOf( HEAD );
+    if( FIRST_SEGMENT == NO_SEGMENT )
+      return NO_SEGMENT;
+
+    // Lacznik moze byc nieaktualny, jesli porcja zostala w miedzyczasie
+    // zdjeta ze stosu - wowczas znacznik wierzcholka ulegl zmianie,
+    // a operacja porownania i zamiany nie powiedzie sie
+    const int NEXT_BATCH = 
+      static_cast< int >( atomicLoadAcquire( &batchNext_[ FIRST_SEGMENT ] ) );
+    const AtomicInt64 NEW_HEAD = pack( NEXT_BATCH, ( HEAD >> 32 ) + 1 );
+    if( atomicCompareExchange64( &central_, NEW_HEAD, HEAD ) == HEAD )
+      return FIRST_SEGMENT;
+  }
+}
+
+//
+template< int ELEM_COUNT, int SEG_SIZE, int BATCH_SIZE >
+bool ConcurrentMemoryAlloc< ELEM_COUNT, SEG_SIZE, BATCH_SIZE >
+::refill( ThreadCache& cache )
+{
+  const int BATCH = popBatch();
+  if( BATCH != NO_SEGMENT ) {
+    cache.head_  = BATCH;
+    cache.count_ = batchCount_[ BATCH ];
+    return true;
+  }
+
+  // Wspolny stos jest pusty - wyciecie nowej porcji z puli
+  // Po wyczerpaniu puli licznik jest przywracany - kolejne nieudane
+  // przydzialy nie moga doprowadzic do jego przepelnienia
+  const long FIRST_SEGMENT = atomicExchangeAdd( &carved_, BATCH_SIZE );
+  if( FIRST_SEGMENT >= ELEM_COUNT ) {
+    atomicExchangeAdd( &carved_, -BATCH_SIZE );
+    return false;
+  }
+
+  const int CARVED = FIRST_SEGMENT + BATCH_SIZE <= ELEM_COUNT ?
+    BATCH_SIZE :
+    static_cast< int >( ELEM_COUNT - FIRST_SEGMENT );
+
+  for( int segment = FIRST_SEGMENT;
+    segment < FIRST_SEGMENT + CARVED - 1;
+    ++segment )
+  {
+    next_[ segment ] = segment + 1;
+  }
+
+  cache.head_  = FIRST_SEGMENT;
+  cache.count_ = CARVED;
+  return true;
+}
+
+//
+template< int ELEM_COUNT, int SEG_SIZE, int BATCH_SIZE >
+void ConcurrentMemoryAlloc< ELEM_COUNT, SEG_SIZE, BATCH_SIZE >
+::releaseBatch( ThreadCache&  cache,
+                int           segmentsCount )
+{
+  const int FIRST_SEGMENT = cache.head_;
+
+  int lastSegment = FIRST_SEGMENT;
+  for( int segment = 1; segment < segmentsCount; ++segment )
+    lastSegment = next_[ lastSegment ];
+
+  cache.head_   = next_[ lastSegment ];
+  cache.count_ -= segmentsCount;
+
+  batchCount_[ FIRST_SEGMENT ] = segmentsCount;
+  pushBatch( FIRST_SEGMENT );
+}
+
+//
+template< int ELEM_COUNT, int SEG_SIZE, int BATCH_SIZE >
+void* ConcurrentMemoryAlloc< ELEM_COUNT, SEG_SIZE, BATCH_SIZE >
+::operator new( size_t bytesCount ) throw( std::bad_alloc )
+{
+  if( bytesCount > static_cast< size_t >( SEG_SIZE ) )
+    return ::operator new( bytesCount );
+
+  ThreadCache& cache = threadCache();
+  if( cache.count_ == 0 && !refill( cache ) )
+    throw std::bad_alloc();
+
+  const int SEGMENT = cache.head_;
+  cache.head_ = next_[ SEGMENT ];
+  --cache.count_;
+
+  return memoryPool_ + SEGMENT * SEG_SIZE;
+}
+
+//
+template< int ELEM_COUNT, int SEG_SIZE, int BATCH_SIZE > inline
+void* ConcurrentMemoryAlloc< ELEM_COUNT, SEG_SIZE, BATCH_SIZE >
+::operator new []( size_t bytesCount ) throw( std::bad_alloc )
+{
+  return operator new( bytesCount );
+}
+
+//
+template< int ELEM_COUNT, int SEG_SIZE, int BATCH_SIZE >
+void ConcurrentMemoryAlloc< ELEM_COUNT, SEG_SIZE, BATCH_SIZE >
+::operator delete( void* memoryToRelease ) throw()
+{
+  char* released = static_cast< char* >( memoryToRelease );
+
+  // Obszary spoza puli pochodza z globalnego operatora new
+  if( released < memoryPool_ || released >= memoryPool_ + size() ) {
+    ::operator delete( memoryToRelease );
+    return;
+  }
+
+  const int SEGMENT = static_cast< int >( released - memoryPool_ ) / SEG_SIZE;
+
+  ThreadCache& cache = threadCache();
+  next_[ SEGMENT ] = cache.head_;
+  cache.head_ = SEGMENT;
+  ++cache.count_;
+
+  // Histereza - pamiec podreczna zachowuje porcje na kolejne przydzialy
+  if( cache.count_ >= 2 * BATCH_SIZE )
+    releaseBatch( cache, BATCH_SIZE );
+}
+
+//
+template< int ELEM_COUNT, int SEG_SIZE, int BATCH_SIZE > inline
+void ConcurrentMemoryAlloc< ELEM_COUNT, SEG_SIZE, BATCH_SIZE >
+::operator delete []( void* memoryToRelease ) throw()
+{
+  operator delete( memoryToRelease );
+}
+
+//
+template< int ELEM_COUNT, int SEG_SIZE, int BATCH_SIZE >
+void ConcurrentMemoryAlloc< ELEM_COUNT, SEG_SIZE, BATCH_SIZE >
+::flushThreadCache()
+{
+  flushCache( cache_ );
+}
+
+//
+template< int ELEM_COUNT, int SEG_SIZE, int BATCH_SIZE > inline
+typename ConcurrentMemoryAlloc< ELEM_COUNT, SEG_SIZE, BATCH_SIZE >::ThreadCache&
+ConcurrentMemoryAlloc< ELEM_COUNT, SEG_SIZE, BATCH_SIZE >
+::threadCache()
+{
+  ThreadCache& cache = cache_;
+  if( !cache.registered_ ) {
+    cache.registered_ = true;
+    Platform::atThreadExit( &threadExit, &cache );
+  }
+  return cache;
+}
+
+//
+template< int ELEM_COUNT, int SEG_SIZE, int BATCH_SIZE >
+void ConcurrentMemoryAlloc< ELEM_COUNT, SEG_SIZE, BATCH_SIZE >
+::threadExit( void* cache )
+{
+  // Zwolnienia wykonane po oproznieniu (np. przez pozostale funkcje
+  // konczacego sie watku) ponownie rejestruja oproznienie
+  ThreadCache& exitingCache = *static_cast< ThreadCache* >( cache );
+  exitingCache.registered_ = false;
+  flushCache( exitingCache );
+}
+
+//
+template< int ELEM_COUNT, int SEG_SIZE, int BATCH_SIZE >
+void ConcurrentMemoryAlloc< ELEM_COUNT, SEG_SIZE, BATCH_SIZE >
+::flushCache( ThreadCache& cache )
+{
+  while( cache.count_ > 0 ) {
+    releaseBatch( cache,
+      cache.count_ < BATCH_SIZE ? cache.count_ : BATCH_SIZE );
+  }
+}
+
+} // namespace Utilities
+} // namespace Gcad
+
+#endif
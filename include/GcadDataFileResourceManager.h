@@ -23,22 +23,30 @@
 
 #include "GcadDataFileResourceManagerBase.h"
 #include "GcadAssertion.h"
+#include "GcadAtomic.h"
+#include "GcadBatchFileReader.h"
 #include "GcadDriveElementsEnumerator.h"
 #include "GcadException.h"
+#include "GcadFileWatcher.h"
+#include "GcadMappedFile.h"
+#include "GcadMemoryInputStream.h"
+#include "GcadProcessedCache.h"
+#include "GcadResourceArchive.h"
+#include "GcadResourceLoader.h"
+#include "GcadResourceManagerStats.h"
 #include "GcadSymbolTST.h"
+#include "GcadThread.h"
 #include "GcadTimeInformation.h"
+#include <algorithm>
 #include <fstream>
+#include <list>
+#include <iterator>
 #include <limits>
 #include <map>
 #include <memory>
 #include <set>
 #include <utility>
-
-/** 
-  @todo Tworzenie sciezek korzysta z stalej doslownej "\\". Dla innych 
-    systemow (np. UNIX) oddzielenie nazwy katalogu wykonuje sie wartoscia
-    "/". Rozwazyc utworzenie nowej klasy hermentyzujacej ta zmiennosc.
-*/
+#include <vector>
 
 namespace Gcad {
 namespace Platform {
@@ -53,6 +61,22 @@ namespace Platform {
       - zautomatyzowanie procesu wyszukiwania zrodel danych (podanie
         nazwy katalogu, od ktorego rozpoczac ma sie przeszukiwanie
         zasobow spelniajacych zadane kryterium)
+      - opcjonalne wczytywanie zasobow w tle (setLoaderThreads, prefetch),
+        bez wstrzymywania watku korzystajacego z menadzera
+      - opcjonalny odczyt plikow odwzorowanych w pamieci (setMappedLoading)
+      - opcjonalne wczytywanie zasobow z archiwum (setResourceArchive)
+      - opcjonalna dyskowa pamiec podreczna przetworzonych zasobow
+        (setProcessedCache)
+      - opcjonalne odswiezanie zasobow po zmianie plikow, bez ponownego
+        przegladania katalogow (setFileWatcher, processFileChanges)
+      - statystyki dzialania (getStatistics): trafienia i chybienia
+        wedlug priorytetow, czasy odczytu i przetwarzania, wielkosci
+        wczytanych i zwolnionych danych, najkosztowniejsze zasoby
+      - opcjonalny wspolny budzet pamieci kilku menadzerow roznych typow
+        zasobow (setMemoryBudget)
+      - opcjonalny dostep wspolbiezny (setConcurrentAccess) - pobieranie
+        uchwytow i dereferencja wczytanych zasobow w wielu watkach bez
+        zajmowania muteksu, oraz jednokrotne wczytanie brakujacego zasobu
 
   @param
     RESOURCE Typ klasy determinujacej wspoldzielony zasob. Jej interfejs 
@@ -67,6 +91,12 @@ namespace Platform {
         jednoargumentowy, wywolywany w trakcie pozyskiwania danych.
         Jego glownym zadaniem (obowiazkiem) jest wczytanie danych zawartych 
         w pliku zasobu agregujacym obiekt typu parametryzowanego RESOURCE
+      - RESOURCE(const Utilities::ByteSpan&) - konstruktor wymagany
+        jedynie w przypadku wywolania setMappedLoading
+      - static RESOURCE* createFromProcessed(const Utilities::ByteSpan&),
+        oraz void writeProcessed(std::ostream&) const - odczyt i zapis
+        przetworzonej postaci zasobu, wymagane jedynie w przypadku
+        wywolania setProcessedCache
   
   @param
     FILE_FORMAT Wewnetrzny format danych pliku zasobu moze byc realizowany
@@ -103,6 +133,43 @@ class DataFileResourceManager : public DataFileResourceManagerBase {
    */
    typedef Utilities::SymbolTST<FILE_FORMAT>  PathToTSTHandle;
    typedef typename PathToTSTHandle::Handle   TSTHandle;
+
+   /**
+     @brief
+       Numer rejestracji posrednika w pozycji tablicy uchwytow TST
+   */
+   typedef unsigned int  Generation;
+
+   /**
+     @brief
+       Obiekt funkcyjny gromadzacy uchwyty zasobow odwiedzanych przez
+       PathToTSTHandle::forEachWithPrefix. Przy ustawionej fladze 
+       directOnly pomijane sa zasoby podkatalogow (pozostalosc sciezki
+       zawiera separator)
+   */
+   class TSTHandleCollector {
+    public:
+      TSTHandleCollector(std::vector<TSTHandle>*  handles,
+                         bool                     directOnly,
+                         char                     separator)
+        : handles_(handles)
+        , directOnly_(directOnly)
+        , separator_(separator)
+      {}
+
+      void operator ()(const typename PathToTSTHandle::String&  suffix,
+                       TSTHandle                                handle)
+      {
+        if( directOnly_ && suffix.find(FILE_FORMAT(separator_)) != suffix.npos )
+          return;
+        handles_->push_back(handle);
+      }
+
+    private:
+      std::vector<TSTHandle>*  handles_;
+      bool                     directOnly_;
+      char                     separator_;
+   };
     
    /**
      @brief
@@ -147,22 +214,34 @@ class DataFileResourceManager : public DataFileResourceManagerBase {
 
       /**
         @brief
-          Wymagany przez standardowy kontener <i>set</i> konstruktor kopiujacy.
+          Wymagany przez standardowy kontener <i>list</i> konstruktor kopiujacy.
           Kompilator nie moze przeprowadzic automatycznej generacji, poniewaz
-          jedna ze skladowych jest typu std::auto_ptr. Semantyka kopiowania
+          posrednik jest wlascicielem obiektu zasobu. Semantyka kopiowania
           tego rodzaju instancji jest rozna od konwencjonalnego, przyjetego
           idiomu kopiowania pobierajacego argument do stalej referencji
+          (obiekt zasobu jest przekazywany kopii)
       */
       SharedResource(const SharedResource& rhs)
         : owner_(rhs.owner_)
         , handle_(rhs.handle_)
         , priority_(rhs.priority_)
-        , resource_(rhs.resource_.release())
-        , lastAccess_(rhs.lastAccess_)
+        , resource_(rhs.resource_)
+        , byteSize_(rhs.byteSize_)
         , referenceCounter_(rhs.referenceCounter_)
+        , pending_(rhs.pending_)
+        , reloading_(rhs.reloading_)
+        , accessStamp_(rhs.accessStamp_)
+        , published_(rhs.published_)
+        , touched_(rhs.touched_)
+        , loading_(rhs.loading_)
       {
+        rhs.resource_ = 0;
       }      
 
+      ~SharedResource() {
+        delete resource_;
+      }
+
       /**
         @brief 
           Zadanie pozyskania zasobu z zewnetrznego zrodla. Operacja wykonuje
@@ -176,6 +255,71 @@ class DataFileResourceManager : public DataFileResourceManagerBase {
       */
       void release() const;
 
+      /**
+        @brief
+          Zadanie wczytania zasobu w tle. Zasob zostaje umieszczony
+          w kolejce puli watkow menadzera, zgodnie ze swoim priorytetem.
+          Bez puli watkow (setLoaderThreads) zasob jest wczytywany
+          natychmiast - tak jak w przypadku acquire()
+      */
+      void requestLoad() const;
+
+      /**
+        @brief
+          Udostepnienie zasobu bez wstrzymywania watku (Handle::tryGet).
+          Zasob nieobecny w pamieci zostaje zlecony do wczytania w tle,
+          a wynikiem jest wartosc zerowa
+      */
+      const RESOURCE* tryGetResource() const;
+
+      /**
+        @brief
+          Przejecie zasobu wczytanego w tle (wywolywane przez menadzer
+          w watku wlasciciela). Jesli zasob zostal w miedzyczasie wczytany
+          synchronicznie, obiekt loaded zostaje zwolniony. Wartosc zerowa
+          oznacza niepowodzenie - kolejne odwolanie ponowi odczyt.
+          Wartosc loadMicroseconds (czas wczytania) trafia do statystyk
+      */
+      void completeLoad(RESOURCE*  loaded,
+                        size_t     loadMicroseconds) const;
+
+      /**
+        @brief
+          Ponowne wczytanie zasobu, ktorego plik zostal zmieniony. Nowy
+          obiekt zastepuje poprzedni dopiero po jego utworzeniu - uchwyty
+          pozostaja wazne i udostepniaja nowa zawartosc. Zasob niewczytany
+          nie wymaga dzialan (kolejne odwolanie odczyta nowa zawartosc)
+
+        @param asynchronous Wczytanie przez pule watkow (o ile istnieje),
+          a zamiana obiektu w chwili odebrania wyniku (completeLoad)
+
+        @return
+          Wartosc false, gdy zasob nie zostal wczytany ponownie
+
+        @exception
+          FailOnResourceAcquireException, oraz wyjatki konstruktora
+          RESOURCE - zasob zachowuje wowczas poprzednia zawartosc
+      */
+      bool reload(bool asynchronous) const;
+
+      /**
+        @brief
+          Utworzenie zasobu z zawartosci pliku odczytanej do pamieci
+          (BatchFileReader). Wymaga konstruktora RESOURCE(std::istream&)
+
+        @exception
+          FailOnResourceAcquireException Plik nie zostal odczytany
+      */
+      void completeRead(const char*  data,
+                        size_t       bytesCount,
+                        bool         succeeded) const;
+
+      /**
+        @brief
+          Porzucenie oczekiwania na wynik wczytywania w tle
+      */
+      void cancelLoad() const;
+
       /**
         @brief
           Inkrementacja licznika odwolan do wspoldzielonego zasobu
@@ -192,11 +336,9 @@ class DataFileResourceManager : public DataFileResourceManagerBase {
         @brief
           Ustalenie priorytetu zasobu
           
-          Poniewaz wartosc priorytetu wplywa na wzgledne polozenie 
-          wewnatrz posortowanej struktury, dlatego w celu zachowania 
-          jej organizacji przeprowadzane sa operacje zapewniajace 
-          spelnienie kryterium zdefiniowanego przez wewnetrzna strukture
-          organizacyjna menadzera
+          Kazdy priorytet posiada wlasna liste zasobow uszeregowanych
+          wedlug czasu ostatniego dostepu. Zmiana priorytetu przenosi
+          zasob na koniec (najswiezsza pozycja) listy nowego priorytetu
       */
       void setPriority(ResourcePriority priority) const;
       
@@ -227,16 +369,6 @@ class DataFileResourceManager : public DataFileResourceManagerBase {
       */
       bool isShared() const;
 
-      /**
-        @brief
-          Kryterium sortowania wykorzystywane przez menadzer. Instancje
-          reprezentujace wspoldzielone zasoby sa sortowane w pierwszej
-          kolejnosci wedlug priorytetow, a w przypadku gdy obie strony
-          relacji maja rowny priorytet - na podstawie wartosci okreslajacej
-          czas ostatniego dostepu do zasobu
-      */
-      bool operator <(const SharedResource& rhs) const;
-
       /**
         @brief
           Udostepnienie rzeczywistego zasobu
@@ -250,7 +382,6 @@ class DataFileResourceManager : public DataFileResourceManagerBase {
       */
       TSTHandle getTstHandle() const;
 
-    private:
       /**
         @brief
           Uzyskanie informacji na temat aktualnego stanu rzeczywistego 
@@ -259,6 +390,64 @@ class DataFileResourceManager : public DataFileResourceManagerBase {
       */
       bool isLoaded() const;
 
+      /**
+        @brief
+          Zasob wczytany i udostepniony watkom - odczyt nie wymaga
+          muteksu (tryb wspolbiezny menadzera)
+      */
+      bool isPublished() const;
+
+      /**
+        @brief
+          Rejestracja odwolania do zasobu udostepnionego, wykonanego bez
+          muteksu (tryb wspolbiezny menadzera) - trafienie w statystykach
+          i zaznaczenie posrednika (takeTouched)
+      */
+      void touchShared() const;
+
+      /**
+        @brief
+          Pobranie i wyzerowanie znacznika odwolania wykonanego bez
+          muteksu (tryb wspolbiezny menadzera)
+      */
+      bool takeTouched() const;
+
+      /**
+        @brief
+          Przygotowanie zwolnienia zasobu z braku pamieci. Wartosc false
+          oznacza, ze w miedzyczasie inny watek pobral uchwyt zasobu
+          - zasob nie moze wowczas zostac zwolniony
+      */
+      bool prepareEviction() const;
+
+      /**
+        @brief
+          Zasob oczekuje na wczytanie przez pule watkow
+      */
+      bool isPending() const;
+
+      /**
+        @brief
+          Wielkosc wczytanego zasobu doliczona do pamieci menadzera
+          (wartosc zerowa, gdy zasob nie znajduje sie w pamieci)
+      */
+      size_t getLoadedByteSize() const;
+
+      /**
+        @brief
+          Znacznik ostatniego odwolania nadany przez wspolny budzet
+          pamieci (MemoryBudget) - bez budzetu wartosc zerowa
+      */
+      AccessStamp getAccessStamp() const { return accessStamp_; }
+      void setAccessStamp(AccessStamp stamp) const { accessStamp_ = stamp; }
+
+      /**
+        @brief
+          Sciezka pliku zasobu (katalog, separator, nazwa pliku)
+      */
+      std::string getFilePath() const;
+
+    private:
       /**
         @brief
           Metoda wykonujaca wczytanie zasobu z zewnetrznego zrodla. Jest ona
@@ -267,16 +456,81 @@ class DataFileResourceManager : public DataFileResourceManagerBase {
       */
       void update() const;
 
+      /**
+        @brief
+          Synchroniczne wczytanie (badz ponowne wczytanie) zasobu,
+          wraz z rejestracja wyniku w statystykach menadzera
+
+        @exception
+          FailOnResourceAcquireException, oraz wyjatki konstruktora
+          RESOURCE
+      */
+      void load() const;
+
+      /**
+        @brief
+          Wczytanie zasobu w trybie wspolbieznym (muteks menadzera zajety).
+          Zasob jest wczytywany przez jeden watek, bez zajetego muteksu,
+          a pozostale watki oczekuja na zakonczenie wczytywania
+
+        @exception
+          FailOnResourceAcquireException, oraz wyjatki konstruktora
+          RESOURCE
+      */
+      void acquireShared() const;
+
+      /**
+        @brief
+          Ustalenie obiektu zasobu utworzonego przez createResource,
+          wraz z rejestracja wyniku w statystykach menadzera
+      */
+      void finishLoad(RESOURCE*  loaded,
+                      size_t     readMicroseconds,
+                      size_t     parseMicroseconds) const;
+
+      /**
+        @brief
+          Utworzenie zasobu z pliku (badz wpisu archiwum). Gdy
+          reserveMemory, przed odczytem menadzer zwalnia pamiec na dane
+          o wielkosci pliku. Metoda nie modyfikuje stanu menadzera
+          (poza zwolnieniem pamieci), wiec w trybie wspolbieznym moze
+          byc wywolywana bez zajetego muteksu
+
+        @exception
+          FailOnResourceAcquireException
+      */
+      RESOURCE* createResource(size_t*  readMicroseconds,
+                               size_t*  parseMicroseconds,
+                               bool     reserveMemory) const;
+
+      /**
+        @brief
+          Zastapienie (badz ustalenie) obiektu zasobu obiektem loaded,
+          wraz z rozliczeniem pamieci menadzera
+      */
+      void install(RESOURCE* loaded) const;
+
     private:
-      typedef unsigned int             RefCounter;
+      typedef long                     RefCounter;
       typedef std::auto_ptr<RESOURCE>  ResourceAutoPtr;
 
       DataFileResourceManager&  owner_;         /**< Wlasciciel zasobu */
       TSTHandle                 handle_;        /**< Uchwyt okreslajacy zrodlo */
       mutable ResourcePriority  priority_;      /**< Priorytet zasobu */
-      mutable ResourceAutoPtr   resource_;      /**< Odwolanie do zasobu */
-      mutable size_t            lastAccess_;    /**< Czas ostatniego dostepu */
-      mutable RefCounter        referenceCounter_; /**< Licznik odwolan zasobu */
+      mutable RESOURCE* volatile  resource_;    /**< Odwolanie do zasobu (wlasnosc;
+                                                     zapis pojedyncza operacja,
+                                                     patrz install) */
+      mutable size_t            byteSize_;      /**< Wielkosc wczytanego zasobu */
+      mutable volatile RefCounter  referenceCounter_; /**< Licznik odwolan 
+                                                          (operacje atomowe) */
+      mutable bool              pending_;       /**< Oczekiwanie na wczytanie w tle */
+      mutable bool              reloading_;     /**< Wynik wczytywania w tle 
+                                                     zastepuje wczytany zasob */
+      mutable AccessStamp       accessStamp_;   /**< Ostatnie odwolanie (budzet) */
+      mutable volatile long     published_;     /**< Zasob udostepniony watkom */
+      mutable volatile long     touched_;       /**< Odwolanie bez muteksu 
+                                                     (operacje atomowe) */
+      mutable bool              loading_;       /**< Wczytywanie w innym watku */
    };
 
  public:  
@@ -335,6 +589,16 @@ class DataFileResourceManager : public DataFileResourceManagerBase {
       const SharedResource& dereferenceResource() const;
   
     public:
+      /**
+        @brief
+          Uchwyt wskazuje zarejestrowany zasob. Uchwyt staje sie niewazny
+          po usunieciu posrednika (purgeAll) - dereferencja niewaznego
+          uchwytu jest bledem (asercja), a jego zniszczenie jest bezpieczne
+      */
+      bool isValid() const {
+        return owner_.findResourcePtr(handle_, generation_) != 0;
+      }
+
       /**
         @brief
           Konstruktor kopiujacy umozliwia poprawne kopiowanie obiektow
@@ -344,21 +608,31 @@ class DataFileResourceManager : public DataFileResourceManagerBase {
       Handle(const Handle& handle)
         : owner_(handle.owner_)
         , handle_(handle.handle_)
+        , generation_(handle.generation_)
       {
         dereferenceResource().increaseRef();
       }
       
       ~Handle() {
-        dereferenceResource().decreaseRef();
+        const SharedResource* resource = 
+          owner_.findResourcePtr(handle_, generation_);
+        if( resource != 0 )
+          resource->decreaseRef();
       }      
       
-      Handle operator =(const& rhs) {
-        dereferenceResource().decreaseRef();
-        handle_ = rhs.handle_;
-        dereferenceResource().increaseRef();
+      Handle& operator =(const Handle& rhs) {
+        rhs.dereferenceResource().increaseRef();
+        const SharedResource* resource = 
+          owner_.findResourcePtr(handle_, generation_);
+        if( resource != 0 )
+          resource->decreaseRef();
+        handle_     = rhs.handle_;
+        generation_ = rhs.generation_;
+        return *this;
       }      
 
       void setPriority(ResourcePriority priority) {
+        ConcurrentLock lock(owner_);
         dereferenceResource().setPriority(priority);
       }
 
@@ -374,15 +648,48 @@ class DataFileResourceManager : public DataFileResourceManagerBase {
         return &dereferenceResource().getResource(); 
       }
 
+      /**
+        @brief
+          Zasob znajduje sie w pamieci - dereferencja nie wymaga odczytu
+      */
+      bool isReady() const {
+        return dereferenceResource().isPublished();
+      }
+
+      /**
+        @brief
+          Zasob oczekuje na wczytanie przez pule watkow menadzera
+      */
+      bool isPending() const {
+        return dereferenceResource().isPending();
+      }
+
+      /**
+        @brief
+          Dereferencja nie wstrzymujaca watku. Jesli zasob nie znajduje
+          sie w pamieci, zostaje zlecone jego wczytanie w tle, a wynikiem
+          jest wartosc zerowa. Zasob staje sie dostepny po odebraniu
+          wynikow przez DataFileResourceManager::processCompletedLoads()
+
+        @remark
+          Bez puli watkow (setLoaderThreads) zasob jest wczytywany
+          natychmiast, a wynik nie jest zerowy
+      */
+      const RESOURCE* tryGet() const;
+
     private:
       // Obiekt uchwytu (wartosc handle_) wprowadza potrzebna warstwe 
       // abstrakcji. Rozwiazanie to umozliwia menadzerowi wykonywanie
       // wewnetrznych operacji, nie majacych oddzwieku w zewnetrznych
       // referencjach (uchwytach Handle). Uzyskana elastycznosc jest
       // podstawa koncepcji, na ktorej opiera sie zarzadca
+      // Dereferencja jest odwolaniem do tablicy posrednikow (indeks -
+      // uchwyt TST). Pokolenie pozycji tablicy pozwala wykryc uchwyt
+      // zasobu usunietego, ktorego pozycje zajal pozniej inny zasob
 
       DataFileResourceManager&  owner_;
-      TSTHandle                 handle_;                                               
+      TSTHandle                 handle_;
+      Generation                generation_;  /**< Pokolenie pozycji posrednika */
    };
 
  public:
@@ -395,11 +702,19 @@ class DataFileResourceManager : public DataFileResourceManagerBase {
      
      @remark
        Domyslna wartoscia determinujaca maksymalny rozmiar pamieci
-       mozliwy do wykorzystania jest jeden megabajt
+       mozliwy do wykorzystania jest jeden megabajt. Sciezki zasobow
+       tworzone sa z separatorem enumeratora (getPathSeparator)
    */
    DataFileResourceManager(DriveElementsEnumerator* fileEnumerator,
                            TimeInformation*         timer);
 
+   /**
+     @brief
+       Zwolnienie obiektow zasobow zastapionych w trybie wspolbieznym
+       (releaseRetiredResources)
+   */
+   ~DataFileResourceManager();
+
    /**
      @brief
        Zwrocenie informacji oznajmujacej ilosc zasobow znajdujacych
@@ -407,7 +722,7 @@ class DataFileResourceManager : public DataFileResourceManagerBase {
        znajdowac sie w pamieci, dokladniej - wartosc rezultatu dzialania 
        funkcji determinuje sume wszystkich obiektow posrednikow
    */
-   size_t resourcesCount() const { return resources_.size(); }
+   size_t resourcesCount() const { return resourcesCount_; }
 
    /**
      @brief
@@ -428,6 +743,15 @@ class DataFileResourceManager : public DataFileResourceManagerBase {
      @brief
        Ustalenie maksymalnej granicy wielkosci obszaru pamieci 
        udostepnionej zasobom danego typu RESOURCE
+
+       Obnizenie granicy ponizej aktualnie wykorzystywanego obszaru
+       powoduje natychmiastowe zwolnienie nieuzywanych zasobow
+
+     @remark
+       Menadzer dolaczony do wspolnego budzetu pamieci (setMemoryBudget)
+       korzysta jedynie z granicy budzetu
+
+     @see releaseMemory()
    */
    void setMemoryMaximum(size_t memorySize);
 
@@ -438,6 +762,54 @@ class DataFileResourceManager : public DataFileResourceManagerBase {
    */
    size_t getMemoryMaximum() const;
 
+   /**
+     @brief
+       Suma wielkosci (RESOURCE::getByteSize()) aktualnie wczytanych zasobow
+   */
+   size_t getUsedMemory() const { return usedMemory_; }
+
+   /**
+     @brief
+       Migawka statystyk menadzera. Wywolanie kopiuje jedynie stan
+       licznikow (bez przegladania zasobow), wiec moze byc wykonywane
+       okresowo, np. w celu eksportu (operator <<)
+   */
+   ResourceManagerStats getStatistics() const;
+
+   /**
+     @brief
+       Wyzerowanie statystyk (np. na poczatku wczytywania poziomu)
+   */
+   void resetStatistics() { statistics_.reset(); }
+
+   /**
+     @brief
+       Wlaczenie trybu dostepu wspolbieznego. Wowczas wiele watkow moze
+       jednoczesnie: pobierac uchwyty (getResource), kopiowac je i niszczyc
+       (atomowe liczniki odwolan), wykonywac dereferencje (rowniez
+       tryGet i prefetch), oraz zmieniac priorytety zasobow. Dereferencja
+       zasobu obecnego w pamieci nie zajmuje muteksu. Brakujacy zasob
+       jest wczytywany jednokrotnie - pozostale watki oczekuja na wynik
+       (tryGet zwraca wartosc zerowa). Wyniki puli watkow odbiera
+       dowolny watek (processCompletedLoads). Obiekt zastapiony przez
+       ponowne wczytanie zasobu, do ktorego istnieja uchwyty, pozostaje
+       w pamieci (poza getUsedMemory) do chwili ich zniszczenia
+
+     @remark
+       Pozostale operacje (wyszukiwanie i usuwanie zasobow, zmiana
+       katalogow, ustawienia menadzera, processFileChanges) wymagaja
+       wylacznego dostepu - zaden inny watek nie moze wowczas korzystac
+       z menadzera, ani z jego uchwytow. Tryb nie obejmuje wspolnego
+       budzetu pamieci (MemoryBudget). Trafienia dereferencji bez
+       muteksu sa zliczane atomowo w segmentach poszczegolnych watkow
+       (getStatistics). Kolejnosc zwalniania
+       zasobow jest przyblizona - odwolania bez muteksu przesuwaja
+       posrednika na koniec listy dopiero w chwili zwalniania pamieci
+   */
+   void setConcurrentAccess(bool enabled) { concurrent_ = enabled; }
+
+   bool isConcurrentAccess() const { return concurrent_; }
+
    /**
      @brief
        Przekazanie informacji sciezki poszukiwania ewentualnych plikow 
@@ -518,9 +890,33 @@ class DataFileResourceManager : public DataFileResourceManagerBase {
 
    /**
      @brief
+       Wczytanie zasobow poddrzewa katalogow (loadResourcesFromTree), 
+       a nastepnie pozyskanie danych wszystkich zasobow zarejestrowanych
+       w tym poddrzewie. Zasoby sa wyszukiwane przedrostkiem sciezki
+       w drzewie TST - bez przegladania calego zbioru posrednikow
    */
    void acquireResourcesFromTree(const std::string& path);
 
+   /**
+     @brief
+       Wariant pozyskania zasobow poddrzewa, w ktorym pliki wszystkich
+       niewczytanych zasobow sa zlecane czytnikowi reader jedna partia
+       (np. io_uring - createBatchFileReader). Zasoby sa tworzone
+       w watku wywolujacym, w kolejnosci zakonczenia odczytu plikow,
+       rownolegle z odczytem pozostalych
+
+     @remark
+       Klasa RESOURCE musi udostepniac konstruktor RESOURCE(std::istream&),
+       gdyz dane sa przekazywane strumieniem Utilities::MemoryInputStream.
+       Zasoby oczekujace na wczytanie w tle rowniez zostaja wczytane
+
+     @exception
+       FailOnResourceAcquireException Blad odczytu pliku zasobu (pozostale
+       pliki partii sa porzucane)
+   */
+   void acquireResourcesFromTree(const std::string&  path,
+                                 BatchFileReader&    reader);
+
    /**
      @brief
    */
@@ -535,6 +931,8 @@ class DataFileResourceManager : public DataFileResourceManagerBase {
 
    /**
      @brief
+       Zwolnienie pamieci przydzielonej zasobom znajdujacym sie
+       w poddrzewie katalogow o korzeniu path
    */
    void releaseResourcesFromTree(const std::string& path);
 
@@ -556,610 +954,2506 @@ class DataFileResourceManager : public DataFileResourceManagerBase {
    */
    void purgeAll();
 
- private:
-   void insertResource(const SharedResource& resource);
-   void removeResource(const SharedResource& resource);
+   /**
+     @brief
+       Ustalenie liczby watkow wczytujacych zasoby w tle. Wartosc zerowa
+       (domyslna) wylacza wczytywanie w tle - zasoby sa wczytywane
+       w chwili pierwszego odwolania, w watku klienta
 
- private:
-   // Trzy glowne typy zewnetrznie utworzonych instancji. Hermetyzacja ich
-   // zachowan sprzyja latwej wymianie podczas przenoszenia kodu na inne
-   // platformy, oraz podczas jego rozwijania - za sprawa instancji typu
-   // ResourceManage. Kolejno, instancja pierwszego typu odpowiada za
-   // wyliczenie elementow wchodzacych w sklad struktury katalogow/plikow
-   // o korzeniu zadanym przez klienta. Drugi obiekt obsluguje zadania 
-   // dotyczace aktualnego czasu systemowego, ktorego wartosc sluzy jako
-   // kryterium podczas organizowania obiektow posredniczacych w dostepie
-   // do zasobow. Trzeci zewnetrzny obiekt jest zdefiniowany na potrzeby
-   // przyszlych implementacji, korzystajacych z zarzadcy. Dzieki 
-   // przedefiniowaniu bazowego interfejsu dostajemy mozliwosc wprowadzania
-   // wlasnych rozszezen, podczas operacji takich jak: pozyskiwanie, ladowanie,
-   // zwalnianie, usuwanie zasobu. Udostepniona funkcjonalnosc tego rodzaju 
-   // moze okazac sie pomocna podczas przeprowadzania pierwotnej inicjalizacji
-   // zasobow. Dla zobrazowania mozna wykorzystac sytuacje wczytywania danych 
-   // danego poziomu gry. Informacje na temat aktualnie wczytywanych zasobow
-   // wyswietlane sa poprzez obiekt realizujacy interfejs.
+       Zmiana liczby watkow porzuca zadania oczekujace w kolejkach
+       (zasoby zostana wczytane przy kolejnym odwolaniu)
 
-   typedef std::auto_ptr<DriveElementsEnumerator> DriveElementsEnumeratorAutoPtr;
-   typedef std::auto_ptr<TimeInformation>         TimeInformationAutoPtr;
-   typedef std::auto_ptr<ResourceManage>          ResourceManageAutoPtr;
+     @exception
+       ThreadException Niepowodzenie utworzenia watku
+   */
+   void setLoaderThreads(unsigned int threadsCount);
 
-   DriveElementsEnumeratorAutoPtr  elementsEnum_;
-   TimeInformationAutoPtr          timeInformation_;
-   ResourceManageAutoPtr           resourceManage_;
-   
- private:
-   // Kolejne definicje synonimow zostaly pogrupowane wedlug kryterium 
-   // realacji miedzy nimi zawartych. Obiekty pierwszego zbioru wchodza
-   // w sklad zakresu okreslajacego dostepne katalogi, ktore brane sa podczas 
-   // rozrozstrzygania dopasowania zasobu do zadanego identyfikatora, oraz
-   // w czasie ladowania wszystkich zasobow (sa to funkcje getResource, oraz
-   // loadResources).
-   // Obiekt nastepnego w kolejnosci typu - ResourcesSet - jest odpowiedzialny
-   // za przechowywanie obiektow posrednikow. Kryterium ich sortowania jest
-   // zdeterminowane poprzez metode operator< znajdujaca sie w zakresie 
-   // klasy SharedResource. Kontener asocjacyjny zapewnia prawidlowa organizacje
-   // elementow, ktora jest podstawa dzialania menadzera, przejawiajaca sie
-   // uszeregowaniem zasobow od najzadziej do najczesciej uzywanego, lacznie
-   // z uwzglednieniem wartosci priorytetu
-   // W sklad trzeciego zestawu wchodza typy, ktore determinuja zrodlo zasobu
-   // w postaci sciezki dostepu (para katalog, nazwa pliku)
-   // Typ TSTHandleToPath, oraz skojarzony z nim iterator odwzorowuja
-   // zadany uchwyt (instancja typu zdefiniowanego w klasie struktury drzewa 
-   // TST) na sciezke katalogow zasobu, ktory jest identyfikowany wartoscia 
-   // uchwytu
-   // Ostatnie odwzorowanie umozliwia pobranie adresu instancji posrednika
-   // bedac w posiadaniu uchwytu TST sprzezonego z danym zasobem
+   /**
+     @brief
+       Liczba watkow wczytujacych zasoby w tle
+   */
+   unsigned int getLoaderThreads() const;
 
-   typedef std::string              DirectoryName;
-   typedef std::set<DirectoryName>  Directories;
-   typedef Directories::iterator    DirectoriesItor;
-   
-   typedef std::set<SharedResource>         ResourcesSet;
-   typedef typename ResourcesSet::iterator  ResourcesSetItor;
+   /**
+     @brief
+       Pobranie uchwytu zasobu (jak getResource), oraz zlecenie jego
+       wczytania w tle. Stan wczytywania udostepniaja metody
+       Handle::isReady(), Handle::isPending() i Handle::tryGet()
 
-   typedef std::string                      FileName;
-   typedef std::string                      Directory;
-   typedef std::pair<Directory, FileName>   Path;
+     @exception
+       ResourceFileIdAmbiguous
+   */
+   Handle prefetch(const std::string& fileName);
 
-   typedef std::map<TSTHandle, Path>             TSTHandleToPath;
-   typedef typename TSTHandleToPath::iterator    TSTHandleToPathItor;
-   typedef typename TSTHandleToPath::value_type  TSTHandleToPathValueType;
-   
-   typedef std::map<TSTHandle, const SharedResource*>  TSTHandleToShrRes;
-   typedef typename TSTHandleToShrRes::iterator        TSTHandleToShrResItor;
+   /**
+     @see
+       Handle prefetch(const std::string& fileName)
+   */
+   Handle prefetch(const std::string& fileName,
+                   const std::string& directory);
 
-   typedef std::auto_ptr<ElementMatcher>  ElementMatcherAutoPtr;
-   
-   size_t  maxMemory_;     /**< Maksymalny dostepny rozmiar pamieci */
-   size_t  usedMemory_;    /**< Aktualnie wykorzystywany obszar pamieci */
-   
-   Directories   searchDir_;  /**< Katalogi wykorzystywane podczas dopasowania */
-   ResourcesSet  resources_;  /**< Zestaw posrednikow zasobow */
-   
-   PathToTSTHandle    pathToTSTHandle_;   /**< Sciezka zasobu na uchwyt TST */
-   TSTHandleToShrRes  tstHandleToShrRes_; /**< Uchwyt TST na posrednika zasobu */
-   TSTHandleToPath    tstHandleToPath_;   /**< Odwzorowanie uchwytu struktury 
-                                               trynarnej na sciezke zasobu */
+   /**
+     @brief
+       Odebranie zasobow wczytanych w tle i udostepnienie ich uchwytom.
+       Metoda powinna byc wywolywana cyklicznie (np. raz na klatke)
+       w watku korzystajacym z menadzera. Gdy zadne wczytywanie sie
+       nie zakonczylo, koszt wywolania ogranicza sie do odczytu licznika
+       - muteks puli nie jest zajmowany
+
+     @return
+       Liczba odebranych wynikow (wraz z nieudanymi)
+   */
+   size_t processCompletedLoads();
 
-   ElementMatcherAutoPtr  elementMatcher_; /**< Kryterium wykorzystywane podczas
-                                                proby pobrani zasobu */
+   /**
+     @brief
+       Oczekiwanie na wczytanie wszystkich zleconych zasobow i ich
+       odebranie (np. na zakonczenie ekranu ladowania poziomu)
+   */
+   void finishPendingLoads();
 
- private:
-   bool isDirectoryValid( const DriveElementsEnumerator::ItorAutoPtr& elemItor );
+   /**
+     @brief
+       Liczba zasobow oczekujacych na wczytanie w tle, badz wczytywanych
+   */
+   size_t pendingLoadsCount() const;
 
- private:
-   // Nie zdefiniowane
-   DataFileResourceManager(const DataFileResourceManager&);
-   DataFileResourceManager& operator =(const DataFileResourceManager&);   
-};
+   /**
+     @brief
+       Wlaczenie odczytu zasobow z plikow odwzorowanych w pamieci
+       (Platform::MappedFile). Konstruktor RESOURCE(const ByteSpan&)
+       parsuje dane bezposrednio ze stron pamieci podrecznej systemu
+       plikow - bez kopiowania pliku do buforow procesu, a strony sa
+       wspoldzielone przez wszystkie procesy wczytujace ten sam plik.
+       Ustawienie dotyczy rowniez wczytywania w tle, oraz odczytu
+       wsadowego (dane sa wowczas przekazywane jako widok bufora)
 
-//
-template<typename RESOURCE, typename FILE_FORMAT>
-DataFileResourceManager<RESOURCE, FILE_FORMAT>::SharedResource
-::SharedResource(DataFileResourceManager&  owner,
+     @remark
+       Metoda wymaga konstruktora RESOURCE(const Utilities::ByteSpan&).
+       Typy zasobow bez niego moga byc zarzadzane, o ile metoda nie jest
+       wywolywana (szablon nie jest konkretyzowany)
+   */
+   void setMappedLoading(bool enabled);
+
+   /**
+     @brief
+       Informacja, czy zasoby sa wczytywane z plikow odwzorowanych w pamieci
+   */
+   bool isMappedLoading() const;
+
+   /**
+     @brief
+       Ustalenie archiwum (AssetPack, QuakePak), z ktorego wczytywane sa
+       dane zasobow (0 - pliki). Sciezka zasobu (katalog + separator + plik)
+       jest nazwa wpisu archiwum, wiec zasoby rejestruje sie jak zwykle
+       (loadResourcesFromTree), korzystajac z enumeratora
+       ArchiveElementsEnumerator. Wczytanie zasobu nie wykonuje wywolan
+       systemowych - dane sa parsowane wprost z odwzorowania archiwum
+       (konstruktorem RESOURCE(const ByteSpan&), gdy wlaczono
+       setMappedLoading, w przeciwnym razie RESOURCE(std::istream&)).
+       Odczyt wsadowy (acquireResourcesFromTree z czytnikiem) nie korzysta
+       wowczas z czytnika
+
+     @remark
+       Menadzer nie przejmuje archiwum na wlasnosc - musi ono pozostac
+       otwarte do czasu zakonczenia zadan wczytywania w tle. Brak wpisu
+       w archiwum jest zglaszany jako FailOnResourceAcquireException
+       podczas pozyskania zasobu
+   */
+   void setResourceArchive(const ResourceArchive* archive);
+
+   /**
+     @brief
+       Archiwum ustalone metoda setResourceArchive (0 - brak)
+   */
+   const ResourceArchive* getResourceArchive() const { return archive_; }
+
+   /**
+     @brief
+       Ustalenie pamieci podrecznej przetworzonych zasobow (0 - brak).
+       Zasob jest tworzony z wpisu o kluczu rownym skrotowi zawartosci
+       pliku (RESOURCE::createFromProcessed), z pominieciem kosztownego
+       przetwarzania (np. obliczania normalnych modeli MD2). Brakujacy
+       wpis jest zapisywany (RESOURCE::writeProcessed) po utworzeniu
+       zasobu z pliku. Zmiana zawartosci pliku zmienia klucz, wiec
+       nieaktualne wpisy nigdy nie sa odczytywane
+
+     @remark
+       Plik zrodlowy jest wowczas zawsze odczytywany przez odwzorowanie
+       (skrot wymaga jego calej zawartosci). Menadzer nie przejmuje
+       pamieci podrecznej na wlasnosc. Metoda wymaga wymienionych
+       w opisie klasy metod RESOURCE - typy zasobow bez nich moga byc
+       zarzadzane, o ile metoda nie jest wywolywana
+   */
+   void setProcessedCache(const ProcessedCache* cache);
+
+   /**
+     @brief
+       Pamiec podreczna ustalona metoda setProcessedCache (0 - brak)
+   */
+   const ProcessedCache* getProcessedCache() const 
+   { 
+     return decoding_.cache_; 
+   }
+
+   /**
+     @brief
+       Ustalenie obserwatora zmian plikow (0 - brak, np. createFileWatcher()
+       na platformie bez obserwacji). Menadzer przejmuje obiekt na wlasnosc
+       i obserwuje nim wszystkie katalogi wyszukiwania zasobow
+       (setResourcesSearchDir - rowniez ustalane przez loadResourcesFromDir
+       i loadResourcesFromTree)
+   */
+   void setFileWatcher(FileWatcher* watcher);
+
+   /**
+     @brief
+       Odebranie zmian plikow obserwowanych katalogow i ich zastosowanie,
+       bez przegladania katalogow i bez zwalniania pozostalych zasobow:
+         - zmieniony plik zarejestrowanego zasobu - zasob wczytany jest
+           wczytywany ponownie (SharedResource::reload), a uchwyty
+           klientow udostepniaja nowa zawartosc
+         - nowy plik spelniajacy kryterium (ElementMatcher) - rejestracja
+           posrednika, jak w przypadku loadResourcesFromDir
+         - nowy podkatalog - rejestracja jego zasobow (loadResourcesFromTree)
+           i obserwacja katalogu
+         - usuniety plik - zwolnienie danych zasobu, o ile klient nie
+           posiada uchwytow (w przeciwnym razie zasob zachowuje ostatnia
+           zawartosc). Posrednik pozostaje zarejestrowany, wiec uchwyty
+           pozostaja wazne
+       Metoda powinna byc wywolywana cyklicznie (np. raz na klatke)
+       w watku korzystajacym z menadzera
+
+     @param asynchronous Ponowne wczytanie zasobow przez pule watkow
+       (setLoaderThreads). Nowa zawartosc staje sie dostepna po odebraniu
+       wynikow (processCompletedLoads) - do tego czasu uchwyty udostepniaja
+       poprzednia. Zasoby oczekujace juz na wczytanie w tle sa wczytywane
+       natychmiast, gdyz zlecony odczyt mogl poprzedzic zmiane pliku
+
+     @remark
+       Wskazniki i referencje uzyskane operatorami uchwytu (*, ->) przed
+       wywolaniem metody moga zostac uniewaznione - uchwyty pozostaja
+       wazne. Plik, ktorego nowej zawartosci nie udalo sie wczytac (np.
+       blad formatu), nie zmienia zasobu. Zmiany sa pomijane, gdy zasoby
+       sa wczytywane z archiwum (setResourceArchive)
+
+     @return
+       Liczba zasobow wczytanych ponownie (badz zleconych), 
+       zarejestrowanych i zwolnionych
+   */
+   size_t processFileChanges(bool asynchronous = false);
+
+ private:
+   /**
+     @brief
+       Rejestracja posrednika na koncu listy jego priorytetu. Jezeli
+       uchwyt TST posiada juz posrednika, zwracany jest istniejacy obiekt
+   */
+   const SharedResource& insertResource(const SharedResource& resource);
+
+   /**
+     @brief
+       Zwolnienie zasobow, az do uzyskania miejsca na bytesNeeded bajtow
+       w granicy okreslonej przez setMemoryMaximum
+
+       Zwalniane sa jedynie zasoby wczytane, do ktorych klient nie posiada
+       uchwytow (SharedResource::isShared), w kolejnosci: od najnizszego
+       priorytetu, a w ramach priorytetu od najdawniej uzywanego. Zasob
+       keep (wlasnie wczytywany) nie jest zwalniany
+
+     @remark
+       Menadzer dolaczony do wspolnego budzetu pamieci przekazuje zadanie
+       budzetowi, ktory zwalnia zasoby wszystkich dolaczonych menadzerow
+
+     @remark
+       Gdy wszystkie zasoby sa wspoldzielone, granica moze zostac
+       przekroczona - wczytanie zasobu nie konczy sie bledem
+   */
+   void releaseMemory(size_t bytesNeeded, const SharedResource* keep);
+
+   /**
+     @brief
+       Zwolnienie zasobu z braku pamieci (powiadomienie ResourceManage)
+   */
+   void evictResource(const SharedResource& resource);
+
+   /**
+     @brief
+       Przeniesienie posrednika wczytanego zasobu na koniec listy jego
+       priorytetu. Zmienna reloaded okresla, czy zasob byl juz wczytany
+       (posrednik znajduje sie wowczas na liscie priorytetu)
+   */
+   void resourceLoaded(const SharedResource& resource, bool reloaded);
+
+   /**
+     @brief
+       Przeniesienie posrednika zwolnionego zasobu do listy zasobow
+       niewczytanych
+   */
+   void resourceReleased(const SharedResource& resource);
+
+   /**
+     @brief
+       Pierwszy (najdawniej uzywany) zasob listy priorytetu priority,
+       ktory moze zostac zwolniony - wczytany, niewspoldzielony i rozny
+       od keep. Wartosc zerowa, gdy takiego zasobu brak
+   */
+   const SharedResource* findOldestEvictable(ResourcePriority  priority,
+                                             const void*       keep) const;
+
+   // Interfejs wspolnego budzetu pamieci (DataFileResourceManagerBase)
+
+   virtual size_t getBudgetedMemory() const;
+
+   virtual bool findEvictable(ResourcePriority  priority,
+                              const void*       keep,
+                              AccessStamp*      stamp) const;
+
+   virtual void evictOldest(ResourcePriority  priority,
+                            const void*       keep);
+
+   /**
+     @brief
+       Przeniesienie posrednika na koniec listy jego priorytetu
+       (najswiezej uzyty zasob)
+   */
+   void touchResource(TSTHandle handle);
+
+   /**
+     @brief
+       Przeniesienie posrednika, ktorego priorytet zostal zmieniony,
+       z listy priorytetu previous na koniec listy biezacego priorytetu
+   */
+   void moveResource(TSTHandle handle, ResourcePriority previous);
+
+   /**
+     @brief
+       Posrednik zasobu o zadanym uchwycie TST, badz wartosc 0
+   */
+   const SharedResource* findResourcePtr(TSTHandle handle) const;
+
+   /**
+     @brief
+       Posrednik zasobu o zadanym uchwycie TST (musi istniec)
+   */
+   const SharedResource& findResource(TSTHandle handle) const;
+
+   /**
+     @brief
+       Posrednik zasobu o zadanym uchwycie TST zarejestrowany jako
+       pokolenie generation, badz wartosc 0 (uchwyt niewazny)
+   */
+   const SharedResource* findResourcePtr(TSTHandle   handle,
+                                         Generation  generation) const;
+
+   /**
+     @brief
+       Ustalenie sciezki zasobu o zadanym uchwycie TST
+   */
+   void setResourcePath(TSTHandle           handle,
+                        const std::string&  directory,
+                        const std::string&  fileName);
+
+   /**
+     @brief
+       Uchwyty TST zasobow zarejestrowanych w katalogu path (directOnly
+       rowne true), badz w calym jego poddrzewie
+   */
+   void collectTSTHandles(const std::string&       path,
+                          bool                     directOnly,
+                          std::vector<TSTHandle>*  handles) const;
+
+   /**
+     @brief
+       Zlecenie wczytania zasobu puli watkow (musi istniec). Wartosc
+       false oznacza brak wpisu w archiwum zasobow - zadanie nie zostaje
+       zlecone
+   */
+   bool enqueueLoad(TSTHandle                handle,
+                    const std::string&       path,
+                    ResourcePriority         priority);
+
+   /**
+     @brief
+       Separator sciezek enumeratora przekazanego konstruktorowi. Wymagany
+       jest enumerator - w przeciwnym razie (kompilacja bez asercji)
+       zwracany jest domyslny separator '\\'
+   */
+   static char pathSeparatorOf(const DriveElementsEnumerator* fileEnumerator);
+
+   /**
+     @brief
+       Utworzenie zasobu z widoku bajtow (setMappedLoading)
+   */
+   static RESOURCE* createFromSpan(const Utilities::ByteSpan& bytes);
+
+   /**
+     @brief
+       Utworzenie zasobu z wpisu pamieci podrecznej (setProcessedCache)
+   */
+   static RESOURCE* createFromProcessed(const Utilities::ByteSpan& processed);
+
+   /**
+     @brief
+       Zapis przetworzonego zasobu do wpisu pamieci podrecznej
+   */
+   static void writeProcessed(const RESOURCE&  resource,
+                              std::ostream&    output);
+
+   /**
+     @brief
+       Liczba mikrosekund, ktore uplynely od chwili *time (wartosc
+       getSystemTime), po czym *time przyjmuje wartosc biezaca. Bez
+       zrodla czasu wynik jest zerowy
+   */
+   size_t measureElapsed(size_t* time) const;
+
+   /**
+     @brief
+       Przeniesienie posrednikow, do ktorych odwolano sie bez muteksu
+       (tryb wspolbiezny), na koniec list ich priorytetow
+   */
+   void applyDeferredTouches();
+
+   /**
+     @brief
+       Zwolnienie obiektow zastapionych przez ponowne wczytanie w trybie
+       wspolbieznym, do ktorych zaden watek nie posiada juz uchwytu
+       (all - wszystkich obiektow, bez sprawdzania uchwytow)
+   */
+   void releaseRetiredResources(bool all);
+
+   /**
+     @brief
+       Zajecie muteksu menadzera na czas istnienia obiektu - jedynie
+       w trybie wspolbieznym (setConcurrentAccess)
+   */
+   class ConcurrentLock {
+    public:
+      explicit ConcurrentLock(const DataFileResourceManager& owner)
+        : mutex_(owner.concurrent_ ? &owner.mutex_ : 0)
+      {
+        if( mutex_ != 0 )
+          mutex_->lock();
+      }
+
+      ~ConcurrentLock() {
+        if( mutex_ != 0 )
+          mutex_->unlock();
+      }
+
+    private:
+      Mutex*  mutex_;
+
+    private:
+      // nie zaimplementowane
+      ConcurrentLock(const ConcurrentLock&);
+      ConcurrentLock& operator =(const ConcurrentLock&);
+   };
+
+   friend class ConcurrentLock;
+
+   /**
+     @brief
+       Utworzenie zasobu z danych znajdujacych sie w pamieci - widokiem
+       (setMappedLoading), badz strumieniem Utilities::MemoryInputStream,
+       z uwzglednieniem pamieci podrecznej (setProcessedCache)
+   */
+   RESOURCE* createFromBytes(const Utilities::ByteSpan& bytes) const;
+
+   /**
+     @brief
+       Zastosowanie zmiany pliku (processFileChanges)
+
+     @return
+       Liczba zasobow, ktorych dotyczyla zmiana
+   */
+   size_t applyFileChange(const FileWatcher::Change&  change,
+                          bool                        asynchronous);
+
+   /**
+     @brief
+       Rejestracja posrednika zasobu fileName katalogu directory (jesli
+       sciezka nie jest jeszcze zarejestrowana)
+
+     @return
+       Wartosc true, gdy posrednik zostal zarejestrowany
+   */
+   bool registerResource(const std::string&  directory,
+                         const std::string&  fileName);
+
+ private:
+   // Trzy glowne typy zewnetrznie utworzonych instancji. Hermetyzacja ich
+   // zachowan sprzyja latwej wymianie podczas przenoszenia kodu na inne
+   // platformy, oraz podczas jego rozwijania - za sprawa instancji typu
+   // ResourceManage. Kolejno, instancja pierwszego typu odpowiada za
+   // wyliczenie elementow wchodzacych w sklad struktury katalogow/plikow
+   // o korzeniu zadanym przez klienta. Drugi obiekt obsluguje zadania 
+   // dotyczace aktualnego czasu systemowego, ktorego wartosc sluzy jako
+   // kryterium podczas organizowania obiektow posredniczacych w dostepie
+   // do zasobow. Trzeci zewnetrzny obiekt jest zdefiniowany na potrzeby
+   // przyszlych implementacji, korzystajacych z zarzadcy. Dzieki 
+   // przedefiniowaniu bazowego interfejsu dostajemy mozliwosc wprowadzania
+   // wlasnych rozszezen, podczas operacji takich jak: pozyskiwanie, ladowanie,
+   // zwalnianie, usuwanie zasobu. Udostepniona funkcjonalnosc tego rodzaju 
+   // moze okazac sie pomocna podczas przeprowadzania pierwotnej inicjalizacji
+   // zasobow. Dla zobrazowania mozna wykorzystac sytuacje wczytywania danych 
+   // danego poziomu gry. Informacje na temat aktualnie wczytywanych zasobow
+   // wyswietlane sa poprzez obiekt realizujacy interfejs.
+
+   typedef std::auto_ptr<DriveElementsEnumerator> DriveElementsEnumeratorAutoPtr;
+   typedef std::auto_ptr<TimeInformation>         TimeInformationAutoPtr;
+   typedef std::auto_ptr<ResourceManage>          ResourceManageAutoPtr;
+
+   DriveElementsEnumeratorAutoPtr  elementsEnum_;
+   const std::string               separator_;
+   TimeInformationAutoPtr          timeInformation_;
+   ResourceManageAutoPtr           resourceManage_;
+   
+ private:
+   // Kolejne definicje synonimow zostaly pogrupowane wedlug kryterium 
+   // realacji miedzy nimi zawartych. Obiekty pierwszego zbioru wchodza
+   // w sklad zakresu okreslajacego dostepne katalogi, ktore brane sa podczas 
+   // rozrozstrzygania dopasowania zasobu do zadanego identyfikatora, oraz
+   // w czasie ladowania wszystkich zasobow (sa to funkcje getResource, oraz
+   // loadResources).
+   // Obiekty nastepnego w kolejnosci typu - ResourcesList - sa
+   // odpowiedzialne za przechowywanie obiektow posrednikow. Kazdy priorytet
+   // posiada wlasna liste zasobow wczytanych, uszeregowana od najzadziej do
+   // najczesciej uzywanego zasobu. Odwolanie do zasobu przepina jego element
+   // na koniec listy (splice), a wiec porzadek jest utrzymywany w czasie
+   // stalym, bez przydzialow pamieci. Posrednicy zasobow niewczytanych
+   // znajduja sie na osobnej liscie, dlatego poczatek listy priorytetu jest
+   // zawsze kandydatem do zwolnienia. Elementy list nie zmieniaja polozenia
+   // (rowniez przy przepieciu do innej listy), wiec iteratory moga byc
+   // przechowywane w tablicy odwzorowania uchwytow
+   // W sklad trzeciego zestawu wchodza typy, ktore determinuja zrodlo zasobu
+   // w postaci sciezki dostepu (para katalog, nazwa pliku)
+   // Typ TSTHandleToPath odwzorowuje zadany uchwyt (instancja typu 
+   // zdefiniowanego w klasie struktury drzewa TST) na sciezke katalogow
+   // zasobu, ktory jest identyfikowany wartoscia uchwytu
+   // Ostatnie odwzorowanie umozliwia pobranie adresu instancji posrednika
+   // bedac w posiadaniu uchwytu TST sprzezonego z danym zasobem. Uchwyty
+   // sa kolejnymi liczbami naturalnymi przydzielanymi przez drzewo TST,
+   // dlatego oba odwzorowania sa tablicami indeksowanymi bezposrednio
+   // uchwytem. Pozycja tablicy posrednikow przechowuje numer rejestracji
+   // (pokolenie) - uchwyty klientow zawieraja go rowniez, wiec uchwyt
+   // usunietego zasobu jest wykrywany porownaniem dwoch liczb
+
+   typedef std::string              DirectoryName;
+   typedef std::set<DirectoryName>  Directories;
+   typedef Directories::iterator    DirectoriesItor;
+   
+   typedef std::list<SharedResource>         ResourcesList;
+   typedef typename ResourcesList::iterator  ResourcesListItor;
+
+   enum { PRIORITIES_COUNT = HIGH_PRIORITY + 1 };
+
+   typedef std::string                      FileName;
+   typedef std::string                      Directory;
+   typedef std::pair<Directory, FileName>   Path;
+
+   typedef std::vector<Path>  TSTHandleToPath;
+   
+   /**
+     @brief
+       Pozycja posrednika w liscie jego priorytetu
+   */
+   struct ResourceSlot {
+     ResourceSlot(ResourcesListItor  itor, 
+                  bool               registered,
+                  Generation         generation)
+       : itor_(itor)
+       , registered_(registered)
+       , generation_(generation)
+     {}
+
+     ResourcesListItor  itor_;
+     bool               registered_;
+     Generation         generation_;  /**< Numer ostatniej rejestracji */
+   };
+
+   typedef std::vector<ResourceSlot>  TSTHandleToShrRes;
+
+   typedef std::auto_ptr<ElementMatcher>  ElementMatcherAutoPtr;
+   
+   size_t  maxMemory_;     /**< Maksymalny dostepny rozmiar pamieci */
+   size_t  usedMemory_;    /**< Aktualnie wykorzystywany obszar pamieci */
+
+   ResourceManagerCounters  statistics_;  /**< Liczniki getStatistics */
+
+   bool                  concurrent_;   /**< Tryb wspolbiezny */
+   mutable Mutex         mutex_;        /**< Muteks trybu wspolbieznego */
+   ConditionVariable     loadFinished_; /**< Koniec wczytywania zasobu
+                                             (wczytanie jednokrotne) */
+   
+   Directories    searchDir_;      /**< Katalogi wykorzystywane podczas dopasowania */
+   ResourcesList  resources_[PRIORITIES_COUNT]; /**< Posrednicy zasobow 
+                                                     wczytanych wedlug 
+                                                     priorytetow */
+   ResourcesList  idleResources_;  /**< Posrednicy zasobow niewczytanych */
+   size_t         resourcesCount_; /**< Liczba posrednikow */
+   Generation     lastGeneration_; /**< Numer ostatniej rejestracji posrednika
+                                        (nie jest zerowany przez purgeAll) */
+   
+   PathToTSTHandle    pathToTSTHandle_;   /**< Sciezka zasobu na uchwyt TST */
+   TSTHandleToShrRes  tstHandleToShrRes_; /**< Uchwyt TST na posrednika zasobu */
+   TSTHandleToPath    tstHandleToPath_;   /**< Odwzorowanie uchwytu struktury 
+                                               trynarnej na sciezke zasobu */
+
+   ElementMatcherAutoPtr  elementMatcher_; /**< Kryterium wykorzystywane podczas
+                                                proby pobrani zasobu */
+
+   const ResourceArchive*  archive_;  /**< Zrodlo danych zasobow (0 - pliki) */
+
+   typedef std::auto_ptr<FileWatcher>  FileWatcherAutoPtr;
+
+   FileWatcherAutoPtr  fileWatcher_;  /**< Obserwacja katalogow (0 - brak) */
+
+   /**
+     @brief
+       Obiekt zasobu zastapiony przez ponowne wczytanie, podczas gdy watki
+       posiadajace uchwyty mogly go odczytywac bez muteksu (install)
+   */
+   struct RetiredResource {
+     RetiredResource(const SharedResource*  owner,
+                     RESOURCE*              resource)
+       : owner_(owner)
+       , resource_(resource)
+     {}
+
+     const SharedResource*  owner_;     /**< Posrednik (adres niezmienny 
+                                             do wywolania purgeAll) */
+     RESOURCE*              resource_;  /**< Zastapiony obiekt */
+   };
+
+   typedef std::vector<RetiredResource>  RetiredResources;
+
+   RetiredResources  retired_;  /**< Obiekty oczekujace na zwolnienie uchwytow
+                                     (nie sa wliczane do usedMemory_) */
+
+   // Pula watkow wczytujacych zasoby w tle. Watki nie odwoluja sie do
+   // struktur menadzera - otrzymuja jedynie uchwyt TST i sciezke pliku,
+   // a wczytane obiekty sa przekazywane posrednikom w watku wlasciciela
+   // (processCompletedLoads). Watki puli nie wspoldziela wiec danych
+   // z dereferencja uchwytow - jej synchronizacje w trybie wspolbieznym
+   // zapewniaja published_ i liczniki odwolan posrednikow (install,
+   // prepareEviction). Skladowa jest zadeklarowana jako ostatnia,
+   // wiec watki koncza dzialanie przed zniszczeniem pozostalych danych
+
+   typedef ResourceLoader<RESOURCE, TSTHandle>  Loader;
+   typedef std::auto_ptr<Loader>                LoaderAutoPtr;
+
+   // Wskazniki funkcji (zamiast znacznikow) pozwalaja wywolac konstruktor
+   // RESOURCE(const ByteSpan&), oraz metody przetworzonej postaci zasobu
+   // jedynie wtedy, gdy klient wlaczyl odpowiednia opcje - pozostale
+   // metody nie wymagaja ich istnienia
+
+   typename Loader::Decoding  decoding_; /**< Sposob tworzenia zasobu 
+                                              z zawartosci pliku */
+
+   LoaderAutoPtr  loader_;          /**< Pula watkow (0 - brak) */
+
+ private:
+   bool isDirectoryValid( const DriveElementsEnumerator::ItorAutoPtr& elemItor );
+
+ private:
+   // Nie zdefiniowane
+   DataFileResourceManager(const DataFileResourceManager&);
+   DataFileResourceManager& operator =(const DataFileResourceManager&);   
+};
+
+//
+template<typename RESOURCE, typename FILE_FORMAT>
+DataFileResourceManager<RESOURCE, FILE_FORMAT>::SharedResource
+::SharedResource(DataFileResourceManager&  owner,
                  const std::string&        dataFileName,
                  const std::string&        dataFilePath)
   : owner_(owner)
-  , handle_(owner.pathToTSTHandle_.getHandle(dataFilePath + "\\" + dataFileName))
-  , priority_(MEDIUM_PRIORITY)
-  , referenceCounter_(1)
-  , resource_(0)
-  , lastAccess_(owner.timeInformation_->getSystemTime())
+  , handle_(owner.pathToTSTHandle_.getHandle(dataFilePath + owner.separator_ + dataFileName))
+  , priority_(MEDIUM_PRIORITY)
+  , resource_(0)
+  , byteSize_(0)
+  , referenceCounter_(1)
+  , pending_(false)
+  , reloading_(false)
+  , accessStamp_(0)
+  , published_(0)
+  , touched_(0)
+  , loading_(false)
+{
+}
+
+//
+template<typename RESOURCE, typename FILE_FORMAT>
+void 
+DataFileResourceManager<RESOURCE, FILE_FORMAT>::SharedResource
+::acquire() const
+{
+  // Aby pozyskac zasob, trzeba sprawdzic czy aktualnie nie znajduje sie 
+  // on w pamieci obslugiwanej przez zarzadce. Jesli menadzer zwolil obszar 
+  // danych mu przynaleznych na rzecz innego pozyskiwanego zasobu, 
+  // wowczas nalezy ponownie wczytac go z zewnetrznego zrodla. Aby prawidlowo
+  // wykonac to zadanie trzeba zdeszyfrowac wartosc uchwytu okreslajaca
+  // jednoznacznie sciezke dostepu do zewnetrznych danych zasobu. Po wykonaniu
+  // tej czynnosci, wystarczy przekazac odpowiedzialnosc nowo utworzonemu 
+  // wspoldzielonemu obiektowi, polegajaca na wczytaniu swoich danych.
+  // Przed odczytem menadzer zwalnia pamiec innych zasobow, aby zmiescic
+  // w budzecie dane o wielkosci pliku (przyblizenie wielkosci zasobu).
+  // Po odczycie wielkosc zasobu jest znana dokladnie, wiec ewentualne
+  // przekroczenie budzetu jest korygowane ponownie
+  
+  // Zasob oczekujacy na wczytanie w tle jest wczytywany synchronicznie,
+  // a pozniejszy wynik puli watkow zostaje porzucony (completeLoad)
+
+  if( !isLoaded() )
+    load();
+
+  Utilities::assertion( isLoaded(),
+    "Obiekt nie zostal wczytany! Blad wewnetrzny!" );
+}
+
+//
+template<typename RESOURCE, typename FILE_FORMAT>
+void
+DataFileResourceManager<RESOURCE, FILE_FORMAT>::SharedResource
+::load() const
+{
+  size_t readMicroseconds  = 0;
+  size_t parseMicroseconds = 0;
+  RESOURCE* loaded = 0;
+
+  try {
+    loaded = createResource(&readMicroseconds, &parseMicroseconds, true);
+  }
+  catch(...) {
+    owner_.statistics_.recordFailedLoad();
+    throw;
+  }
+
+  finishLoad(loaded, readMicroseconds, parseMicroseconds);
+}
+
+//
+template<typename RESOURCE, typename FILE_FORMAT>
+void
+DataFileResourceManager<RESOURCE, FILE_FORMAT>::SharedResource
+::acquireShared() const
+{
+  // Pierwszy watek ustawia znacznik loading_ i wczytuje zasob bez
+  // zajetego muteksu (pozostale zasoby pozostaja dostepne), a kolejne
+  // oczekuja na zmiennej warunkowej menadzera. Nieudane wczytanie budzi
+  // oczekujace watki - kazdy z nich ponawia probe. Zasob udostepniony
+  // w miedzyczasie przez pule watkow nie jest zastepowany, poniewaz inne
+  // watki moga juz z niego korzystac. Pamiec innych zasobow jest
+  // zwalniana dopiero po wczytaniu (pod muteksem)
+
+  while( !isLoaded() )
+  {
+    if( loading_ ) {
+      owner_.loadFinished_.wait(owner_.mutex_);
+      continue;
+    }
+
+    loading_ = true;
+    owner_.mutex_.unlock();
+
+    size_t readMicroseconds  = 0;
+    size_t parseMicroseconds = 0;
+    ResourceAutoPtr loaded;
+
+    try {
+      loaded = ResourceAutoPtr(
+        createResource(&readMicroseconds, &parseMicroseconds, false) );
+    }
+    catch(...) {
+      owner_.mutex_.lock();
+      loading_ = false;
+      owner_.loadFinished_.notifyAll();
+      owner_.statistics_.recordFailedLoad();
+      throw;
+    }
+
+    owner_.mutex_.lock();
+    loading_ = false;
+    owner_.loadFinished_.notifyAll();
+
+    if( !isLoaded() )
+      finishLoad(loaded.release(), readMicroseconds, parseMicroseconds);
+  }
+}
+
+//
+template<typename RESOURCE, typename FILE_FORMAT>
+void
+DataFileResourceManager<RESOURCE, FILE_FORMAT>::SharedResource
+::finishLoad(RESOURCE*  loaded,
+             size_t     readMicroseconds,
+             size_t     parseMicroseconds) const
+{
+  install(loaded);
+  pending_   = false;
+  reloading_ = false;
+
+  owner_.statistics_.recordRead(readMicroseconds);
+  owner_.statistics_.recordParse(parseMicroseconds);
+  owner_.statistics_.recordLoad( getFilePath(), byteSize_, 
+    readMicroseconds + parseMicroseconds );
+}
+
+//
+template<typename RESOURCE, typename FILE_FORMAT>
+RESOURCE*
+DataFileResourceManager<RESOURCE, FILE_FORMAT>::SharedResource
+::createResource(size_t*  readMicroseconds,
+                 size_t*  parseMicroseconds,
+                 bool     reserveMemory) const
+{
+  // Faza odczytu konczy sie po otwarciu (odwzorowaniu) pliku. Czas
+  // zwalniania pamieci innych zasobow nie jest doliczany do zadnej
+  // z faz - zalezy on od stanu menadzera, a nie od wczytywanego pliku
+
+  const std::string PATH = getFilePath();
+  size_t time = 0;
+  owner_.measureElapsed(&time);
+
+  ResourceAutoPtr resource;
+
+  if( owner_.archive_ != 0 )
+  {
+    // Dane wpisu archiwum sa juz odwzorowane w pamieci - ani otwarcie,
+    // ani odczyt pliku nie sa potrzebne
+    Utilities::ByteSpan bytes;
+    if( !owner_.archive_->find(PATH, &bytes) )
+      throw FailOnResourceAcquireException(PATH);
+
+    *readMicroseconds = owner_.measureElapsed(&time);
+    if( reserveMemory )
+      owner_.releaseMemory( bytes.size(), this );
+    owner_.measureElapsed(&time);
+    resource = ResourceAutoPtr( owner_.createFromBytes(bytes) );
+  }
+  else if( owner_.decoding_.needsBytes() )
+  {
+    // Odwzorowanie jest zwalniane po utworzeniu zasobu - zasob nie moze
+    // przechowywac wskaznikow do widoku
+    MappedFile file;
+    if( !file.map(PATH) )
+      throw FailOnResourceAcquireException(PATH);
+
+    *readMicroseconds = owner_.measureElapsed(&time);
+    if( reserveMemory )
+      owner_.releaseMemory( file.bytes().size(), this );
+    owner_.measureElapsed(&time);
+    resource = ResourceAutoPtr( owner_.createFromBytes(file.bytes()) );
+  }
+  else
+  {
+    std::ifstream input(PATH.c_str(), std::ios_base::binary);
+    if(!input)
+      throw FailOnResourceAcquireException(PATH);
+
+    input.seekg(0, std::ios_base::end);
+    const std::streamoff FILE_SIZE = input.tellg();
+    input.seekg(0, std::ios_base::beg);
+
+    *readMicroseconds = owner_.measureElapsed(&time);
+    if( reserveMemory )
+      owner_.releaseMemory( 
+        FILE_SIZE > 0 ? static_cast<size_t>(FILE_SIZE) : 0, this );
+    owner_.measureElapsed(&time);
+    resource = ResourceAutoPtr( new RESOURCE(input) );
+  }
+
+  *parseMicroseconds = owner_.measureElapsed(&time);
+  return resource.release();
+}
+
+//
+template<typename RESOURCE, typename FILE_FORMAT>
+void
+DataFileResourceManager<RESOURCE, FILE_FORMAT>::SharedResource
+::install(RESOURCE* loaded) const
+{
+  // Po utworzeniu wielkosc zasobu jest znana dokladnie, wiec ewentualne
+  // przekroczenie budzetu jest korygowane ponownie. Poprzedni obiekt
+  // (ponowne wczytanie) jest zwalniany dopiero po utworzeniu nowego
+
+  // W trybie wspolbieznym watki posiadajace uchwyty odczytuja poprzedni
+  // obiekt bez muteksu. Jesli zaden watek nie posiada uchwytu, wycofanie
+  // udostepnienia (prepareEviction) pozwala zwolnic obiekt od razu.
+  // W przeciwnym razie obiekt jest przekazywany menadzerowi do chwili
+  // zwolnienia uchwytow (releaseRetiredResources), a wskaznik nowego
+  // obiektu jest zapisywany pojedyncza operacja po pelnej barierze
+  // pamieci - watek odczytujacy otrzymuje jeden z dwoch kompletnych
+  // obiektow, nigdy wartosci zerowej
+
+  ResourceAutoPtr resource(loaded);
+  const bool RELOADED = isLoaded();
+  const bool RETIRE = RELOADED && owner_.concurrent_ && !prepareEviction();
+
+  if( RETIRE ) {
+    owner_.retired_.push_back( RetiredResource(this, resource_) );
+    Utilities::atomicCompareExchange(&published_, 1, 1);
+  }
+  else
+    delete resource_;
+
+  owner_.usedMemory_ -= byteSize_;
+  resource_ = resource.release();
+  byteSize_ = resource_->getByteSize();
+  owner_.usedMemory_ += byteSize_;
+
+  // Operacja atomowa udostepnia utworzony obiekt watkom odczytujacym
+  // published_ (isPublished) - wraz z zawartoscia obiektu
+  Utilities::atomicCompareExchange(&published_, 1, 0);
+
+  owner_.resourceLoaded(*this, RELOADED);
+  owner_.releaseMemory(0, this);
+}
+
+//
+template<typename RESOURCE, typename FILE_FORMAT>
+bool
+DataFileResourceManager<RESOURCE, FILE_FORMAT>::SharedResource
+::reload(bool asynchronous) const
+{
+  // Zasob oczekujacy na wynik puli watkow jest wczytywany natychmiast -
+  // zlecony odczyt mogl poprzedzic zmiane pliku, dlatego jego wynik
+  // zostanie porzucony (completeLoad)
+
+  if( !isLoaded() && !pending_ )
+    return false;
+
+  if( asynchronous && !pending_ && owner_.loader_.get() != 0 ) {
+    pending_   = owner_.enqueueLoad(handle_, getFilePath(), priority_);
+    reloading_ = pending_;
+    return pending_;
+  }
+
+  load();
+  return true;
+}
+
+//
+template<typename RESOURCE, typename FILE_FORMAT>
+void
+DataFileResourceManager<RESOURCE, FILE_FORMAT>::SharedResource
+::requestLoad() const
+{
+  if( isLoaded() || pending_ )
+    return;
+
+  if( owner_.loader_.get() == 0 ) {
+    if( owner_.concurrent_ )
+      acquireShared();
+    else
+      acquire();
+    return;
+  }
+
+  pending_ = owner_.enqueueLoad(handle_, getFilePath(), priority_);
+}
+
+//
+template<typename RESOURCE, typename FILE_FORMAT>
+const RESOURCE*
+DataFileResourceManager<RESOURCE, FILE_FORMAT>::SharedResource
+::tryGetResource() const
+{
+  // Ponowne odwolanie do zasobu oczekujacego na wynik puli watkow
+  // nie jest kolejnym chybieniem. W trybie wspolbieznym zasob
+  // wczytywany przez inny watek rowniez jest oczekujacy
+
+  if( owner_.concurrent_ )
+  {
+    if( isPublished() ) {
+      touchShared();
+      return resource_;
+    }
+
+    MutexLock lock(owner_.mutex_);
+
+    if( !isLoaded() ) {
+      if( loading_ || pending_ )
+        return 0;
+
+      owner_.statistics_.recordMiss(priority_);
+      requestLoad();
+      if( !isLoaded() )
+        return 0;
+    }
+
+    owner_.touchResource(handle_);
+    return resource_;
+  }
+
+  if( isLoaded() )
+    owner_.statistics_.recordHit(priority_);
+  else {
+    if( !pending_ )
+      owner_.statistics_.recordMiss(priority_);
+
+    requestLoad();
+    if( !isLoaded() )
+      return 0;
+  }
+
+  owner_.touchResource(handle_);
+  return resource_;
+}
+
+//
+template<typename RESOURCE, typename FILE_FORMAT>
+void
+DataFileResourceManager<RESOURCE, FILE_FORMAT>::SharedResource
+::completeLoad(RESOURCE*  loaded,
+               size_t     loadMicroseconds) const
+{
+  // Zasob wczytany w tle podlega tym samym zasadom rozliczania pamieci
+  // co zasob wczytany synchronicznie - przekroczenie budzetu zwalnia
+  // najdawniej uzywane zasoby (z wyjatkiem biezacego)
+
+  // Wynik ponownego wczytania (reload) zastepuje wczytany zasob,
+  // a nieudane ponowne wczytanie pozostawia poprzednia zawartosc
+
+  ResourceAutoPtr resource(loaded);
+  const bool REPLACE = reloading_;
+  pending_   = false;
+  reloading_ = false;
+
+  if( resource.get() == 0 ) {
+    owner_.statistics_.recordFailedLoad();
+    return;
+  }
+
+  if( isLoaded() && !REPLACE )
+    return;
+
+  install( resource.release() );
+  owner_.statistics_.recordLoad( getFilePath(), byteSize_, loadMicroseconds );
+}
+
+//
+template<typename RESOURCE, typename FILE_FORMAT>
+void
+DataFileResourceManager<RESOURCE, FILE_FORMAT>::SharedResource
+::completeRead(const char*  data,
+               size_t       bytesCount,
+               bool         succeeded) const
+{
+  if( !succeeded ) {
+    owner_.statistics_.recordFailedLoad();
+    throw FailOnResourceAcquireException( getFilePath() );
+  }
+
+  if( isLoaded() )
+    return;
+
+  owner_.releaseMemory(bytesCount, this);
+
+  // Odczyt wsadowy nie mierzy fazy odczytu - rejestrowane jest
+  // jedynie przetwarzanie
+  size_t time = 0;
+  owner_.measureElapsed(&time);
+
+  RESOURCE* resource = 0;
+  try {
+    resource = owner_.createFromBytes( Utilities::ByteSpan(data, bytesCount) );
+  }
+  catch(...) {
+    owner_.statistics_.recordFailedLoad();
+    throw;
+  }
+
+  const size_t PARSE_MICROSECONDS = owner_.measureElapsed(&time);
+  owner_.statistics_.recordParse(PARSE_MICROSECONDS);
+  completeLoad( resource, PARSE_MICROSECONDS );
+}
+
+//
+template<typename RESOURCE, typename FILE_FORMAT>
+void
+DataFileResourceManager<RESOURCE, FILE_FORMAT>::SharedResource
+::cancelLoad() const
+{
+  pending_   = false;
+  reloading_ = false;
+}
+
+//
+template<typename RESOURCE, typename FILE_FORMAT>
+void
+DataFileResourceManager<RESOURCE, FILE_FORMAT>::SharedResource
+::release() const
+{
+  // Operacja zwolnienia pamieci przydzielonej zasobowi polega na 
+  // oproznieniu obszaru pamieci udostepnionej zbiorowi danych 
+  // tworzacych wspoldzielona jego czesc
+
+  if( isLoaded() ) {
+    Utilities::atomicCompareExchange(&published_, 0, 1);
+    delete resource_;
+    resource_ = 0;
+    owner_.usedMemory_ -= byteSize_;
+    byteSize_ = 0;
+    owner_.resourceReleased(*this);
+  }
+
+  Utilities::assertion( resource_ == 0, 
+    "Zwolnienie zasobu zakonczone niepowodzeniem!" );
+}
+
+//
+template<typename RESOURCE, typename FILE_FORMAT>
+void 
+DataFileResourceManager<RESOURCE, FILE_FORMAT>::SharedResource
+::increaseRef() const
+{ 
+  // Licznik zawiera odwolanie menadzera, wiec po inkrementacji wynosi
+  // co najmniej dwa - mniejsza wartosc oznacza przepelnienie
+
+  const RefCounter REFERENCES = 
+    Utilities::atomicIncrement(&referenceCounter_);
+
+  Utilities::assertion( REFERENCES > 1,
+    "Maksymalna wartosc licznika odwolan! Mozliwy blad przepelnienia!" );
+}
+  
+//
+template<typename RESOURCE, typename FILE_FORMAT>
+void 
+DataFileResourceManager<RESOURCE, FILE_FORMAT>::SharedResource
+::decreaseRef() const
+{
+  // Wspoldzielony zasob zawsze posiada przynajmniej wartosc rowna
+  // jednosci wynikla z posiadania przez menadzer prawa wlasnosci do zasobu
+
+//  Utilities::assertion( referenceCounter_ <= 1, 
+//  "Licznik odwolan zasobu posiada bledna wartosc!" );
+
+  Utilities::atomicDecrement(&referenceCounter_); 
+}
+
+//
+template<typename RESOURCE, typename FILE_FORMAT>
+void 
+DataFileResourceManager<RESOURCE, FILE_FORMAT>::SharedResource
+::setPriority(ResourcePriority priority) const
+{
+  // Jesli biezacy priorytet posiada rozna wartosc od pozadanej przez
+  // klienta, ktory inicjuje komunikat, wowczas nalezy przystapic do jego
+  // zmiany. Implikacja calego zajscia jest zmiana pozycji zasobu 
+  // w posiadajacym do niego prawa wlasnosci agregacie-menadzerze,
+  // ktora wykonywana jest za posrednictwem wywolania metody moveResource()
+
+  if(priority_ != priority) {
+    const ResourcePriority PREVIOUS_PRIORITY = priority_;
+    priority_ = priority; 
+    owner_.moveResource(handle_, PREVIOUS_PRIORITY);
+  }
+}
+
+//
+template<typename RESOURCE, typename FILE_FORMAT>
+typename DataFileResourceManager<RESOURCE, FILE_FORMAT>::ResourcePriority 
+DataFileResourceManager<RESOURCE, FILE_FORMAT>::SharedResource
+::getPriority() const 
+{ 
+  return priority_; 
+}
+  
+//
+template<typename RESOURCE, typename FILE_FORMAT>
+size_t
+DataFileResourceManager<RESOURCE, FILE_FORMAT>::SharedResource
+::getByteSize() const 
+{
+  // Do prawidlowego dzialania funkcji jest wymagane zdefiniowanie
+  // przez uzytkownika metody getByteSize() w klasie zasobu
+
+  update();
+  return resource_->getByteSize();
+}
+
+//
+template<typename RESOURCE, typename FILE_FORMAT>
+bool 
+DataFileResourceManager<RESOURCE, FILE_FORMAT>::SharedResource
+::isShared() const 
+{ 
+  return Utilities::atomicLoadAcquire(&referenceCounter_) > 1; 
+}
+
+//
+template<typename RESOURCE, typename FILE_FORMAT>
+const RESOURCE& 
+DataFileResourceManager<RESOURCE, FILE_FORMAT>::SharedResource
+::getResource() const
+{
+  update();
+  return *resource_;
+}
+
+//
+template<typename RESOURCE, typename FILE_FORMAT>
+typename DataFileResourceManager<RESOURCE, FILE_FORMAT>::TSTHandle 
+DataFileResourceManager<RESOURCE, FILE_FORMAT>::SharedResource
+::getTstHandle() const
+{
+  return handle_;
+}
+
+//
+template<typename RESOURCE, typename FILE_FORMAT>
+bool
+DataFileResourceManager<RESOURCE, FILE_FORMAT>::SharedResource
+::isLoaded() const 
+{ 
+  return resource_ != 0; 
+}
+
+//
+template<typename RESOURCE, typename FILE_FORMAT>
+bool
+DataFileResourceManager<RESOURCE, FILE_FORMAT>::SharedResource
+::isPublished() const 
+{ 
+  return Utilities::atomicLoadAcquire(&published_) != 0; 
+}
+
+//
+template<typename RESOURCE, typename FILE_FORMAT>
+void
+DataFileResourceManager<RESOURCE, FILE_FORMAT>::SharedResource
+::touchShared() const 
+{ 
+  // Priorytet jest celowo odczytywany bez muteksu - zmiana (setPriority)
+  // jest zapisem pojedynczego slowa pod muteksem, wiec odczyt zwraca
+  // poprawna wartosc, a trafienie rownolegle ze zmiana priorytetu moze
+  // zostac zaliczone poprzedniemu. Znacznik jest zapisywany operacja
+  // atomowa jedynie przy zmianie wartosci
+
+  const ResourcePriority PRIORITY = 
+    *const_cast<const volatile ResourcePriority*>(&priority_);
+  owner_.statistics_.recordSharedHit(PRIORITY);
+
+  if( Utilities::atomicLoadAcquire(&touched_) == 0 )
+    Utilities::atomicCompareExchange(&touched_, 1, 0);
+}
+
+//
+template<typename RESOURCE, typename FILE_FORMAT>
+bool
+DataFileResourceManager<RESOURCE, FILE_FORMAT>::SharedResource
+::takeTouched() const 
+{ 
+  // Wywolanie pod muteksem; znacznik jest zerowany operacja atomowa, 
+  // wiec rownolegle zaznaczenie nie zostaje utracone bez sladu
+
+  if( Utilities::atomicLoadAcquire(&touched_) == 0 )
+    return false;
+
+  Utilities::atomicCompareExchange(&touched_, 0, 1);
+  return true;
+}
+
+//
+template<typename RESOURCE, typename FILE_FORMAT>
+bool
+DataFileResourceManager<RESOURCE, FILE_FORMAT>::SharedResource
+::prepareEviction() const 
+{ 
+  // Watek pobierajacy uchwyt najpierw zwieksza licznik odwolan, a potem
+  // odczytuje published_. Zwalnianie przebiega w odwrotnej kolejnosci
+  // (obie operacje z pelna bariera pamieci), wiec co najmniej jedna ze
+  // stron zauwazy zmiane drugiej: watek odczyta published_ rowne zero
+  // (i przejdzie do wczytania pod muteksem), badz zasob pozostanie
+  // w pamieci
+
+  Utilities::atomicCompareExchange(&published_, 0, 1);
+
+  if( isShared() ) {
+    Utilities::atomicCompareExchange(&published_, 1, 0);
+    return false;
+  }
+
+  return true;
+}
+
+//
+template<typename RESOURCE, typename FILE_FORMAT>
+bool
+DataFileResourceManager<RESOURCE, FILE_FORMAT>::SharedResource
+::isPending() const 
+{ 
+  return pending_; 
+}
+
+//
+template<typename RESOURCE, typename FILE_FORMAT>
+size_t
+DataFileResourceManager<RESOURCE, FILE_FORMAT>::SharedResource
+::getLoadedByteSize() const 
+{ 
+  return byteSize_; 
+}
+
+//
+template<typename RESOURCE, typename FILE_FORMAT>
+void
+DataFileResourceManager<RESOURCE, FILE_FORMAT>::SharedResource
+::update() const
+{
+  // Kazde odwolanie do zasobu przenosi go na koniec listy jego
+  // priorytetu. Poczatki list zawieraja zatem zasoby najdluzej
+  // nieuzywane, ktore w sytuacji niedoboru pamieci sa zwalniane
+  // w pierwszej kolejnosci (poczynajac od najnizszego priorytetu).
+  // Operacja przepiecia elementu listy (splice) ma staly koszt i nie
+  // wymaga kopiowania posrednika, przydzialu pamieci, ani odczytu
+  // czasu systemowego
+
+  // W trybie wspolbieznym dereferencja zasobu udostepnionego nie zajmuje
+  // muteksu - odwolanie jest jedynie zaznaczane (touched_), a posrednik
+  // jest przenoszony na koniec listy w chwili zwalniania pamieci.
+  // Znacznik jest zapisywany jedynie przy zmianie wartosci, a trafienie
+  // jest zliczane w segmencie biezacego watku (recordSharedHit), wiec
+  // watki odczytujace nie rywalizuja o linie pamieci podrecznej
+
+  if( owner_.concurrent_ )
+  {
+    if( isPublished() ) {
+      touchShared();
+      return;
+    }
+
+    MutexLock lock(owner_.mutex_);
+
+    if( !isLoaded() ) {
+      owner_.statistics_.recordMiss(priority_);
+      acquireShared();
+    }
+
+    owner_.touchResource(handle_);
+    return;
+  }
+
+  if( isLoaded() )
+    owner_.statistics_.recordHit(priority_);
+  else {
+    owner_.statistics_.recordMiss(priority_);
+    acquire();
+  }
+
+  owner_.touchResource(handle_);
+}
+
+//
+template<typename RESOURCE, typename FILE_FORMAT>
+std::string
+DataFileResourceManager<RESOURCE, FILE_FORMAT>::SharedResource
+::getFilePath() const
+{
+  const Path& PATH = owner_.tstHandleToPath_[ handle_ ];
+  return PATH.first + owner_.separator_ + PATH.second;
+}
+
+//
+template<typename RESOURCE, typename FILE_FORMAT>
+DataFileResourceManager<RESOURCE, FILE_FORMAT>::Handle
+::Handle(DataFileResourceManager&  owner,
+         TSTHandle                 handle)
+  : owner_(owner)
+  , handle_(handle)
+  , generation_(0)
+{
+  const SharedResource& RESOURCE_PROXY = owner_.findResource( handle_ );
+  generation_ = owner_.tstHandleToShrRes_[ handle_ ].generation_;
+  RESOURCE_PROXY.increaseRef();
+}
+
+//
+template<typename RESOURCE, typename FILE_FORMAT>
+const typename DataFileResourceManager<RESOURCE, FILE_FORMAT>::SharedResource&
+DataFileResourceManager<RESOURCE, FILE_FORMAT>::Handle
+::dereferenceResource() const
+{
+  const SharedResource* resource = 
+    owner_.findResourcePtr( handle_, generation_ );
+
+  Utilities::assertion( resource != 0,
+    "Uchwyt zasobu jest niewazny (zasob zostal usuniety)!" );
+
+  return *resource;
+}
+
+//
+template<typename RESOURCE, typename FILE_FORMAT>
+const RESOURCE*
+DataFileResourceManager<RESOURCE, FILE_FORMAT>::Handle
+::tryGet() const
+{
+  return dereferenceResource().tryGetResource();
+}
+
+//
+template<typename RESOURCE, typename FILE_FORMAT>
+DataFileResourceManager<RESOURCE, FILE_FORMAT>
+::DataFileResourceManager(DriveElementsEnumerator*  fileEnumerator,
+                          TimeInformation*          timeInformation)
+  : elementsEnum_(fileEnumerator)
+  , separator_(1, pathSeparatorOf(fileEnumerator))
+  , timeInformation_(timeInformation)
+  , resourceManage_(createNullResourceManage())
+  , usedMemory_(0)
+  , concurrent_(false)
+  , resourcesCount_(0)
+  , lastGeneration_(0)
+  , elementMatcher_(createNullElementMatcher())
+  , archive_(0)
+{
+  const int ONE_MEGABYTE = 1024 * 1024;
+  maxMemory_ = ONE_MEGABYTE;
+}
+
+//
+template<typename RESOURCE, typename FILE_FORMAT>
+DataFileResourceManager<RESOURCE, FILE_FORMAT>
+::~DataFileResourceManager()
+{
+  releaseRetiredResources(true);
+}
+
+//
+template<typename RESOURCE, typename FILE_FORMAT>
+void
+DataFileResourceManager<RESOURCE, FILE_FORMAT>
+::setResourceManage(ResourceManage* resourceManage)
+{
+  resourceManage_ = ResourceManageAutoPtr(resourceManage);
+}
+
+//
+template<typename RESOURCE, typename FILE_FORMAT>
+void 
+DataFileResourceManager<RESOURCE, FILE_FORMAT>
+::setElementMatcher(ElementMatcher* elementMatcher)
+{
+  elementMatcher_ = ElementMatcherAutoPtr(elementMatcher);
+}
+
+//
+template<typename RESOURCE, typename FILE_FORMAT>
+void 
+DataFileResourceManager<RESOURCE, FILE_FORMAT>
+::setMemoryMaximum(size_t memorySize)
+{
+  maxMemory_ = memorySize;
+  releaseMemory(0, 0);
+}
+
+//
+template<typename RESOURCE, typename FILE_FORMAT>
+size_t 
+DataFileResourceManager<RESOURCE, FILE_FORMAT>
+::getMemoryMaximum() const
+{
+  return maxMemory_;
+}
+
+//
+template<typename RESOURCE, typename FILE_FORMAT>
+ResourceManagerStats
+DataFileResourceManager<RESOURCE, FILE_FORMAT>
+::getStatistics() const
+{
+  ConcurrentLock lock(*this);
+
+  ResourceManagerStats stats;
+  statistics_.fill(&stats);
+
+  stats.usedMemory_     = usedMemory_;
+  stats.maxMemory_      = getMemoryBudget() != 0 ? 
+    getMemoryBudget()->getMemoryMaximum() : maxMemory_;
+  stats.resourcesCount_ = resourcesCount_;
+  return stats;
+}
+
+//
+template<typename RESOURCE, typename FILE_FORMAT>
+size_t
+DataFileResourceManager<RESOURCE, FILE_FORMAT>
+::measureElapsed(size_t* time) const
+{
+  if( timeInformation_.get() == 0 )
+    return 0;
+
+  const size_t START_TIME = *time;
+  *time = timeInformation_->getSystemTime();
+  return timeInformation_->getElapsedMicroseconds(START_TIME, *time);
+}
+
+//
+template<typename RESOURCE, typename FILE_FORMAT>
+void
+DataFileResourceManager<RESOURCE, FILE_FORMAT>
+::applyDeferredTouches()
+{
+  // Zaznaczone posredniki sa przenoszone w kolejnosci ich polozenia na
+  // liscie - porzadek odwolan wykonanych bez muteksu nie jest znany
+
+  for(int priority = LOW_PRIORITY; priority < PRIORITIES_COUNT; ++priority)
+  {
+    ResourcesList& list = resources_[priority];
+
+    ResourcesListItor resItor = list.begin();
+    for(size_t count = list.size(); count > 0; --count)
+    {
+      const ResourcesListItor TOUCHED_ITOR = resItor++;
+      if( !TOUCHED_ITOR->takeTouched() )
+        continue;
+
+      list.splice(list.end(), list, TOUCHED_ITOR);
+      if( getMemoryBudget() != 0 )
+        TOUCHED_ITOR->setAccessStamp( getMemoryBudget()->nextAccessStamp() );
+    }
+  }
+}
+
+//
+template<typename RESOURCE, typename FILE_FORMAT>
+void
+DataFileResourceManager<RESOURCE, FILE_FORMAT>
+::releaseRetiredResources(bool all)
+{
+  // Nowy uchwyt moze powstac jedynie z uchwytu istniejacego, badz pod
+  // muteksem (getResource) - wowczas odczytuje on juz nowy obiekt. Brak
+  // uchwytow oznacza wiec, ze zaden watek nie odwoluje sie do obiektu
+  // zastapionego, a zmniejszenie licznika odwolan (pelna bariera)
+  // konczy jego odczyty
+
+  typename RetiredResources::iterator keptItor = retired_.begin();
+  for(typename RetiredResources::iterator retItor = retired_.begin();
+    retItor != retired_.end();
+    ++retItor)
+  {
+    if( !all && retItor->owner_->isShared() )
+      *keptItor++ = *retItor;
+    else
+      delete retItor->resource_;
+  }
+
+  retired_.erase(keptItor, retired_.end());
+}
+
+//
+template<typename RESOURCE, typename FILE_FORMAT>
+void 
+DataFileResourceManager<RESOURCE, FILE_FORMAT>
+::setResourcesSearchDir(const std::string& path)
+{
+  if( searchDir_.insert(path).second && fileWatcher_.get() != 0 )
+    fileWatcher_->watch(path);
+}
+
+//
+template<typename RESOURCE, typename FILE_FORMAT>
+bool 
+DataFileResourceManager<RESOURCE, FILE_FORMAT>
+::removeResourcesSearchDir(const std::string& path)
+{
+  if( searchDir_.erase(path) == 0 )
+    return false;
+
+  if( fileWatcher_.get() != 0 )
+    fileWatcher_->unwatch(path);
+  return true;
+}
+
+template<typename RESOURCE, typename FILE_FORMAT>
+bool 
+DataFileResourceManager<RESOURCE, FILE_FORMAT>
+::isDirectoryValid( const DriveElementsEnumerator::ItorAutoPtr& elemItor )
+{
+  return elemItor->isDirectory() &&
+    elemItor->getElementName() != "." &&
+    elemItor->getElementName() != "..";
+}
+
+//
+template<typename RESOURCE, typename FILE_FORMAT>
+typename DataFileResourceManager<RESOURCE, FILE_FORMAT>::Handle 
+DataFileResourceManager<RESOURCE, FILE_FORMAT>
+::getResource(const std::string& fileName)
+{
+  // Z pobraniem uchwytu do zasobu jedynie na podstawie nazwy pliku
+  // wiaze sie mozliwosc powstania dwuznacznego dopasowania identyfikatora
+  // (nazwy pliku) do danych zasobu.
+  // Aby wykonac dopasowanie nalezy wykonac trawersacje przez wszystkie
+  // zarejestrowane w obiekcie menadzera katalogi. W kazdej kolejnej iteracji
+  // poszukiwany jest odpowiadajacy identyfikatorowi zasob. Jesli zadana 
+  // nazwa zasobu bedzie odwzorowana wiecej niz raz, zdarzenie to zostanie 
+  // zgloszone w postaci obiektu wyjatku informujacego o niemoznosci 
+  // jednoznacznego dopasowania identyfikatora do zasobu
+
+  // Sciezki wszystkich katalogow sa sprawdzane jednym przejsciem
+  // drzewa TST (PathToTSTHandle::findHandles) - wspolne przedrostki
+  // nazw katalogow nie sa porownywane wielokrotnie
+
+  std::vector<std::string> paths;
+  paths.reserve(searchDir_.size());
+
+  for(DirectoriesItor dirItor = searchDir_.begin();
+    dirItor != searchDir_.end();
+    ++dirItor)
+  {
+    paths.push_back(*dirItor + separator_ + fileName);
+  }
+
+  std::vector<TSTHandle> tstHandles;
+  tstHandles.reserve(paths.size());
+
+  const size_t MAPPED_COUNT = pathToTSTHandle_.findHandles(
+    paths.begin(), paths.end(), std::back_inserter(tstHandles) );
+
+  if( MAPPED_COUNT > 1 )
+    throw createResourceFileIdAmbiguousException(fileName);
+  
+  if( MAPPED_COUNT == 0 )
+    throw createUnvalidIdException(fileName);
+
+  typename std::vector<TSTHandle>::const_iterator handleItor = 
+    tstHandles.begin();
+  while( *handleItor == PathToTSTHandle::invalidHandle() )
+    ++handleItor;
+
+  return Handle(*this, *handleItor);
+}
+
+//
+template<typename RESOURCE, typename FILE_FORMAT>
+typename DataFileResourceManager<RESOURCE, FILE_FORMAT>::Handle 
+DataFileResourceManager<RESOURCE, FILE_FORMAT>
+::getResource(const std::string& fileName,
+              const std::string& directory)
+{
+  // Chcac pobrac uchwyt do zasobu o zadanym identyfikatorze, oraz
+  // sciezce okreslajacej katalog, w ktorym sie znajduje nalezy
+  // sprawdzic, czy wartosc konkatencji argumentow wywolania funkcji
+  // (pelna sciezka okreslajace zrodlo danych zasobu) jest
+  // odwzorowana w strukturze drzewa TST danych menadzera.
+  // Odwzorowanie zwroci wartosc prawda wtedy i tylko wtedy, gdy
+  // zasob byl w przeszlosci wczytywany. Jest to rownoznaczne
+  // ze stwierdzeniem, iz istnieje mozliwosc pobrania jego uchwytu,
+  // dzieki ktoremu wywolujacy metode otrzymuje mozliwosc pobierania
+  // danych zasobu
+
+  const std::string PATH = directory + separator_ + fileName;
+
+  TSTHandle tstHandle;
+  if( pathToTSTHandle_.findHandle(PATH, &tstHandle) )
+    return Handle( *this, tstHandle );
+  else
+    throw createUnvalidIdException(fileName);
+}
+
+//
+template<typename RESOURCE, typename FILE_FORMAT>
+void 
+DataFileResourceManager<RESOURCE, FILE_FORMAT>
+::purgeAll()
+{
+  const size_t  EMPTY = 0;
+  usedMemory_ = EMPTY;
+  releaseRetiredResources(true);
+   
+  if( fileWatcher_.get() != 0 ) {
+    for(DirectoriesItor dirItor = searchDir_.begin();
+      dirItor != searchDir_.end();
+      ++dirItor)
+    {
+      fileWatcher_->unwatch(*dirItor);
+    }
+  }
+
+  Directories().swap(searchDir_);
+  for(int priority = 0; priority < PRIORITIES_COUNT; ++priority)
+    ResourcesList().swap(resources_[priority]);
+  ResourcesList().swap(idleResources_);
+  resourcesCount_ = 0;
+  TSTHandleToPath().swap(tstHandleToPath_);
+  TSTHandleToShrRes().swap(tstHandleToShrRes_);
+  PathToTSTHandle().swap(pathToTSTHandle_);
+
+  // Uchwyty TST sa przydzielane od poczatku, wiec wyniki zadan zleconych
+  // przed wyczyszczeniem nie moga trafic do nowych posrednikow
+  setLoaderThreads( getLoaderThreads() );
+}
+
+//
+template<typename RESOURCE, typename FILE_FORMAT>
+void 
+DataFileResourceManager<RESOURCE, FILE_FORMAT>
+::loadResourcesFromDir(const std::string& path)
+{
+  DriveElementsEnumeratorAutoPtr dirElemsEnum( elementsEnum_->clone() );
+  dirElemsEnum->setDirectory(path);
+
+  for(DriveElementsEnumerator::ItorAutoPtr fileEnum(dirElemsEnum->getItor());
+    fileEnum->isValid();
+    fileEnum->moveToNextElement())
+  {
+    const std::string& FILE_OR_DIR_ELEMENT = fileEnum->getElementName();
+    if( elementMatcher_->match(FILE_OR_DIR_ELEMENT) &&
+      !pathToTSTHandle_.isIdMapped(path + separator_ + FILE_OR_DIR_ELEMENT) ) 
+    {
+      resourceManage_->load(path, FILE_OR_DIR_ELEMENT);
+      SharedResource res(*this, FILE_OR_DIR_ELEMENT, path);
+      insertResource( res );
+      setResourcePath( res.getTstHandle(), path, FILE_OR_DIR_ELEMENT );
+    }
+  }
+  setResourcesSearchDir(path);
+}
+
+//
+template<typename RESOURCE, typename FILE_FORMAT>
+void 
+DataFileResourceManager<RESOURCE, FILE_FORMAT>
+::loadResourcesFromTree(const std::string& rootPathNode)
+{
+  // Metoda wykonuje funkcje wczytania zasobow (spelniajacych okreslone
+  // kryterium) znajdujacych sie w strukturze katalogow, ktorej korzeniem
+  // jest zadana przez argument wywolania wartosc determinujaca poczatkowa
+  // sciezke (katalog) poszukiwan.
+
+  const std::string& PATH = rootPathNode;
+
+  DriveElementsEnumeratorAutoPtr dirElemsEnum( elementsEnum_->clone() );
+  dirElemsEnum->setDirectory(PATH);
+  
+  // Aby wykonac ewentualne wczytanie zasobow w pierwszej kolejnosci
+  // nalezy sprawdzic biezacy katalog w poszukiwaniu elementow 
+  // spelniajacych okreslone kryterium (np. dopasowanie nazwy pliku 
+  // do zadanego rozszezenia).
+  
+  // Oczywiscie jezeli aktualnie sprawdzany element jest katalogiem
+  // wowczas wchodzimy w rekurencyjne wywolania, aby przejzec wszystkie
+  // odnogi katalogow.
+  
+  // Gdy trawersowany element spelnia warunek okreslony przez instancje 
+  // typu ElementMatcher, mozemy dokonac wczytania zasobu. W pierwszej
+  // kolejnosci dajemy mozliwosc uzytkownikowi zareagowania na 
+  // przeprowadzane dzialanie. Nastepnie tworzymy posrednika, ktory 
+  // reprezentuje zasob, oraz powiadamiamy wewnetrzne struktury
+  // menadzera o zaistnialym zdarzeniu
+
+  for(DriveElementsEnumerator::ItorAutoPtr elemItor( dirElemsEnum->getItor() );
+    elemItor->isValid();
+    elemItor->moveToNextElement())
+  {
+    if( isDirectoryValid(elemItor) ) 
+    {
+      loadResourcesFromTree( PATH + separator_ + elemItor->getElementName() );
+    }
+    else 
+    {
+      const std::string& FILE_ELEMENT = elemItor->getElementName();
+  
+      if( elementMatcher_->match(FILE_ELEMENT) &&
+        !pathToTSTHandle_.isIdMapped(PATH + separator_ + FILE_ELEMENT) ) 
+      {
+        resourceManage_->load(PATH, FILE_ELEMENT);
+
+        // Tworzac obiekt posrednika wykonuje on prace informujaca
+        // wewnetrzna strukture TST menadzera o nowej sciezce zasobu.
+        // Ustalony zostaje priorytet zasobu rowny sredniej wartosci.
+        // Wartosc udostepnionego czasu systemowego sluzy do inicjalizacji
+        // zmiennej okreslajacej ostatni czas dostepu do zasobu
+
+        SharedResource proxyResource(*this, FILE_ELEMENT, PATH);
+
+        insertResource( proxyResource );
+
+        setResourcePath( proxyResource.getTstHandle(), PATH, FILE_ELEMENT );
+      
+        setResourcesSearchDir(PATH);
+      }
+    }
+  }
+}
+
+//
+template<typename RESOURCE, typename FILE_FORMAT>
+void 
+DataFileResourceManager<RESOURCE, FILE_FORMAT>
+::loadResources()
 {
+  // Aby odczytac wszystkie zasoby znajdujace sie w wyszczegolnionych
+  // katalogach (wykorzystanie metody setResourcesSearchDir) nalezy
+  // dla kazdego z nich wykonac funkcje odczytu zasobow z zadanego
+  // katalogu. Zasoby, ktore beda wczytane musza spelniac zadane kryterium
+  // okreslone przez obiekt typu ElementMatcher
+
+  for(DirectoriesItor dirItor = searchDir_.begin();
+    dirItor != searchDir_.end();
+    ++dirItor)
+  {
+    const std::string& DIRECTORY_PATH = *dirItor;
+    loadResourcesFromDir( DIRECTORY_PATH );
+  }
 }
 
 //
 template<typename RESOURCE, typename FILE_FORMAT>
 void 
-DataFileResourceManager<RESOURCE, FILE_FORMAT>::SharedResource
-::acquire() const
+DataFileResourceManager<RESOURCE, FILE_FORMAT>
+::acquireResourcesFromDir(const std::string& path)
 {
-  // Aby pozyskac zasob, trzeba sprawdzic czy aktualnie nie znajduje sie 
-  // on w pamieci obslugiwanej przez zarzadce. Jesli menadzer zwolil obszar 
-  // danych mu przynaleznych na rzecz innego pozyskiwanego zasobu, 
-  // wowczas nalezy ponownie wczytac go z zewnetrznego zrodla. Aby prawidlowo
-  // wykonac to zadanie trzeba zdeszyfrowac wartosc uchwytu okreslajaca
-  // jednoznacznie sciezke dostepu do zewnetrznych danych zasobu. Po wykonaniu
-  // tej czynnosci, wystarczy przekazac odpowiedzialnosc nowo utworzonemu 
-  // wspoldzielonemu obiektowi, polegajaca na wczytaniu swoich danych
-  
-  if( !isLoaded() )
+  elementsEnum_->setDirectory(path);
+
+  for(DriveElementsEnumerator::ItorAutoPtr fileEnum(elementsEnum_->getItor());
+    fileEnum->isValid();
+    fileEnum->moveToNextElement())
   {
-    Path& pathPair = owner_.tstHandleToPath_[ handle_ ];
-    const Directory& DIRECTORY = pathPair.first;
-    const FileName&  FILE_NAME = pathPair.second;
-    std::string      PATH = DIRECTORY + "\\" + FILE_NAME;
-    std::ifstream input(PATH.c_str(), std::ios_base::binary);
-    if(!input)
-      throw FailOnResourceAcquireException(PATH);
-    resource_ = ResourceAutoPtr( new RESOURCE(input) );
+    SharedResource resource(*this, fileEnum->getElementName(), path);
+    setResourcePath( resource.getTstHandle(), path, 
+      fileEnum->getElementName() );
+    insertResource( resource ).acquire();
   }
 
-  Utilities::assertion( isLoaded(),
-    "Obiekt nie zostal wczytany! Blad wewnetrzny!" );
+  setResourcesSearchDir(path);
 }
 
 //
 template<typename RESOURCE, typename FILE_FORMAT>
-void
-DataFileResourceManager<RESOURCE, FILE_FORMAT>::SharedResource
-::release() const
+void 
+DataFileResourceManager<RESOURCE, FILE_FORMAT>
+::acquireResourcesFromTree(const std::string& path)
 {
-  // Operacja zwolnienia pamieci przydzielonej zasobowi polega na 
-  // oproznieniu obszaru pamieci udostepnionej zbiorowi danych 
-  // tworzacych wspoldzielona jego czesc
+  loadResourcesFromTree(path);
 
-  if( isLoaded() ) 
-    resource_ = ResourceAutoPtr(0);
+  std::vector<TSTHandle> tstHandles;
+  collectTSTHandles(path, false, &tstHandles);
 
-  Utilities::assertion( resource_.get() == 0, 
-    "Zwolnienie zasobu zakonczone niepowodzeniem!" );
+  // Z pula watkow zasoby sa jedynie kolejkowane - metoda nie czeka
+  // na ich wczytanie (patrz processCompletedLoads, finishPendingLoads)
+
+  for(typename std::vector<TSTHandle>::const_iterator handleItor = 
+    tstHandles.begin(); handleItor != tstHandles.end(); ++handleItor)
+  {
+    const SharedResource* resource = findResourcePtr(*handleItor);
+    if( resource != 0 )
+      resource->requestLoad();
+  }
 }
 
 //
 template<typename RESOURCE, typename FILE_FORMAT>
 void 
-DataFileResourceManager<RESOURCE, FILE_FORMAT>::SharedResource
-::increaseRef() const
-{ 
-  Utilities::assertion(
-    referenceCounter_ != std::numeric_limits<RefCounter>::max(),
-    "Maksymalna wartosc licznika odwolan! Mozliwy blad przepelnienia!" );
+DataFileResourceManager<RESOURCE, FILE_FORMAT>
+::acquireResourcesFromTree(const std::string&  path,
+                           BatchFileReader&    reader)
+{
+  // Zamiast odczytu kolejnych plikow blokujacymi strumieniami, sciezki
+  // wszystkich niewczytanych zasobow sa przekazywane czytnikowi jednym
+  // zleceniem. Wyniki sa odbierane w kolejnosci zakonczenia odczytu -
+  // tworzenie zasobu z pierwszego pliku nie czeka na odczyt pozostalych
+
+  loadResourcesFromTree(path);
+
+  std::vector<TSTHandle> tstHandles;
+  collectTSTHandles(path, false, &tstHandles);
+
+  // Dane archiwum zasobow sa juz w pamieci - odczyt wsadowy jest zbedny
+  if( archive_ != 0 ) {
+    for(typename std::vector<TSTHandle>::const_iterator handleItor = 
+      tstHandles.begin(); handleItor != tstHandles.end(); ++handleItor)
+    {
+      const SharedResource* resource = findResourcePtr(*handleItor);
+      if( resource != 0 )
+        resource->acquire();
+    }
+    return;
+  }
+
+  std::vector<TSTHandle> batchHandles;
+  BatchFileReader::Paths batchPaths;
+
+  for(typename std::vector<TSTHandle>::const_iterator handleItor = 
+    tstHandles.begin(); handleItor != tstHandles.end(); ++handleItor)
+  {
+    const SharedResource* resource = findResourcePtr(*handleItor);
+    if( resource != 0 && !resource->isLoaded() ) {
+      batchHandles.push_back(*handleItor);
+      batchPaths.push_back(resource->getFilePath());
+    }
+  }
 
-  ++referenceCounter_; 
+  if( batchPaths.empty() )
+    return;
+
+  reader.submit(batchPaths);
+
+  BatchFileReader::Completion completion;
+  while( reader.waitCompleted(&completion) )
+  {
+    findResource( batchHandles[completion.request_] ).completeRead(
+      completion.data_, completion.size_, completion.succeeded_ );
+  }
 }
-  
+
 //
 template<typename RESOURCE, typename FILE_FORMAT>
 void 
-DataFileResourceManager<RESOURCE, FILE_FORMAT>::SharedResource
-::decreaseRef() const
+DataFileResourceManager<RESOURCE, FILE_FORMAT>
+::releaseResourcesFromDir(const std::string& path)
 {
-  // Wspoldzielony zasob zawsze posiada przynajmniej wartosc rowna
-  // jednosci wynikla z posiadania przez menadzer prawa wlasnosci do zasobu
+  // Zasoby katalogu sa odnajdywane w drzewie TST na podstawie
+  // przedrostka sciezki. Koszt operacji zalezy od liczby zasobow
+  // poddrzewa, a nie od liczby wszystkich zasobow menadzera
 
-//  Utilities::assertion( referenceCounter_ <= 1, 
-//  "Licznik odwolan zasobu posiada bledna wartosc!" );
+  std::vector<TSTHandle> tstHandles;
+  collectTSTHandles(path, true, &tstHandles);
 
-  --referenceCounter_; 
+  for(typename std::vector<TSTHandle>::const_iterator handleItor = 
+    tstHandles.begin(); handleItor != tstHandles.end(); ++handleItor)
+  {
+    const SharedResource* resource = findResourcePtr(*handleItor);
+    if( resource != 0 )
+      resource->release();
+  }
 }
 
 //
 template<typename RESOURCE, typename FILE_FORMAT>
 void 
-DataFileResourceManager<RESOURCE, FILE_FORMAT>::SharedResource
-::setPriority(ResourcePriority priority) const
+DataFileResourceManager<RESOURCE, FILE_FORMAT>
+::releaseResourcesFromTree(const std::string& path)
 {
-  // Jesli biezacy priorytet posiada rozna wartosc od pozadanej przez
-  // klienta, ktory inicjuje komunikat, wowczas nalezy przystapic do jego
-  // zmiany. Implikacja calego zajscia jest zmiana pozycji zasobu 
-  // w posiadajacym do niego prawa wlasnosci agregacie-menadzerze,
-  // ktora wykonywana jest za posrednictwem wywolania metody update()
+  std::vector<TSTHandle> tstHandles;
+  collectTSTHandles(path, false, &tstHandles);
 
-  if(priority_ != priority) {
-    priority_ = priority; 
-    update();
+  for(typename std::vector<TSTHandle>::const_iterator handleItor = 
+    tstHandles.begin(); handleItor != tstHandles.end(); ++handleItor)
+  {
+    const SharedResource* resource = findResourcePtr(*handleItor);
+    if( resource != 0 )
+      resource->release();
   }
 }
 
 //
 template<typename RESOURCE, typename FILE_FORMAT>
-typename DataFileResourceManager<RESOURCE, FILE_FORMAT>::ResourcePriority 
-DataFileResourceManager<RESOURCE, FILE_FORMAT>::SharedResource
-::getPriority() const 
-{ 
-  return priority_; 
+void 
+DataFileResourceManager<RESOURCE, FILE_FORMAT>
+::collectTSTHandles(const std::string&       path,
+                    bool                     directOnly,
+                    std::vector<TSTHandle>*  handles) const
+{
+  // Separator zamykajacy przedrostek wyklucza katalogi o nazwach
+  // rozpoczynajacych sie od nazwy path (np. "data" oraz "data2")
+
+  pathToTSTHandle_.forEachWithPrefix( path + separator_,
+    TSTHandleCollector(handles, directOnly, separator_[0]) );
 }
-  
+
 //
 template<typename RESOURCE, typename FILE_FORMAT>
-size_t
-DataFileResourceManager<RESOURCE, FILE_FORMAT>::SharedResource
-::getByteSize() const 
+void 
+DataFileResourceManager<RESOURCE, FILE_FORMAT>
+::setLoaderThreads(unsigned int threadsCount)
 {
-  // Do prawidlowego dzialania funkcji jest wymagane zdefiniowanie
-  // przez uzytkownika metody getByteSize() w klasie zasobu
+  // Zniszczenie puli konczy prace watkow i zwalnia nieodebrane wyniki,
+  // zatem wszystkie zasoby oczekujace powracaja do stanu niewczytanego
 
-  update();
-  return resource_->getByteSize();
+  loader_ = LoaderAutoPtr(0);
+
+  for(int priority = 0; priority < PRIORITIES_COUNT; ++priority)
+  {
+    ResourcesList& list = resources_[priority];
+    for(ResourcesListItor resItor = list.begin(); 
+      resItor != list.end(); 
+      ++resItor)
+    {
+      resItor->cancelLoad();
+    }
+  }
+
+  for(ResourcesListItor resItor = idleResources_.begin(); 
+    resItor != idleResources_.end(); 
+    ++resItor)
+  {
+    resItor->cancelLoad();
+  }
+
+  if( threadsCount != 0 )
+    loader_ = LoaderAutoPtr( new Loader(threadsCount, PRIORITIES_COUNT,
+      timeInformation_.get()) );
 }
 
 //
 template<typename RESOURCE, typename FILE_FORMAT>
-bool 
-DataFileResourceManager<RESOURCE, FILE_FORMAT>::SharedResource
-::isShared() const 
-{ 
-  return referenceCounter_ > 1; 
+unsigned int
+DataFileResourceManager<RESOURCE, FILE_FORMAT>
+::getLoaderThreads() const
+{
+  return loader_.get() != 0 ? 
+    static_cast<unsigned int>( loader_->threadsCount() ) : 0;
 }
 
 //
 template<typename RESOURCE, typename FILE_FORMAT>
-bool 
-DataFileResourceManager<RESOURCE, FILE_FORMAT>::SharedResource
-::operator <(const SharedResource& rhs) const 
+typename DataFileResourceManager<RESOURCE, FILE_FORMAT>::Handle 
+DataFileResourceManager<RESOURCE, FILE_FORMAT>
+::prefetch(const std::string& fileName)
 {
-  if( priority_ < rhs.priority_ ) 
-    return true;
-  else if( priority_ > rhs.priority_ )
-    return false;
-  else { // zasoby o rownych priorytetach
-    if( lastAccess_ < rhs.lastAccess_ )
-      return true;
-    else if( lastAccess_ > rhs.lastAccess_ )
-      return false;
-    else // rowne czasy ostatniego dostepu (malo prawdopodobne)
-      return false;
+  Handle handle = getResource(fileName);
+
+  ConcurrentLock lock(*this);
+  handle.dereferenceResource().requestLoad();
+  return handle;
+}
+
+//
+template<typename RESOURCE, typename FILE_FORMAT>
+typename DataFileResourceManager<RESOURCE, FILE_FORMAT>::Handle 
+DataFileResourceManager<RESOURCE, FILE_FORMAT>
+::prefetch(const std::string& fileName,
+           const std::string& directory)
+{
+  Handle handle = getResource(fileName, directory);
+
+  ConcurrentLock lock(*this);
+  handle.dereferenceResource().requestLoad();
+  return handle;
+}
+
+//
+template<typename RESOURCE, typename FILE_FORMAT>
+size_t 
+DataFileResourceManager<RESOURCE, FILE_FORMAT>
+::processCompletedLoads()
+{
+  // Posrednik mogl zostac usuniety w trakcie wczytywania - wowczas
+  // wynik jest jedynie zwalniany
+
+  if( loader_.get() == 0 || !loader_->hasCompleted() )
+    return 0;
+
+  ConcurrentLock lock(*this);
+
+  typename Loader::Results results;
+  loader_->takeCompleted(&results);
+
+  for(typename Loader::Results::const_iterator resultItor = results.begin();
+    resultItor != results.end();
+    ++resultItor)
+  {
+    const SharedResource* resource = findResourcePtr(resultItor->key_);
+    if( resource == 0 ) {
+      delete resultItor->resource_;
+      continue;
+    }
+
+    if( resultItor->resource_ != 0 ) {
+      statistics_.recordRead(resultItor->readMicroseconds_);
+      statistics_.recordParse(resultItor->parseMicroseconds_);
+    }
+
+    resource->completeLoad( resultItor->resource_, 
+      resultItor->readMicroseconds_ + resultItor->parseMicroseconds_ );
   }
+
+  return results.size();
 }
 
 //
 template<typename RESOURCE, typename FILE_FORMAT>
-const RESOURCE& 
-DataFileResourceManager<RESOURCE, FILE_FORMAT>::SharedResource
-::getResource() const
+void 
+DataFileResourceManager<RESOURCE, FILE_FORMAT>
+::finishPendingLoads()
 {
-  update();
-  return *resource_;
+  if( loader_.get() == 0 )
+    return;
+
+  loader_->waitUntilIdle();
+  processCompletedLoads();
 }
 
 //
 template<typename RESOURCE, typename FILE_FORMAT>
-typename DataFileResourceManager<RESOURCE, FILE_FORMAT>::TSTHandle 
-DataFileResourceManager<RESOURCE, FILE_FORMAT>::SharedResource
-::getTstHandle() const
+size_t 
+DataFileResourceManager<RESOURCE, FILE_FORMAT>
+::pendingLoadsCount() const
 {
-  return handle_;
+  return loader_.get() != 0 ? loader_->pendingCount() : 0;
 }
 
 //
 template<typename RESOURCE, typename FILE_FORMAT>
 bool
-DataFileResourceManager<RESOURCE, FILE_FORMAT>::SharedResource
-::isLoaded() const 
-{ 
-  return resource_.get() != 0; 
+DataFileResourceManager<RESOURCE, FILE_FORMAT>
+::enqueueLoad(TSTHandle           handle,
+              const std::string&  path,
+              ResourcePriority    priority)
+{
+  if( archive_ == 0 ) {
+    loader_->enqueue(handle, path, priority, decoding_);
+    return true;
+  }
+
+  // Brak wpisu zostanie zgloszony dopiero podczas pozyskania zasobu
+  // (acquire), tak jak nieudany odczyt pliku
+  Utilities::ByteSpan bytes;
+  if( !archive_->find(path, &bytes) )
+    return false;
+
+  loader_->enqueue(handle, path, bytes, priority, decoding_);
+  return true;
 }
 
 //
 template<typename RESOURCE, typename FILE_FORMAT>
-void
-DataFileResourceManager<RESOURCE, FILE_FORMAT>::SharedResource
-::update() const
+char
+DataFileResourceManager<RESOURCE, FILE_FORMAT>
+::pathSeparatorOf(const DriveElementsEnumerator* fileEnumerator)
 {
-  // Przy kazdym odwolaniu do zasobu jest uwzgledniany aktualny
-  // czas, ktorego wartosc jest jednym z czynnikow kryterium
-  // sortowania w menadzerze. Dzieki aktualizacji tej wartosci
-  // w sytuacji niedoboru pamieci podczas pobierania nowych zasobow,
-  // obiekty bedace nieuzywane od dluzszego czasu sa zwalniane,
-  // tym samym umozliwiajac pobranie pozadanych zewnetrznych danych
-  // zasobow.
-  // Proces wykonania aktualizacji struktury odwzorowujacej
-  // uszeregowana sekwencje, w ktorej nieuzytki, oraz obiekty
-  // najczesciej wykorzystywane sa wzgledem siebie posortowane jest
-  // podyktowany wewnetrzna reprezentacja struktury zbioru. Aby
-  // etap sortowania przebiegl w prawidlowy sposob, z agregatu
-  // najpierw usuwany jest obiekt udostepnianego zasobu, nastepnie
-  // po wykonaniu aktualizacji czasu jest on spowrotem umieszczany
-  // w kolekcji na nowej - okreslonej przez kryterium - pozycji.
+  // Separator jest pobierany na liscie inicjalizacyjnej konstruktora,
+  // przed przejeciem enumeratora przez elementsEnum_
+  Utilities::assertion( fileEnumerator != 0,
+    "DataFileResourceManager: Nie przekazano enumeratora elementow!" );
 
-  if( !isLoaded() )
-    acquire();
+  return fileEnumerator != 0 ? fileEnumerator->getPathSeparator() : '\\';
+}
+
+//
+template<typename RESOURCE, typename FILE_FORMAT>
+RESOURCE*
+DataFileResourceManager<RESOURCE, FILE_FORMAT>
+::createFromSpan(const Utilities::ByteSpan& bytes)
+{
+  return new RESOURCE(bytes);
+}
 
-  // Kopiowanie obiektu wspoldzielonego zasobu w tym wypadku nie jest
-  // pracochlonnym zadaniem, poniewaz wiekszosc z danych skladowych
-  // jest typu wbudowanego. Kopiowanie inteligentnego wskaznika
-  // reprezentujacego obiekt zasobu rowniez jest bezpieczne, poniewaz
-  // prawa wlasnosci sa poprawnie przekazywane z, oraz do obiektow
-  // bioracych udzial w operacji
+//
+template<typename RESOURCE, typename FILE_FORMAT>
+RESOURCE*
+DataFileResourceManager<RESOURCE, FILE_FORMAT>
+::createFromProcessed(const Utilities::ByteSpan& processed)
+{
+  return RESOURCE::createFromProcessed(processed);
+}
 
-  SharedResource resourceCopy(*this);
-  resourceCopy.lastAccess_ = owner_.timeInformation_->getSystemTime();
-  owner_.insertResource(resourceCopy);
-  owner_.removeResource(*this);
+//
+template<typename RESOURCE, typename FILE_FORMAT>
+void
+DataFileResourceManager<RESOURCE, FILE_FORMAT>
+::writeProcessed(const RESOURCE&  resource,
+                 std::ostream&    output)
+{
+  resource.writeProcessed(output);
 }
 
 //
 template<typename RESOURCE, typename FILE_FORMAT>
-DataFileResourceManager<RESOURCE, FILE_FORMAT>::Handle
-::Handle(DataFileResourceManager&  owner,
-         TSTHandle                 handle)
-  : owner_(owner)
-  , handle_(handle)
+RESOURCE*
+DataFileResourceManager<RESOURCE, FILE_FORMAT>
+::createFromBytes(const Utilities::ByteSpan& bytes) const
 {
-  dereferenceResource().increaseRef();
+  return Loader::create(bytes, decoding_);
 }
 
 //
 template<typename RESOURCE, typename FILE_FORMAT>
-typename const DataFileResourceManager<RESOURCE, FILE_FORMAT>::SharedResource&
-DataFileResourceManager<RESOURCE, FILE_FORMAT>::Handle
-::dereferenceResource() const
+void 
+DataFileResourceManager<RESOURCE, FILE_FORMAT>
+::setResourceArchive(const ResourceArchive* archive)
 {
-  return *( owner_.tstHandleToShrRes_[ handle_ ] );
+  // Zasoby juz wczytane pozostaja w pamieci - zmiana dotyczy jedynie
+  // kolejnych odczytow
+  archive_ = archive;
 }
 
 //
 template<typename RESOURCE, typename FILE_FORMAT>
+void 
 DataFileResourceManager<RESOURCE, FILE_FORMAT>
-::DataFileResourceManager(DriveElementsEnumerator*  fileEnumerator,
-                          TimeInformation*          timeInformation)
-  : elementsEnum_(fileEnumerator)
-  , timeInformation_(timeInformation)
-  , resourceManage_(createNullResourceManage())
-  , elementMatcher_(createNullElementMatcher())
-  , usedMemory_(0)
+::setMappedLoading(bool enabled)
 {
-  const int ONE_MEGABYTE = 1024;
-  maxMemory_ = ONE_MEGABYTE;
+  // Zadania juz umieszczone w kolejkach puli watkow zachowuja sposob
+  // odczytu z chwili ich zlecenia
+  decoding_.spanFactory_ = enabled ? &createFromSpan : 0;
 }
 
 //
 template<typename RESOURCE, typename FILE_FORMAT>
-void
+bool
 DataFileResourceManager<RESOURCE, FILE_FORMAT>
-::setResourceManage(ResourceManage* resourceManage)
+::isMappedLoading() const
 {
-  resourceManage_ = ResourceManageAutoPtr(resourceManage);
+  return decoding_.spanFactory_ != 0;
 }
 
 //
 template<typename RESOURCE, typename FILE_FORMAT>
 void 
 DataFileResourceManager<RESOURCE, FILE_FORMAT>
-::setElementMatcher(ElementMatcher* elementMatcher)
+::setProcessedCache(const ProcessedCache* cache)
 {
-  elementMatcher_ = ElementMatcherAutoPtr(elementMatcher);
+  // Zadania juz umieszczone w kolejkach puli watkow zachowuja sposob
+  // odczytu z chwili ich zlecenia
+  decoding_.cache_         = cache;
+  decoding_.fromProcessed_ = cache != 0 ? &createFromProcessed : 0;
+  decoding_.toProcessed_   = cache != 0 ? &writeProcessed : 0;
 }
 
 //
 template<typename RESOURCE, typename FILE_FORMAT>
 void 
 DataFileResourceManager<RESOURCE, FILE_FORMAT>
-::setMemoryMaximum(size_t memorySize)
+::setFileWatcher(FileWatcher* watcher)
 {
-  maxMemory_ = memorySize;
+  fileWatcher_ = FileWatcherAutoPtr(watcher);
+  if( fileWatcher_.get() == 0 )
+    return;
+
+  for(DirectoriesItor dirItor = searchDir_.begin();
+    dirItor != searchDir_.end();
+    ++dirItor)
+  {
+    fileWatcher_->watch(*dirItor);
+  }
 }
 
 //
 template<typename RESOURCE, typename FILE_FORMAT>
 size_t 
 DataFileResourceManager<RESOURCE, FILE_FORMAT>
-::getMemoryMaximum() const
+::processFileChanges(bool asynchronous)
 {
-  return maxMemory_;
+  // Zapis pliku czesto generuje kilka zdarzen (np. zapis pliku
+  // tymczasowego, usuniecie i przemianowanie), dlatego zmiany tej samej
+  // sciezki sa laczone - obowiazuje ostatnia. Utrata zdarzen (przepelnienie
+  // kolejki systemu) wymusza sprawdzenie wszystkich katalogow i ponowne
+  // wczytanie wszystkich wczytanych zasobow
+
+  if( fileWatcher_.get() == 0 )
+    return 0;
+
+  FileWatcher::Changes changes;
+  if( fileWatcher_->poll(&changes) == 0 || archive_ != 0 )
+    return 0;
+
+  typedef std::map<std::string, const FileWatcher::Change*>  LatestChanges;
+
+  LatestChanges latestChanges;
+  bool overflowed = false;
+
+  for(FileWatcher::Changes::const_iterator changeItor = changes.begin();
+    changeItor != changes.end();
+    ++changeItor)
+  {
+    if( changeItor->kind_ == FileWatcher::Change::OVERFLOWED )
+      overflowed = true;
+    else
+      latestChanges[ changeItor->directory_ + separator_ + changeItor->name_ ] = 
+        &*changeItor;
+  }
+
+  size_t updatedCount = 0;
+
+  for(typename LatestChanges::const_iterator changeItor = 
+    latestChanges.begin(); changeItor != latestChanges.end(); ++changeItor)
+  {
+    updatedCount += applyFileChange(*changeItor->second, asynchronous);
+  }
+
+  if( overflowed )
+  {
+    const size_t PREVIOUS_COUNT = resourcesCount_;
+    loadResources();
+    updatedCount += resourcesCount_ - PREVIOUS_COUNT;
+
+    for(typename TSTHandleToShrRes::const_iterator slotItor = 
+      tstHandleToShrRes_.begin(); slotItor != tstHandleToShrRes_.end(); 
+      ++slotItor)
+    {
+      try {
+        if( slotItor->registered_ && slotItor->itor_->reload(asynchronous) )
+          ++updatedCount;
+      }
+      catch(...) {
+      }
+    }
+  }
+
+  return updatedCount;
 }
 
 //
 template<typename RESOURCE, typename FILE_FORMAT>
-void 
+size_t 
 DataFileResourceManager<RESOURCE, FILE_FORMAT>
-::setResourcesSearchDir(const std::string& path)
+::applyFileChange(const FileWatcher::Change&  change,
+                  bool                        asynchronous)
 {
-  searchDir_.insert(path);
+  const std::string PATH = change.directory_ + separator_ + change.name_;
+
+  if( change.isDirectory_ )
+  {
+    // Katalog jest obserwowany niezaleznie od tego, czy zawiera juz pliki
+    // zasobow - moga one zostac skopiowane po jego utworzeniu
+    if( change.kind_ != FileWatcher::Change::CHANGED )
+      return 0;
+
+    const size_t PREVIOUS_COUNT = resourcesCount_;
+    setResourcesSearchDir(PATH);
+    loadResourcesFromTree(PATH);
+    return resourcesCount_ - PREVIOUS_COUNT;
+  }
+
+  if( !elementMatcher_->match(change.name_) )
+    return 0;
+
+  TSTHandle tstHandle;
+  const SharedResource* resource = 
+    pathToTSTHandle_.findHandle(PATH, &tstHandle) ? 
+      findResourcePtr(tstHandle) : 0;
+
+  if( resource == 0 )
+  {
+    return change.kind_ == FileWatcher::Change::CHANGED && 
+      registerResource(change.directory_, change.name_) ? 1 : 0;
+  }
+
+  if( change.kind_ == FileWatcher::Change::REMOVED )
+  {
+    if( !resource->isLoaded() || resource->isShared() )
+      return 0;
+
+    resourceManage_->release(change.directory_, change.name_);
+    resource->release();
+    return 1;
+  }
+
+  // Niepowodzenie wczytania nowej zawartosci (np. plik niekompletny,
+  // badz w niepoprawnym formacie) nie moze przerwac pracy programu -
+  // zasob zachowuje poprzednia zawartosc
+  try {
+    return resource->reload(asynchronous) ? 1 : 0;
+  }
+  catch(...) {
+    return 0;
+  }
 }
 
 //
 template<typename RESOURCE, typename FILE_FORMAT>
 bool 
 DataFileResourceManager<RESOURCE, FILE_FORMAT>
-::removeResourcesSearchDir(const std::string& path)
+::registerResource(const std::string&  directory,
+                   const std::string&  fileName)
 {
-  return searchDir_.erase(path) != 0;
+  if( pathToTSTHandle_.isIdMapped(directory + separator_ + fileName) )
+    return false;
+
+  resourceManage_->load(directory, fileName);
+  SharedResource resource(*this, fileName, directory);
+  insertResource( resource );
+  setResourcePath( resource.getTstHandle(), directory, fileName );
+  return true;
 }
 
+//
 template<typename RESOURCE, typename FILE_FORMAT>
-bool 
+const typename DataFileResourceManager<RESOURCE, FILE_FORMAT>::SharedResource&
 DataFileResourceManager<RESOURCE, FILE_FORMAT>
-::isDirectoryValid( const DriveElementsEnumerator::ItorAutoPtr& elemItor )
-{
-  return elemItor->isDirectory() &&
-    elemItor->getElementName() != "." &&
-    elemItor->getElementName() != "..";
+::insertResource(const SharedResource& resource)
+{  
+  const TSTHandle HANDLE = resource.getTstHandle();
+
+  if( HANDLE >= tstHandleToShrRes_.size() )
+    tstHandleToShrRes_.resize( HANDLE + 1,
+      ResourceSlot(resources_[LOW_PRIORITY].end(), false, 0) );
+
+  ResourceSlot& slot = tstHandleToShrRes_[HANDLE];
+  if( !slot.registered_ ) {
+    ResourcesList& list = resource.isLoaded() ? 
+      resources_[ resource.getPriority() ] : idleResources_;
+    slot.itor_ = list.insert(list.end(), resource);
+    slot.registered_ = true;
+    slot.generation_ = ++lastGeneration_;
+    ++resourcesCount_;
+  }
+
+  return *slot.itor_;
 }
 
 //
 template<typename RESOURCE, typename FILE_FORMAT>
-typename DataFileResourceManager<RESOURCE, FILE_FORMAT>::Handle 
+void 
 DataFileResourceManager<RESOURCE, FILE_FORMAT>
-::getResource(const std::string& fileName)
+::releaseMemory(size_t                 bytesNeeded,
+                const SharedResource*  keep)
 {
-  // Z pobraniem uchwytu do zasobu jedynie na podstawie nazwy pliku
-  // wiaze sie mozliwosc powstania dwuznacznego dopasowania identyfikatora
-  // (nazwy pliku) do danych zasobu.
-  // Aby wykonac dopasowanie nalezy wykonac trawersacje przez wszystkie
-  // zarejestrowane w obiekcie menadzera katalogi. W kazdej kolejnej iteracji
-  // poszukiwany jest odpowiadajacy identyfikatorowi zasob. Jesli zadana 
-  // nazwa zasobu bedzie odwzorowana wiecej niz raz, zdarzenie to zostanie 
-  // zgloszone w postaci obiektu wyjatku informujacego o niemoznosci 
-  // jednoznacznego dopasowania identyfikatora do zasobu
+  // Poczatki list priorytetow zawieraja zasoby najdawniej uzywane.
+  // Zwolniony zasob przechodzi do listy zasobow niewczytanych, dlatego
+  // iterator jest przesuwany przed zwolnieniem
 
-  bool handleAlreadyExists = false;
-  TSTHandle tstHandle;
+  if( concurrent_ ) {
+    applyDeferredTouches();
+    releaseRetiredResources(false);
+  }
 
-  for(DirectoriesItor dirItor = searchDir_.begin();
-    dirItor != searchDir_.end();
-    ++dirItor)
+  if( getMemoryBudget() != 0 ) {
+    getMemoryBudget()->reserve(bytesNeeded, keep);
+    return;
+  }
+
+  for(int priority = LOW_PRIORITY; priority < PRIORITIES_COUNT; ++priority)
   {
-    std::string path = *dirItor + "\\" + fileName;
-    
-    if( pathToTSTHandle_.isIdMapped(path) )
+    ResourcesList& list = resources_[priority];
+
+    for(ResourcesListItor resItor = list.begin(); 
+      resItor != list.end() && usedMemory_ + bytesNeeded > maxMemory_;)
     {
-      if( handleAlreadyExists )
-        throw createResourceFileIdAmbiguousException(fileName);
-      
-      handleAlreadyExists = true;
-      
-      tstHandle = pathToTSTHandle_.getHandle(path);
+      const ResourcesListItor CURRENT_ITOR = resItor++;
+      if( &*CURRENT_ITOR == keep || CURRENT_ITOR->isShared() )
+        continue;
+
+      evictResource(*CURRENT_ITOR);
     }
+
+    if( usedMemory_ + bytesNeeded <= maxMemory_ )
+      return;
   }
-  
-  if( handleAlreadyExists )
-    return Handle(*this, tstHandle);
-  else
-    throw createUnvalidIdException(fileName);
 }
 
 //
 template<typename RESOURCE, typename FILE_FORMAT>
-typename DataFileResourceManager<RESOURCE, FILE_FORMAT>::Handle 
+void 
 DataFileResourceManager<RESOURCE, FILE_FORMAT>
-::getResource(const std::string& fileName,
-              const std::string& directory)
+::evictResource(const SharedResource& resource)
 {
-  // Chcac pobrac uchwyt do zasobu o zadanym identyfikatorze, oraz
-  // sciezce okreslajacej katalog, w ktorym sie znajduje nalezy
-  // sprawdzic, czy wartosc konkatencji argumentow wywolania funkcji
-  // (pelna sciezka okreslajace zrodlo danych zasobu) jest
-  // odwzorowana w strukturze drzewa TST danych menadzera.
-  // Odwzorowanie zwroci wartosc prawda wtedy i tylko wtedy, gdy
-  // zasob byl w przeszlosci wczytywany. Jest to rownoznaczne
-  // ze stwierdzeniem, iz istnieje mozliwosc pobrania jego uchwytu,
-  // dzieki ktoremu wywolujacy metode otrzymuje mozliwosc pobierania
-  // danych zasobu
-
-  const std::string PATH = directory + "\\" + fileName;
+  if( !resource.prepareEviction() )
+    return;
 
-  if( pathToTSTHandle_.isIdMapped(PATH) )
-    return Handle( *this, pathToTSTHandle_.getHandle(PATH) );
-  else
-    throw createUnvalidIdException(fileName);
+  const Path& PATH = tstHandleToPath_[ resource.getTstHandle() ];
+  resourceManage_->release(PATH.first, PATH.second);
+  statistics_.recordEviction( resource.getLoadedByteSize() );
+  resource.release();
 }
 
 //
 template<typename RESOURCE, typename FILE_FORMAT>
 void 
 DataFileResourceManager<RESOURCE, FILE_FORMAT>
-::purgeAll()
+::resourceLoaded(const SharedResource&  resource,
+                 bool                   reloaded)
 {
-  const size_t  EMPTY = 0;
-  usedMemory_ = EMPTY;
-   
-  Directories().swap(searchDir_);
-  ResourcesSet().swap(resources_);
-  TSTHandleToPath().swap(tstHandleToPath_);
-  TSTHandleToShrRes().swap(tstHandleToShrRes_);
-  PathToTSTHandle().swap(pathToTSTHandle_);
+  // Posrednik nieumieszczony w menadzerze (kopia) nie posiada listy
+
+  const TSTHandle HANDLE = resource.getTstHandle();
+  if( HANDLE >= tstHandleToShrRes_.size() ||
+    !tstHandleToShrRes_[HANDLE].registered_ ||
+    &*tstHandleToShrRes_[HANDLE].itor_ != &resource )
+  {
+    return;
+  }
+
+  const ResourceSlot& SLOT = tstHandleToShrRes_[HANDLE];
+  ResourcesList& list = resources_[ resource.getPriority() ];
+  list.splice(list.end(), reloaded ? list : idleResources_, SLOT.itor_);
+
+  if( getMemoryBudget() != 0 )
+    SLOT.itor_->setAccessStamp( getMemoryBudget()->nextAccessStamp() );
 }
 
 //
 template<typename RESOURCE, typename FILE_FORMAT>
 void 
 DataFileResourceManager<RESOURCE, FILE_FORMAT>
-::loadResourcesFromDir(const std::string& path)
+::resourceReleased(const SharedResource& resource)
 {
-  DriveElementsEnumeratorAutoPtr dirElemsEnum( elementsEnum_->clone() );
-  dirElemsEnum->setDirectory(path);
-
-  for(DriveElementsEnumerator::ItorAutoPtr fileEnum(dirElemsEnum->getItor());
-    fileEnum->isValid();
-    fileEnum->moveToNextElement())
+  const TSTHandle HANDLE = resource.getTstHandle();
+  if( HANDLE >= tstHandleToShrRes_.size() ||
+    !tstHandleToShrRes_[HANDLE].registered_ ||
+    &*tstHandleToShrRes_[HANDLE].itor_ != &resource )
   {
-    const std::string& FILE_OR_DIR_ELEMENT = fileEnum->getElementName();
-    if( elementMatcher_->match(FILE_OR_DIR_ELEMENT) &&
-      !pathToTSTHandle_.isIdMapped(path + "\\" + FILE_OR_DIR_ELEMENT) ) 
-    {
-      resourceManage_->load(path, FILE_OR_DIR_ELEMENT);
-      SharedResource res(*this, FILE_OR_DIR_ELEMENT, path);
-      insertResource( res );
-      tstHandleToPath_.insert( TSTHandleToPathValueType( 
-        res.getTstHandle(),
-        std::make_pair(path, FILE_OR_DIR_ELEMENT) )
-      );
-    }
+    return;
   }
-  setResourcesSearchDir(path);
+
+  idleResources_.splice(idleResources_.end(), 
+    resources_[ resource.getPriority() ], tstHandleToShrRes_[HANDLE].itor_);
 }
 
 //
 template<typename RESOURCE, typename FILE_FORMAT>
-void 
+const typename DataFileResourceManager<RESOURCE, FILE_FORMAT>::SharedResource*
 DataFileResourceManager<RESOURCE, FILE_FORMAT>
-::loadResourcesFromTree(const std::string& rootPathNode)
+::findOldestEvictable(ResourcePriority  priority,
+                      const void*       keep) const
 {
-  // Metoda wykonuje funkcje wczytania zasobow (spelniajacych okreslone
-  // kryterium) znajdujacych sie w strukturze katalogow, ktorej korzeniem
-  // jest zadana przez argument wywolania wartosc determinujaca poczatkowa
-  // sciezke (katalog) poszukiwan.
+  const ResourcesList& LIST = resources_[priority];
 
-  const std::string& PATH = rootPathNode;
+  for(typename ResourcesList::const_iterator resItor = LIST.begin(); 
+    resItor != LIST.end(); 
+    ++resItor)
+  {
+    if( &*resItor != keep && !resItor->isShared() )
+      return &*resItor;
+  }
 
-  DriveElementsEnumeratorAutoPtr dirElemsEnum( elementsEnum_->clone() );
-  dirElemsEnum->setDirectory(PATH);
-  
-  // Aby wykonac ewentualne wczytanie zasobow w pierwszej kolejnosci
-  // nalezy sprawdzic biezacy katalog w poszukiwaniu elementow 
-  // spelniajacych okreslone kryterium (np. dopasowanie nazwy pliku 
-  // do zadanego rozszezenia).
-  
-  // Oczywiscie jezeli aktualnie sprawdzany element jest katalogiem
-  // wowczas wchodzimy w rekurencyjne wywolania, aby przejzec wszystkie
-  // odnogi katalogow.
-  
-  // Gdy trawersowany element spelnia warunek okreslony przez instancje 
-  // typu ElementMatcher, mozemy dokonac wczytania zasobu. W pierwszej
-  // kolejnosci dajemy mozliwosc uzytkownikowi zareagowania na 
-  // przeprowadzane dzialanie. Nastepnie tworzymy posrednika, ktory 
-  // reprezentuje zasob, oraz powiadamiamy wewnetrzne struktury
-  // menadzera o zaistnialym zdarzeniu
+  return 0;
+}
 
-  for(DriveElementsEnumerator::ItorAutoPtr elemItor( dirElemsEnum->getItor() );
-    elemItor->isValid();
-    elemItor->moveToNextElement())
-  {
-    if( isDirectoryValid(elemItor) ) 
-    {
-      loadResourcesFromTree( PATH + "\\" + elemItor->getElementName() );
-    }
-    else 
-    {
-      const std::string& FILE_ELEMENT = elemItor->getElementName();
-  
-      if( elementMatcher_->match(FILE_ELEMENT) &&
-        !pathToTSTHandle_.isIdMapped(PATH + "\\" + FILE_ELEMENT) ) 
-      {
-        resourceManage_->load(PATH, FILE_ELEMENT);
+//
+template<typename RESOURCE, typename FILE_FORMAT>
+size_t 
+DataFileResourceManager<RESOURCE, FILE_FORMAT>
+::getBudgetedMemory() const
+{
+  return usedMemory_;
+}
 
-        // Tworzac obiekt posrednika wykonuje on prace informujaca
-        // wewnetrzna strukture TST menadzera o nowej sciezce zasobu.
-        // Ustalony zostaje priorytet zasobu rowny sredniej wartosci.
-        // Wartosc udostepnionego czasu systemowego sluzy do inicjalizacji
-        // zmiennej okreslajacej ostatni czas dostepu do zasobu
+//
+template<typename RESOURCE, typename FILE_FORMAT>
+bool 
+DataFileResourceManager<RESOURCE, FILE_FORMAT>
+::findEvictable(ResourcePriority  priority,
+                const void*       keep,
+                AccessStamp*      stamp) const
+{
+  const SharedResource* resource = findOldestEvictable(priority, keep);
+  if( resource == 0 )
+    return false;
 
-        SharedResource proxyResource(*this, FILE_ELEMENT, PATH);
+  *stamp = resource->getAccessStamp();
+  return true;
+}
 
-        insertResource( proxyResource );
+//
+template<typename RESOURCE, typename FILE_FORMAT>
+void 
+DataFileResourceManager<RESOURCE, FILE_FORMAT>
+::evictOldest(ResourcePriority  priority,
+              const void*       keep)
+{
+  // Zwolniony zasob przechodzi do listy zasobow niewczytanych. Zasob,
+  // ktorego nie mozna bylo zwolnic (odczytywany przez inny watek), jest
+  // przenoszony na koniec listy, aby kolejne wyszukiwanie go pominelo
 
-        tstHandleToPath_.insert( 
-          TSTHandleToPathValueType( 
-            proxyResource.getTstHandle(),
-            std::make_pair(PATH, FILE_ELEMENT) 
-          )
-        );
-      
-        setResourcesSearchDir(PATH);
-      }
-    }
+  const SharedResource* resource = findOldestEvictable(priority, keep);
+  if( resource == 0 )
+    return;
+
+  evictResource(*resource);
+
+  if( resource->isLoaded() ) {
+    ResourcesList& list = resources_[priority];
+    list.splice(list.end(), list, 
+      tstHandleToShrRes_[ resource->getTstHandle() ].itor_);
   }
 }
 
@@ -1167,66 +3461,96 @@ DataFileResourceManager<RESOURCE, FILE_FORMAT>
 template<typename RESOURCE, typename FILE_FORMAT>
 void 
 DataFileResourceManager<RESOURCE, FILE_FORMAT>
-::loadResources()
+::touchResource(TSTHandle handle)
 {
-  // Aby odczytac wszystkie zasoby znajdujace sie w wyszczegolnionych
-  // katalogach (wykorzystanie metody setResourcesSearchDir) nalezy
-  // dla kazdego z nich wykonac funkcje odczytu zasobow z zadanego
-  // katalogu. Zasoby, ktore beda wczytane musza spelniac zadane kryterium
-  // okreslone przez obiekt typu ElementMatcher
+  // Polozenie zasobu niewczytanego nie ma znaczenia dla kolejnosci
+  // zwalniania
+  const ResourceSlot& SLOT = tstHandleToShrRes_[handle];
+  if( !SLOT.itor_->isLoaded() )
+    return;
 
-  for(DirectoriesItor dirItor = searchDir_.begin();
-    dirItor != searchDir_.end();
-    ++dirItor)
-  {
-    const std::string& DIRECTORY_PATH = *dirItor;
-    loadResourcesFromDir( DIRECTORY_PATH );
-  }
+  ResourcesList& list = resources_[ SLOT.itor_->getPriority() ];
+  list.splice(list.end(), list, SLOT.itor_);
+
+  if( getMemoryBudget() != 0 )
+    SLOT.itor_->setAccessStamp( getMemoryBudget()->nextAccessStamp() );
 }
 
 //
 template<typename RESOURCE, typename FILE_FORMAT>
 void 
 DataFileResourceManager<RESOURCE, FILE_FORMAT>
-::acquireResourcesFromDir(const std::string& path)
+::moveResource(TSTHandle         handle, 
+               ResourcePriority  previous)
 {
-  elementsEnum_->setDirectory(path);
+  // Lista zasobow niewczytanych jest wspolna dla wszystkich priorytetow
+  const ResourceSlot& SLOT = tstHandleToShrRes_[handle];
+  if( !SLOT.itor_->isLoaded() )
+    return;
 
-  for(DriveElementsEnumerator::ItorAutoPtr fileEnum(elementsEnum_->getItor());
-    fileEnum->isValid();
-    fileEnum->moveToNextElement())
+  ResourcesList& list = resources_[ SLOT.itor_->getPriority() ];
+  list.splice(list.end(), resources_[previous], SLOT.itor_);
+
+  if( getMemoryBudget() != 0 )
+    SLOT.itor_->setAccessStamp( getMemoryBudget()->nextAccessStamp() );
+}
+
+//
+template<typename RESOURCE, typename FILE_FORMAT>
+const typename DataFileResourceManager<RESOURCE, FILE_FORMAT>::SharedResource*
+DataFileResourceManager<RESOURCE, FILE_FORMAT>
+::findResourcePtr(TSTHandle handle) const
+{
+  if( handle >= tstHandleToShrRes_.size() ||
+    !tstHandleToShrRes_[handle].registered_ )
   {
-    SharedResource resource(*this, fileEnum->getElementName(), path);
-    resource.acquire();
-    insertResource( resource );
-    tstHandleToPath_.insert( TSTHandleToPathValueType( 
-      resource.getTstHandle(),
-      std::make_pair(path, fileEnum->getElementName()) )
-    );
+    return 0;
   }
 
-  setResourcesSearchDir(path);
+  return &*tstHandleToShrRes_[handle].itor_;
 }
 
 //
 template<typename RESOURCE, typename FILE_FORMAT>
-void 
+const typename DataFileResourceManager<RESOURCE, FILE_FORMAT>::SharedResource&
 DataFileResourceManager<RESOURCE, FILE_FORMAT>
-::insertResource(const SharedResource& resource)
-{  
-  ResourcesSetItor newResourcePos = resources_.insert(resource).first;
-  tstHandleToShrRes_.insert(
-    TSTHandleToShrRes::value_type(resource.getTstHandle(), &*newResourcePos) );
+::findResource(TSTHandle handle) const
+{
+  const SharedResource* resource = findResourcePtr(handle);
+
+  Utilities::assertion( resource != 0,
+    "Uchwyt nie posiada posrednika zasobu!" );
+
+  return *resource;
+}
+
+//
+template<typename RESOURCE, typename FILE_FORMAT>
+const typename DataFileResourceManager<RESOURCE, FILE_FORMAT>::SharedResource*
+DataFileResourceManager<RESOURCE, FILE_FORMAT>
+::findResourcePtr(TSTHandle   handle,
+                  Generation  generation) const
+{
+  if( handle >= tstHandleToShrRes_.size() )
+    return 0;
+
+  const ResourceSlot& SLOT = tstHandleToShrRes_[handle];
+  return SLOT.registered_ && SLOT.generation_ == generation ? 
+    &*SLOT.itor_ : 0;
 }
 
 //
 template<typename RESOURCE, typename FILE_FORMAT>
 void 
 DataFileResourceManager<RESOURCE, FILE_FORMAT>
-::removeResource(const SharedResource& resource)
+::setResourcePath(TSTHandle           handle,
+                  const std::string&  directory,
+                  const std::string&  fileName)
 {
-  tstHandleToShrRes_.erase(resource.getTstHandle());
-  resources_.erase(resource);
+  if( handle >= tstHandleToPath_.size() )
+    tstHandleToPath_.resize(handle + 1);
+
+  tstHandleToPath_[handle] = Path(directory, fileName);
 }
 
 } // namespace Platform
@@ -23,7 +23,9 @@
 
 #include "GcadBase.h"
 #include "GcadException.h"
+#include <cstddef>
 #include <string>
+#include <vector>
 
 namespace Gcad {
 namespace Platform {
@@ -214,9 +216,116 @@ class DataFileResourceManagerBase {
       virtual bool match(const std::string& element) const;
    };
 
+   /**
+     @brief
+       Znacznik czasu ostatniego odwolania do zasobu, nadawany przez
+       wspolny budzet pamieci (MemoryBudget)
+   */
+#ifdef _MSC_VER
+   typedef unsigned __int64  AccessStamp;
+#else
+   __extension__ typedef unsigned long long  AccessStamp;
+#endif
+
+   /**
+     @brief
+       Wspolny budzet pamieci kilku menadzerow zasobow (np. roznych
+       formatow modeli). Menadzery dolaczone do budzetu (setMemoryBudget)
+       nie korzystaja z wlasnej granicy pamieci - brak miejsca dla
+       wczytywanego zasobu powoduje zwolnienie zasobow wszystkich
+       menadzerow: od najnizszego priorytetu, a w ramach priorytetu od
+       najdawniej uzywanego. Pamiec otrzymuje zatem ten typ zasobow,
+       ktory jest aktualnie wykorzystywany
+
+     @remark
+       Kolejnosc odwolan do zasobow roznych menadzerow jest ustalana
+       na podstawie znacznikow nadawanych przez budzet. Budzet, oraz
+       dolaczone menadzery musza byc uzywane w jednym watku. Zniszczenie
+       budzetu odlacza menadzery, a zniszczenie menadzera odlacza go
+       od budzetu
+   */
+   class GCAD_EXPORT MemoryBudget {
+    public:
+      explicit MemoryBudget(size_t maxMemory);
+      ~MemoryBudget();
+
+      /**
+        @brief
+          Ustalenie wspolnej granicy pamieci. Obnizenie granicy ponizej
+          aktualnie wykorzystywanego obszaru powoduje natychmiastowe
+          zwolnienie nieuzywanych zasobow
+      */
+      void setMemoryMaximum(size_t memorySize);
+
+      size_t getMemoryMaximum() const { return maxMemory_; }
+
+      /**
+        @brief
+          Suma pamieci wczytanych zasobow wszystkich dolaczonych menadzerow
+      */
+      size_t getUsedMemory() const;
+
+      /**
+        @brief
+          Liczba dolaczonych menadzerow
+      */
+      size_t managersCount() const { return managers_.size(); }
+
+      /**
+        @brief
+          Zwolnienie zasobow (z pominieciem zasobu keep), tak aby
+          zmiescic w budzecie dodatkowe bytesNeeded bajtow. Gdy wszystkie
+          zasoby sa wspoldzielone, granica moze zostac przekroczona
+      */
+      void reserve(size_t       bytesNeeded, 
+                   const void*  keep);
+
+      /**
+        @brief
+          Kolejny znacznik odwolania do zasobu
+      */
+      AccessStamp nextAccessStamp() { return ++lastAccessStamp_; }
+
+    private:
+      friend class DataFileResourceManagerBase;
+
+      void attach(DataFileResourceManagerBase* manager);
+      void detach(DataFileResourceManagerBase* manager);
+
+    private:
+      typedef std::vector<DataFileResourceManagerBase*>  Managers;
+
+      size_t       maxMemory_;
+      Managers     managers_;
+      AccessStamp  lastAccessStamp_;
+
+    private:
+      // nie zaimplementowane
+      MemoryBudget(const MemoryBudget&);
+      MemoryBudget& operator =(const MemoryBudget&);
+   };
+
+   /**
+     @brief
+       Dolaczenie menadzera do wspolnego budzetu pamieci (wartosc zerowa
+       - odlaczenie i powrot do wlasnej granicy menadzera). Budzet musi
+       istniec do czasu odlaczenia menadzera, badz jego zniszczenia
+   */
+   void setMemoryBudget(MemoryBudget* budget) {
+     if( budget_ != 0 )
+       budget_->detach(this);
+     budget_ = budget;
+     if( budget_ != 0 )
+       budget_->attach(this);
+   }
+
+   MemoryBudget* getMemoryBudget() const { return budget_; }
+
  protected:
    // Zablokowanie przed klientem mozliwosci tworzenia instancji
-   DataFileResourceManagerBase() {}
+   DataFileResourceManagerBase() : budget_(0) {}
+
+   virtual ~DataFileResourceManagerBase() { setMemoryBudget(0); }
 
    /**
      @brief 
@@ -253,6 +362,37 @@ class DataFileResourceManagerBase {
    */
    NullElementMatcher*
    createNullElementMatcher() const { return new NullElementMatcher(); }
+
+ private:
+   // Interfejs wykorzystywany przez wspolny budzet pamieci. Zasob keep
+   // (wlasnie wczytywany) nie moze zostac zwolniony
+
+   friend class MemoryBudget;
+
+   /**
+     @brief
+       Suma pamieci wczytanych zasobow menadzera
+   */
+   virtual size_t getBudgetedMemory() const = 0;
+
+   /**
+     @brief
+       Znacznik najdawniej uzywanego zasobu priorytetu priority, ktory
+       moze zostac zwolniony. Wartosc false - brak takiego zasobu
+   */
+   virtual bool findEvictable(ResourcePriority  priority,
+                              const void*       keep,
+                              AccessStamp*      stamp) const = 0;
+
+   /**
+     @brief
+       Zwolnienie zasobu wskazanego przez findEvictable
+   */
+   virtual void evictOldest(ResourcePriority  priority,
+                            const void*       keep) = 0;
+
+ private:
+   MemoryBudget*  budget_;  /**< Wspolny budzet pamieci (0 - brak) */
 };
 
 } // namespace Platform
@@ -133,6 +133,14 @@ class GCAD_EXPORT DriveElementsEnumerator {
         zmianie korzenia katalogu, musza otrzymac zadanie moveToBegin()
    */
    virtual void setDirectory(const std::string& directory) = 0;
+
+   /**
+     @brief
+       Znak oddzielajacy nazwy katalogow w sciezkach elementow (domyslnie
+       '\\'). Na jego podstawie DataFileResourceManager tworzy sciezki
+       zasobow
+   */
+   virtual char getPathSeparator() const;
 };
 
 } // namespace Platform
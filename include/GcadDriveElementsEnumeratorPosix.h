@@ -0,0 +1,120 @@
+/***************************************************************************
+ *   Copyright (C) 2005 by Eryk Klebanski                                  *
+ *   rixment@gmail.com                                                     *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+
+#ifndef _GCAD_DRIVEELEMENTSENUMERATORPOSIX_H_
+#define _GCAD_DRIVEELEMENTSENUMERATORPOSIX_H_
+
+#include "GcadBase.h"
+#include "GcadDriveElementsEnumerator.h"
+#include <dirent.h>
+#include <vector>
+
+namespace Gcad {
+namespace Platform {
+
+/**
+  @brief
+    Realizacja interfejsu wykonana dla systemow POSIX. Sciezki elementow
+    sa oddzielane znakiem '/'
+
+    W systemie Linux wpisy katalogu sa pobierane duzymi porcjami
+    bezposrednio wywolaniem systemowym getdents64 (jedno wywolanie na
+    kilkaset wpisow), a w pozostalych systemach funkcja readdir. Rodzaj
+    elementu jest okreslany na podstawie pola d_type - funkcja stat jest
+    wywolywana jedynie dla dowiazan symbolicznych i systemow plikow, 
+    ktore nie wypelniaja tego pola (DT_UNKNOWN)
+*/
+class GCAD_EXPORT DriveElementsEnumeratorPosix 
+  : public DriveElementsEnumerator 
+{
+ public:
+   /**
+     @brief
+       Realizacja klasy interfejsu iteratora elementow 
+       struktury hierarchicznej plik/katalog
+   */
+   class GCAD_EXPORT Itor 
+     : public DriveElementsEnumerator::Itor
+   {
+    private:
+      friend class DriveElementsEnumeratorPosix;
+      
+      Itor(const DriveElementsEnumeratorPosix& owner);
+    
+    public:      
+      ~Itor();
+
+      virtual bool isDirectory() const;
+
+      virtual std::string getElementName() const;
+
+      virtual bool moveToNextElement();
+
+      virtual bool isValid() const;
+
+      virtual void moveToBegin();
+
+    private:
+      /**
+        @brief
+          Pobranie kolejnego wpisu katalogu (name_, isDirectory_).
+          Wartosc false oznacza koniec wpisow, badz blad odczytu
+      */
+      bool readEntry();
+
+      void closeDirectory();
+    
+    private:
+      const DriveElementsEnumeratorPosix&  owner_;
+      DIR*                                 currDir_;
+      std::vector<char>                    buffer_;   /**< Porcja wpisow 
+                                                           (getdents64) */
+      size_t                               filled_;   /**< Wypelnienie bufora */
+      size_t                               position_; /**< Nastepny wpis */
+      const char*                          name_;     /**< Biezacy wpis */
+      bool                                 isDirectory_;
+
+    private:
+      // nie zaimplementowane
+      Itor(const Itor&);
+      Itor& operator =(const Itor&);
+   };
+   
+   friend class Itor;
+
+   DriveElementsEnumeratorPosix(const std::string& directory = ".");
+   
+   virtual DriveElementsEnumeratorPosix* clone() const;
+
+   virtual ItorAutoPtr getItor() const;
+
+   virtual void setDirectory(const std::string& newDirectory);
+
+   virtual char getPathSeparator() const;
+   
+ private:
+   std::string  baseDir_;
+};
+
+} // namespace Platform
+} // namespace Gcad
+
+#endif
@@ -21,6 +21,7 @@
 #ifndef _GCAD_DYNAMICMATRIX_H_
 #define _GCAD_DYNAMICMATRIX_H_
 
+#include "GcadBase.h"
 #include "GcadAssertion.h"
 #include <algorithm>
 
@@ -207,6 +208,21 @@ class DynamicMatrix {
    template< typename U >
      DynamicMatrix& operator =( const DynamicMatrix< U >& rhs );
 
+#ifdef GCAD_HAS_RVALUE_REFERENCES
+   /**
+     @brief
+       Konstruktor przenoszacy - przejecie obszaru elementow bez ich
+       kopiowania. Zrodlo pozostaje macierza pusta (0 x 0)
+   */
+   DynamicMatrix( DynamicMatrix&& rhs );
+
+   /**
+     @brief
+       Przenoszacy operator przypisania
+   */
+   DynamicMatrix& operator =( DynamicMatrix&& rhs );
+#endif
+
    /**
      @brief
        Operacja podmiany wewnetrznych wartosci wykorzystywanych w prywatnej
@@ -327,6 +343,29 @@ template< typename T > DynamicMatrix< T >
   init( rhs );
 }
 
+#ifdef GCAD_HAS_RVALUE_REFERENCES
+//
+template< typename T > DynamicMatrix< T >
+::DynamicMatrix( DynamicMatrix&& rhs ) 
+  : width_( rhs.width_ )
+  , height_( rhs.height_ )
+  , elements_( rhs.elements_ )
+  , allocatedWithCtors_( rhs.allocatedWithCtors_ )
+{
+  rhs.width_    = 0;
+  rhs.height_   = 0;
+  rhs.elements_ = 0;
+}
+
+//
+template< typename T > DynamicMatrix< T >& DynamicMatrix< T >
+::operator =( DynamicMatrix&& rhs ) 
+{
+  DynamicMatrix temp( static_cast< DynamicMatrix&& >( rhs ) );
+  return swap( temp );
+}
+#endif
+
 //
 template< typename T > DynamicMatrix< T >
 ::~DynamicMatrix() 
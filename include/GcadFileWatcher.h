@@ -0,0 +1,123 @@
+/***************************************************************************
+ *   Copyright (C) 2005 by Eryk Klebanski                                  *
+ *   rixment@gmail.com                                                     *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+
+#ifndef _GCAD_FILEWATCHER_H_
+#define _GCAD_FILEWATCHER_H_
+
+#include "GcadBase.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace Gcad {
+namespace Platform {
+
+/**
+  @brief
+    Interfejs obserwacji zmian zawartosci katalogow
+
+    Obserwowane sa pojedyncze katalogi (bez podkatalogow). Zmiany sa
+    gromadzone przez system i odbierane bez wstrzymywania watku (poll),
+    np. raz na klatke. Zapis pliku jest zglaszany dopiero po jego
+    zamknieciu, badz przemianowaniu pliku tymczasowego na docelowy, wiec
+    odbiorca nie odczytuje plikow zapisanych czesciowo
+
+  @remark
+    Obiekt nie jest bezpieczny dla watkow - katalogi dodaje i zmiany
+    odbiera ten sam watek
+
+  @code
+    std::auto_ptr< FileWatcher > watcher( createFileWatcher() );
+    if( watcher.get() != 0 && watcher->watch( "data" ) ) {
+      FileWatcher::Changes changes;
+      watcher->poll( &changes );
+      // ... changes[ i ].directory_, changes[ i ].name_
+    }
+  @endcode
+*/
+class GCAD_EXPORT FileWatcher {
+ public:
+   /**
+     @brief
+       Zmiana elementu obserwowanego katalogu
+   */
+   struct Change {
+     enum Kind {
+       CHANGED,     /**< Element zapisany, utworzony, badz przeniesiony */
+       REMOVED,     /**< Element usuniety, badz przeniesiony poza katalog */
+       OVERFLOWED   /**< Czesc zmian zostala utracona (przepelnienie 
+                         kolejki systemu) - nazwy sa puste */
+     };
+
+     std::string  directory_;    /**< Katalog (w postaci z wywolania watch) */
+     std::string  name_;         /**< Nazwa pliku, badz katalogu */
+     Kind         kind_;
+     bool         isDirectory_;
+   };
+
+   typedef std::vector< Change >  Changes;
+
+   virtual ~FileWatcher() {}
+
+   /**
+     @brief
+       Rozpoczecie obserwacji katalogu directory
+
+     @return
+       Wartosc false, gdy katalog nie istnieje, badz przekroczono
+       systemowy limit obserwowanych katalogow
+   */
+   virtual bool watch( const std::string& directory ) = 0;
+
+   /**
+     @brief
+       Zakonczenie obserwacji katalogu directory
+   */
+   virtual void unwatch( const std::string& directory ) = 0;
+
+   /**
+     @brief
+       Przeniesienie zgromadzonych zmian na koniec wektora changes (bez
+       oczekiwania). Zmiany sa zglaszane w kolejnosci ich zajscia
+
+     @return
+       Liczba odebranych zmian
+   */
+   virtual size_t poll( Changes* changes ) = 0;
+
+   /**
+     @brief
+       Nazwa mechanizmu obserwacji (np. "inotify")
+   */
+   virtual const char* backendName() const = 0;
+};
+
+/**
+  @brief
+    Utworzenie obserwatora dla platformy (Linux - inotify), badz
+    wartosc 0, gdy platforma nie udostepnia obserwacji katalogow
+*/
+GCAD_EXPORT FileWatcher* createFileWatcher();
+
+} // namespace Platform
+} // namespace Gcad
+
+#endif
@@ -0,0 +1,115 @@
+/***************************************************************************
+ *   Copyright (C) 2005 by Eryk Klebanski                                  *
+ *   rixment@gmail.com                                                     *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef _GCAD_FRAMEARENA_H_
+#define _GCAD_FRAMEARENA_H_
+
+#include "GcadBase.h"
+#include <cstddef>
+#include <memory>  // std::bad_alloc
+#include <vector>
+
+namespace Gcad {
+namespace Utilities {
+
+/**
+  @brief
+    Liniowy obszar pamieci (ang. arena) dla danych tymczasowych,
+    istniejacych nie dluzej niz jedna klatka
+
+    Przydzial polega na przesunieciu wskaznika wewnatrz bloku, a zwolnienie
+    pojedynczych obszarow nie jest mozliwe - cala pamiec jest odzyskiwana
+    jednorazowo, wywolaniem reset(). Zadania przekraczajace pojemnosc
+    bloku glownego sa obslugiwane przez bloki dodatkowe, pobierane ze
+    sterty. Podczas resetu blok glowny zostaje powiekszony do najwiekszego
+    zaobserwowanego zapotrzebowania, wiec w stanie ustalonym kazda klatka
+    miesci sie w jednym bloku
+
+  @remark
+    Destruktory obiektow umieszczonych w arenie nie sa wywolywane.
+    Przechowywane dane powinny byc typami prostymi, badz kontenerami
+    korzystajacymi z ArenaAllocator, usuwanymi przed wywolaniem reset()
+*/
+class GCAD_EXPORT FrameArena {
+ public:
+   /**
+     @brief
+       Domyslne wyrownanie przydzielanych obszarow (wystarczajace
+       dla typow wbudowanych, oraz rejestrow SSE)
+   */
+   enum { DEFAULT_ALIGNMENT = 16 };
+
+   /**
+     @brief
+       Utworzenie areny z blokiem glownym o zadanej pojemnosci
+   */
+   explicit FrameArena( size_t initialBytes = 64 * 1024 );
+
+   ~FrameArena();
+
+   /**
+     @brief
+       Przydzial obszaru o wielkosci bytesCount bajtow
+
+     @param alignment Wyrownanie adresu (potega dwojki)
+
+     @exception
+       std::bad_alloc Brak mozliwosci pobrania bloku dodatkowego
+   */
+   void* allocate( size_t  bytesCount,
+                   size_t  alignment = DEFAULT_ALIGNMENT )
+     throw( std::bad_alloc );
+
+   /**
+     @brief
+       Odzyskanie calej pamieci areny. Wszystkie uzyskane wczesniej
+       adresy staja sie niewazne
+   */
+   void reset();
+
+   /**
+     @brief
+       Liczba bajtow przydzielonych od ostatniego resetu
+   */
+   size_t usedBytes() const { return usedBytes_; }
+
+   /**
+     @brief
+       Pojemnosc bloku glownego
+   */
+   size_t capacity() const { return capacity_; }
+
+ private:
+   char*                 block_;      /**< Blok glowny */
+   size_t                capacity_;   /**< Pojemnosc bloku glownego */
+   size_t                offset_;     /**< Pierwszy wolny bajt bloku glownego */
+   size_t                usedBytes_;  /**< Zapotrzebowanie biezacej klatki */
+   std::vector< char* >  overflow_;   /**< Bloki dodatkowe */
+
+ private:
+   // nie zaimplementowane
+   FrameArena( const FrameArena& );
+   FrameArena& operator =( const FrameArena& );
+};
+
+} // namespace Utilities
+} // namespace Gcad
+
+#endif
@@ -23,6 +23,7 @@
 
 #include "GcadBase.h"
 #include "GcadVector3.h"
+#include "GcadArenaAllocator.h"
 #include <vector>
 #include <memory>
 
@@ -79,6 +80,9 @@ class GCAD_EXPORT MD2Animator {
    typedef NormalsKeyFrame::iterator         NormalsKeyFrameItor;
    typedef std::auto_ptr< NormalsKeyFrame >  NormalsKeyFrameAutoPtr;
 
+   typedef Gcad::Utilities::ArenaAllocator< Vector3 >  Vector3ArenaAllocator;
+   typedef std::vector< Vector3, Vector3ArenaAllocator >  TransientKeyFrame;
+
    /**
      @brief Konstruktor wiazacy iterator z agregatem danych siatki
    */
@@ -96,6 +100,46 @@ class GCAD_EXPORT MD2Animator {
    */
    NormalsKeyFrameAutoPtr interpolatedNormals() const;
 
+   /**
+     @brief
+       Wypelnienie kontenera umieszczonego w arenie klatki danymi
+       interpolowanych wierzcholkow. Wersja nie korzysta ze sterty
+
+     @code
+       MD2Animator::TransientKeyFrame vertices(
+         MD2Animator::Vector3ArenaAllocator( sceneGraph.getFrameArena() ) );
+       animator.interpolatedVertices( &vertices );
+     @endcode
+   */
+   void interpolatedVertices( TransientKeyFrame* vertices ) const;
+
+   /**
+     @brief
+       Wypelnienie kontenera umieszczonego w arenie klatki danymi
+       interpolowanych normalnych
+
+     @see
+       interpolatedVertices( TransientKeyFrame* ) const
+   */
+   void interpolatedNormals( TransientKeyFrame* normals ) const;
+
+   /**
+     @brief
+       Wypelnienie kontenera klienta danymi interpolowanych wierzcholkow.
+       Kontener wielokrotnie uzywany (np. skladowa obiektu renderujacego)
+       nie wymaga przydzialu pamieci po pierwszej klatce
+   */
+   void interpolatedVertices( VerticesKeyFrame* vertices ) const;
+
+   /**
+     @brief
+       Wypelnienie kontenera klienta danymi interpolowanych normalnych
+
+     @see
+       interpolatedVertices( VerticesKeyFrame* ) const
+   */
+   void interpolatedNormals( NormalsKeyFrame* normals ) const;
+
    /**
      @brief 
        Okreslenie biezacej animacji, oraz sposobu jej odegrania
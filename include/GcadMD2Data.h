@@ -23,8 +23,11 @@
 
 #include "GcadMD2FileHeader.h"
 #include "GcadAssertion.h"
+#include "GcadAtomicRefCountPtr.h"
+#include "GcadByteSize.h"
+#include "GcadByteSpan.h"
 #include "GcadException.h"
-#include "GcadRefCountPtr.h"
+#include "GcadModelDataAllocator.h"
 #include "GcadVector2.h"
 #include "GcadVector3.h"
 #include <fstream>
@@ -124,13 +127,21 @@ class GCAD_EXPORT MD2Data {
    typedef Math::Vector2<float>  Vector2;
    typedef Math::Vector3<float>  Vector3;
 
+   /** 
+     @brief 
+       Alokatory danych modelu (patrz ModelDataAllocator)
+   */
+   typedef ModelDataAllocator< Vector3 >::Type  Vector3Allocator;
+   typedef ModelDataAllocator< Vector2 >::Type  Vector2Allocator;
+
    /** 
      @brief Synonim typu dla zbioru wierzcholkow jednej klatki animacji
    */
-   typedef std::vector< Vector3 >                        VerticesFrame;
+   typedef std::vector< Vector3, Vector3Allocator >      VerticesFrame;
    typedef VerticesFrame::iterator                       VerticesFrameItor;
    typedef VerticesFrame::const_iterator                 VerticesFrameConstItor;
-   typedef Gcad::Utilities::RefCountPtr< VerticesFrame > VerticesFrameSmartPtr;
+   typedef Gcad::Utilities::AtomicRefCountPtr< VerticesFrame >
+     VerticesFrameSmartPtr;
 
    /** 
      @brief Synonim typu dla kolekcji klatek animacji wierzcholkow
@@ -142,10 +153,11 @@ class GCAD_EXPORT MD2Data {
    /** 
      @brief Synonim typu dla zbioru normalnych jednej klatki animacji
    */
-   typedef std::vector< Vector3 >                        NormalsFrame;
+   typedef std::vector< Vector3, Vector3Allocator >      NormalsFrame;
    typedef NormalsFrame::iterator                        NormalsFrameItor;
    typedef NormalsFrame::const_iterator                  NormalsFrameConstItor;
-   typedef Gcad::Utilities::RefCountPtr< NormalsFrame >  NormalsFrameSmartPtr;
+   typedef Gcad::Utilities::AtomicRefCountPtr< NormalsFrame >
+     NormalsFrameSmartPtr;
 
    /** 
      @brief Synonim typu dla kolekcji klatek animacji normalnych
@@ -157,9 +169,9 @@ class GCAD_EXPORT MD2Data {
    /** 
      @brief Synonim koordynat tekstur wierzcholka 
    */
-   typedef std::vector< Vector2 >         TextureCoords;
-   typedef TextureCoords::iterator        TextureCoordsItor;
-   typedef TextureCoords::const_iterator  TextureCoordsConstItor;
+   typedef std::vector< Vector2, Vector2Allocator >  TextureCoords;
+   typedef TextureCoords::iterator                   TextureCoordsItor;
+   typedef TextureCoords::const_iterator             TextureCoordsConstItor;
 
    /** 
      @brief 
@@ -184,16 +196,52 @@ class GCAD_EXPORT MD2Data {
    /**
      @brief 
        Odczyt danych MD2 z podanego zewnetrznie zrodla. Zadany strumien
-       powinien cechowac sie wartoscia ios::binary
+       powinien cechowac sie wartoscia ios::binary (plik), badz
+       udostepniac dane wczytane wczesniej do pamieci
+       (Utilities::MemoryInputStream)
+   */
+   MD2Data( std::istream& inputData );
+
+   /**
+     @brief
+       Odczyt danych MD2 bezposrednio z obszaru pamieci (np. pliku
+       odwzorowanego przez Platform::MappedFile), bez posredniego bufora.
+       Obszar musi istniec jedynie w czasie dzialania konstruktora
+
+     @exception
+       FileReadError Obszar krotszy od rozmiaru pliku zapisanego
+       w naglowku, badz sekcje danych wykraczajace poza plik
+
+     @exception
+       MD2FileHeader::BadHeaderData
+   */
+   MD2Data( const Utilities::ByteSpan& md2Data );
+
+#ifdef GCAD_HAS_RVALUE_REFERENCES
+   /**
+     @brief
+       Przeniesienie danych modelu (bez kopiowania klatek animacji)
+   */
+   MD2Data( MD2Data&& that );
+   MD2Data& operator =( MD2Data&& rhs );
+#endif
+
+   /**
+     @brief
+       Wymiana danych dwoch modeli w czasie stalym
    */
-   MD2Data( std::ifstream& inputData );
+   void swap( MD2Data& that );
   
    /** 
      @brief Udostepnienie informacji dotyczacych naglowka wczytanego pliku
    */
-   MD2FileHeader attributes() const; 
+   const MD2FileHeader& attributes() const; 
 
    /**
+     @brief
+       Calkowita wielkosc pamieci zajmowanej przez model: obiekt, naglowek,
+       dane wszystkich klatek animacji (wraz z blokami licznikow
+       odniesien), koordynaty tekstur, oraz opis poligonow
    */
    size_t getByteSize() const;
 
@@ -217,6 +265,14 @@ class GCAD_EXPORT MD2Data {
    NormalsFrameConstItor  beginNormalsKeyFrame( size_t frameNum ) const;
    NormalsFrameConstItor  endNormalsKeyFrame( size_t frameNum ) const;
 
+   /**
+     @brief
+       Wspoldzielony dostep do klatki kluczowej. Watki robocze moga
+       przechowywac uzyskane wskazniki niezaleznie od czasu zycia modelu
+   */
+   VerticesFrameSmartPtr  sharedVerticesKeyFrame( size_t frameNum ) const;
+   NormalsFrameSmartPtr   sharedNormalsKeyFrame( size_t frameNum ) const;
+
    /**
      @brief Informacja dotyczaca ilosci klatek kluczowych
    */
@@ -239,24 +295,89 @@ class GCAD_EXPORT MD2Data {
    PolygonsIndicesConstItor  beginPolygonsIndices() const;
    PolygonsIndicesConstItor  endPolygonsIndices() const;
 
+   /**
+     @brief
+       Zapis przetworzonego modelu (zdekompresowane wierzcholki, obliczone
+       normalne, koordynaty tekstur, poligony), odczytywanego metoda
+       createFromProcessed. Tablice sa zapisywane w postaci ciaglej, wiec
+       ich odczyt sprowadza sie do kopiowania pamieci (np. pamiec podreczna
+       Platform::ProcessedCache)
+   */
+   void writeProcessed( std::ostream& output ) const;
+
+   /**
+     @brief
+       Utworzenie modelu z danych zapisanych metoda writeProcessed - bez
+       dekompresji klatek animacji i obliczania normalnych. Obszar musi
+       istniec jedynie w czasie dzialania metody
+
+     @exception
+       FileReadError Niepoprawne (badz niepelne) dane
+
+     @exception
+       MD2FileHeader::BadHeaderData
+   */
+   static MD2Data* createFromProcessed( const Utilities::ByteSpan& processed );
+
  private:
+   /**
+     @brief
+       Utworzenie modelu o zadanym naglowku, bez danych (createFromProcessed)
+   */
+   explicit MD2Data( const MD2FileHeader& header );
+
+   /**
+     @brief
+       Odczyt tablic modelu zapisanych metoda writeProcessed
+   */
+   void readProcessed( Utilities::ByteSpanReader& processed );
+
    /**
      @brief 
        Wykonanie odczytu danych formatu MD2 z zadanego strumienia wejsciowego
    */
-   void loadDataFromInput( std::ifstream& inputData );
+   void loadDataFromInput( std::istream& inputData );
+
+   /**
+     @brief
+       Odczyt sekcji danych pliku MD2 (klatki, koordynaty tekstur,
+       poligony), oraz obliczenie normalnych. Argument fileData wskazuje
+       poczatek pliku o rozmiarze MD2FileHeader::offsetEnd()
+   */
+   void loadDataFromMemory( const Byte* fileData );
+
+   /**
+     @brief
+       Kontrola, czy sekcje opisane naglowkiem zawieraja sie w pliku
+
+     @exception
+       FileReadError
+   */
+   void checkSectionsBounds() const;
+
+   /**
+     @brief
+       Kontrola, czy indeksy wszystkich poligonow wskazuja na istniejace
+       wierzcholki i koordynaty tekstur
+
+     @exception
+       FileReadError
+   */
+   void checkPolygonsIndices( size_t verticesCount,
+                              size_t texCoordsCount ) const;
 
    /** 
      @brief 
-       Utworzenie bufora o wielkosci rownej wartosci pola struktury 
+       Przygotowanie bufora o wielkosci rownej wartosci pola struktury 
        MD2FileHeader::offsetEnd, oraz wypelnienie go zawartoscia pliku 
    */
-   BytesVectorAutoPtr createBuffer( std::istream& dataSrc );
+   void createBuffer( std::istream&  dataSrc,
+                      BytesVector*   buffer );
 
    /** 
      @brief Odczyt wartosci reprezentujacych pojedyncza klatke animacji 
    */
-   void readFrameVert( Byte*           verticesData, 
+   void readFrameVert( const Byte*     verticesData, 
                        VerticesFrame&  frameVert );
 
    /** 
@@ -274,14 +395,14 @@ class GCAD_EXPORT MD2Data {
    /** 
      @brief Odczyt wartosci towarzyszacych kazdej klatce animacji 
    */
-   void readFrameHeader( Byte* headerData,
+   void readFrameHeader( const Byte* headerData,
                          float ( &scale )[ CB_SCALE ],
                          float ( &translate )[ CB_TRANSL ],
                          Byte  ( &name )[ CB_STRING ] );
                              
-   void readVerticesKeyFrames( Byte* fileData );
-   void readTextureCoords( Byte* fileData );
-   void readPolygonsIndices( Byte* fileData );
+   void readVerticesKeyFrames( const Byte* fileData );
+   void readTextureCoords( const Byte* fileData );
+   void readPolygonsIndices( const Byte* fileData );
 
    void computeNormalsKeyFrames();
 
@@ -297,7 +418,7 @@ class GCAD_EXPORT MD2Data {
 
 
 //
-inline MD2FileHeader MD2Data
+inline const MD2FileHeader& MD2Data
 ::attributes() const 
 {
   return *fileHeader_;
@@ -383,6 +504,24 @@ inline MD2Data::NormalsFrameConstItor MD2Data
   return normFrames_[ frameNum ]->end();
 }
 
+//
+inline MD2Data::VerticesFrameSmartPtr MD2Data
+::sharedVerticesKeyFrame( size_t frameNum ) const 
+{
+  Gcad::Utilities::assertion( frameNum < vertFrames_.size(),
+    "MD2Data::sharedVerticesKeyFrame(size_t): Indeks spoza zakresu!" );
+  return vertFrames_[ frameNum ];
+}
+
+//
+inline MD2Data::NormalsFrameSmartPtr MD2Data
+::sharedNormalsKeyFrame( size_t frameNum ) const 
+{
+  Gcad::Utilities::assertion( frameNum < normFrames_.size(),
+    "MD2Data::sharedNormalsKeyFrame(size_t): Indeks spoza zakresu!" );
+  return normFrames_[ frameNum ];
+}
+
 //
 inline size_t MD2Data
 ::keyFramesCount() const
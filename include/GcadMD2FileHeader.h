@@ -21,6 +21,7 @@
 #ifndef _GCAD_MD2FILEHEADER_H_
 #define _GCAD_MD2FILEHEADER_H_
 
+#include "GcadByteSpan.h"
 #include "GcadException.h"
 #include <iostream>
 
@@ -87,6 +88,17 @@ class GCAD_EXPORT MD2FileHeader {
        odczytany, z powodu niezgodnosci danych w nim zawartych
    */
    MD2FileHeader( std::istream& inputMD2HeaderData );
+
+   /**
+     @brief
+       Odczyt naglowka z poczatku obszaru danych pliku MD2 (np. pliku
+       odwzorowanego w pamieci)
+
+     @exception
+       BadHeaderData Obszar krotszy od naglowka, badz wartosci naglowka
+       niezgodne z oczekiwanymi
+   */
+   MD2FileHeader( const Utilities::ByteSpan& md2Data );
  
    // Akcesory do wartosci naglowka
    int identifier()       const;
@@ -107,6 +119,9 @@ class GCAD_EXPORT MD2FileHeader {
    int offsetOpenGLCmds() const;
    int offsetEnd()        const;
 
+ private:
+   void validate() const;
+
  private:
    int  identifier_;    /**< Magiczna liczba zawsze rowna IDP2 */
    int  version_;       /**< Magiczna liczba zawsze rowna 8 */
@@ -21,6 +21,7 @@
 #ifndef _GCAD_MD3BONEFRAME_H_
 #define _GCAD_MD3BONEFRAME_H_
 
+#include "GcadByteSpan.h"
 #include "GcadVector3.h"
 #include <iostream>
 #include <string>
@@ -47,6 +48,15 @@ class MD3BoneFrame {
    */
    MD3BoneFrame( std::istream& boneFrameData );
 
+   /**
+     @brief
+       Odczyt klatki z biezacej pozycji obszaru danych MD3
+
+     @exception
+       Utilities::ByteSpanReader::Overrun
+   */
+   MD3BoneFrame( Utilities::ByteSpanReader& boneFrameData );
+
    /**
      @brief
        Akcesor do wartosci determinujacej pierwszy 
@@ -79,6 +89,10 @@ class MD3BoneFrame {
    */
    std::string name() const;
 
+ private:
+   template< typename SOURCE >
+   void readFrom( SOURCE& boneFrameData );
+
  private:
    Vector3  minBBox_;      /**< @brief Pierwszy rog otaczajacego szescianu */
    Vector3  maxBBox_;      /**< @brief Drugi rog otaczajacego szescianu */
@@ -81,6 +81,20 @@ class MD3Data {
    */
    MD3Data( const std::string& fileName );
 
+   /**
+     @brief
+       Odczyt modelu bezposrednio z obszaru pamieci (np. pliku
+       odwzorowanego przez Platform::MappedFile), bez posrednich buforow
+
+     @exception
+       MD3FileHeader::BadHeaderData
+
+     @exception
+       Utilities::ByteSpanReader::Overrun Dane ucinaja sie przed koncem
+       opisanych naglowkiem sekcji
+   */
+   MD3Data( const Utilities::ByteSpan& md3Data );
+
    /**
      @brief
        Udostepnienie informacji dotyczacej naglowka pliku
@@ -103,11 +117,23 @@ class MD3Data {
        Informacja na temat ilosci siatek, z ktorych sklada sie model
    */
    size_t meshesCount() const;
+
+   /**
+     @brief
+       Calkowita wielkosc pamieci zajmowanej przez model - suma
+       wielkosci naglowka, klatek szkieletu, lacznikow, oraz siatek
+   */
+   size_t getByteSize() const;
  
  private:
-   void readBoneFrames( std::istream& boneFrameData );
-   void readTags      ( std::istream& tagsData );
+   template< typename SOURCE >
+   void readBoneFrames( SOURCE& boneFrameData );
+
+   template< typename SOURCE >
+   void readTags      ( SOURCE& tagsData );
+
    void readMeshes    ( std::istream& meshesData );
+   void readMeshes    ( Utilities::ByteSpanReader& meshesData );
  
  private:
    SmartPtrMD3FileHeader  fileHeader_;
@@ -21,6 +21,8 @@
 #ifndef _GCAD_MD3FILEHEADER_H_
 #define _GCAD_MD3FILEHEADER_H_
 
+#include "GcadAssertion.h"
+#include "GcadByteSpan.h"
 #include "GcadException.h"
 #include <iostream>
 #include <string>
@@ -48,7 +50,17 @@ class MD3FileHeader {
       BadHeaderData( std::istream&  badStream,
                      const char*    exceptionDecription )
         : Gcad::Utilities::Exception( exceptionDecription )
-        , badStream_( badStream )
+        , badStream_( &badStream )
+      {}
+
+      /**
+        @brief
+          Konstruktor wyjatku zglaszanego podczas odczytu danych
+          z obszaru pamieci (brak strumienia)
+      */
+      BadHeaderData( const char* exceptionDecription )
+        : Gcad::Utilities::Exception( exceptionDecription )
+        , badStream_( 0 )
       {}
       
       /**
@@ -56,10 +68,21 @@ class MD3FileHeader {
           Akcesor do strumienia, ktorego niepoprawny stan byl powodem
           powstania sytuacji wyjatkowej
       */
-      std::istream& badStream() { return badStream_; }
+      std::istream& badStream() {
+        Gcad::Utilities::assertion( badStream_ != 0,
+          "MD3FileHeader::BadHeaderData::badStream(): Brak strumienia!" );
+        return *badStream_;
+      }
+
+      /**
+        @brief
+          Informacja, czy wyjatek zostal zgloszony podczas odczytu
+          ze strumienia
+      */
+      bool hasBadStream() const { return badStream_ != 0; }
     
     private:
-      std::istream& badStream_;
+      std::istream* badStream_;
    };
 
    /**
@@ -71,6 +94,15 @@ class MD3FileHeader {
    */   
    MD3FileHeader( std::istream& inputHeaderData );
 
+   /**
+     @brief
+       Odczyt naglowka z poczatku obszaru danych formatu MD3
+
+     @exception
+       MD3FileHeader::BadHeaderData
+   */
+   MD3FileHeader( const Utilities::ByteSpan& md3Data );
+
    std::string  id()          const;
    std::string  fileName()    const;
    int          version()     const;
@@ -83,6 +115,9 @@ class MD3FileHeader {
    int          meshStart()   const;
    int          fileSize()    const;
 
+ private:
+   bool isValid() const;
+
  private:
    char  id_[ 4 ];        /**< @brief Magiczna wartosc, zawsze rowna "IDP3" */
    int   version_;        /**< @brief Numer wersji, zawsze rowny 15 */
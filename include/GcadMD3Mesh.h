@@ -22,8 +22,10 @@
 #define _GCAD_MD3MESH_H_
 
 #include "GcadMD3MeshHeader.h"
+#include "GcadByteSpan.h"
 #include "GcadVector2.h"
 #include "GcadVector3.h"
+#include "GcadByteSize.h"
 #include "GcadRefCountPtr.h"
 #include <iostream>
 #include <vector>
@@ -114,12 +116,40 @@ class MD3Mesh {
    */
    MD3Mesh( std::istream& meshDataStream );
 
+   /**
+     @brief
+       Odczyt siatki bezposrednio z obszaru pamieci, rozpoczynajacego sie
+       naglowkiem siatki (przesuniecia sekcji sa liczone od jego poczatku)
+
+     @exception
+       MD3FileHeader::BadHeaderData Sekcje siatki wykraczaja poza obszar
+       danych
+
+     @exception
+       Utilities::ByteSpanReader::Overrun
+   */
+   MD3Mesh( const Utilities::ByteSpan& meshData );
+
+   /**
+     @brief
+       Wymiana danych dwoch modeli w czasie stalym (w C++11 przenoszenie
+       obiektow korzysta z niejawnie generowanych konstruktorow)
+   */
+   void swap( MD3Mesh& that );
+
+   /**
+     @brief
+       Calkowita wielkosc pamieci zajmowanej przez siatke (obiekt,
+       naglowek, dane klatek kluczowych, koordynaty tekstur, poligony)
+   */
+   size_t getByteSize() const;
+
    /**
      @brief
        Akcesor skladowej opisujacej naglowek siatki (podstawowego
        budulca modelu MD3)
    */
-   MD3MeshHeader meshHeader() const;
+   const MD3MeshHeader& meshHeader() const;
 
    /**
      @brief
@@ -168,6 +198,19 @@ class MD3Mesh {
    void readVerticesKeyFrames( std::istream&           framesStream,
                                std::istream::pos_type  meshOffset );
 
+   /**
+     @brief
+       Dekompresja wierzcholkow wszystkich klatek z danych formatu MD3
+   */
+   void convertVerticesKeyFrames( const Utilities::ByteSpan::Byte* framesData );
+
+   /**
+     @brief
+       Kontrola, czy sekcje opisane naglowkiem zawieraja sie w obszarze
+       meshBytesCount bajtow
+   */
+   void checkSectionsBounds( size_t meshBytesCount ) const;
+
    void computeVerticesNormals();
 
  private:   
@@ -180,7 +223,7 @@ class MD3Mesh {
 
 
 //
-inline MD3MeshHeader MD3Mesh
+inline const MD3MeshHeader& MD3Mesh
 ::meshHeader() const 
 { 
   return *meshHeader_; 
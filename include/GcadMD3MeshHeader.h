@@ -21,6 +21,7 @@
 #ifndef _GCAD_MD3MESHHEADER_H_
 #define _GCAD_MD3MESHHEADER_H_
 
+#include "GcadByteSpan.h"
 #include <iostream>
 #include <string>
 
@@ -39,6 +40,15 @@ class MD3MeshHeader {
    */
    MD3MeshHeader( std::istream& meshHeaderStream );
 
+   /**
+     @brief
+       Odczyt naglowka z biezacej pozycji obszaru danych siatki
+
+     @exception
+       Utilities::ByteSpanReader::Overrun
+   */
+   MD3MeshHeader( Utilities::ByteSpanReader& meshHeaderData );
+
    std::string  id()             const;
    std::string  name()           const;
    int          framesNum()      const;
@@ -74,6 +84,13 @@ inline MD3MeshHeader
     sizeof( MD3MeshHeader ) );
 }
 
+//
+inline MD3MeshHeader
+::MD3MeshHeader( Utilities::ByteSpanReader& meshHeaderData )
+{
+  meshHeaderData.read( this );
+}
+
 //
 inline std::string MD3MeshHeader
 ::id() const
@@ -21,6 +21,7 @@
 #ifndef _GCAD_MD3TAG_H_
 #define _GCAD_MD3TAG_H_
 
+#include "GcadByteSpan.h"
 #include "GcadMatrix.h"
 #include "GcadQuaternion.h"
 #include "GcadVector3.h"
@@ -52,6 +53,15 @@ class MD3Tag {
    */
    MD3Tag( std::istream& tagDataStream );
 
+   /**
+     @brief
+       Odczyt lacznika z biezacej pozycji obszaru danych MD3
+
+     @exception
+       Utilities::ByteSpanReader::Overrun
+   */
+   MD3Tag( Utilities::ByteSpanReader& tagData );
+
    /**
      @brief
        Opisowa nazwa lacznika
@@ -76,6 +86,10 @@ class MD3Tag {
    */
    Quaternion quatOrient() const;
 
+ private:
+   template< typename SOURCE >
+   void readFrom( SOURCE& tagDataSource );
+
  private:
    char       name_[ 64 ];  /**< @brief Opis lacznika */
    Vector3    position_;    /**< @brief Pozycja lacznika */
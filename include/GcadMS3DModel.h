@@ -22,7 +22,10 @@
 #define _GCAD_MS3DMODEL_H_
 
 #include "GcadAssertion.h"
+#include "GcadByteSize.h"
+#include "GcadByteSpan.h"
 #include "GcadException.h"
+#include "GcadModelDataAllocator.h"
 #include "GcadQuaternion.h"
 #include "GcadVector2.h"
 #include "GcadVector3.h"
@@ -64,12 +67,14 @@ namespace Framework {
 class GCAD_EXPORT MS3DModel {
  public:
    class GCAD_EXPORT Vertex;
-   typedef std::vector<Vertex>       Vertices;
-   typedef Vertices::const_iterator  VerticesConstItor;
+   typedef std::vector<Vertex,
+     ModelDataAllocator<Vertex>::Type>  Vertices;
+   typedef Vertices::const_iterator     VerticesConstItor;
 
    class GCAD_EXPORT Face;
-   typedef std::vector<Face>      Faces; 
-   typedef Faces::const_iterator  FacesConstItor;
+   typedef std::vector<Face,
+     ModelDataAllocator<Face>::Type>  Faces; 
+   typedef Faces::const_iterator      FacesConstItor;
 
    class GCAD_EXPORT Mesh;
    typedef std::vector<Mesh>       Meshes;
@@ -188,6 +193,13 @@ class GCAD_EXPORT MS3DModel {
         return triIndexes_.end();
       }
 
+      /**
+        @brief
+          Wielkosc pamieci dynamicznej przydzielonej przez obiekt
+          (bez samego obiektu)
+      */
+      size_t getDynamicByteSize() const;
+
     public:
       // Interfejs implementacji wewnetrznej. Klient nie jest upowazniony
       // do jego uzywania!
@@ -223,6 +235,13 @@ class GCAD_EXPORT MS3DModel {
       const std::string& getTextureName() const { return textureName_; }
       const std::string& getAlphaTextureName() const { return alphaTexName_; }
 
+      /**
+        @brief
+          Wielkosc pamieci dynamicznej przydzielonej przez obiekt
+          (bez samego obiektu)
+      */
+      size_t getDynamicByteSize() const;
+
     public:
       // Jak i w poprzednich przypadkach funkcje zawarte w tym
       // przedziale, oznaczonym przez specyfikator publiczny nie powinny
@@ -318,6 +337,13 @@ class GCAD_EXPORT MS3DModel {
       float   getTranslationFrameTimeMember(size_t whichFrame) const;
       Vector3 getTranslationFrameData(size_t whichFrame) const;
 
+      /**
+        @brief
+          Wielkosc pamieci dynamicznej przydzielonej przez obiekt
+          (bez samego obiektu)
+      */
+      size_t getDynamicByteSize() const;
+
     public:
       // Interfejs wewnetrznej implementacji. Klient nie jest upowazniony
       // do wykonywania funkcji zawartych w tym przedziale!      
@@ -330,6 +356,20 @@ class GCAD_EXPORT MS3DModel {
             int numKeyFrameRotations,
             int numKeyFrameTranslations);
 
+      Joint(Utilities::ByteSpanReader& input,
+            const std::string& name,
+            const std::string& parentName,
+            const Vector3& initialRotation,
+            const Vector3& initialPosition,
+            int numKeyFrameRotations,
+            int numKeyFrameTranslations);
+
+    private:
+      template<typename SOURCE>
+      void readKeyFrames(SOURCE& input,
+                         int numKeyFrameRotations,
+                         int numKeyFrameTranslations);
+
     private:
       std::string name_;  /**< @brief Nazwa joint'a zdefiniowana w edytorze */
       std::string parentName_; /**< @brief Nazwa joint'a wezla ojca */
@@ -366,6 +406,35 @@ class GCAD_EXPORT MS3DModel {
  public:
    MS3DModel(std::istream& inputData);
 
+   /**
+     @brief
+       Odczyt modelu bezposrednio z obszaru pamieci (np. pliku
+       odwzorowanego przez Platform::MappedFile), bez posrednich buforow
+
+     @exception
+       BadDataFormat
+
+     @exception
+       Utilities::ByteSpanReader::Overrun Dane ucinaja sie przed koncem
+       modelu
+   */
+   MS3DModel(const Utilities::ByteSpan& ms3dData);
+
+   /**
+     @brief
+       Wymiana danych dwoch modeli w czasie stalym (w C++11 przenoszenie
+       obiektow korzysta z niejawnie generowanych konstruktorow)
+   */
+   void swap(MS3DModel& that);
+
+   /**
+     @brief
+       Calkowita wielkosc pamieci zajmowanej przez model (obiekt, tablice
+       wierzcholkow i poligonow, siatki, materialy, oraz szkielet wraz
+       z danymi klatek kluczowych)
+   */
+   size_t getByteSize() const;
+
  public: // interfejs bazujacy na iteratorach
    VerticesConstItor beginVertices() const { return vertices_.begin(); }
    VerticesConstItor endVertices() const { return vertices_.end(); }
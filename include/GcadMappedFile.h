@@ -0,0 +1,97 @@
+/***************************************************************************
+ *   Copyright (C) 2005 by Eryk Klebanski                                  *
+ *   rixment@gmail.com                                                     *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+
+#ifndef _GCAD_MAPPEDFILE_H_
+#define _GCAD_MAPPEDFILE_H_
+
+#include "GcadBase.h"
+#include "GcadByteSpan.h"
+#include <cstddef>
+#include <string>
+
+namespace Gcad {
+namespace Platform {
+
+/**
+  @brief
+    Plik odwzorowany w pamieci wylacznie do odczytu. Strony pliku sa
+    pobierane z pamieci podrecznej systemu plikow w chwili pierwszego
+    dostepu - nie nastepuje kopiowanie danych do buforow procesu, a te
+    same strony fizyczne sa wspoldzielone przez wszystkie procesy
+    odwzorowujace plik
+
+  @remark
+    Modyfikacja (badz skrocenie) pliku przez inny proces w czasie trwania
+    odwzorowania moze zmienic odczytywane dane, a w przypadku skrocenia
+    zakonczyc proces sygnalem SIGBUS (POSIX)
+
+  @code
+    MappedFile file;
+    if( file.map( "model.md2" ) ) {
+      MD2Data model( file.bytes() );
+    }
+  @endcode
+*/
+class GCAD_EXPORT MappedFile {
+ public:
+   MappedFile();
+   ~MappedFile();
+
+   /**
+     @brief
+       Odwzorowanie pliku path, poprzednie odwzorowanie zostaje zwolnione.
+       Pusty plik jest odwzorowywany jako pusty widok
+
+     @return
+       Wartosc false, gdy pliku nie udalo sie otworzyc badz odwzorowac
+   */
+   bool map( const std::string& path );
+
+   /**
+     @brief
+       Zwolnienie odwzorowania. Widoki uzyskane metoda bytes() staja sie
+       niewazne
+   */
+   void unmap();
+
+   bool isMapped() const;
+
+   /**
+     @brief
+       Widok calej zawartosci pliku (pusty, gdy plik nie jest odwzorowany)
+   */
+   Utilities::ByteSpan bytes() const;
+
+ private:
+   void*   address_;
+   size_t  size_;
+   bool    mapped_;
+
+ private:
+   // nie zaimplementowane
+   MappedFile( const MappedFile& );
+   MappedFile& operator =( const MappedFile& );
+};
+
+} // namespace Platform
+} // namespace Gcad
+
+#endif
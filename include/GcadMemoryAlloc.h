@@ -22,6 +22,8 @@
 #define _GCAD_MEMORYALLOC_H_
 
 #include "GcadAssertion.h"
+#include "GcadMemoryAllocStats.h"
+#include <cstddef> // size_t
 #include <memory>  // std::bad_alloc
 #include <utility> // std::pair
 
@@ -178,6 +180,13 @@ class MemoryAlloc {
    */
    static int segmentsCount();
 
+   /**
+     @brief
+       Migawka biezacego stanu puli - zajetosc, fragmentacja, oraz
+       liczniki operacji (patrz MemoryAllocStats)
+   */
+   static MemoryAllocStats statistics();
+
  protected:
    /** 
      @brief 
@@ -291,6 +300,12 @@ class MemoryAlloc {
        ELEM_COUNT * SEG_SIZE bajtow
    */
    static char  memoryPool_[ ELEM_COUNT * SEG_SIZE ];
+
+   /**
+     @brief
+       Liczniki operacji (aktywne z definicja GCAD_MEMORY_STATS)
+   */
+   static MemoryAllocCounters  counters_;
  
  private:
    // nie zaimplementowane
@@ -315,12 +330,17 @@ template< int ELEM_COUNT, int SEG_SIZE >
 char MemoryAlloc< ELEM_COUNT, SEG_SIZE >
 ::memoryPool_[ ELEM_COUNT * SEG_SIZE ] = { 0 };
 
+//
+template< int ELEM_COUNT, int SEG_SIZE > 
+MemoryAllocCounters MemoryAlloc< ELEM_COUNT, SEG_SIZE >
+::counters_;
+
 //
 template< int ELEM_COUNT, int SEG_SIZE > inline 
 void* MemoryAlloc< ELEM_COUNT, SEG_SIZE >
 ::operator new []( size_t bytesCount ) throw( std::bad_alloc )
 {
-  return operator new( byteSize );
+  return operator new( bytesCount );
 }
 
 //
@@ -328,7 +348,7 @@ template< int ELEM_COUNT, int SEG_SIZE > inline
 void MemoryAlloc< ELEM_COUNT, SEG_SIZE >
 ::operator delete []( void* memoryToRelease ) throw() 
 {
-  delete static_cast< void* >( memoryToRelease );
+  operator delete( memoryToRelease );
 }
 
 //
@@ -354,6 +374,8 @@ void MemoryAlloc< ELEM_COUNT, SEG_SIZE >
   const int lastEmptyNode  = ELEM_COUNT;
   links_[ lastEmptyNode ].next_ = 0;
   links_[ lastEmptyNode ].seg_  = 0;
+
+  counters_.reset();
 }
 
 //
@@ -361,6 +383,9 @@ template< int ELEM_COUNT, int SEG_SIZE >
 void MemoryAlloc< ELEM_COUNT, SEG_SIZE >
 ::operator delete( void* memoryToRelease ) throw() 
 {
+  if( memoryToRelease == 0 )
+    return;
+
   // Obliczamy ilosc elementow znajdujacych sie pomiedzy zakresem wyznaczonym
   // przez wskaznik p (konwertowany z void* na char*, aby mogla byc wykonana
   // arytmetyka wskaznikow), a wskaznikiem okreslajacym poczatek tablicy pamieci
@@ -380,6 +405,8 @@ void MemoryAlloc< ELEM_COUNT, SEG_SIZE >
   if( links_[ memPoolIndex ].next_ != memPoolIndex )
     return;
 
+  counters_.recordDeallocation( links_[ memPoolIndex ].seg_ * SEG_SIZE );
+
   // Zapamietujemy nastepny lacznik, czyli indeks kolejnego wezla listy za
   // aktualnie wskazywanym przez glowe wolnego obszaru
   int next = links_[ head_ ].next_;
@@ -467,7 +494,7 @@ template< int ELEM_COUNT, int SEG_SIZE >
 void* MemoryAlloc< ELEM_COUNT, SEG_SIZE >
 ::operator new( size_t bytesCount ) throw( std::bad_alloc ) 
 {
-  CommonUtil::assure( 
+  assertion( 
     bytesPerSegment() != 0, 
     "MemoryAlloc::operator new( size_t bytesCount ): Dedukowana wartosc "
     "okreslajaca wielkosc segmentu nie moze byc rowna zeru" );
@@ -493,7 +520,16 @@ void* MemoryAlloc< ELEM_COUNT, SEG_SIZE >
     floorNededSegments;
   
   // Probujemy przydzielic obszar
-  return giveBlock( blockCount );
+  void* memory = 0;
+  try {
+    memory = giveBlock( blockCount );
+  } catch( std::bad_alloc& ) {
+    counters_.recordFailure( bytesCount );
+    throw;
+  }
+
+  counters_.recordAllocation( bytesCount, blockCount * SEG_SIZE );
+  return memory;
 }
 
 //
@@ -529,7 +565,7 @@ void* MemoryAlloc< ELEM_COUNT, SEG_SIZE >
 //
 template< int ELEM_COUNT, int SEG_SIZE > inline 
 int MemoryAlloc< ELEM_COUNT, SEG_SIZE >
-::size() const
+::size()
 {
   return ELEM_COUNT * SEG_SIZE;
 }
@@ -537,7 +573,7 @@ int MemoryAlloc< ELEM_COUNT, SEG_SIZE >
 //
 template< int ELEM_COUNT, int SEG_SIZE > inline 
 int MemoryAlloc< ELEM_COUNT, SEG_SIZE >
-::bytesPerSegment() const
+::bytesPerSegment()
 {
   return SEG_SIZE;
 }
@@ -545,11 +581,46 @@ int MemoryAlloc< ELEM_COUNT, SEG_SIZE >
 //
 template< int ELEM_COUNT, int SEG_SIZE > inline
 int MemoryAlloc< ELEM_COUNT, SEG_SIZE >
-::segmentsCount() const
+::segmentsCount()
 {
   return ELEM_COUNT;
 }
 
+//
+template< int ELEM_COUNT, int SEG_SIZE >
+MemoryAllocStats MemoryAlloc< ELEM_COUNT, SEG_SIZE >
+::statistics()
+{
+  MemoryAllocStats stats;
+  counters_.fill( &stats );
+
+  // Obszar ciagly to sekwencja wezlow listy wolnej pamieci, z ktorych
+  // kazdy wskazuje na bezposrednio nastepujacy po nim segment
+  int largestRun = 0;
+  int freeRuns   = 0;
+  int currentRun = 0;
+
+  for( int node = head_;
+    links_[ node ].isEnd() == false;
+    node = links_[ node ].next_ )
+  {
+    ++currentRun;
+
+    if( links_[ node ].next_ != node + 1 ||
+      links_[ node + 1 ].isEnd() )
+    {
+      ++freeRuns;
+      if( currentRun > largestRun )
+        largestRun = currentRun;
+      currentRun = 0;
+    }
+  }
+
+  stats.largestFreeRun_ = largestRun * SEG_SIZE;
+  stats.freeRuns_       = freeRuns;
+  return stats;
+}
+
 } // namespace Utilities
 } // namespace Gcad
 
@@ -0,0 +1,241 @@
+/***************************************************************************
+ *   Copyright (C) 2005 by Eryk Klebanski                                  *
+ *   rixment@gmail.com                                                     *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef _GCAD_MEMORYALLOCSTATS_H_
+#define _GCAD_MEMORYALLOCSTATS_H_
+
+#include <cstddef>
+#include <ostream>
+
+namespace Gcad {
+namespace Utilities {
+
+/**
+  @brief
+    Migawka stanu puli pamieci (MemoryAlloc, SegregatedMemoryAlloc,
+    ChunkedMemoryPool)
+
+    Wartosci opisujace uklad wolnej pamieci (largestFreeRun_, freeRuns_)
+    sa wyznaczane w chwili pobrania migawki i sa dostepne zawsze.
+    Liczniki operacji, oraz histogram wielkosci zadan sa zbierane jedynie
+    wtedy, gdy biblioteka zostala skompilowana z definicja symbolu
+    GCAD_MEMORY_STATS - w przeciwnym wypadku maja wartosc zerowa
+
+  @remark
+    Koszyk k histogramu zlicza zadania o wielkosci z przedzialu
+    < 2^k, 2^(k+1) ) bajtow. Koszyk zerowy obejmuje rowniez zadania
+    zerowe, a ostatni - wszystkie wieksze
+*/
+struct MemoryAllocStats {
+   enum { HISTOGRAM_BUCKETS = 16 };
+
+   size_t  bytesInUse_;          /**< Bajty aktualnie przydzielonych segmentow */
+   size_t  highWaterMark_;       /**< Najwieksza wartosc bytesInUse_ */
+   size_t  allocations_;         /**< Liczba udanych przydzialow */
+   size_t  deallocations_;       /**< Liczba zwolnien */
+   size_t  failedAllocations_;   /**< Liczba przydzialow zakonczonych bad_alloc */
+   size_t  largestFreeRun_;      /**< Najwiekszy ciagly wolny obszar (bajty) */
+   size_t  freeRuns_;            /**< Liczba wolnych obszarow (fragmentacja) */
+
+   /**
+     @brief
+       Histogram wielkosci zadan przydzialu
+   */
+   size_t  requestHistogram_[ HISTOGRAM_BUCKETS ];
+};
+
+/**
+  @brief
+    Liczniki operacji puli pamieci
+
+  @remark
+    Bez definicji GCAD_MEMORY_STATS metody rejestrujace sa puste i zostaja
+    calkowicie usuniete przez kompilator. Pola sa obecne niezaleznie od
+    konfiguracji, aby uklad klas zawierajacych liczniki byl identyczny
+    w bibliotece i u jej klientow
+*/
+class MemoryAllocCounters {
+ public:
+   MemoryAllocCounters() { reset(); }
+
+   /**
+     @brief
+       Wyzerowanie wszystkich licznikow
+   */
+   void reset();
+
+   /**
+     @brief
+       Rejestracja udanego przydzialu
+
+     @param requestedBytes Wielkosc zadania
+     @param grantedBytes Wielkosc obszaru (pelne segmenty)
+   */
+   void recordAllocation( size_t requestedBytes, size_t grantedBytes );
+
+   /**
+     @brief
+       Rejestracja przydzialu zakonczonego niepowodzeniem
+   */
+   void recordFailure( size_t requestedBytes );
+
+   /**
+     @brief
+       Rejestracja zwolnienia obszaru o wielkosci grantedBytes
+   */
+   void recordDeallocation( size_t grantedBytes );
+
+   /**
+     @brief
+       Przepisanie wartosci licznikow do migawki
+   */
+   void fill( MemoryAllocStats* stats ) const;
+
+ private:
+   void recordRequest( size_t requestedBytes );
+
+ private:
+   size_t  bytesInUse_;
+   size_t  highWaterMark_;
+   size_t  allocations_;
+   size_t  deallocations_;
+   size_t  failedAllocations_;
+   size_t  requestHistogram_[ MemoryAllocStats::HISTOGRAM_BUCKETS ];
+};
+
+
+//
+inline void MemoryAllocCounters
+::reset()
+{
+  bytesInUse_        = 0;
+  highWaterMark_     = 0;
+  allocations_       = 0;
+  deallocations_     = 0;
+  failedAllocations_ = 0;
+
+  for( int bucket = 0; bucket < MemoryAllocStats::HISTOGRAM_BUCKETS; ++bucket )
+    requestHistogram_[ bucket ] = 0;
+}
+
+//
+inline void MemoryAllocCounters
+::recordRequest( size_t requestedBytes )
+{
+  int bucket = 0;
+  while( requestedBytes > 1 &&
+    bucket < MemoryAllocStats::HISTOGRAM_BUCKETS - 1 )
+  {
+    requestedBytes >>= 1;
+    ++bucket;
+  }
+
+  ++requestHistogram_[ bucket ];
+}
+
+//
+inline void MemoryAllocCounters
+::recordAllocation( size_t requestedBytes,
+                    size_t grantedBytes )
+{
+#ifdef GCAD_MEMORY_STATS
+  recordRequest( requestedBytes );
+  ++allocations_;
+
+  bytesInUse_ += grantedBytes;
+  if( bytesInUse_ > highWaterMark_ )
+    highWaterMark_ = bytesInUse_;
+#else
+  ( void )requestedBytes;
+  ( void )grantedBytes;
+#endif
+}
+
+//
+inline void MemoryAllocCounters
+::recordFailure( size_t requestedBytes )
+{
+#ifdef GCAD_MEMORY_STATS
+  recordRequest( requestedBytes );
+  ++failedAllocations_;
+#else
+  ( void )requestedBytes;
+#endif
+}
+
+//
+inline void MemoryAllocCounters
+::recordDeallocation( size_t grantedBytes )
+{
+#ifdef GCAD_MEMORY_STATS
+  ++deallocations_;
+  bytesInUse_ -= grantedBytes;
+#else
+  ( void )grantedBytes;
+#endif
+}
+
+//
+inline void MemoryAllocCounters
+::fill( MemoryAllocStats* stats ) const
+{
+  stats->bytesInUse_        = bytesInUse_;
+  stats->highWaterMark_     = highWaterMark_;
+  stats->allocations_       = allocations_;
+  stats->deallocations_     = deallocations_;
+  stats->failedAllocations_ = failedAllocations_;
+
+  for( int bucket = 0; bucket < MemoryAllocStats::HISTOGRAM_BUCKETS; ++bucket )
+    stats->requestHistogram_[ bucket ] = requestHistogram_[ bucket ];
+}
+
+/**
+  @brief
+    Zapis migawki w postaci tekstowej, wraz z histogramem wielkosci zadan
+*/
+inline
+std::ostream&
+operator <<( std::ostream&            out,
+             const MemoryAllocStats&  stats )
+{
+  out << "bytes in use:       " << stats.bytesInUse_        << '\n'
+      << "high-water mark:    " << stats.highWaterMark_     << '\n'
+      << "allocations:        " << stats.allocations_       << '\n'
+      << "deallocations:      " << stats.deallocations_     << '\n'
+      << "failed allocations: " << stats.failedAllocations_ << '\n'
+      << "largest free run:   " << stats.largestFreeRun_    << '\n'
+      << "free runs:          " << stats.freeRuns_          << '\n'
+      << "request sizes:"                                   << '\n';
+
+  for( int bucket = 0; bucket < MemoryAllocStats::HISTOGRAM_BUCKETS; ++bucket ) {
+    if( stats.requestHistogram_[ bucket ] == 0 )
+      continue;
+
+    out << "  >= " << ( static_cast< size_t >( 1 ) << bucket ) << "\t"
+        << stats.requestHistogram_[ bucket ] << '\n';
+  }
+
+  return out;
+}
+
+} // namespace Utilities
+} // namespace Gcad
+
+#endif
@@ -0,0 +1,111 @@
+/***************************************************************************
+ *   Copyright (C) 2005 by Eryk Klebanski                                  *
+ *   rixment@gmail.com                                                     *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+
+#ifndef _GCAD_MEMORYINPUTSTREAM_H_
+#define _GCAD_MEMORYINPUTSTREAM_H_
+
+#include <cstddef>
+#include <istream>
+#include <streambuf>
+
+namespace Gcad {
+namespace Utilities {
+
+/**
+  @brief
+    Bufor strumienia odczytujacy dane z ciaglego obszaru pamieci, bez
+    ich kopiowania. Obslugiwane jest pozycjonowanie (seekg, tellg),
+    wykorzystywane przez parsery formatow plikow modeli
+
+  @remark
+    Obszar musi istniec przez caly czas korzystania z bufora
+*/
+class MemoryStreamBuf : public std::streambuf {
+ public:
+   MemoryStreamBuf( const char*  data,
+                    size_t       bytesCount )
+   {
+     char* begin = const_cast< char* >( data );
+     setg( begin, begin, begin + bytesCount );
+   }
+
+ protected:
+   pos_type seekoff( off_type                 offset,
+                     std::ios_base::seekdir   direction,
+                     std::ios_base::openmode  mode = std::ios_base::in )
+   {
+     if( ( mode & std::ios_base::in ) == 0 )
+       return pos_type( off_type( -1 ) );
+
+     char* origin = gptr();
+     if( direction == std::ios_base::beg )
+       origin = eback();
+     else if( direction == std::ios_base::end )
+       origin = egptr();
+
+     if( offset < eback() - origin || offset > egptr() - origin )
+       return pos_type( off_type( -1 ) );
+
+     setg( eback(), origin + offset, egptr() );
+     return pos_type( gptr() - eback() );
+   }
+
+   pos_type seekpos( pos_type                 position,
+                     std::ios_base::openmode  mode = std::ios_base::in )
+   {
+     return seekoff( off_type( position ), std::ios_base::beg, mode );
+   }
+
+ private:
+   // nie zaimplementowane
+   MemoryStreamBuf( const MemoryStreamBuf& );
+   MemoryStreamBuf& operator =( const MemoryStreamBuf& );
+};
+
+/**
+  @brief
+    Strumien wejsciowy danych zawartych w pamieci (np. pliku wczytanego
+    przez Platform::BatchFileReader). Pozwala przekazac bufor do
+    konstruktorow modeli pobierajacych std::istream
+
+  @code
+    MemoryInputStream input( completion.data_, completion.size_ );
+    MS3DModel model( input );
+  @endcode
+*/
+class MemoryInputStream : public std::istream {
+ public:
+   MemoryInputStream( const char*  data,
+                      size_t       bytesCount )
+     : std::istream( 0 )
+     , buffer_( data, bytesCount )
+   {
+     rdbuf( &buffer_ );
+   }
+
+ private:
+   MemoryStreamBuf  buffer_;
+};
+
+} // namespace Utilities
+} // namespace Gcad
+
+#endif
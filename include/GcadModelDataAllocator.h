@@ -0,0 +1,115 @@
+/***************************************************************************
+ *   Copyright (C) 2005 by Eryk Klebanski                                  *
+ *   rixment@gmail.com                                                     *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef _GCAD_MODELDATAALLOCATOR_H_
+#define _GCAD_MODELDATAALLOCATOR_H_
+
+#include <memory>
+
+#ifdef GCAD_MODEL_DATA_POOL
+  #include "GcadBase.h"
+  #include "GcadChunkedMemoryPool.h"
+  #include "GcadPoolAllocator.h"
+#endif
+
+namespace Gcad {
+namespace Framework {
+
+#ifdef GCAD_MODEL_DATA_POOL
+
+/**
+  @brief
+    Pula pamieci danych modeli (wierzcholki, normalne, koordynaty
+    tekstur). Fragmenty po 4MB, maksymalnie 64 fragmenty
+
+    Modele sa tworzone w watkach roboczych (ResourceLoader), a usuwane
+    w watku wlasciciela menadzera, dlatego kazda operacja na puli
+    zajmuje muteks
+
+  @remark
+    Rozmiar fragmentu ogranicza wielkosc pojedynczego kontenera - bufor
+    wierzcholkow (klatki, badz calego modelu) wiekszy niz 4MB nie moze
+    zostac przydzielony (std::bad_alloc)
+
+  @remark
+    Wywolanie ModelDataPool::purgeMemory() zwalnia jednorazowo dane
+    wszystkich modeli - dopuszczalne jedynie po ich usunieciu
+*/
+class GCAD_EXPORT ModelDataPool {
+ public:
+   /**
+     @exception
+       std::bad_alloc Wyczerpanie fragmentow puli, badz zadanie
+       przekraczajace rozmiar fragmentu
+   */
+   static void* operator new( size_t bytesCount ) throw( std::bad_alloc );
+
+   static void operator delete( void* memoryToRelease ) throw();
+
+   static void purgeMemory();
+
+   /**
+     @brief
+       Migawka biezacego stanu puli (patrz MemoryAllocStats)
+   */
+   static Utilities::MemoryAllocStats statistics();
+
+   /**
+     @brief
+       Konfiguracja zwrotu wolnych fragmentow do systemu (patrz
+       ChunkedMemoryPool::setIdleRelease)
+   */
+   static void setIdleRelease( const Platform::TimeInformation*  timeInformation,
+                               size_t                            idleMilliseconds );
+
+   static void releaseIdleChunks();
+
+ private:
+   // nie zaimplementowane
+   ModelDataPool();
+};
+
+/**
+  @brief
+    Alokator kontenerow danych modeli (MD2Data, MS3DModel)
+
+    Wybor alokatora odbywa sie w czasie kompilacji biblioteki. Z definicja
+    symbolu GCAD_MODEL_DATA_POOL kontenery korzystaja z puli ModelDataPool,
+    a ich elementy sa wyrownane do 16 bajtow. W przeciwnym wypadku
+    stosowany jest std::allocator
+*/
+template< typename T >
+struct ModelDataAllocator {
+  typedef Utilities::PoolAllocator< T, ModelDataPool, 16 >  Type;
+};
+
+#else
+
+template< typename T >
+struct ModelDataAllocator {
+  typedef std::allocator< T >  Type;
+};
+
+#endif
+
+} // namespace Framework
+} // namespace Gcad
+
+#endif
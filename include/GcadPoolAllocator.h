@@ -0,0 +1,160 @@
+/***************************************************************************
+ *   Copyright (C) 2005 by Eryk Klebanski                                  *
+ *   rixment@gmail.com                                                     *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef _GCAD_POOLALLOCATOR_H_
+#define _GCAD_POOLALLOCATOR_H_
+
+#include <cstddef>
+#include <memory>  // std::bad_alloc
+#include <new>
+
+namespace Gcad {
+namespace Utilities {
+
+/**
+  @brief
+    Alokator zgodny z wymaganiami biblioteki standardowej, pobierajacy
+    pamiec z puli o statycznym interfejsie (MemoryAlloc,
+    SegregatedMemoryAlloc, ChunkedMemoryAlloc)
+
+    Kazdy przydzial jest powiekszany o ALIGNMENT bajtow, dzieki czemu
+    zwracany adres moze zostac wyrownany do granicy ALIGNMENT (np. 16, 32,
+    64 - wymagania SSE/AVX, badz linii pamieci podrecznej). Odleglosc od
+    poczatku obszaru uzyskanego z puli zostaje zapisana w bajcie
+    poprzedzajacym zwracany adres
+
+  @param
+    T Typ elementow kontenera
+
+  @param
+    POOL Klasa udostepniajaca statyczne operatory new i delete
+
+  @param
+    ALIGNMENT Wyrownanie adresow elementow (potega dwojki, nie wieksza
+    niz 128)
+
+  @remark
+    Alokator nie posiada stanu - wszystkie instancje o tych samych
+    parametrach sa rownowazne. Zwolnienie calej pamieci kontenerow
+    (np. wszystkich danych modelu) nastepuje jednorazowo, wywolaniem
+    POOL::purgeMemory(), o ile zadne z nich nie jest juz uzywane
+
+  @code
+    typedef ChunkedMemoryAlloc< 4096, 64 >                  VertexPool;
+    typedef PoolAllocator< Vector3, VertexPool, 32 >        VertexAllocator;
+    typedef std::vector< Vector3, VertexAllocator >         Vertices;
+  @endcode
+*/
+template< typename T,
+          typename POOL,
+          int      ALIGNMENT = 16 >
+class PoolAllocator {
+ public:
+   typedef T                 value_type;
+   typedef T*                pointer;
+   typedef const T*          const_pointer;
+   typedef T&                reference;
+   typedef const T&          const_reference;
+   typedef std::size_t       size_type;
+   typedef std::ptrdiff_t    difference_type;
+
+   template< typename U >
+   struct rebind {
+     typedef PoolAllocator< U, POOL, ALIGNMENT >  other;
+   };
+
+   PoolAllocator() throw() {}
+
+   template< typename U >
+   PoolAllocator( const PoolAllocator< U, POOL, ALIGNMENT >& ) throw() {}
+
+   pointer address( reference value ) const { return &value; }
+   const_pointer address( const_reference value ) const { return &value; }
+
+   /**
+     @exception
+       std::bad_alloc Wyczerpanie pamieci puli POOL
+   */
+   pointer allocate( size_type count, const void* = 0 )
+   {
+     char* block = static_cast< char* >(
+       POOL::operator new( count * sizeof( T ) + ALIGNMENT ) );
+
+     // Przesuniecie z zakresu < 1, ALIGNMENT > - zawsze pozostaje
+     // miejsce na zapis jego wartosci
+     const std::size_t OFFSET = ALIGNMENT -
+       reinterpret_cast< std::size_t >( block ) % ALIGNMENT;
+
+     char* aligned = block + OFFSET;
+     aligned[ -1 ] = static_cast< char >( OFFSET );
+     return reinterpret_cast< pointer >( aligned );
+   }
+
+   void deallocate( pointer place, size_type )
+   {
+     if( place == 0 )
+       return;
+
+     char* aligned = reinterpret_cast< char* >( place );
+     POOL::operator delete(
+       aligned - static_cast< unsigned char >( aligned[ -1 ] ) );
+   }
+
+   size_type max_size() const throw()
+   {
+     return ( static_cast< size_type >( -1 ) - ALIGNMENT ) / sizeof( T );
+   }
+
+   void construct( pointer place, const T& value )
+   {
+     new( static_cast< void* >( place ) ) T( value );
+   }
+
+   void destroy( pointer place ) { place->~T(); }
+
+ private:
+   // Kontrola parametru ALIGNMENT w czasie kompilacji
+   typedef char AlignmentCheck[
+     ( ALIGNMENT > 0 && ALIGNMENT <= 128 &&
+       ( ALIGNMENT & ( ALIGNMENT - 1 ) ) == 0 ) ? 1 : -1 ];
+};
+
+//
+template< typename T, typename U, typename POOL, int ALIGNMENT > inline
+bool
+operator ==( const PoolAllocator< T, POOL, ALIGNMENT >&,
+             const PoolAllocator< U, POOL, ALIGNMENT >& )
+{
+  return true;
+}
+
+//
+template< typename T, typename U, typename POOL, int ALIGNMENT > inline
+bool
+operator !=( const PoolAllocator< T, POOL, ALIGNMENT >&,
+             const PoolAllocator< U, POOL, ALIGNMENT >& )
+{
+  return false;
+}
+
+} // namespace Utilities
+} // namespace Gcad
+
+#endif
@@ -0,0 +1,138 @@
+/***************************************************************************
+ *   Copyright (C) 2005 by Eryk Klebanski                                  *
+ *   rixment@gmail.com                                                     *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+
+#ifndef _GCAD_PROCESSEDCACHE_H_
+#define _GCAD_PROCESSEDCACHE_H_
+
+#include "GcadBase.h"
+#include "GcadByteSpan.h"
+#include "GcadMappedFile.h"
+#include <cstddef>
+#include <string>
+
+namespace Gcad {
+namespace Platform {
+
+/**
+  @brief
+    Skrot zawartosci pliku zrodlowego (64 bity)
+*/
+#ifdef _MSC_VER
+  typedef unsigned __int64  ContentHash;
+#else
+  __extension__ typedef unsigned long long  ContentHash;
+#endif
+
+/**
+  @brief
+    Trwala (dyskowa) pamiec podreczna przetworzonych zasobow, np. modeli
+    MD2 z obliczonymi normalnymi (MD2Data::writeProcessed). Kluczem wpisu
+    jest skrot zawartosci pliku zrodlowego (FNV-1a), wiec zmiana pliku
+    zmienia klucz - nieaktualny wpis nie jest juz nigdy odczytywany,
+    a zasob zostaje przetworzony i zapisany ponownie
+
+    Wpis jest pojedynczym plikiem katalogu pamieci (nazwa - szesnastkowy
+    zapis skrotu) skladajacym sie z naglowka (Header), oraz danych
+    przetworzonego zasobu rozpoczynajacych sie od przesuniecia
+    sizeof(Header). Wpis jest odczytywany przez odwzorowanie w pamieci
+
+  @remark
+    Katalog musi istniec. Wpisy sa zapisywane do pliku tymczasowego,
+    a nastepnie przemianowywane, wiec jednoczesny zapis tego samego wpisu
+    przez kilka watkow (procesow) nie uszkadza danych. Nieaktualne wpisy
+    nie sa usuwane automatycznie. Metody stale moga byc wywolywane
+    jednoczesnie przez wiele watkow
+
+  @code
+    ProcessedCache cache( "cache" );
+    manager.setProcessedCache( &cache );  // DataFileResourceManager<MD2Data>
+  @endcode
+*/
+class GCAD_EXPORT ProcessedCache {
+ public:
+   typedef unsigned int  UInt32;
+
+   enum { 
+     VERSION = 1 
+   };
+
+   struct Header {
+     char    magic_[4];       /**< "GPCE" */
+     UInt32  version_;
+     UInt32  hashLow_;        /**< Skrot zawartosci zrodla */
+     UInt32  hashHigh_;
+     UInt32  payloadSize_;    /**< Rozmiar danych za naglowkiem */
+     UInt32  reserved_[3];
+   };
+
+   explicit ProcessedCache(const std::string& directory);
+
+   const std::string& getDirectory() const { return directory_; }
+
+   /**
+     @brief
+       Skrot zawartosci pliku zrodlowego (FNV-1a, 64 bity)
+   */
+   static ContentHash hashContent(const Utilities::ByteSpan& bytes);
+
+   /**
+     @brief
+       Odwzorowanie wpisu o kluczu hash. Widok payload wskazuje dane
+       przetworzonego zasobu i jest wazny do czasu zwolnienia entry
+
+     @return
+       Wartosc false, gdy wpis nie istnieje, badz jest niepoprawny
+   */
+   bool find(ContentHash           hash,
+             MappedFile*           entry,
+             Utilities::ByteSpan*  payload) const;
+
+   /**
+     @brief
+       Zapis (zastapienie) wpisu o kluczu hash
+
+     @return
+       Wartosc false w przypadku bledu zapisu (pamiec podreczna jest
+       jedynie optymalizacja, wiec blad nie jest zglaszany wyjatkiem)
+   */
+   bool store(ContentHash         hash,
+              const std::string&  payload) const;
+
+   /**
+     @brief
+       Sciezka pliku wpisu o kluczu hash
+   */
+   std::string entryPath(ContentHash hash) const;
+
+ private:
+   std::string             directory_;
+   mutable volatile long   temporaryCounter_; /**< Unikalne nazwy plikow 
+                                                   tymczasowych */
+ private:
+   // nie zaimplementowane
+   ProcessedCache(const ProcessedCache&);
+   ProcessedCache& operator =(const ProcessedCache&);
+};
+
+} // namespace Platform
+} // namespace Gcad
+
+#endif
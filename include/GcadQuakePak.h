@@ -0,0 +1,158 @@
+/***************************************************************************
+ *   Copyright (C) 2005 by Eryk Klebanski                                  *
+ *   rixment@gmail.com                                                     *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+
+#ifndef _GCAD_QUAKEPAK_H_
+#define _GCAD_QUAKEPAK_H_
+
+#include "GcadBase.h"
+#include "GcadByteSpan.h"
+#include "GcadMappedFile.h"
+#include "GcadResourceArchive.h"
+#include "GcadSymbolTST.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace Gcad {
+namespace Platform {
+
+/**
+  @brief
+    Archiwum .pak gier Quake / Quake2, odwzorowane w pamieci w calosci.
+    Katalog archiwum jest indeksowany jednokrotnie podczas otwarcia -
+    nazwy wpisow trafiaja do drzewa SymbolTST, ktorego uchwyty sa indeksami
+    tablicy wpisow. Dane wpisow sa udostepniane jako widoki odwzorowania
+    (bez kopiowania), wiec modele moga byc tworzone bezposrednio
+    z archiwum - konstruktorami MD2Data(const ByteSpan&),
+    MD3Data(const ByteSpan&)
+
+    Uklad pliku (wartosci 32-bitowe little-endian):
+      - naglowek: "PACK", przesuniecie katalogu, rozmiar katalogu
+      - katalog: wpisy o rozmiarze 64 bajtow - nazwa (56 znakow, sciezka
+        oddzielana znakiem '/'), przesuniecie danych, rozmiar danych
+
+    Znaki '/' nazw sa zamieniane na '\\' (ResourceArchive). Jezeli katalog
+    zawiera kilka wpisow o tej samej nazwie, obowiazuje pierwszy z nich
+    (tak jak w silniku Quake)
+
+  @remark
+    Obiekt nie jest kopiowalny. Widoki wpisow sa wazne do czasu zamkniecia
+    archiwum
+
+  @code
+    QuakePak pak;
+    Utilities::ByteSpan bytes;
+    if( pak.open( "pak0.pak" ) &&
+        pak.find( "models\\monsters\\soldier\\tris.md2", &bytes ) )
+    {
+      MD2Data soldier( bytes );
+    }
+  @endcode
+*/
+class GCAD_EXPORT QuakePak : public ResourceArchive {
+ public:
+   typedef unsigned int  UInt32;
+
+   enum { 
+     NAME_LENGTH = 56 
+   };
+
+   struct Header {
+     char    magic_[4];          /**< "PACK" */
+     UInt32  directoryOffset_;
+     UInt32  directoryLength_;
+   };
+
+   struct Entry {
+     char    name_[NAME_LENGTH];
+     UInt32  filePosition_;
+     UInt32  fileLength_;
+   };
+
+   QuakePak();
+
+   /**
+     @brief
+       Odwzorowanie archiwum path, poprzednie archiwum zostaje zamkniete.
+       Sprawdzany jest naglowek, oraz zawieranie sie katalogu i danych
+       wszystkich wpisow w pliku
+
+     @return
+       Wartosc false, gdy pliku nie udalo sie odwzorowac, badz nie jest
+       on poprawnym archiwum
+   */
+   bool open(const std::string& path);
+
+   void close();
+
+   bool isOpen() const { return file_.isMapped(); }
+
+   virtual size_t entriesCount() const;
+
+   virtual std::string entryName(size_t index) const;
+
+   virtual Utilities::ByteSpan entryBytes(size_t index) const;
+
+   virtual size_t lowerBound(const std::string& name) const;
+
+   /**
+     @brief
+       Odnalezienie wpisu przeszukaniem drzewa TST (koszt zalezy jedynie
+       od dlugosci nazwy)
+   */
+   virtual bool find(const std::string&    name, 
+                     Utilities::ByteSpan*  bytes) const;
+
+ private:
+   /**
+     @brief
+       Weryfikacja oraz indeksowanie katalogu odwzorowanego archiwum.
+       Wpisy katalogu sa kopiowane (memcpy), gdyz katalog nie musi byc
+       wyrownany
+   */
+   bool indexDirectory();
+
+   /**
+     @brief
+       Porownanie nazw wpisow o zadanych uchwytach (sortowanie)
+   */
+   struct NameLess;
+
+ private:
+   typedef Utilities::SymbolTST<char>  NameToEntry;
+
+   MappedFile                        file_;
+   NameToEntry                       nameToEntry_; /**< Nazwa na uchwyt */
+   std::vector<Utilities::ByteSpan>  bytes_;       /**< Dane wedlug uchwytow */
+   std::vector<std::string>          names_;       /**< Nazwy wedlug uchwytow */
+   std::vector<size_t>               sorted_;      /**< Uchwyty w porzadku 
+                                                        nazw */
+
+ private:
+   // nie zaimplementowane
+   QuakePak(const QuakePak&);
+   QuakePak& operator =(const QuakePak&);
+};
+
+} // namespace Platform
+} // namespace Gcad
+
+#endif
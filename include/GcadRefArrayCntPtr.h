@@ -26,24 +26,26 @@
 namespace Gcad {
 namespace Utilities {
 
+/**
+  @brief
+    Odmiana RefCountPtr dla tablic utworzonych operatorem new[]
+
+    Tablica jest usuwana operatorem delete[] dopiero wtedy, gdy
+    licznik odniesien osiagnie wartosc zero
+*/
 template<typename T>
-class RefArrayCntPtr : public RefCountPtr<T> {
+class RefArrayCntPtr : public RefCountPtr< T, DeleteArray<T> > {
  public:
    RefArrayCntPtr( T* pointer = 0 )
-     : RefCountPtr<T>(pointer)
+     : RefCountPtr< T, DeleteArray<T> >(pointer)
    {}
    
    RefArrayCntPtr( const RefArrayCntPtr& that )
-     : RefCountPtr<T>(that)
+     : RefCountPtr< T, DeleteArray<T> >(that)
    {}
 
    T& operator [](size_t index) const {
-     return *( get() + index );
-   }
-
-   ~RefArrayCntPtr() {
-     T* array = release();
-     delete [] array;
+     return *( this->get() + index );
    }
 };
 
@@ -21,8 +21,11 @@
 #ifndef _GCAD_REFCOUNTPTR_H_
 #define _GCAD_REFCOUNTPTR_H_
 
+#include "GcadBase.h"
 #include "GcadAssertion.h"
-#include <map>
+#include "GcadDeletePolicy.h"
+#include "GcadRefCounted.h"
+#include <algorithm>
 
 namespace Gcad {
 namespace Utilities {
@@ -34,6 +37,11 @@ namespace Utilities {
     Klasa "inteligentnych wskaznikow" wykorzystujaca techniki:
     - zliczania odniesien
     - pozyskanie zasobow jest inicjalizacja
+
+    Obiekty klas pochodnych RefCounted przechowuja licznik odniesien
+    w sobie. Dla pozostalych typow licznik jest przydzielany w stercie
+    jednorazowo, podczas objecia obiektu kontrola. W obu przypadkach
+    kopiowanie, przypisanie i zniszczenie wskaznika sa operacjami O(1)
     
     <b>Instancje konkretynych klas szablonowych w postaci danych 
     skladowych klas nie podlegaja kopiowaniu zgodnego
@@ -56,13 +64,11 @@ namespace Utilities {
     nie jest bezcelowe. Obiekty tej klasy nie reprezentuja jedynie "wskaznika 
     zarzadzajacego zasobami", wykorzystywanego w technice "pozyskiwanie zasobow 
     jest inicjalizacja", lecz rowniez wykorzystuja metode zliczania odniesien.
-    Poniewaz w klasie znajduje sie zmienna statyczna implementujaca mechanizm
-    zliczania odniesien, umozliwienie takich przypisan, powodowaloby problemy
-    zwiazane z inkrementacja (wzglednie dekrementacja) licznika odniesien,
-    ktory "rozsiany" bylby pomiedzy roznymi danymi statycznymi skonkretyzowanych
-    klas. Ta "niedogodnosc" mozna w prosty sposob ominac, poslugujac sie jawnym 
-    rzutowaniem wskaznika na typ podstawowy podczas przypisania, lub 
-    inicjalizacji.<br>
+    Licznik obiektu nie bedacego pochodna RefCounted jest skojarzony
+    z pierwszym wskaznikiem, ktory objal go kontrola - utworzenie kolejnego
+    wskaznika z "surowego" adresu takiego obiektu (rowniez po rzutowaniu
+    na typ podstawowy) prowadzi do podwojnego usuniecia. Ograniczenie nie
+    dotyczy klas pochodnych RefCounted.<br>
     Pozostawienie konstruktora bez modyfikatora explicit, moze nie jest 
     najlepszym rozwiazaniem, ale dzieki takiemu postepowaniu, skladnia przypisan,
     oraz inicjalizacji jest mniej skomplikowana (nie trzeba poslugiwac sie jawnym
@@ -78,11 +84,14 @@ namespace Utilities {
     globalnych, a nawet tablic obiektow utworzonych dynamicznie za posrednictwem
     wywolania operatora new[], powodowac beda zalamanie programu podczas
     wykonywania destruktora, ktorego cialo zawiera instrukcje operatora 
-    delete<br>
+    delete (tablice nalezy powierzac szablonowi RefArrayCntPtr)<br>
   
   @param
     T Typ instancji bedacej pod kontrola obiektu RefCountPtr< T >
 
+  @param
+    DELETER Sposob zniszczenia obiektu (DeleteObject, DeleteArray)
+
   @code
     #include "GcadRefCountPtr.h"
     #include <iostream>
@@ -108,7 +117,9 @@ namespace Utilities {
     }
   @endcode
 */
-template< typename T > class RefCountPtr {
+template< typename T,
+          typename DELETER = DeleteObject< T > >
+class RefCountPtr {
  public:
    /** 
      @brief 
@@ -126,6 +137,20 @@ template< typename T > class RefCountPtr {
    */
    RefCountPtr( const RefCountPtr& that );
 
+#ifdef GCAD_HAS_RVALUE_REFERENCES
+   /** 
+     @brief 
+       Konstruktor przenoszacy - licznik odniesien nie ulega zmianie
+   */
+   RefCountPtr( RefCountPtr&& that );
+
+   /** 
+     @brief 
+       Przypisanie przenoszace
+   */
+   RefCountPtr& operator =( RefCountPtr&& rhs );
+#endif
+
    /**
      @brief 
        Destruktor dekrementuje licznik odniesien. Gdy wyniesie 
@@ -188,6 +213,26 @@ template< typename T > class RefCountPtr {
    */
    T* release() const;
 
+   /**
+     @brief
+       Wymiana zawartosci dwoch wskaznikow, bez zmiany licznikow odniesien
+   */
+   void swap( RefCountPtr& that );
+
+ private:
+   /**
+     @brief
+       Zmniejszenie licznika odniesien i ewentualne zniszczenie obiektu
+   */
+   void dispose();
+
+   /**
+     @brief
+       Czy licznik zostal przydzielony w stercie (obiekt nie jest
+       pochodna RefCounted)
+   */
+   bool ownsCounter() const;
+
  private:
    /** 
      @brief 
@@ -197,146 +242,185 @@ template< typename T > class RefCountPtr {
 
    /** 
      @brief 
-       Zwraca kontener przechowujacy adresy obiektow (sprzezonych z
-       licznikami odniesien) dla danego typu T (konkretyzacji szablonu)
-    
-     @remark 
-       Poniewaz funkcja wykorzystuje zmienna statyczna, dlatego nie 
-       zostala zadeklarowana, jako inline. Najprawdopodobniej kompilator 
-       powinien poradzic sobie z taka konstrukcja (jesli jest zgodny 
-       z postanowieniami "standardu"), jednak ze wzgledow bezpieczenstwa 
-       jest pozbawiona modyfikatora inline
+       Licznik odniesien - pole obiektu RefCounted, badz wartosc w stercie
    */
-   static std::map< T*, int >& refMap();
+   mutable int*  count_;
 };
 
 
 //
-template< typename T > 
-std::map< T*, int >& 
-RefCountPtr< T >
-::refMap()
+template< typename T, typename DELETER > inline
+void
+swap( RefCountPtr< T, DELETER >&  lhs,
+      RefCountPtr< T, DELETER >&  rhs )
 {
-  // Wykorzystanie wzorca Singleton gwarantujacego inicjalizacje 
-  // przed pierwszym uzyciem
-  static std::map< T*, int > refPtrCounter;
-  return refPtrCounter;
+  lhs.swap( rhs );
 }
 
 //
-template< typename T > 
+template< typename T, typename DELETER > 
 bool
-operator ==( const RefCountPtr< T >&  lhs,
-             const RefCountPtr< T >&  rhs )
+operator ==( const RefCountPtr< T, DELETER >&  lhs,
+             const RefCountPtr< T, DELETER >&  rhs )
 {
   return lhs.get() == rhs.get();
 }
 
 //
-template< typename T > 
+template< typename T, typename DELETER > 
 bool
-operator !=( const RefCountPtr< T >&  lhs,
-             const RefCountPtr< T >&  rhs )
+operator !=( const RefCountPtr< T, DELETER >&  lhs,
+             const RefCountPtr< T, DELETER >&  rhs )
 {
   return !( lhs == rhs );
 }
 
 // 
-template< typename T > 
+template< typename T, typename DELETER > 
 bool
-operator <( const RefCountPtr< T >&  lhs,
-            const RefCountPtr< T >&  rhs )
+operator <( const RefCountPtr< T, DELETER >&  lhs,
+            const RefCountPtr< T, DELETER >&  rhs )
 {
   return lhs.get() < rhs.get();
 }
 
 //
-template< typename T > 
-RefCountPtr< T >
+template< typename T, typename DELETER > 
+RefCountPtr< T, DELETER >
 ::RefCountPtr( T*  pointer )
   : ptr_( pointer )
+  , count_( 0 )
 {
-  // Zakladajac, iz przekazany adres ma poprawna wartosc, nalezy
-  // zwiekszyc licznik odniesien obiektu wskazywanego przez ten wskaznik
-  // Jesli przekazany wskaznik jest rozny od wartosci zerowej, wowczas 
-  // sprawdz, czy odpowiadajaca mu wartosc nie znajduje sie juz w kontenerze.
-  // Nastepnie, w zaleznosci od powyzszego stwierdzenia, ustal odpowiadajaca
-  // "wspolnemu zasobowi" wartosc licznika odniesien
+  // Obiekt pochodny RefCounted udostepnia wlasny licznik (rowniez wtedy,
+  // gdy jest juz kontrolowany przez inne wskazniki). Dla pozostalych
+  // typow licznik zostaje utworzony w stercie - w razie niepowodzenia
+  // obiekt jest usuwany, gdyz nikt inny nie przejmie za niego
+  // odpowiedzialnosci
   if( ptr_ ) {
-    if( refMap().count( ptr_ ) == 0 )
-      refMap()[ ptr_ ] = 1;
-    else
-      ++refMap()[ ptr_ ];
+    count_ = intrusiveCounter( ptr_ );
+    if( count_ == 0 ) {
+      try {
+        count_ = new int( 0 );
+      }
+      catch( ... ) {
+        DELETER::destroy( ptr_ );
+        throw;
+      }
+    }
+    ++*count_;
   }
 }
 
 //
-template< typename T > 
-RefCountPtr< T >
+template< typename T, typename DELETER > 
+RefCountPtr< T, DELETER >
 ::RefCountPtr( const RefCountPtr&  that )
+  : ptr_( that.ptr_ )
+  , count_( that.count_ )
 {
-  new( this ) RefCountPtr( that.ptr_ );
+  if( count_ )
+    ++*count_;
 }
 
+#ifdef GCAD_HAS_RVALUE_REFERENCES
 //
-template< typename T > 
-RefCountPtr< T >
+template< typename T, typename DELETER > 
+RefCountPtr< T, DELETER >
+::RefCountPtr( RefCountPtr&&  that )
+  : ptr_( that.ptr_ )
+  , count_( that.count_ )
+{
+  that.ptr_   = 0;
+  that.count_ = 0;
+}
+
+//
+template< typename T, typename DELETER > 
+RefCountPtr< T, DELETER >& 
+RefCountPtr< T, DELETER >
+::operator =( RefCountPtr&& rhs )
+{
+  RefCountPtr( static_cast< RefCountPtr&& >( rhs ) ).swap( *this );
+  return *this;
+}
+#endif
+
+//
+template< typename T, typename DELETER > 
+RefCountPtr< T, DELETER >
 ::~RefCountPtr()
 {
-  // Odnajdz obiekt reprezentujacy sprzezona wartosc wskaznik-licznik odniesien.
-  // Jezeli obiekt nie zostanie odnaleziony, to nie wykonuj zadnej czynnosci
-  // (malo prawdopodobne), w przeciwnym wypadku zmiejsz jego licznik odwolan.
+  dispose();
+}
+
+//
+template< typename T, typename DELETER > 
+void
+RefCountPtr< T, DELETER >
+::dispose()
+{
   // W przypadku, gdy licznik odniesien wynosi zero, wowczas nalezy zwolnic
   // nieuzywany zasob (powinien on znajdowac sie w stercie)
-  typename std::map< T*, int >::iterator found = refMap().find( ptr_ );
-  
-  if( found != refMap().end() && 
-    --found->second == 0 )
-  {
-    delete ptr_;
-    ptr_ = 0;
+  if( count_ && --*count_ == 0 ) {
+    const bool OWNS_COUNTER = ownsCounter();
+
+    DELETER::destroy( ptr_ );
+    if( OWNS_COUNTER )
+      delete count_;
   }
+  ptr_   = 0;
+  count_ = 0;
 }
 
 //
-template< typename T > 
-RefCountPtr< T >& 
-RefCountPtr< T >
+template< typename T, typename DELETER > 
+bool
+RefCountPtr< T, DELETER >
+::ownsCounter() const
+{
+  return intrusiveCounter( ptr_ ) == 0;
+}
+
+//
+template< typename T, typename DELETER > 
+RefCountPtr< T, DELETER >& 
+RefCountPtr< T, DELETER >
 ::operator =( const RefCountPtr& rhs )
 {
-  // Jesli cel przypisania nie jest nowo utworzonym "wskaznikiem", oraz
-  // Jezeli obiekty "wskaznikow" odwoluja sie do tego samego obiektu, to nie
-  // wykonuj zadnych dzialan
-  if( ptr_ != 0 && *this == rhs )
-    return *this;
-  
-  // 1. Zmniejsz wartosc odwolan dla obiektu, do ktorego aktualnie odnosi sie
-  // inteligentny wskaznik. W wypadku, gdy zaden z obiektow wskaznikow nie
-  // odwoluje sie do wspolnej wartosci, wowczas zwolnij zasob.
-  // 2. Ustaw odwolanie do nowego zasobu, oraz zwieksz jego licznik odwolan
-  this->RefCountPtr< T >::~RefCountPtr();
-  new( this ) RefCountPtr( rhs );
+  // Kopia tymczasowa zwieksza licznik nowego obiektu przed zmniejszeniem
+  // licznika dotychczasowego, wiec przypisanie wskaznika do samego
+  // siebie jest bezpieczne
+  RefCountPtr( rhs ).swap( *this );
   return *this;
 }
 
 //
-template< typename T > 
-RefCountPtr< T >& 
-RefCountPtr< T >
+template< typename T, typename DELETER > 
+RefCountPtr< T, DELETER >& 
+RefCountPtr< T, DELETER >
 ::operator =( T* rhs )
 {
   if( ptr_ != 0 && ptr_ == rhs )
     return *this;
 
-  this->RefCountPtr< T >::~RefCountPtr();
-  new( this ) RefCountPtr( rhs );
+  RefCountPtr( rhs ).swap( *this );
   return *this;
 }
 
 //
-template< typename T > 
+template< typename T, typename DELETER > 
+void
+RefCountPtr< T, DELETER >
+::swap( RefCountPtr& that )
+{
+  std::swap( ptr_, that.ptr_ );
+  std::swap( count_, that.count_ );
+}
+
+//
+template< typename T, typename DELETER > 
 T& 
-RefCountPtr< T >
+RefCountPtr< T, DELETER >
 ::operator *() const
 {
   assertion( ptr_ != 0, 
@@ -345,9 +429,9 @@ RefCountPtr< T >
 }
 
 //
-template< typename T > 
+template< typename T, typename DELETER > 
 T*
-RefCountPtr< T > 
+RefCountPtr< T, DELETER > 
 ::operator ->() const
 {
   assertion( ptr_ != 0, 
@@ -356,25 +440,36 @@ RefCountPtr< T >
 }
 
 //
-template< typename T > 
+template< typename T, typename DELETER > 
 T*
-RefCountPtr< T > 
+RefCountPtr< T, DELETER > 
 ::get() const 
 {
   return ptr_;
 }
 
 //
-template< typename T > 
+template< typename T, typename DELETER > 
 T* 
-RefCountPtr< T > 
+RefCountPtr< T, DELETER > 
 ::release() const
 {
   assertion( ptr_ != 0, 
     "Proba zwolnienia pustego wskaznika" );
 
+  // Pozostale wskazniki (o ile istnieja) nie usuna juz obiektu, gdyz
+  // licznik nie zostaje zmniejszony. Jedynie wtedy, gdy byl to ostatni
+  // wskaznik, licznik jest zwalniany (badz zerowany w obiekcie RefCounted)
+  if( *count_ == 1 ) {
+    if( ownsCounter() )
+      delete count_;
+    else
+      *count_ = 0;
+  }
+
   T* ptrToRelease = ptr_;
-  ptr_ = 0;
+  ptr_   = 0;
+  count_ = 0;
   return ptrToRelease;
 }
 
@@ -0,0 +1,91 @@
+/***************************************************************************
+ *   Copyright (C) 2005 by Eryk Klebanski                                  *
+ *   rixment@gmail.com                                                     *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef _GCAD_REFCOUNTED_H_
+#define _GCAD_REFCOUNTED_H_
+
+namespace Gcad {
+namespace Utilities {
+
+/**
+  @brief
+    Klasa bazowa obiektow przechowujacych wlasny licznik odniesien
+
+    Obiekty klas pochodnych, kontrolowane przez RefCountPtr, nie wymagaja
+    dodatkowego przydzialu pamieci dla licznika, a kopiowanie wskaznikow
+    sprowadza sie do inkrementacji pola obiektu. Ponadto inteligentny
+    wskaznik moze zostac bezpiecznie utworzony z "surowego" adresu
+    obiektu, ktory jest juz kontrolowany (np. z wartosci this)
+
+  @remark
+    Kopiowanie obiektu nie kopiuje jego licznika - kopia nie jest
+    wskazywana przez zaden inteligentny wskaznik
+
+  @code
+    class Node : public RefCounted {
+      // ...
+    };
+
+    RefCountPtr< Node >  node( new Node );
+    RefCountPtr< Node >  same( node.get() ); // wspolny licznik
+  @endcode
+*/
+class RefCounted {
+ public:
+   /**
+     @brief
+       Liczba inteligentnych wskaznikow odwolujacych sie do obiektu
+   */
+   int referencesCount() const { return refCount_; }
+
+ protected:
+   RefCounted() : refCount_( 0 ) {}
+   RefCounted( const RefCounted& ) : refCount_( 0 ) {}
+   RefCounted& operator =( const RefCounted& ) { return *this; }
+   ~RefCounted() {}
+
+ private:
+   friend int* intrusiveCounter( const RefCounted* object );
+
+   mutable int  refCount_;
+};
+
+/**
+  @brief
+    Adres licznika odniesien obiektu pochodnego klasy RefCounted
+*/
+inline int* intrusiveCounter( const RefCounted* object )
+{
+  return &object->refCount_;
+}
+
+/**
+  @brief
+    Wariant dla pozostalych typow - obiekt nie posiada wlasnego licznika
+*/
+inline int* intrusiveCounter( const volatile void* )
+{
+  return 0;
+}
+
+} // namespace Utilities
+} // namespace Gcad
+
+#endif
@@ -0,0 +1,80 @@
+/***************************************************************************
+ *   Copyright (C) 2005 by Eryk Klebanski                                  *
+ *   rixment@gmail.com                                                     *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+
+#ifndef _GCAD_RESOURCEARCHIVE_H_
+#define _GCAD_RESOURCEARCHIVE_H_
+
+#include "GcadBase.h"
+#include "GcadByteSpan.h"
+#include <cstddef>
+#include <string>
+
+namespace Gcad {
+namespace Platform {
+
+/**
+  @brief
+    Archiwum plikow odwzorowane w pamieci (AssetPack, QuakePak), z ktorego
+    DataFileResourceManager moze wczytywac zasoby (setResourceArchive),
+    a ArchiveElementsEnumerator wyliczac zawartosc katalogow
+
+    Nazwy wpisow sa sciezkami oddzielanymi znakiem '\\', identycznymi
+    z tworzonymi przez DataFileResourceManager (katalog + "\\" + plik).
+    Indeksy wpisow odpowiadaja porzadkowi leksykograficznemu nazw, wiec
+    wpisy o wspolnym przedrostku zajmuja ciagly zakres indeksow
+
+  @remark
+    Widoki zwracane przez archiwum wskazuja bezposrednio odwzorowanie
+    pliku - sa wazne do czasu jego zamkniecia. Metody stale moga byc
+    wywolywane jednoczesnie przez wiele watkow
+*/
+class GCAD_EXPORT ResourceArchive {
+ public:
+   virtual ~ResourceArchive();
+
+   virtual size_t entriesCount() const = 0;
+
+   virtual std::string entryName(size_t index) const = 0;
+
+   virtual Utilities::ByteSpan entryBytes(size_t index) const = 0;
+
+   /**
+     @brief
+       Indeks pierwszego wpisu, ktorego nazwa nie jest mniejsza
+       od name (entriesCount(), gdy takiego nie ma)
+   */
+   virtual size_t lowerBound(const std::string& name) const = 0;
+
+   /**
+     @brief
+       Odnalezienie wpisu o nazwie name
+
+     @return
+       Wartosc false, gdy archiwum nie zawiera wpisu
+   */
+   virtual bool find(const std::string&    name, 
+                     Utilities::ByteSpan*  bytes) const = 0;
+};
+
+} // namespace Platform
+} // namespace Gcad
+
+#endif
@@ -0,0 +1,571 @@
+/***************************************************************************
+ *   Copyright (C) 2005 by Eryk Klebanski                                  *
+ *   rixment@gmail.com                                                     *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+
+#ifndef _GCAD_RESOURCELOADER_H_
+#define _GCAD_RESOURCELOADER_H_
+
+#include "GcadAtomic.h"
+#include "GcadByteSpan.h"
+#include "GcadMappedFile.h"
+#include "GcadMemoryInputStream.h"
+#include "GcadProcessedCache.h"
+#include "GcadThread.h"
+#include "GcadTimeInformation.h"
+#include <cstddef>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace Gcad {
+namespace Platform {
+
+/**
+  @brief
+    Pula watkow wczytujacych zasoby w tle
+
+    Zadania (klucz, sciezka pliku) trafiaja do kolejek priorytetow - watki
+    zawsze pobieraja najstarsze zadanie o najwyzszym priorytecie. Watek
+    otwiera plik i wywoluje konstruktor RESOURCE(std::ifstream&), po czym
+    umieszcza wynik na liscie zakonczonych zadan. Wyniki odbiera watek
+    wlasciciela (takeCompleted), wiec wczytane obiekty sa udostepniane
+    wylacznie w jego kontekscie
+
+    Zadanie moze wskazywac funkcje tworzaca zasob z widoku bajtow
+    (SpanFactory) - wowczas plik jest odwzorowywany w pamieci
+    (MappedFile) i parsowany bez posrednich buforow. Zadanie moze tez
+    wskazywac dane znajdujace sie juz w pamieci (np. wpis archiwum
+    ResourceArchive) - watek jedynie tworzy z nich zasob. Sposob
+    tworzenia zasobu z bajtow opisuje struktura Decoding (widok, badz
+    strumien, oraz opcjonalna pamiec podreczna przetworzonych zasobow
+    ProcessedCache)
+
+  @param
+    RESOURCE Typ wczytywanego zasobu (konstruktor jednoargumentowy,
+    pobierajacy strumien pliku)
+
+  @param
+    KEY Typ wartosci identyfikujacej zadanie (np. uchwyt TST)
+
+  @remark
+    Konstruktor RESOURCE jest wywolywany jednoczesnie w wielu watkach,
+    nie moze wiec korzystac z niechronionych danych globalnych. Sprawdzenie
+    obecnosci wynikow (hasCompleted) nie zajmuje muteksu
+*/
+template<typename RESOURCE,
+         typename KEY>
+class ResourceLoader {
+ public:
+   /**
+     @brief
+       Wynik zadania. Wartosc resource_ rowna zero oznacza niepowodzenie
+       (brak pliku, wyjatek konstruktora). Prawo wlasnosci obiektu
+       przechodzi na odbiorce wyniku. Czasy faz odczytu (otwarcie, 
+       badz odwzorowanie pliku) i przetwarzania sa mierzone jedynie 
+       wowczas, gdy pula otrzymala zrodlo czasu
+   */
+   struct Result {
+     KEY          key_;
+     RESOURCE*    resource_;
+     std::string  path_;
+     size_t       readMicroseconds_;
+     size_t       parseMicroseconds_;
+   };
+
+   typedef std::vector<Result>  Results;
+
+   /**
+     @brief
+       Funkcja tworzaca zasob z zawartosci pliku odwzorowanego w pamieci
+   */
+   typedef RESOURCE* (*SpanFactory)(const Utilities::ByteSpan&);
+
+   /**
+     @brief
+       Funkcja zapisujaca przetworzony zasob do strumienia binarnego
+   */
+   typedef void (*ProcessedWriter)(const RESOURCE&, std::ostream&);
+
+   /**
+     @brief
+       Sposob tworzenia zasobu z zawartosci pliku. Zerowe wartosci
+       oznaczaja: spanFactory_ - konstruktor RESOURCE(std::istream&),
+       cache_ - brak pamieci podrecznej przetworzonych zasobow. Funkcje
+       fromProcessed_ i toProcessed_ sa wymagane, gdy cache_ != 0
+   */
+   struct Decoding {
+     SpanFactory            spanFactory_;
+     const ProcessedCache*  cache_;
+     SpanFactory            fromProcessed_;
+     ProcessedWriter        toProcessed_;
+
+     Decoding()
+       : spanFactory_(0)
+       , cache_(0)
+       , fromProcessed_(0)
+       , toProcessed_(0)
+     {}
+
+     /**
+       @brief
+         Czy zawartosc pliku jest potrzebna w postaci widoku (odwzorowanie
+         pliku zamiast strumienia)
+     */
+     bool needsBytes() const { return spanFactory_ != 0 || cache_ != 0; }
+   };
+
+   /**
+     @brief
+       Utworzenie zasobu z zawartosci pliku bytes. Gdy ustalono pamiec
+       podreczna, zasob jest tworzony z wpisu o kluczu rownym skrotowi
+       zawartosci, a w razie jego braku - z zawartosci pliku, po czym
+       wpis zostaje zapisany
+   */
+   static RESOURCE* create(const Utilities::ByteSpan&  bytes,
+                           const Decoding&             decoding);
+
+   /**
+     @brief
+       Utworzenie threadsCount watkow obslugujacych prioritiesCount
+       kolejek zadan. Zrodlo czasu timer (opcjonalne) sluzy pomiarowi
+       czasu wykonania zadan i musi istniec do czasu zniszczenia puli -
+       jest odczytywane jednoczesnie w wielu watkach
+
+     @exception
+       ThreadException Niepowodzenie utworzenia watku
+   */
+   ResourceLoader(unsigned int             threadsCount,
+                  int                      prioritiesCount,
+                  const TimeInformation*   timer = 0);
+
+   /**
+     @brief
+       Porzucenie oczekujacych zadan, zakonczenie watkow (po wykonaniu
+       zadan aktualnie realizowanych) i zwolnienie nieodebranych wynikow
+   */
+   ~ResourceLoader();
+
+   /**
+     @brief
+       Dodanie zadania wczytania pliku path do kolejki priorytetu
+       priority (wyzsza wartosc - wczesniejsza realizacja). Gdy
+       decoding.needsBytes(), plik jest odczytywany przez odwzorowanie
+   */
+   void enqueue(const KEY&          key,
+                const std::string&  path,
+                int                 priority,
+                const Decoding&     decoding = Decoding());
+
+   /**
+     @brief
+       Dodanie zadania utworzenia zasobu z danych bytes (path sluzy
+       jedynie identyfikacji wyniku). Dane musza istniec do czasu
+       odebrania wyniku zadania
+   */
+   void enqueue(const KEY&                   key,
+                const std::string&           path,
+                const Utilities::ByteSpan&   bytes,
+                int                          priority,
+                const Decoding&              decoding = Decoding());
+
+   /**
+     @brief
+       Informacja o obecnosci nieodebranych wynikow. Metoda nie zajmuje
+       muteksu - moze byc wywolywana w kazdej klatce
+   */
+   bool hasCompleted() const;
+
+   /**
+     @brief
+       Przeniesienie zakonczonych zadan na koniec wektora results
+   */
+   void takeCompleted(Results* results);
+
+   /**
+     @brief
+       Oczekiwanie na wykonanie wszystkich zadan kolejek
+   */
+   void waitUntilIdle();
+
+   /**
+     @brief
+       Liczba zadan oczekujacych, oraz realizowanych
+   */
+   size_t pendingCount() const;
+
+   /**
+     @brief
+       Liczba watkow puli
+   */
+   size_t threadsCount() const { return threads_.size(); }
+
+ private:
+   struct Request {
+     KEY                  key_;
+     std::string          path_;
+     Decoding             decoding_;
+     bool                 inMemory_;   /**< Dane w bytes_ (bez odczytu) */
+     Utilities::ByteSpan  bytes_;
+   };
+
+   typedef std::deque<Request>  RequestsQueue;
+
+   static void workerRoutine(void* loader);
+
+   void work();
+   void stop();
+
+   /**
+     @brief
+       Pobranie zadania o najwyzszym priorytecie (muteks zajety)
+   */
+   bool popRequest(Request* request);
+
+ private:
+   mutable Mutex               mutex_;
+   ConditionVariable           wakeUp_;     /**< Nowe zadanie, badz koniec */
+   ConditionVariable           idle_;       /**< Oproznienie kolejek */
+   std::vector<RequestsQueue>  queues_;     /**< Kolejki wedlug priorytetow */
+   size_t                      queuedCount_;
+   size_t                      activeCount_; /**< Zadania w realizacji */
+   Results                     completed_;
+   mutable volatile long       completedCount_;
+   bool                        stopping_;
+   std::vector<Thread*>        threads_;
+   const TimeInformation*      timer_;
+
+ private:
+   // nie zaimplementowane
+   ResourceLoader(const ResourceLoader&);
+   ResourceLoader& operator =(const ResourceLoader&);
+};
+
+//
+template<typename RESOURCE, typename KEY>
+ResourceLoader<RESOURCE, KEY>
+::ResourceLoader(unsigned int             threadsCount,
+                 int                      prioritiesCount,
+                 const TimeInformation*   timer)
+  : queues_(prioritiesCount)
+  , queuedCount_(0)
+  , activeCount_(0)
+  , completedCount_(0)
+  , stopping_(false)
+  , timer_(timer)
+{
+  threads_.reserve(threadsCount);
+
+  try {
+    for(unsigned int thread = 0; thread < threadsCount; ++thread)
+      threads_.push_back( new Thread(&workerRoutine, this) );
+  }
+  catch(...) {
+    stop();
+    throw;
+  }
+}
+
+//
+template<typename RESOURCE, typename KEY>
+ResourceLoader<RESOURCE, KEY>
+::~ResourceLoader()
+{
+  stop();
+
+  for(typename Results::iterator resultItor = completed_.begin();
+    resultItor != completed_.end();
+    ++resultItor)
+  {
+    delete resultItor->resource_;
+  }
+}
+
+//
+template<typename RESOURCE, typename KEY>
+void
+ResourceLoader<RESOURCE, KEY>
+::stop()
+{
+  {
+    MutexLock lock(mutex_);
+    stopping_ = true;
+    for(size_t priority = 0; priority < queues_.size(); ++priority)
+      RequestsQueue().swap(queues_[priority]);
+    queuedCount_ = 0;
+    wakeUp_.notifyAll();
+    idle_.notifyAll();
+  }
+
+  for(size_t thread = 0; thread < threads_.size(); ++thread)
+    delete threads_[thread];  // destruktor dolacza watek
+  threads_.clear();
+}
+
+//
+template<typename RESOURCE, typename KEY>
+void
+ResourceLoader<RESOURCE, KEY>
+::enqueue(const KEY&          key,
+          const std::string&  path,
+          int                 priority,
+          const Decoding&     decoding)
+{
+  Request request;
+  request.key_      = key;
+  request.path_     = path;
+  request.decoding_ = decoding;
+  request.inMemory_ = false;
+
+  MutexLock lock(mutex_);
+  queues_[priority].push_back(request);
+  ++queuedCount_;
+  wakeUp_.notifyOne();
+}
+
+//
+template<typename RESOURCE, typename KEY>
+void
+ResourceLoader<RESOURCE, KEY>
+::enqueue(const KEY&                   key,
+          const std::string&           path,
+          const Utilities::ByteSpan&   bytes,
+          int                          priority,
+          const Decoding&              decoding)
+{
+  Request request;
+  request.key_      = key;
+  request.path_     = path;
+  request.decoding_ = decoding;
+  request.inMemory_ = true;
+  request.bytes_    = bytes;
+
+  MutexLock lock(mutex_);
+  queues_[priority].push_back(request);
+  ++queuedCount_;
+  wakeUp_.notifyOne();
+}
+
+//
+template<typename RESOURCE, typename KEY>
+RESOURCE*
+ResourceLoader<RESOURCE, KEY>
+::create(const Utilities::ByteSpan&  bytes,
+         const Decoding&             decoding)
+{
+  // Uszkodzony wpis pamieci podrecznej (np. zapisany przez inna wersje
+  // programu) nie moze uniemozliwic wczytania zasobu - jest pomijany,
+  // a zasob przetwarzany ponownie z pliku zrodlowego
+
+  ContentHash hash = 0;
+  if( decoding.cache_ != 0 )
+  {
+    hash = ProcessedCache::hashContent(bytes);
+
+    MappedFile entry;
+    Utilities::ByteSpan processed;
+    if( decoding.cache_->find(hash, &entry, &processed) ) {
+      try {
+        return decoding.fromProcessed_(processed);
+      }
+      catch(...) {
+      }
+    }
+  }
+
+  std::auto_ptr<RESOURCE> resource;
+  if( decoding.spanFactory_ != 0 )
+    resource = std::auto_ptr<RESOURCE>( decoding.spanFactory_(bytes) );
+  else {
+    Utilities::MemoryInputStream input(
+      reinterpret_cast<const char*>( bytes.data() ), bytes.size() );
+    resource = std::auto_ptr<RESOURCE>( new RESOURCE(input) );
+  }
+
+  if( decoding.cache_ != 0 )
+  {
+    // Blad zapisu wpisu nie wplywa na wynik - zasob zostanie
+    // przetworzony ponownie przy kolejnym wczytaniu
+    std::ostringstream output(std::ios_base::out | std::ios_base::binary);
+    decoding.toProcessed_(*resource, output);
+    if( output )
+      decoding.cache_->store(hash, output.str());
+  }
+
+  return resource.release();
+}
+
+//
+template<typename RESOURCE, typename KEY>
+bool
+ResourceLoader<RESOURCE, KEY>
+::hasCompleted() const
+{
+  return Utilities::atomicLoad(&completedCount_) != 0;
+}
+
+//
+template<typename RESOURCE, typename KEY>
+void
+ResourceLoader<RESOURCE, KEY>
+::takeCompleted(Results* results)
+{
+  MutexLock lock(mutex_);
+  results->insert(results->end(), completed_.begin(), completed_.end());
+  Utilities::atomicExchangeAdd(&completedCount_,
+    -static_cast<long>(completed_.size()));
+  completed_.clear();
+}
+
+//
+template<typename RESOURCE, typename KEY>
+void
+ResourceLoader<RESOURCE, KEY>
+::waitUntilIdle()
+{
+  MutexLock lock(mutex_);
+  while( !stopping_ && queuedCount_ + activeCount_ != 0 )
+    idle_.wait(mutex_);
+}
+
+//
+template<typename RESOURCE, typename KEY>
+size_t
+ResourceLoader<RESOURCE, KEY>
+::pendingCount() const
+{
+  MutexLock lock(mutex_);
+  return queuedCount_ + activeCount_;
+}
+
+//
+template<typename RESOURCE, typename KEY>
+void
+ResourceLoader<RESOURCE, KEY>
+::workerRoutine(void* loader)
+{
+  static_cast<ResourceLoader*>(loader)->work();
+}
+
+//
+template<typename RESOURCE, typename KEY>
+bool
+ResourceLoader<RESOURCE, KEY>
+::popRequest(Request* request)
+{
+  for(size_t priority = queues_.size(); priority-- > 0; )
+  {
+    RequestsQueue& queue = queues_[priority];
+    if( !queue.empty() ) {
+      *request = queue.front();
+      queue.pop_front();
+      --queuedCount_;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+//
+template<typename RESOURCE, typename KEY>
+void
+ResourceLoader<RESOURCE, KEY>
+::work()
+{
+  // Odczyt pliku i konstrukcja zasobu odbywaja sie bez zajetego
+  // muteksu - jest on potrzebny jedynie podczas pobrania zadania
+  // i zapisu wyniku. Wyjatki konstruktora zasobu nie moga opuscic
+  // funkcji watku, dlatego sa zamieniane na wynik zerowy
+
+  Request request;
+
+  for(;;)
+  {
+    {
+      MutexLock lock(mutex_);
+      while( !stopping_ && !popRequest(&request) )
+        wakeUp_.wait(mutex_);
+
+      if( stopping_ )
+        return;
+
+      ++activeCount_;
+    }
+
+    Result result;
+    result.key_               = request.key_;
+    result.resource_          = 0;
+    result.path_              = request.path_;
+    result.readMicroseconds_  = 0;
+    result.parseMicroseconds_ = 0;
+
+    const size_t START_TIME = timer_ != 0 ? timer_->getSystemTime() : 0;
+    size_t readTime = START_TIME;
+
+    try {
+      if( request.inMemory_ )
+        result.resource_ = create( request.bytes_, request.decoding_ );
+      else if( request.decoding_.needsBytes() ) {
+        MappedFile file;
+        if( file.map(request.path_) ) {
+          readTime = timer_ != 0 ? timer_->getSystemTime() : 0;
+          result.resource_ = create( file.bytes(), request.decoding_ );
+        }
+      }
+      else {
+        std::ifstream input(request.path_.c_str(), std::ios_base::binary);
+        if( input ) {
+          readTime = timer_ != 0 ? timer_->getSystemTime() : 0;
+          result.resource_ = new RESOURCE(input);
+        }
+      }
+    }
+    catch(...) {
+      result.resource_ = 0;
+    }
+
+    if( timer_ != 0 ) {
+      result.readMicroseconds_  = 
+        timer_->getElapsedMicroseconds( START_TIME, readTime );
+      result.parseMicroseconds_ = 
+        timer_->getElapsedMicroseconds( readTime, timer_->getSystemTime() );
+    }
+
+    MutexLock lock(mutex_);
+    try {
+      completed_.push_back(result);
+      Utilities::atomicIncrement(&completedCount_);
+    }
+    catch(...) {
+      delete result.resource_;
+    }
+
+    if( --activeCount_ == 0 && queuedCount_ == 0 )
+      idle_.notifyAll();
+  }
+}
+
+} // namespace Platform
+} // namespace Gcad
+
+#endif
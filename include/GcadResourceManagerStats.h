@@ -0,0 +1,219 @@
+/***************************************************************************
+ *   Copyright (C) 2005 by Eryk Klebanski                                  *
+ *   rixment@gmail.com                                                     *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+
+#ifndef _GCAD_RESOURCEMANAGERSTATS_H_
+#define _GCAD_RESOURCEMANAGERSTATS_H_
+
+#include "GcadBase.h"
+#include "GcadAtomic.h"
+#include "GcadDataFileResourceManagerBase.h"
+#include <cstddef>
+#include <ostream>
+#include <string>
+
+namespace Gcad {
+namespace Platform {
+
+/**
+  @brief
+    Migawka statystyk menadzera zasobow (DataFileResourceManager::
+    getStatistics)
+
+    Trafienie (hits_) jest odwolaniem do zasobu znajdujacego sie w pamieci,
+    a chybienie (misses_) - odwolaniem wymagajacym jego wczytania
+    (synchronicznego, badz zleconego w tle metoda Handle::tryGet).
+    Wartosci sa zliczane osobno dla kazdego priorytetu zasobu. Wczytanie
+    zasobu sklada sie z fazy odczytu (otwarcie, badz odwzorowanie pliku)
+    i fazy przetwarzania (utworzenie zasobu) - czas kazdej z nich trafia
+    do osobnego histogramu. Dane pliku strumienia, oraz strony pliku
+    odwzorowanego sa wczytywane w trakcie przetwarzania, wiec ich odczyt
+    jest doliczany do drugiej fazy. Odczyt wsadowy (BatchFileReader) nie
+    mierzy fazy odczytu
+
+  @remark
+    Koszyk k histogramu zlicza wczytania trwajace < 2^k, 2^(k+1) )
+    mikrosekund. Koszyk zerowy obejmuje rowniez czasy zerowe, a ostatni
+    - wszystkie dluzsze. Najkosztowniejsze zasoby (expensive_) sa
+    uszeregowane malejaco wedlug najdluzszego zaobserwowanego czasu
+    wczytania
+*/
+struct GCAD_EXPORT ResourceManagerStats {
+   enum { 
+     PRIORITIES_COUNT  = DataFileResourceManagerBase::HIGH_PRIORITY + 1,
+     HISTOGRAM_BUCKETS = 24,
+     EXPENSIVE_COUNT   = 8
+   };
+
+   /**
+     @brief
+       Zasob o dlugim czasie wczytania
+   */
+   struct ExpensiveResource {
+     std::string  path_;              /**< Sciezka pliku zasobu */
+     size_t       loadMicroseconds_;  /**< Najdluzszy czas wczytania */
+     size_t       byteSize_;          /**< Wielkosc zasobu (ostatnie wczytanie) */
+   };
+
+   size_t  hits_[ PRIORITIES_COUNT ];   /**< Odwolania do wczytanych zasobow */
+   size_t  misses_[ PRIORITIES_COUNT ]; /**< Odwolania wymagajace wczytania */
+   size_t  loads_;             /**< Udane wczytania (rowniez w tle) */
+   size_t  failedLoads_;       /**< Wczytania zakonczone bledem */
+   size_t  bytesLoaded_;       /**< Suma wielkosci wczytanych zasobow */
+   size_t  evictions_;         /**< Zasoby zwolnione z braku pamieci */
+   size_t  bytesEvicted_;      /**< Suma wielkosci zwolnionych zasobow */
+   size_t  usedMemory_;        /**< Pamiec wczytanych zasobow */
+   size_t  maxMemory_;         /**< Granica pamieci (setMemoryMaximum) */
+   size_t  resourcesCount_;    /**< Liczba posrednikow */
+
+   size_t  readHistogram_[ HISTOGRAM_BUCKETS ];  /**< Czas fazy odczytu */
+   size_t  parseHistogram_[ HISTOGRAM_BUCKETS ]; /**< Czas fazy przetwarzania */
+
+   size_t             expensiveCount_;
+   ExpensiveResource  expensive_[ EXPENSIVE_COUNT ];
+};
+
+/**
+  @brief
+    Liczniki menadzera zasobow
+
+  @remark
+    Liczniki sa aktualizowane wylacznie w watku wlasciciela menadzera -
+    czasy wczytywania w tle sa przekazywane wraz z wynikami puli watkow.
+    Rejestracja trafien i chybien jest jedynie inkrementacja elementu
+    tablicy, wiec moze towarzyszyc kazdej dereferencji uchwytu. Wyjatkiem
+    sa trafienia dereferencji bez muteksu w trybie wspolbieznym
+    (recordSharedHit) - zliczane atomowo, z dowolnego watku. Kazdy watek
+    zlicza je w jednym z segmentow (SHARED_HIT_SHARDS) polozonych na
+    osobnych liniach pamieci podrecznej, wiec watki odczytujace zasoby
+    nie rywalizuja o wspolny licznik. Migawka (fill) sumuje segmenty
+*/
+class GCAD_EXPORT ResourceManagerCounters {
+ public:
+   typedef DataFileResourceManagerBase::ResourcePriority  ResourcePriority;
+
+   ResourceManagerCounters() { reset(); }
+
+   /**
+     @brief
+       Wyzerowanie wszystkich licznikow
+   */
+   void reset();
+
+   void recordHit( ResourcePriority priority ) { ++hits_[ priority ]; }
+   void recordMiss( ResourcePriority priority ) { ++misses_[ priority ]; }
+
+   /**
+     @brief
+       Rejestracja trafienia bez wylacznego dostepu do licznikow
+       (dereferencja zasobu udostepnionego w trybie wspolbieznym).
+       Operacja atomowa dotyczy segmentu biezacego watku - wspolny
+       segment moze przypasc jedynie watkom o numerach rownych modulo
+       SHARED_HIT_SHARDS
+   */
+   void recordSharedHit( ResourcePriority priority );
+
+   /**
+     @brief
+       Rejestracja czasu fazy odczytu pliku
+   */
+   void recordRead( size_t microseconds );
+
+   /**
+     @brief
+       Rejestracja czasu fazy przetwarzania (utworzenia zasobu)
+   */
+   void recordParse( size_t microseconds );
+
+   /**
+     @brief
+       Rejestracja udanego wczytania zasobu path o wielkosci byteSize,
+       trwajacego lacznie loadMicroseconds mikrosekund
+   */
+   void recordLoad( const std::string&  path,
+                    size_t              byteSize,
+                    size_t              loadMicroseconds );
+
+   void recordFailedLoad() { ++failedLoads_; }
+
+   /**
+     @brief
+       Rejestracja zwolnienia zasobu z braku pamieci
+   */
+   void recordEviction( size_t byteSize );
+
+   /**
+     @brief
+       Przepisanie wartosci licznikow do migawki (bez pol opisujacych
+       stan menadzera - usedMemory_, maxMemory_, resourcesCount_)
+   */
+   void fill( ResourceManagerStats* stats ) const;
+
+ private:
+   enum {
+     SHARED_HIT_SHARDS = 16,  /**< Potega dwojki */
+     CACHE_LINE_SIZE   = 64
+   };
+
+   /**
+     @brief
+       Segment trafien zliczanych atomowo (recordSharedHit). Dopelnienie
+       o dlugosci linii pamieci podrecznej oddziela liczniki sasiednich
+       segmentow niezaleznie od wyrownania obiektu licznikow
+   */
+   struct SharedHitShard {
+     volatile long  hits_[ ResourceManagerStats::PRIORITIES_COUNT ];
+     char           padding_[ CACHE_LINE_SIZE ];
+   };
+
+   static void recordTime( size_t*  histogram, 
+                           size_t   microseconds );
+
+ private:
+   size_t  hits_[ ResourceManagerStats::PRIORITIES_COUNT ];
+   size_t  misses_[ ResourceManagerStats::PRIORITIES_COUNT ];
+
+   mutable SharedHitShard  sharedHits_[ SHARED_HIT_SHARDS ];
+
+   size_t  loads_;
+   size_t  failedLoads_;
+   size_t  bytesLoaded_;
+   size_t  evictions_;
+   size_t  bytesEvicted_;
+   size_t  readHistogram_[ ResourceManagerStats::HISTOGRAM_BUCKETS ];
+   size_t  parseHistogram_[ ResourceManagerStats::HISTOGRAM_BUCKETS ];
+
+   size_t  expensiveCount_;
+   ResourceManagerStats::ExpensiveResource  
+     expensive_[ ResourceManagerStats::EXPENSIVE_COUNT ]; /**< Bez porzadku */
+};
+
+/**
+  @brief
+    Zapis migawki w postaci tekstowej (wiersze "nazwa wartosc"),
+    przeznaczonej do okresowego eksportu
+*/
+GCAD_EXPORT std::ostream& operator <<( std::ostream&                out,
+                                       const ResourceManagerStats&  stats );
+
+} // namespace Platform
+} // namespace Gcad
+
+#endif
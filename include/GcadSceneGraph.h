@@ -28,6 +28,7 @@
 #include "GcadVector3.h"
 #include "GcadRefCountPtr.h"
 #include "GcadAnagramSet.h"
+#include "GcadFrameArena.h"
 #include <string>
 #include <vector>
 
@@ -74,7 +75,7 @@ class GCAD_EXPORT SceneGraph {
    };
 
    //! @b Fundamental scene element
-   class GCAD_EXPORT Node {  
+   class GCAD_EXPORT Node : public Gcad::Utilities::RefCounted {
     public:
       typedef Gcad::Math::Quaternion<float>    Quaternion;
       typedef Gcad::Math::Matrix<4, 4, float>  Matrix4x4;
@@ -112,14 +113,14 @@ class GCAD_EXPORT SceneGraph {
       void setRenderAction(NodeRender* act);
       void setUpdateAction(NodeUpdate* act);
 
-      void setMesh(MeshId meshId);
+      void setMesh(const MeshId& meshId);
     
     public:
       Node&      getParent() const;
 
-      Id         getId() const;
-      Id         getParentId() const;
-      MeshId     getMeshId() const;
+      const Id&      getId() const;
+      const Id&      getParentId() const;
+      const MeshId&  getMeshId() const;
 
       Vector3    getTranslation() const;
       Quaternion getOrientation() const;
@@ -167,9 +168,17 @@ class GCAD_EXPORT SceneGraph {
       //! @b Hided functionality used inside implementation
       const Node* getNode() const;
 
+      //! @b View matrix computed with patch memory taken from allocator
+      template<typename NODES_PATCH_ALLOCATOR>
+      Matrix4x4 compoundMatrix(const NODES_PATCH_ALLOCATOR& allocator) const;
+
     private:
       Matrix4x4    relativeView_; /**< @b Relative matrix view */
       const Node*  nodeView_;     /**< @b Viewer is attached to specyfic node */
+
+      /** @b Scratch memory of the owning scene, valid for one frame
+          (0 - viewer without a scene, heap is used) */
+      Gcad::Utilities::FrameArena*  frameArena_;
    };
 
  public:
@@ -190,18 +199,27 @@ class GCAD_EXPORT SceneGraph {
    void removeNode(const std::string& nodeId);
 
    //! @b Update all entitiy nodes based on elapsed time value
+   //! @remark Frame arena is reset at the beginning of each update
    void update(float elapsedTime);
 
    //! @b Scene rendering function
+   //! @remark Frame arena is reset, when no update preceded rendering
    void render();
 
    //! @b Dereference an viewer
    Viewer& getViewer();
+
+   //! @b Scratch memory for data living no longer than one frame
+   Gcad::Utilities::FrameArena& getFrameArena();
    
  private:
+   Gcad::Utilities::FrameArena  frameArena_;
+
    NodeCountPtr   root_;
    Viewer         viewer_;
    NodesAnagrams  anagrams_;   
+
+   bool  frameStarted_;  /**< @b Update reset the arena of current frame */
 };
 
 bool
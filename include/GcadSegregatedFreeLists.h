@@ -0,0 +1,518 @@
+/***************************************************************************
+ *   Copyright (C) 2005 by Eryk Klebanski                                  *
+ *   rixment@gmail.com                                                     *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef _GCAD_SEGREGATEDFREELISTS_H_
+#define _GCAD_SEGREGATEDFREELISTS_H_
+
+#include "GcadAssertion.h"
+
+namespace Gcad {
+namespace Utilities {
+
+/**
+  @brief
+    Struktura organizujaca wolne obszary ciaglej tablicy segmentow
+    w postaci list rozdzielonych wedlug klas rozmiaru (ang. segregated
+    free lists)
+
+    Kazdy obszar (zarowno wolny, jak i zajety) posiada naglowek na swoim
+    pierwszym segmencie, oraz stopke na ostatnim. Obie wartosci opisuja
+    dlugosc obszaru, oraz jego stan. Dzieki temu podczas zwalniania
+    mozliwe jest natychmiastowe sprawdzenie sasiadow i scalenie wolnych
+    obszarow (ang. coalescing) bez przegladania calej tablicy.<br>
+    Obszary o dlugosci mniejszej od SIZE_CLASSES segmentow sa
+    przechowywane na listach dokladnego rozmiaru, wiec ich pobranie,
+    oraz zwrot wykonywane jest w czasie stalym. Dluzsze obszary trafiaja
+    na ostatnia liste, przeszukiwana metoda najlepszego dopasowania
+    (ang. best fit)
+
+  @remark
+    Klasa nie jest wlascicielem tablicy wezlow, ani obszaru pamieci -
+    operuje wylacznie na indeksach segmentow. Z tego powodu moze zostac
+    wykorzystana zarowno przez statyczne pule (SegregatedMemoryAlloc),
+    jak i przez pule skladajace sie z wielu niezaleznych fragmentow
+
+  @param
+    SIZE_CLASSES Liczba list wolnych obszarow. Wartosc musi zawierac sie
+    w przedziale < 2, 32 >
+*/
+template< int SIZE_CLASSES = 8 >
+class SegregatedFreeLists {
+ public:
+   /**
+     @brief
+       Wartosc indeksu oznaczajaca brak obszaru (koniec listy, lub
+       niemoznosc zaspokojenia zadania przydzialu)
+   */
+   enum { NO_BLOCK = -1 };
+
+   /**
+     @brief
+       Opis pojedynczego segmentu. Znaczenie maja jedynie wartosci
+       przechowywane w naglowkach, oraz stopkach obszarow
+   */
+   struct InfoNode {
+     int   next_;  /**< Nastepny obszar listy (zajety naglowek: sam siebie) */
+     int   prev_;  /**< Poprzedni obszar listy */
+     int   seg_;   /**< Dlugosc obszaru wyrazona w segmentach */
+     bool  free_;  /**< Stan obszaru */
+   };
+
+   /**
+     @brief
+       Konstruktor tworzacy pusta strukture. Przed pierwszym uzyciem
+       nalezy wykonac metode reset()
+   */
+   SegregatedFreeLists();
+
+   /**
+     @brief
+       Przywrocenie stanu surowego - caly obszar tablicy links staje sie
+       jednym wolnym obszarem
+
+     @param links Tablica opisow segmentow o wielkosci segmentsCount
+     @param segmentsCount Liczba segmentow zarzadzanego obszaru
+   */
+   void reset( InfoNode*  links,
+               int        segmentsCount );
+
+   /**
+     @brief
+       Informacja, czy struktura zostala zainicjalizowana metoda reset()
+   */
+   bool isInitialized() const { return links_ != 0; }
+
+   /**
+     @brief
+       Pobranie ciaglego obszaru o dlugosci blockCount segmentow
+
+     @return
+       Indeks pierwszego segmentu obszaru, badz NO_BLOCK w przypadku
+       braku wystarczajacej ilosci ciaglej, wolnej pamieci
+   */
+   int take( int blockCount );
+
+   /**
+     @brief
+       Zwrot obszaru rozpoczynajacego sie od segmentu blockIndex.
+       Sasiadujace wolne obszary zostaja scalone
+
+     @return
+       Liczba zwolnionych segmentow. Wartosc zerowa oznacza, iz podany
+       indeks nie okresla poczatku zajetego obszaru (zwolnienie zostaje
+       zignorowane, podobnie jak w przypadku klasy MemoryAlloc)
+   */
+   int give( int blockIndex );
+
+   /**
+     @brief
+       Sprawdzenie, czy zadany indeks jest poczatkiem zajetego obszaru
+   */
+   bool isTaken( int blockIndex ) const;
+
+   /**
+     @brief
+       Dlugosc (w segmentach) zajetego obszaru rozpoczynajacego sie
+       od segmentu blockIndex
+   */
+   int blockSegments( int blockIndex ) const;
+
+   /**
+     @brief
+       Liczba wszystkich wolnych segmentow
+   */
+   int freeSegmentsCount() const { return freeSegments_; }
+
+   /**
+     @brief
+       Dlugosc najwiekszego ciaglego wolnego obszaru
+   */
+   int largestFreeRun() const;
+
+   /**
+     @brief
+       Liczba rozlacznych wolnych obszarow (miara fragmentacji)
+   */
+   int freeRunsCount() const;
+
+ private:
+   /**
+     @brief
+       Indeks listy, na ktorej przechowywany jest obszar o zadanej dlugosci
+   */
+   static int classOf( int runLength );
+
+   /**
+     @brief
+       Zapisanie naglowka i stopki obszaru
+   */
+   void mark( int blockIndex, int runLength, bool isFree );
+
+   /**
+     @brief
+       Dolaczenie wolnego obszaru na poczatek odpowiedniej listy
+   */
+   void link( int blockIndex );
+
+   /**
+     @brief
+       Odlaczenie wolnego obszaru z listy, na ktorej sie znajduje
+   */
+   void unlink( int blockIndex );
+
+   /**
+     @brief
+       Przeszukanie listy obszarow dlugich metoda najlepszego dopasowania
+   */
+   int findBestFit( int blockCount ) const;
+
+   /**
+     @brief
+       Oznaczenie obszaru jako zajetego, oraz oddanie ewentualnej
+       reszty z powrotem do list wolnych obszarow
+   */
+   int split( int blockIndex, int blockCount );
+
+ private:
+   enum { LARGE_CLASS = SIZE_CLASSES - 1 };
+
+   InfoNode*      links_;         /**< Opisy segmentow */
+   int            segmentsCount_; /**< Liczba segmentow */
+   int            freeSegments_;  /**< Liczba wolnych segmentow */
+   int            heads_[ SIZE_CLASSES ]; /**< Poczatki list */
+   unsigned long  nonEmpty_;      /**< Maska bitowa niepustych list */
+};
+
+
+//
+template< int SIZE_CLASSES >
+SegregatedFreeLists< SIZE_CLASSES >
+::SegregatedFreeLists()
+  : links_( 0 )
+  , segmentsCount_( 0 )
+  , freeSegments_( 0 )
+  , nonEmpty_( 0 )
+{
+  for( int classIndex = 0; classIndex < SIZE_CLASSES; ++classIndex )
+    heads_[ classIndex ] = NO_BLOCK;
+}
+
+//
+template< int SIZE_CLASSES >
+void
+SegregatedFreeLists< SIZE_CLASSES >
+::reset( InfoNode*  links,
+         int        segmentsCount )
+{
+  assertion( SIZE_CLASSES >= 2 && SIZE_CLASSES <= 32,
+    "SegregatedFreeLists: Niepoprawna liczba klas rozmiaru!" );
+  assertion( links != 0 && segmentsCount > 0,
+    "SegregatedFreeLists::reset(): Niepoprawny obszar!" );
+
+  links_         = links;
+  segmentsCount_ = segmentsCount;
+  freeSegments_  = segmentsCount;
+  nonEmpty_      = 0;
+
+  for( int classIndex = 0; classIndex < SIZE_CLASSES; ++classIndex )
+    heads_[ classIndex ] = NO_BLOCK;
+
+  mark( 0, segmentsCount, true );
+  link( 0 );
+}
+
+//
+template< int SIZE_CLASSES > inline
+int
+SegregatedFreeLists< SIZE_CLASSES >
+::classOf( int runLength )
+{
+  return runLength < SIZE_CLASSES ? runLength - 1 : LARGE_CLASS;
+}
+
+//
+template< int SIZE_CLASSES > inline
+void
+SegregatedFreeLists< SIZE_CLASSES >
+::mark( int   blockIndex,
+        int   runLength,
+        bool  isFree )
+{
+  // Najpierw stopka, nastepnie naglowek - dla obszarow jednosegmentowych
+  // oba opisy dotycza tego samego wezla, a o stanie decyduje naglowek
+  InfoNode& footer = links_[ blockIndex + runLength - 1 ];
+  footer.seg_  = runLength;
+  footer.free_ = isFree;
+  footer.next_ = NO_BLOCK;
+
+  InfoNode& header = links_[ blockIndex ];
+  header.seg_  = runLength;
+  header.free_ = isFree;
+  header.next_ = isFree ? NO_BLOCK : blockIndex;
+  header.prev_ = isFree ? NO_BLOCK : blockIndex;
+}
+
+//
+template< int SIZE_CLASSES > inline
+void
+SegregatedFreeLists< SIZE_CLASSES >
+::link( int blockIndex )
+{
+  const int CLASS_INDEX = classOf( links_[ blockIndex ].seg_ );
+
+  links_[ blockIndex ].prev_ = NO_BLOCK;
+  links_[ blockIndex ].next_ = heads_[ CLASS_INDEX ];
+
+  if( heads_[ CLASS_INDEX ] != NO_BLOCK )
+    links_[ heads_[ CLASS_INDEX ] ].prev_ = blockIndex;
+
+  heads_[ CLASS_INDEX ] = blockIndex;
+  nonEmpty_ |= 1UL << CLASS_INDEX;
+}
+
+//
+template< int SIZE_CLASSES > inline
+void
+SegregatedFreeLists< SIZE_CLASSES >
+::unlink( int blockIndex )
+{
+  const int CLASS_INDEX = classOf( links_[ blockIndex ].seg_ );
+  const int PREV = links_[ blockIndex ].prev_;
+  const int NEXT = links_[ blockIndex ].next_;
+
+  if( PREV != NO_BLOCK )
+    links_[ PREV ].next_ = NEXT;
+  else
+    heads_[ CLASS_INDEX ] = NEXT;
+
+  if( NEXT != NO_BLOCK )
+    links_[ NEXT ].prev_ = PREV;
+
+  if( heads_[ CLASS_INDEX ] == NO_BLOCK )
+    nonEmpty_ &= ~( 1UL << CLASS_INDEX );
+}
+
+//
+template< int SIZE_CLASSES >
+int
+SegregatedFreeLists< SIZE_CLASSES >
+::findBestFit( int blockCount ) const
+{
+  int bestBlock  = NO_BLOCK;
+  int bestLength = 0;
+
+  for( int block = heads_[ LARGE_CLASS ];
+    block != NO_BLOCK;
+    block = links_[ block ].next_ )
+  {
+    const int RUN_LENGTH = links_[ block ].seg_;
+
+    if( RUN_LENGTH >= blockCount &&
+      ( bestBlock == NO_BLOCK || RUN_LENGTH < bestLength ) )
+    {
+      bestBlock  = block;
+      bestLength = RUN_LENGTH;
+
+      // Lepszego dopasowania nie ma sensu szukac
+      if( RUN_LENGTH == blockCount )
+        break;
+    }
+  }
+
+  return bestBlock;
+}
+
+//
+template< int SIZE_CLASSES >
+int
+SegregatedFreeLists< SIZE_CLASSES >
+::split( int blockIndex,
+         int blockCount )
+{
+  const int RUN_LENGTH = links_[ blockIndex ].seg_;
+
+  unlink( blockIndex );
+  mark( blockIndex, blockCount, false );
+
+  if( RUN_LENGTH > blockCount ) {
+    const int REMAINDER = blockIndex + blockCount;
+    mark( REMAINDER, RUN_LENGTH - blockCount, true );
+    link( REMAINDER );
+  }
+
+  freeSegments_ -= blockCount;
+  return blockIndex;
+}
+
+//
+template< int SIZE_CLASSES >
+int
+SegregatedFreeLists< SIZE_CLASSES >
+::take( int blockCount )
+{
+  assertion( isInitialized(),
+    "SegregatedFreeLists::take(): Struktura nie zostala zainicjalizowana!" );
+
+  if( blockCount <= 0 || blockCount > freeSegments_ )
+    return NO_BLOCK;
+
+  if( blockCount < SIZE_CLASSES ) {
+    // Sciezka szybka - lista obszarow o dokladnie zadanej dlugosci
+    const int EXACT_CLASS = classOf( blockCount );
+    if( heads_[ EXACT_CLASS ] != NO_BLOCK )
+      return split( heads_[ EXACT_CLASS ], blockCount );
+
+    // Najmniejsza niepusta lista obszarow dluzszych od zadanego. Obszary
+    // list dokladnych sa dzielone bez przeszukiwania, jedynie lista
+    // obszarow dlugich wymaga wyboru najlepszego dopasowania
+    const unsigned long LONGER_CLASSES =
+      nonEmpty_ & ~( ( 2UL << EXACT_CLASS ) - 1 );
+
+    if( LONGER_CLASSES != 0 ) {
+      int classIndex = EXACT_CLASS + 1;
+      while( ( LONGER_CLASSES & ( 1UL << classIndex ) ) == 0 )
+        ++classIndex;
+
+      if( classIndex != LARGE_CLASS )
+        return split( heads_[ classIndex ], blockCount );
+    }
+  }
+
+  const int FOUND = findBestFit( blockCount );
+  return FOUND == NO_BLOCK ? NO_BLOCK : split( FOUND, blockCount );
+}
+
+//
+template< int SIZE_CLASSES >
+int
+SegregatedFreeLists< SIZE_CLASSES >
+::give( int blockIndex )
+{
+  if( !isTaken( blockIndex ) )
+    return 0;
+
+  const int RELEASED = links_[ blockIndex ].seg_;
+  int runBegin  = blockIndex;
+  int runLength = RELEASED;
+
+  // Naglowek zwalnianego obszaru przestaje opisywac obszar zajety. Przy
+  // scaleniu z lewym sasiadem lezy on wewnatrz wolnego obszaru i nie
+  // zostaje nadpisany - ponowne zwolnienie zostaloby wowczas przyjete
+  links_[ blockIndex ].free_ = true;
+  links_[ blockIndex ].next_ = NO_BLOCK;
+
+  // Scalenie z prawym sasiadem - jego naglowek lezy bezposrednio
+  // za ostatnim segmentem zwalnianego obszaru
+  const int RIGHT = blockIndex + RELEASED;
+  if( RIGHT < segmentsCount_ && links_[ RIGHT ].free_ ) {
+    runLength += links_[ RIGHT ].seg_;
+    unlink( RIGHT );
+  }
+
+  // Scalenie z lewym sasiadem - na jego poczatek wskazuje stopka
+  // umieszczona w segmencie poprzedzajacym zwalniany obszar
+  if( blockIndex > 0 && links_[ blockIndex - 1 ].free_ ) {
+    const int LEFT_LENGTH = links_[ blockIndex - 1 ].seg_;
+    runBegin   = blockIndex - LEFT_LENGTH;
+    runLength += LEFT_LENGTH;
+    unlink( runBegin );
+  }
+
+  mark( runBegin, runLength, true );
+  link( runBegin );
+
+  freeSegments_ += RELEASED;
+  return RELEASED;
+}
+
+//
+template< int SIZE_CLASSES > inline
+bool
+SegregatedFreeLists< SIZE_CLASSES >
+::isTaken( int blockIndex ) const
+{
+  return blockIndex >= 0 &&
+    blockIndex < segmentsCount_ &&
+    !links_[ blockIndex ].free_ &&
+    links_[ blockIndex ].next_ == blockIndex;
+}
+
+//
+template< int SIZE_CLASSES > inline
+int
+SegregatedFreeLists< SIZE_CLASSES >
+::blockSegments( int blockIndex ) const
+{
+  assertion( isTaken( blockIndex ),
+    "SegregatedFreeLists::blockSegments(): Obszar nie jest zajety!" );
+  return links_[ blockIndex ].seg_;
+}
+
+//
+template< int SIZE_CLASSES >
+int
+SegregatedFreeLists< SIZE_CLASSES >
+::largestFreeRun() const
+{
+  int largest = 0;
+
+  for( int block = heads_[ LARGE_CLASS ];
+    block != NO_BLOCK;
+    block = links_[ block ].next_ )
+  {
+    if( links_[ block ].seg_ > largest )
+      largest = links_[ block ].seg_;
+  }
+
+  if( largest != 0 )
+    return largest;
+
+  for( int classIndex = LARGE_CLASS - 1; classIndex >= 0; --classIndex ) {
+    if( heads_[ classIndex ] != NO_BLOCK )
+      return classIndex + 1;
+  }
+
+  return 0;
+}
+
+//
+template< int SIZE_CLASSES >
+int
+SegregatedFreeLists< SIZE_CLASSES >
+::freeRunsCount() const
+{
+  int runs = 0;
+
+  for( int classIndex = 0; classIndex < SIZE_CLASSES; ++classIndex ) {
+    for( int block = heads_[ classIndex ];
+      block != NO_BLOCK;
+      block = links_[ block ].next_ )
+    {
+      ++runs;
+    }
+  }
+
+  return runs;
+}
+
+} // namespace Utilities
+} // namespace Gcad
+
+#endif
@@ -0,0 +1,326 @@
+/***************************************************************************
+ *   Copyright (C) 2005 by Eryk Klebanski                                  *
+ *   rixment@gmail.com                                                     *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef _GCAD_SEGREGATEDMEMORYALLOC_H_
+#define _GCAD_SEGREGATEDMEMORYALLOC_H_
+
+#include "GcadAssertion.h"
+#include "GcadSegregatedFreeLists.h"
+#include "GcadMemoryAllocStats.h"
+#include <cstddef> // size_t
+#include <memory>  // std::bad_alloc
+
+namespace Gcad {
+namespace Utilities {
+
+/**
+  @brief
+    Odmiana szablonu MemoryAlloc, ktorej wolne obszary sa organizowane
+    w postaci list rozdzielonych wedlug klas rozmiaru
+
+    Interfejs szablonu jest zgodny z MemoryAlloc, wiec zamiana klasy
+    bazowej nie wymaga zmian w kodzie klientow. Roznica dotyczy
+    wylacznie kosztu operacji: przydzial obiektow zajmujacych mniej niz
+    SIZE_CLASSES segmentow, oraz ich zwolnienie odbywa sie w czasie
+    stalym, niezaleznie od wielkosci puli i stopnia jej fragmentacji.
+    Podczas zwalniania sasiednie wolne obszary sa natychmiast scalane,
+    a wieksze zadania sa obslugiwane metoda najlepszego dopasowania
+
+  @param
+    ELEM_COUNT Maksymalna ilosc segmentow w zarezerwowanym buforze
+
+  @param
+    SEG_SIZE Rozmiar segmentu wyrazony w bajtach
+
+  @param
+    SIZE_CLASSES Liczba list wolnych obszarow (patrz SegregatedFreeLists)
+
+  @remark
+    Inicjalizacja obszaru nastepuje automatycznie podczas pierwszego
+    przydzialu. Metoda purgeMemory() pozwala przywrocic stan surowy
+
+  @code
+    typedef SegregatedMemoryAlloc< 1024, sizeof( int ) * 4 >  NodeMemAlloc;
+
+    class Particle : public NodeMemAlloc {
+      // ...
+    };
+
+    Particle* particle = new Particle;  // NodeMemAlloc::operator new
+    delete particle;                    // NodeMemAlloc::operator delete
+  @endcode
+*/
+template< int ELEM_COUNT,
+          int SEG_SIZE     = sizeof( int ),
+          int SIZE_CLASSES = 8 >
+class SegregatedMemoryAlloc {
+ public:
+   /**
+     @brief
+       Zasloniecie globalnego operatora new w klasach pochodnych
+
+     @exception
+       std::bad_alloc Brak ciaglego obszaru o wystarczajacej wielkosci
+   */
+   static void* operator new( size_t bytesCount ) throw( std::bad_alloc );
+
+   /**
+     @brief
+       Zasloniecie globalnego operatora new[]
+
+     @exception
+       std::bad_alloc
+   */
+   static void* operator new []( size_t bytesCount ) throw( std::bad_alloc );
+
+   /**
+     @brief
+       Zasloniecie globalnego operatora delete. Zwalniany obszar zostaje
+       scalony z sasiadujacymi wolnymi obszarami
+   */
+   static void operator delete( void* memoryToRelease ) throw();
+
+   /**
+     @brief
+       Zasloniecie globalnego operatora delete[]
+   */
+   static void operator delete []( void* memoryToRelease ) throw();
+
+   /**
+     @brief
+       Przywrocenie stanu surowego pamieci (wykonanie dezalokacji
+       wszystkich zarezerwowanych segmentow)
+   */
+   static void purgeMemory();
+
+   /**
+     @brief
+       Podany w bajtach rozmiar calego bloku pamieci
+   */
+   static int size();
+
+   /**
+     @brief
+       Ilosc bajtow przypadajaca na segment
+   */
+   static int bytesPerSegment();
+
+   /**
+     @brief
+       Liczba segmentow, z ktorych sklada sie caly obszar dostepnej pamieci
+   */
+   static int segmentsCount();
+
+   /**
+     @brief
+       Migawka biezacego stanu puli (patrz MemoryAllocStats)
+   */
+   static MemoryAllocStats statistics();
+
+ protected:
+   /**
+     @brief
+       Domyslny konstruktor, wywolywany podczas tworzenia
+       instancji klas pochodnych
+   */
+   SegregatedMemoryAlloc() {}
+
+ private:
+   typedef SegregatedFreeLists< SIZE_CLASSES >  FreeLists;
+   typedef typename FreeLists::InfoNode         InfoNode;
+
+   /**
+     @brief
+       Struktura list wolnych obszarow
+   */
+   static FreeLists  freeLists_;
+
+   /**
+     @brief
+       Opisy segmentow puli (naglowki, oraz stopki obszarow)
+   */
+   static InfoNode  links_[ ELEM_COUNT ];
+
+   /**
+     @brief
+       Obszar pamieci przeznaczonej do wykorzystania
+       przez obiekty klas pochodnych
+   */
+   static char  memoryPool_[ ELEM_COUNT * SEG_SIZE ];
+
+   /**
+     @brief
+       Liczniki operacji (aktywne z definicja GCAD_MEMORY_STATS)
+   */
+   static MemoryAllocCounters  counters_;
+
+ private:
+   // nie zaimplementowane
+   SegregatedMemoryAlloc( const SegregatedMemoryAlloc& );
+   SegregatedMemoryAlloc& operator =( const SegregatedMemoryAlloc& );
+};
+
+
+//
+template< int ELEM_COUNT, int SEG_SIZE, int SIZE_CLASSES >
+typename SegregatedMemoryAlloc< ELEM_COUNT, SEG_SIZE, SIZE_CLASSES >::FreeLists
+SegregatedMemoryAlloc< ELEM_COUNT, SEG_SIZE, SIZE_CLASSES >
+::freeLists_;
+
+//
+template< int ELEM_COUNT, int SEG_SIZE, int SIZE_CLASSES >
+typename SegregatedMemoryAlloc< ELEM_COUNT, SEG_SIZE, SIZE_CLASSES >::InfoNode
+SegregatedMemoryAlloc< ELEM_COUNT, SEG_SIZE, SIZE_CLASSES >
+::links_[ ELEM_COUNT ];
+
+//
+template< int ELEM_COUNT, int SEG_SIZE, int SIZE_CLASSES >
+char SegregatedMemoryAlloc< ELEM_COUNT, SEG_SIZE, SIZE_CLASSES >
+::memoryPool_[ ELEM_COUNT * SEG_SIZE ] = { 0 };
+
+//
+template< int ELEM_COUNT, int SEG_SIZE, int SIZE_CLASSES >
+MemoryAllocCounters SegregatedMemoryAlloc< ELEM_COUNT, SEG_SIZE, SIZE_CLASSES >
+::counters_;
+
+//
+template< int ELEM_COUNT, int SEG_SIZE, int SIZE_CLASSES >
+void* SegregatedMemoryAlloc< ELEM_COUNT, SEG_SIZE, SIZE_CLASSES >
+::operator new( size_t bytesCount ) throw( std::bad_alloc )
+{
+  if( !freeLists_.isInitialized() )
+    purgeMemory();
+
+  // Zaokraglenie w gore do pelnych segmentow. Obiekt o zerowym
+  // rozmiarze rowniez musi otrzymac unikalny adres
+  int blockCount = static_cast< int >(
+    ( bytesCount + SEG_SIZE - 1 ) / SEG_SIZE );
+  if( blockCount == 0 )
+    blockCount = 1;
+
+  const int FOUNDED_BLOCK = freeLists_.take( blockCount );
+  if( FOUNDED_BLOCK == FreeLists::NO_BLOCK ) {
+    counters_.recordFailure( bytesCount );
+    throw std::bad_alloc();
+  }
+
+  counters_.recordAllocation( bytesCount, blockCount * SEG_SIZE );
+
+  return memoryPool_ + FOUNDED_BLOCK * SEG_SIZE;
+}
+
+//
+template< int ELEM_COUNT, int SEG_SIZE, int SIZE_CLASSES > inline
+void* SegregatedMemoryAlloc< ELEM_COUNT, SEG_SIZE, SIZE_CLASSES >
+::operator new []( size_t bytesCount ) throw( std::bad_alloc )
+{
+  return operator new( bytesCount );
+}
+
+//
+template< int ELEM_COUNT, int SEG_SIZE, int SIZE_CLASSES >
+void SegregatedMemoryAlloc< ELEM_COUNT, SEG_SIZE, SIZE_CLASSES >
+::operator delete( void* memoryToRelease ) throw()
+{
+  if( memoryToRelease == 0 )
+    return;
+
+  const char* RELEASED = static_cast< const char* >( memoryToRelease );
+
+  // Adres spoza puli, badz nie wyrownany do poczatku segmentu
+  // nie moze wskazywac na obszar przydzielony przez operator new
+  if( RELEASED < memoryPool_ || RELEASED >= memoryPool_ + size() )
+    return;
+
+  const int COUNT_BYTES_TO_RELEASED_MEM = RELEASED - memoryPool_;
+  if( COUNT_BYTES_TO_RELEASED_MEM % SEG_SIZE != 0 )
+    return;
+
+  // Niepoprawne indeksy (np. podwojne zwolnienie) sa ignorowane
+  const int RELEASED_SEGMENTS =
+    freeLists_.give( COUNT_BYTES_TO_RELEASED_MEM / SEG_SIZE );
+  if( RELEASED_SEGMENTS != 0 )
+    counters_.recordDeallocation( RELEASED_SEGMENTS * SEG_SIZE );
+}
+
+//
+template< int ELEM_COUNT, int SEG_SIZE, int SIZE_CLASSES > inline
+void SegregatedMemoryAlloc< ELEM_COUNT, SEG_SIZE, SIZE_CLASSES >
+::operator delete []( void* memoryToRelease ) throw()
+{
+  operator delete( memoryToRelease );
+}
+
+//
+template< int ELEM_COUNT, int SEG_SIZE, int SIZE_CLASSES >
+void SegregatedMemoryAlloc< ELEM_COUNT, SEG_SIZE, SIZE_CLASSES >
+::purgeMemory()
+{
+  freeLists_.reset( links_, ELEM_COUNT );
+  counters_.reset();
+}
+
+//
+template< int ELEM_COUNT, int SEG_SIZE, int SIZE_CLASSES > inline
+int SegregatedMemoryAlloc< ELEM_COUNT, SEG_SIZE, SIZE_CLASSES >
+::size()
+{
+  return ELEM_COUNT * SEG_SIZE;
+}
+
+//
+template< int ELEM_COUNT, int SEG_SIZE, int SIZE_CLASSES > inline
+int SegregatedMemoryAlloc< ELEM_COUNT, SEG_SIZE, SIZE_CLASSES >
+::bytesPerSegment()
+{
+  return SEG_SIZE;
+}
+
+//
+template< int ELEM_COUNT, int SEG_SIZE, int SIZE_CLASSES > inline
+int SegregatedMemoryAlloc< ELEM_COUNT, SEG_SIZE, SIZE_CLASSES >
+::segmentsCount()
+{
+  return ELEM_COUNT;
+}
+
+//
+template< int ELEM_COUNT, int SEG_SIZE, int SIZE_CLASSES >
+MemoryAllocStats SegregatedMemoryAlloc< ELEM_COUNT, SEG_SIZE, SIZE_CLASSES >
+::statistics()
+{
+  MemoryAllocStats stats;
+  counters_.fill( &stats );
+
+  if( freeLists_.isInitialized() ) {
+    stats.largestFreeRun_ = freeLists_.largestFreeRun() * SEG_SIZE;
+    stats.freeRuns_       = freeLists_.freeRunsCount();
+  } else {
+    stats.largestFreeRun_ = size();
+    stats.freeRuns_       = 1;
+  }
+
+  return stats;
+}
+
+} // namespace Utilities
+} // namespace Gcad
+
+#endif
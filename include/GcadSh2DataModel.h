@@ -22,6 +22,9 @@
 #define _GCAD_SH2DATAMODEL_H_
 
 #include "GcadBase.h"
+#include "GcadByteSize.h"
+#include "GcadByteSpan.h"
+#include "GcadException.h"
 #include "GcadRefCountPtr.h"
 #include "GcadVector2.h"
 #include "GcadVector3.h"
@@ -57,10 +60,38 @@ class GCAD_EXPORT Sh2DataModel {
    typedef std::pair<TextureCoordinatesConstItor,
                      TextureCoordinatesConstItor> BeginEndItorTextureCoordinates;
 
+   /**
+     @brief
+       Wyjatek zglaszany, gdy liczby elementow zapisane w naglowku sa
+       niezgodne z rozmiarem danych
+   */
+   struct GCAD_EXPORT BadDataFormat : Utilities::Exception {
+     BadDataFormat(const std::string& exceptionDescription)
+       : Utilities::Exception(exceptionDescription)
+     {}
+   };
+
  public:
    Sh2DataModel(const std::string& fileName);
    Sh2DataModel(std::istream& sh2Data);
 
+   /**
+     @brief
+       Odczyt modelu bezposrednio z obszaru pamieci (np. pliku
+       odwzorowanego przez Platform::MappedFile), bez posrednich buforow
+
+     @exception
+       BadDataFormat
+   */
+   Sh2DataModel(const Utilities::ByteSpan& sh2Data);
+
+   /**
+     @brief
+       Wymiana danych dwoch modeli w czasie stalym (w C++11 przenoszenie
+       obiektow korzysta z niejawnie generowanych konstruktorow)
+   */
+   void swap(Sh2DataModel& that);
+
    BeginEndItorVerticesFrame getKeyFrameVertices(int frameNum) const;
    BeginEndItorNormalsFrame getKeyFrameNormals(int frameNum) const;
    BeginEndItorTextureCoordinates getTextureCoordinates() const;
@@ -70,6 +101,13 @@ class GCAD_EXPORT Sh2DataModel {
    int polygonsCount() const;
    int texturesCoordinatesCount() const;
 
+   /**
+     @brief
+       Calkowita wielkosc pamieci zajmowanej przez model (obiekt, dane
+       klatek kluczowych wraz z licznikami odniesien, koordynaty tekstur)
+   */
+   size_t getByteSize() const;
+
  private:
    VerticesKeyFrames  verticesFrames_;
    NormalsKeyFrames   normalsFrames_;
@@ -82,7 +120,8 @@ class GCAD_EXPORT Sh2DataModel {
    int texturesCoordinatesCount_;
 
  private:
-   void loadDataFromStream(std::istream& sh2input);
+   template<typename SOURCE>
+   void loadData(SOURCE& sh2input);
 };
 
 } // namespace Framework
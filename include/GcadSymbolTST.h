@@ -21,10 +21,12 @@
 #ifndef _GCAD_SYMBOLTST_H_
 #define _GCAD_SYMBOLTST_H_
 
-#include "GcadValuePtr.h"
 #include <algorithm>
 #include <string>
 #include <limits>
+#include <stdexcept>
+#include <vector>
+#include <utility>
 
 namespace Gcad {
 namespace Utilities {
@@ -39,12 +41,12 @@ namespace Utilities {
     przedstawionej w "Algorytmy C++ Grafy" R. Sedgewick'a, str. 47
 
   @remark
-    Wyszczegolniona realizacja tablicy poszukiwan moze okazac sie 
-    niewystarczajaca pod wzgledem wydajnosciowym. Uzycie w jej
-    wewnetrznej reprezentacji sprytnych wskaznikow - opartych na zachowaniu
-    semantyki tworzenia kopii elementow, za ktore sa odpowiedzialne -
-    moze powodowac znaczne przeciazenia czasowe, implikowane wywolaniami
-    konstruktorow kopiujacych, czy operatorow przypisania    
+    Wezly drzewa sa przechowywane w ciaglej tablicy, a laczenia miedzy
+    nimi sa 32-bitowymi indeksami tej tablicy. Kopiowanie struktury
+    sprowadza sie do skopiowania jednego wektora, a przeszukiwanie nie
+    wymaga odwolan do rozproszonych po stercie obiektow. Po zakonczeniu
+    budowy tablicy mozna wywolac freeze(), ktora uklada wezly w kolejnosci
+    przegladania
   
   @code
     #include "GcadSymbolTST.h"
@@ -127,14 +129,14 @@ class SymbolTST {
    typedef typename String::const_iterator  StringConstItor;
 
  private:
-   struct Node;
-
    /**
-     @brief 
-       Typ instancji o charakterystyce opakowujacej automatyczne 
-       zachowanie kopiowania obiektow wskaznikow
+     @brief
+       Indeks wezla w tablicy nodes_. Wartosc 32-bitowa - wezly sa
+       o polowe mniejsze niz przy laczeniach wskaznikowych
    */
-   typedef ValuePtr< Node >  NodeValuePtr;
+   typedef unsigned int  NodeIndex;
+
+   enum { NO_NODE = 0xffffffffu }; /**< Brak wezla potomnego */
 
    /**
      @brief 
@@ -152,9 +154,9 @@ class SymbolTST {
    */
    struct Node {
      Node( SymbolChar symbol )
-       : left_( 0 )
-       , middle_( 0 )
-       , right_( 0 )
+       : left_( NO_NODE )
+       , middle_( NO_NODE )
+       , right_( NO_NODE )
        , handle_( std::numeric_limits< Handle >::max() )
        , symbol_( symbol )
      {}
@@ -168,23 +170,36 @@ class SymbolTST {
        return handle_ != std::numeric_limits< Handle >::max(); 
      }
 
-     // Laczniki wezla struktury drzewa trynarnego
-     NodeValuePtr  left_;
-     NodeValuePtr  middle_;
-     NodeValuePtr  right_;
+     // Laczniki wezla struktury drzewa trynarnego (indeksy w nodes_)
+     NodeIndex     left_;
+     NodeIndex     middle_;
+     NodeIndex     right_;
 
      Handle        handle_; /**< Wartosc uchwytu danego wezla */
      SymbolChar    symbol_; /**< Wartosc symbolu zapisanego w danym wezle */
    };
 
+   typedef std::vector< Node >  Nodes;
+
+   /**
+     @brief
+       Porzadek identyfikatorow w findHandles()
+   */
+   struct IdLess {
+     bool operator ()( const std::pair< const String*, size_t >&  lhs,
+                       const std::pair< const String*, size_t >&  rhs ) const
+     {
+       return *lhs.first < *rhs.first;
+     }
+   };
+
  public:
    /**
      @brief Domyslny konstruktor inicjalizujacy wewnetrzna reprezentacje
    */
    SymbolTST()
-     : head_( 0 )
-     , handlePool_( 0 )
-     , handleToReturn_( 0 )
+     : handlePool_( 0 )
+     , emptyIdHandle_( std::numeric_limits< Handle >::max() )
    {}
 
    /**
@@ -198,6 +213,9 @@ class SymbolTST {
      @brief
        Na podstawie przekazanego argumentu wywolania, w postaci wartosci
        symbolu, metoda zwraca niepowtarzalny uchwyt z nim sprzezony
+
+     @exception
+       std::length_error Przekroczenie 32-bitowego zakresu indeksow wezlow
    */
    Handle getHandle( const String&  identifier );
 
@@ -208,40 +226,156 @@ class SymbolTST {
        zostac odwzorowana na podstawie zadanego identyfikatora przekazanego
        w formie argumentu wywolania
    */
-   bool isIdMapped( const String&  identifier );
+   bool isIdMapped( const String&  identifier ) const;
+
+   /**
+     @brief
+       Wartosc uchwytu oznaczajaca brak odwzorowania (zwracana przez
+       findHandles() dla nieznanych identyfikatorow)
+   */
+   static Handle invalidHandle() { 
+     return std::numeric_limits< Handle >::max(); 
+   }
+
+   /**
+     @brief
+       Odczyt uchwytu identyfikatora bez modyfikacji drzewa. Zastepuje
+       para wywolan isIdMapped(), getHandle() - przeszukiwanie odbywa sie
+       jednokrotnie
+
+     @return
+       Wartosc falszywa, gdy identyfikator nie zostal odwzorowany
+       (zmienna handle pozostaje wowczas niezmieniona)
+   */
+   bool findHandle( const String&  identifier,
+                    Handle*        handle ) const;
+
+   /**
+     @brief
+       Odczyt uchwytow sekwencji identyfikatorow w jednym przejsciu
+       drzewa
+
+       Identyfikatory sa przegladane w porzadku leksykograficznym, a
+       kazde kolejne poszukiwanie rozpoczyna sie od wezla, na ktorym
+       konczy sie wspolny przedrostek z poprzednim identyfikatorem.
+       Uchwyty (badz invalidHandle()) sa zapisywane w kolejnosci
+       identyfikatorow wejsciowych
+
+     @param firstId, lastId Zakres obiektow typu String
+     @param handles Iterator wyjsciowy uchwytow
+
+     @return
+       Liczba odwzorowanych identyfikatorow
+   */
+   template< typename ID_ITOR, typename HANDLE_ITOR >
+   size_t findHandles( ID_ITOR      firstId,
+                       ID_ITOR      lastId,
+                       HANDLE_ITOR  handles ) const;
+
+   /**
+     @brief
+       Najdluzszy odwzorowany identyfikator bedacy przedrostkiem
+       zadanego ciagu
+
+     @param identifier Przeszukiwany ciag
+     @param prefixLength Dlugosc znalezionego przedrostka
+     @param handle Uchwyt znalezionego przedrostka
+
+     @return
+       Wartosc falszywa, gdy zaden przedrostek nie jest odwzorowany
+   */
+   bool longestPrefixMatch( const String&  identifier,
+                            size_t*        prefixLength,
+                            Handle*        handle ) const;
+
+   /**
+     @brief
+       Wywolanie obiektu visitor dla kazdego odwzorowanego identyfikatora
+       rozpoczynajacego sie od zadanego przedrostka
+
+       Odwiedzane sa jedynie wezly poddrzewa przedrostka, wiec koszt
+       operacji jest proporcjonalny do jego wielkosci, a nie liczby
+       wszystkich symboli. Identyfikatory sa przekazywane w porzadku
+       leksykograficznym (wzgledem wartosci SymbolChar)
+
+     @param prefix Przedrostek (pusty - wszystkie identyfikatory)
+     @param visitor Obiekt funkcyjny wywolywany z argumentami
+       ( const String& suffix, Handle handle ), gdzie suffix jest
+       pozostaloscia identyfikatora po usunieciu przedrostka
+
+     @return
+       Kopia obiektu visitor po odwiedzeniu wszystkich identyfikatorow
+       (analogicznie do std::for_each)
+
+     @code
+       struct PrintSuffix {
+         void operator ()( const std::string& suffix, size_t handle ) {
+           std::cout << suffix << " -> " << handle << '\n';
+         }
+       };
+
+       tst.forEachWithPrefix( "models\\", PrintSuffix() );
+     @endcode
+   */
+   template< typename VISITOR >
+   VISITOR forEachWithPrefix( const String&  prefix,
+                              VISITOR        visitor ) const;
+
+   /**
+     @brief
+       Uporzadkowanie wezlow w kolejnosci przegladania drzewa
+
+       Wezly zostaja ulozone w porzadku wzdluznym, w ktorym nastepnik
+       srodkowy znajduje sie bezposrednio za swoim rodzicem. Poszukiwanie
+       symbolu przebiega wowczas w wiekszosci po sasiednich elementach
+       tablicy. Nadmiarowa pojemnosc tablicy zostaje zwolniona
+
+     @remark
+       Operacja jest opcjonalna i przeznaczona dla tablic, ktore po fazie
+       budowy sa jedynie przeszukiwane. Kolejne wywolania getHandle() sa
+       dozwolone, lecz nowe wezly trafiaja na koniec tablicy. Wartosci
+       uchwytow nie ulegaja zmianie
+   */
+   void freeze();
+
+   /**
+     @brief
+       Liczba wezlow drzewa
+   */
+   size_t nodesCount() const { return nodes_.size(); }
 
  private:
    /**
      @brief
-       Poprzez rekurencyjne wywolania metody, zostaje sprawdzone, ewentualnie
-       dobudowane drzewo trynarne poszukiwan.
-       
-       Kolejne podzbiory ciagu, przekazanego za posrednictwem pary iteratorow,
-       sa przekazywane do kolejnych wywolan funkcji, wewnatrz ktorej nastepuje
-       analiza jego poszczegolnych znakow. W jednej iteracji jest sprawdzany
-       dokladnie jedna wartosc, na podstawie ktorej budowana jest konstrukcja
-       oparta na strukturze drzewa. Gdy trawersacja wszystkich elementow
-       symbolu dobiegnie konca, wowczas nastepuja powroty z rekurencji, ktore
-       ewentualnie wykonuja prace polaczenia utworzonych wezlow, do glownej
-       struktury organizacyjnej.
+       Dolaczenie nowego wezla na koncu tablicy nodes_
+
+     @exception
+       std::length_error Przekroczenie zakresu indeksow NodeIndex
    */
-   NodeValuePtr& generateHandle( NodeValuePtr&    node,
-                                 StringConstItor  beginSymbol,
-                                 StringConstItor  endSymbol );
+   NodeIndex appendNode( SymbolChar symbol );
 
    /**
-     @brief 
-       Rekurencyjnie wywolywana pomocnicza funkcja uzywana 
-       w implementacji metody isIdMapped
+     @brief
+       Indeks wezla ostatniego znaku identyfikatora (niepustego), badz
+       NO_NODE, gdy sciezka nie istnieje
    */
-   bool checkId( const String&  identifier,
-                 size_t         charIndex,
-                 NodeValuePtr&  node );
+   NodeIndex findNode( const String&  identifier ) const;
+
+   /**
+     @brief
+       Rekurencyjne przejscie poddrzewa o korzeniu node w porzadku
+       leksykograficznym. Zmienna suffix zawiera znaki sciezki od
+       przedrostka do rodzica wezla
+   */
+   template< typename VISITOR >
+   void visitSubtree( NodeIndex  node,
+                      String*    suffix,
+                      VISITOR&   visitor ) const;
 
  private:
-   NodeValuePtr  head_;           /**< Korzen drzewa trynarnego */
-   Handle        handlePool_;     /**< Ostatnia zachowana wartosc uchwytu */
-   Handle        handleToReturn_; /**< Wartosc uchwytu zadanego symbolu */
+   Nodes   nodes_;         /**< Wezly drzewa, korzen pod indeksem zerowym */
+   Handle  handlePool_;    /**< Ostatnia zachowana wartosc uchwytu */
+   Handle  emptyIdHandle_; /**< Uchwyt pustego identyfikatora */
 }; 
 
 
@@ -252,132 +386,391 @@ SymbolTST< CHARACTER, HANDLE >
 ::swap( SymbolTST& rhs )
 {
   std::swap( handlePool_, rhs.handlePool_ );
-  std::swap( handleToReturn_, rhs.handleToReturn_ );
-  head_.swap( rhs.head_ );
+  std::swap( emptyIdHandle_, rhs.emptyIdHandle_ );
+  nodes_.swap( rhs.nodes_ );
 }
 
 //
 template< typename CHARACTER, typename HANDLE >
-typename SymbolTST< CHARACTER, HANDLE >::Handle 
+typename SymbolTST< CHARACTER, HANDLE >::NodeIndex
 SymbolTST< CHARACTER, HANDLE >
-::getHandle( const String&  identifier )
+::appendNode( SymbolChar symbol )
 {
-  head_ = NodeValuePtr( 
-    generateHandle( head_, identifier.begin(), identifier.end() ) );
-  return handleToReturn_;
+  if( nodes_.size() >= NO_NODE )
+    throw std::length_error( "SymbolTST: too many nodes" );
+
+  nodes_.push_back( Node( symbol ) );
+  return static_cast< NodeIndex >( nodes_.size() - 1 );
 }
 
 //
 template< typename CHARACTER, typename HANDLE >
-typename SymbolTST< CHARACTER, HANDLE >::NodeValuePtr&
+typename SymbolTST< CHARACTER, HANDLE >::Handle 
 SymbolTST< CHARACTER, HANDLE >
-::generateHandle( NodeValuePtr&    node,
-                  StringConstItor  beginSymbol,
-                  StringConstItor  endSymbol )
+::getHandle( const String&  identifier )
 {
-  StringConstItor  currSymbol = beginSymbol;
-  SymbolChar       symbol     = *currSymbol;
-
-  // Calkiem prawdopodobne, iz obiektowi sprytnego wskaznika brakuje
-  // reprezentatywnego wezla (zmienna node) aktywnego symbolu (zmienna symbol).
-  // Implikuje to sytuacje, gdy dana sciezka prowadzaca od korzenia drzewa
-  // jest dziewicza. Efektem zaistnienia tej sytuacji jest potrzeba konstrukcji
-  // nowych wezlow - tym samym budowa nowej sciezki - sprzezonych z aktualnie
-  // przetwarzana encja symbolu
-
-  if( node.empty() )
-    node = NodeValuePtr( new Node( symbol ) );
-
-  // Dotarcie do konca ciagu (poprzez rekurencyjne wywolania, zawezajace
-  // zakres nazwy symbolicznej) implikuje wykonanie wyrazenia konczacego
-  // rekursje. Sprawdzamy zawartosc ostatniego wezla, reprezentujacego
-  // ostatni znak symbolu, determinujacego przypisany mu uchwyt. W sytuacji,
-  // gdy dany ciag znakow jest nowym zbiorem uporzadkowanych elementow, 
-  // musimy wygenerowac nowy uchwyt dla konczacego go wezla. Wartosc ta
-  // nastepnie jest zapisywana w wewnetrznej strukturze klasy (handleToReturn),
-  // aby umozliwic jej odczyt po powrocie z wywolan rekurencyjnych
-  
-  if( currSymbol == endSymbol ) {
-    if( !node->isHandleAvaible() ) {
-      node->handle_ = handlePool_++;
-    }
-    handleToReturn_ = node->handle_;
-    return node;
+  if( identifier.empty() ) {
+    if( emptyIdHandle_ == std::numeric_limits< Handle >::max() )
+      emptyIdHandle_ = handlePool_++;
+    return emptyIdHandle_;
   }
 
-  // Powroty rekurencyjne - zeby byc scislym, wartosci przez nie zwracane -
-  // sluza do powiazania wezlow drzewa. Nowo powstale wezly (znajdujace sie
-  // na stosie wywolan), sa kolejno sprzezne, tworzac tym samym prawidlowa
-  // strukture drzewa poszukiwan.
-  // Kwestia do rozpatrzenia jest uzycie sprytnych wskaznikow. 
-  // Najprawdopodobniej powoduja one spadek efektywnosciowy algorytmu,
-  // podczas przypisan zwracanych odwolan do wezlow. Powodem zanizenia
-  // czasu wykonania sa naprzemienne wywolania dekstruktow, konstruktorow
-  // operatora przypisania. Jednak dopoki nie zostana wykonane testy empiryczne,
-  // za posrednictwem programu profilujacego, stwierdzenie, iz stosunek korzysci
-  // plynacej z uzycia sprytnych wskaznikow w celu automatyzacji kopiowania
-  // (oraz bezpiecznej obslugi w wypadku powstania sytuacji wyjatkowych), 
-  // do wartosci zmniejszenia wydajnosci implementacji, jest niedopuszczalny,
-  // dopoty kwestia ta nie bedzie wplywac na realizacje algorytmu, oraz jego
-  // struktury
-
-  if( symbol < node->symbol_ ) {
-    node->left_ = NodeValuePtr(
-      generateHandle( node->left_, currSymbol, endSymbol ) );
-  }
+  StringConstItor  currSymbol = identifier.begin();
+  StringConstItor  lastSymbol = identifier.end() - 1;
+
+  // Sciezka jest budowana iteracyjnie. Dowiazania przechowuja indeksy,
+  // a nie adresy wezlow, wiec realokacja tablicy podczas dolaczania
+  // kolejnych elementow nie uniewaznia zadnego z nich - po kazdym
+  // appendNode() wezel jest ponownie odczytywany poprzez indeks
+
+  if( nodes_.empty() )
+    appendNode( *currSymbol );
+
+  NodeIndex  node = 0;
+  for( ;; ) {
+    const SymbolChar  symbol = nodes_[ node ].symbol_;
+    NodeIndex         next;
+
+    if( *currSymbol < symbol ) {
+      next = nodes_[ node ].left_;
+      if( next == NO_NODE ) {
+        next = appendNode( *currSymbol );
+        nodes_[ node ].left_ = next;
+      }
+    }
+    else if( *currSymbol > symbol ) {
+      next = nodes_[ node ].right_;
+      if( next == NO_NODE ) {
+        next = appendNode( *currSymbol );
+        nodes_[ node ].right_ = next;
+      }
+    }
+    else {
+      if( currSymbol == lastSymbol )
+        break;
+
+      ++currSymbol;
+      next = nodes_[ node ].middle_;
+      if( next == NO_NODE ) {
+        next = appendNode( *currSymbol );
+        nodes_[ node ].middle_ = next;
+      }
+    }
 
-  if( symbol == node->symbol_ ) {
-    node->middle_ = NodeValuePtr( 
-      generateHandle( node->middle_, ++currSymbol, endSymbol ) );
+    node = next;
   }
 
-  if( symbol > node->symbol_ ) {
-    node->right_ = NodeValuePtr(
-      generateHandle( node->right_, currSymbol, endSymbol ) );
+  // Wezel ostatniego znaku symbolu przechowuje przypisany mu uchwyt.
+  // Gdy dany ciag znakow jest nowym zbiorem uporzadkowanych elementow,
+  // musimy wygenerowac nowa wartosc
+
+  if( !nodes_[ node ].isHandleAvaible() )
+    nodes_[ node ].handle_ = handlePool_++;
+  return nodes_[ node ].handle_;
+}
+
+//
+template< typename CHARACTER, typename HANDLE >
+typename SymbolTST< CHARACTER, HANDLE >::NodeIndex
+SymbolTST< CHARACTER, HANDLE >
+::findNode( const String&  identifier ) const
+{
+  if( nodes_.empty() || identifier.empty() )
+    return NO_NODE;
+
+  StringConstItor  currSymbol = identifier.begin();
+  StringConstItor  lastSymbol = identifier.end() - 1;
+
+  NodeIndex  node = 0;
+  while( node != NO_NODE ) {
+    const Node&  current = nodes_[ node ];
+
+    if( *currSymbol < current.symbol_ ) {
+      node = current.left_;
+    }
+    else if( *currSymbol > current.symbol_ ) {
+      node = current.right_;
+    }
+    else {
+      if( currSymbol == lastSymbol )
+        return node;
+
+      ++currSymbol;
+      node = current.middle_;
+    }
   }
 
-  return node;
+  return NO_NODE;
 }
 
 //
 template< typename CHARACTER, typename HANDLE >
 bool
 SymbolTST< CHARACTER, HANDLE >
-::isIdMapped( const String& identifier )
+::isIdMapped( const String& identifier ) const
 {
-  const size_t FIRST_ID_CHARACTER = 0;
-  return checkId( identifier, FIRST_ID_CHARACTER, head_ );
+  if( identifier.empty() )
+    return emptyIdHandle_ != std::numeric_limits< Handle >::max();
+
+  const NodeIndex  node = findNode( identifier );
+  return node != NO_NODE && nodes_[ node ].isHandleAvaible();
 }
 
 //
 template< typename CHARACTER, typename HANDLE >
 bool
 SymbolTST< CHARACTER, HANDLE >
-::checkId( const String&  identifier,
-           size_t         charIndex,
-           NodeValuePtr&  node )
+::findHandle( const String&  identifier,
+              Handle*        handle ) const
 {
-  if( node.empty() ) 
+  if( identifier.empty() ) {
+    if( emptyIdHandle_ == invalidHandle() )
+      return false;
+
+    *handle = emptyIdHandle_;
+    return true;
+  }
+
+  const NodeIndex  node = findNode( identifier );
+  if( node == NO_NODE || !nodes_[ node ].isHandleAvaible() )
     return false;
 
-  if( charIndex == identifier.size() &&
-    node->isHandleAvaible() )
+  *handle = nodes_[ node ].handle_;
+  return true;
+}
+
+//
+template< typename CHARACTER, typename HANDLE >
+template< typename ID_ITOR, typename HANDLE_ITOR >
+size_t
+SymbolTST< CHARACTER, HANDLE >
+::findHandles( ID_ITOR      firstId,
+               ID_ITOR      lastId,
+               HANDLE_ITOR  handles ) const
+{
+  typedef std::pair< const String*, size_t >  IdPosition;
+
+  std::vector< IdPosition >  ids;
+  for( size_t position = 0; firstId != lastId; ++firstId, ++position )
+    ids.push_back( IdPosition( &*firstId, position ) );
+
+  std::sort( ids.begin(), ids.end(), IdLess() );
+
+  // Element resume[ depth ] jest wezlem, od ktorego rozpoczyna sie
+  // dopasowanie znaku o indeksie depth biezacego identyfikatora.
+  // Identyfikatory sa posortowane, wiec kolejny z nich dzieli
+  // z poprzednim przedrostek o dlugosci lcp - poszukiwanie jest
+  // kontynuowane od wezla resume[ lcp ], bez ponownego przechodzenia
+  // od korzenia
+
+  std::vector< Handle >     results( ids.size(), invalidHandle() );
+  std::vector< NodeIndex >  resume( 1, nodes_.empty() ? NodeIndex( NO_NODE ) : 0 );
+  const String*             previous = 0;
+  size_t                    mappedCount = 0;
+
+  for( typename std::vector< IdPosition >::const_iterator itor = ids.begin();
+    itor != ids.end(); ++itor )
   {
-    return true;
+    const String&  identifier = *itor->first;
+
+    if( identifier.empty() ) {
+      results[ itor->second ] = emptyIdHandle_;
+      continue;
+    }
+
+    size_t  depth = 0;
+    if( previous != 0 ) {
+      const size_t  maxDepth = std::min( previous->size(), identifier.size() );
+      while( depth < maxDepth && ( *previous )[ depth ] == identifier[ depth ] )
+        ++depth;
+    }
+    depth = std::min( depth, resume.size() - 1 );
+    resume.resize( depth + 1 );
+    previous = &identifier;
+
+    NodeIndex  node = resume[ depth ];
+    while( node != NO_NODE ) {
+      const Node&  current = nodes_[ node ];
+
+      if( identifier[ depth ] < current.symbol_ ) {
+        node = current.left_;
+      }
+      else if( identifier[ depth ] > current.symbol_ ) {
+        node = current.right_;
+      }
+      else {
+        if( depth == identifier.size() - 1 ) {
+          results[ itor->second ] = current.handle_;
+          break;
+        }
+
+        ++depth;
+        node = current.middle_;
+        resume.push_back( node );
+      }
+    }
   }
 
-  if( identifier[charIndex] < node->symbol_ ) {
-    return checkId( identifier, charIndex, node->left_ );
+  for( typename std::vector< Handle >::const_iterator result = results.begin();
+    result != results.end(); ++result )
+  {
+    if( *result != invalidHandle() )
+      ++mappedCount;
+    *handles++ = *result;
   }
-  else if( identifier[charIndex] == node->symbol_ ) {
-    return checkId( identifier, charIndex + 1, node->middle_ );
+
+  return mappedCount;
+}
+
+//
+template< typename CHARACTER, typename HANDLE >
+bool
+SymbolTST< CHARACTER, HANDLE >
+::longestPrefixMatch( const String&  identifier,
+                      size_t*        prefixLength,
+                      Handle*        handle ) const
+{
+  bool  matched = false;
+
+  if( emptyIdHandle_ != invalidHandle() ) {
+    *prefixLength = 0;
+    *handle       = emptyIdHandle_;
+    matched       = true;
+  }
+
+  NodeIndex  node      = nodes_.empty() ? NodeIndex( NO_NODE ) : 0;
+  size_t     charIndex = 0;
+
+  while( node != NO_NODE && charIndex < identifier.size() ) {
+    const Node&  current = nodes_[ node ];
+
+    if( identifier[ charIndex ] < current.symbol_ ) {
+      node = current.left_;
+    }
+    else if( identifier[ charIndex ] > current.symbol_ ) {
+      node = current.right_;
+    }
+    else {
+      ++charIndex;
+      if( current.isHandleAvaible() ) {
+        *prefixLength = charIndex;
+        *handle       = current.handle_;
+        matched       = true;
+      }
+      node = current.middle_;
+    }
+  }
+
+  return matched;
+}
+
+//
+template< typename CHARACTER, typename HANDLE >
+template< typename VISITOR >
+VISITOR
+SymbolTST< CHARACTER, HANDLE >
+::forEachWithPrefix( const String&  prefix,
+                     VISITOR        visitor ) const
+{
+  String  suffix;
+
+  if( prefix.empty() ) {
+    if( emptyIdHandle_ != invalidHandle() )
+      visitor( suffix, emptyIdHandle_ );
+    if( !nodes_.empty() )
+      visitSubtree( 0, &suffix, visitor );
+    return visitor;
+  }
+
+  const NodeIndex  node = findNode( prefix );
+  if( node == NO_NODE )
+    return visitor;
+
+  if( nodes_[ node ].isHandleAvaible() )
+    visitor( suffix, nodes_[ node ].handle_ );
+  if( nodes_[ node ].middle_ != NO_NODE )
+    visitSubtree( nodes_[ node ].middle_, &suffix, visitor );
+
+  return visitor;
+}
+
+//
+template< typename CHARACTER, typename HANDLE >
+template< typename VISITOR >
+void
+SymbolTST< CHARACTER, HANDLE >
+::visitSubtree( NodeIndex  node,
+                String*    suffix,
+                VISITOR&   visitor ) const
+{
+  const Node&  current = nodes_[ node ];
+
+  if( current.left_ != NO_NODE )
+    visitSubtree( current.left_, suffix, visitor );
+
+  suffix->push_back( current.symbol_ );
+  if( current.isHandleAvaible() )
+    visitor( *suffix, current.handle_ );
+  if( current.middle_ != NO_NODE )
+    visitSubtree( current.middle_, suffix, visitor );
+  suffix->erase( suffix->size() - 1 );
+
+  if( current.right_ != NO_NODE )
+    visitSubtree( current.right_, suffix, visitor );
+}
+
+//
+template< typename CHARACTER, typename HANDLE >
+void
+SymbolTST< CHARACTER, HANDLE >
+::freeze()
+{
+  if( nodes_.empty() )
+    return;
+
+  // Przejscie wzdluzne z jawnym stosem (glebokosc drzewa jest rzedu
+  // dlugosci najdluzszego symbolu, lecz zdegenerowane galezie boczne
+  // moglyby przepelnic stos wywolan). Srodkowy potomek jest odkladany
+  // jako ostatni, wiec zostaje pobrany bezposrednio po rodzicu
+
+  std::vector< NodeIndex >  newIndex( nodes_.size(), NO_NODE );
+  std::vector< NodeIndex >  pending;
+  Nodes                     ordered;
+
+  ordered.reserve( nodes_.size() );
+  pending.push_back( 0 );
+
+  while( !pending.empty() ) {
+    const NodeIndex  node = pending.back();
+    pending.pop_back();
+
+    newIndex[ node ] = static_cast< NodeIndex >( ordered.size() );
+    ordered.push_back( nodes_[ node ] );
+
+    const Node&  current = nodes_[ node ];
+    if( current.right_ != NO_NODE )
+      pending.push_back( current.right_ );
+    if( current.left_ != NO_NODE )
+      pending.push_back( current.left_ );
+    if( current.middle_ != NO_NODE )
+      pending.push_back( current.middle_ );
   }
-  else {
-    return checkId( identifier, charIndex, node->right_ );
+
+  for( typename Nodes::iterator itor = ordered.begin();
+    itor != ordered.end(); ++itor )
+  {
+    if( itor->left_ != NO_NODE )
+      itor->left_ = newIndex[ itor->left_ ];
+    if( itor->middle_ != NO_NODE )
+      itor->middle_ = newIndex[ itor->middle_ ];
+    if( itor->right_ != NO_NODE )
+      itor->right_ = newIndex[ itor->right_ ];
   }
+
+  nodes_.swap( ordered );
 }
 
 } // namespace Utilities
 } // namespace Gcad
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,220 @@
+/***************************************************************************
+ *   Copyright (C) 2005 by Eryk Klebanski                                  *
+ *   rixment@gmail.com                                                     *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+
+#ifndef _GCAD_THREAD_H_
+#define _GCAD_THREAD_H_
+
+#include "GcadBase.h"
+#include "GcadException.h"
+#include <string>
+
+namespace Gcad {
+namespace Platform {
+
+/**
+  @brief
+    Wyjatek zglaszany w przypadku niepowodzenia utworzenia watku,
+    badz obiektu synchronizacji
+*/
+class GCAD_EXPORT ThreadException : public Utilities::Exception {
+ public:
+   ThreadException(const std::string& exceptInfo)
+     : Utilities::Exception( exceptInfo )
+   {}
+};
+
+/**
+  @brief
+    Muteks chroniacy dane wspoldzielone przez watki. Implementacja jest
+    zalezna od platformy (POSIX - pthread_mutex_t, Win32 - sekcja krytyczna)
+
+  @remark
+    Muteks nie jest rekurencyjny - ponowne zajecie przez watek, ktory
+    go posiada prowadzi do zakleszczenia
+*/
+class GCAD_EXPORT Mutex {
+ public:
+   /**
+     @exception
+       ThreadException Niepowodzenie utworzenia obiektu systemowego
+   */
+   Mutex();
+   ~Mutex();
+
+   void lock();
+   void unlock();
+
+ private:
+   friend class ConditionVariable;
+
+   void*  handle_;  /**< Obiekt systemowy */
+
+ private:
+   // nie zaimplementowane
+   Mutex( const Mutex& );
+   Mutex& operator =( const Mutex& );
+};
+
+/**
+  @brief
+    Zajecie muteksu na czas istnienia obiektu (idiom RAII)
+
+  @code
+    {
+      MutexLock lock( mutex );
+      // ...
+    } // zwolnienie muteksu
+  @endcode
+*/
+class MutexLock {
+ public:
+   explicit MutexLock( Mutex& mutex ) : mutex_( mutex ) { mutex_.lock(); }
+   ~MutexLock() { mutex_.unlock(); }
+
+ private:
+   Mutex&  mutex_;
+
+ private:
+   // nie zaimplementowane
+   MutexLock( const MutexLock& );
+   MutexLock& operator =( const MutexLock& );
+};
+
+/**
+  @brief
+    Zmienna warunkowa - oczekiwanie watku na zdarzenie sygnalizowane
+    przez inny watek
+
+  @remark
+    Metoda wait() moze powrocic bez sygnalu (ang. spurious wakeup),
+    dlatego warunek nalezy sprawdzac w petli
+*/
+class GCAD_EXPORT ConditionVariable {
+ public:
+   /**
+     @exception
+       ThreadException Niepowodzenie utworzenia obiektu systemowego
+   */
+   ConditionVariable();
+   ~ConditionVariable();
+
+   /**
+     @brief
+       Zwolnienie muteksu (zajetego przez watek wywolujacy) i oczekiwanie
+       na sygnal. Przed powrotem muteks zostaje ponownie zajety
+   */
+   void wait( Mutex& mutex );
+
+   /**
+     @brief
+       Obudzenie jednego z oczekujacych watkow
+   */
+   void notifyOne();
+
+   /**
+     @brief
+       Obudzenie wszystkich oczekujacych watkow
+   */
+   void notifyAll();
+
+ private:
+   void*  handle_;  /**< Obiekt systemowy */
+
+ private:
+   // nie zaimplementowane
+   ConditionVariable( const ConditionVariable& );
+   ConditionVariable& operator =( const ConditionVariable& );
+};
+
+/**
+  @brief
+    Watek systemowy wykonujacy funkcje routine z argumentem argument.
+    Watek rozpoczyna dzialanie w konstruktorze, a destruktor oczekuje
+    na jego zakonczenie (o ile nie nastapilo wczesniej wywolanie join())
+
+  @code
+    void work( void* argument );
+
+    Thread worker( &work, &data );
+    // ...
+    worker.join();
+  @endcode
+*/
+class GCAD_EXPORT Thread {
+ public:
+   typedef void (*Routine)( void* argument );
+
+   /**
+     @exception
+       ThreadException Niepowodzenie utworzenia watku
+   */
+   Thread( Routine  routine,
+           void*    argument );
+
+   ~Thread();
+
+   /**
+     @brief
+       Oczekiwanie na zakonczenie funkcji watku
+   */
+   void join();
+
+   /**
+     @brief
+       Liczba watkow wykonywanych jednoczesnie przez sprzet (co najmniej 1)
+   */
+   static unsigned int hardwareConcurrency();
+
+ private:
+   void*  handle_;  /**< Obiekt systemowy */
+   bool   joined_;  /**< Watek zostal juz dolaczony */
+
+ private:
+   // nie zaimplementowane
+   Thread( const Thread& );
+   Thread& operator =( const Thread& );
+};
+
+/**
+  @brief
+    Funkcja wywolywana przy zakonczeniu watku (patrz atThreadExit)
+*/
+typedef void (*ThreadExitRoutine)( void* argument );
+
+/**
+  @brief
+    Rejestracja funkcji routine, wywolywanej z argumentem argument
+    w chwili zakonczenia biezacego watku. Funkcje sa wywolywane w kolejnosci
+    odwrotnej do rejestracji, rowniez dla watkow nie utworzonych klasa
+    Thread. Zakonczenie procesu (powrot z funkcji main, exit) nie wywoluje
+    funkcji zarejestrowanych przez watek glowny
+
+  @remark
+    Implementacja jest zalezna od platformy (POSIX - klucz pthread_key_t
+    z destruktorem, Win32 - indeks FLS z funkcja zwrotna)
+*/
+GCAD_EXPORT void atThreadExit( ThreadExitRoutine  routine,
+                               void*              argument );
+
+} // namespace Platform
+} // namespace Gcad
+
+#endif
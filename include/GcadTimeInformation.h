@@ -52,6 +52,15 @@ class GCAD_EXPORT TimeInformation {
        wykonanych w ciagu jednej sekundy
    */
    virtual size_t getTicksCountPerSec() const = 0;
+
+   /**
+     @brief
+       Przeliczenie odstepu pomiedzy wartosciami startTime i endTime
+       metody getSystemTime na mikrosekundy (z uwzglednieniem 
+       przepelnienia licznika)
+   */
+   size_t getElapsedMicroseconds(size_t  startTime,
+                                 size_t  endTime) const;
 };
 
 } // namespace Platform
@@ -21,6 +21,7 @@
 #ifndef _GCAD_VALUEPTR_H_
 #define _GCAD_VALUEPTR_H_
 
+#include "GcadBase.h"
 #include "GcadAssertion.h"
 #include <utility>
 
@@ -171,6 +172,28 @@ class ValuePtr {
      return *this;
    }
 
+#ifdef GCAD_HAS_RVALUE_REFERENCES
+   /**
+     @brief
+       Konstruktor przenoszacy - zasob zmienia wlasciciela bez tworzenia
+       kopii (ValuePtrTriats::clone nie jest wywolywane)
+   */
+   ValuePtr( ValuePtr&& rhs )
+     : ptr_( rhs.ptr_ )
+   {
+     rhs.ptr_ = 0;
+   }
+
+   /**
+     @brief Przypisanie przenoszace
+   */
+   ValuePtr& operator =( ValuePtr&& rhs ) {
+     ValuePtr temp( static_cast< ValuePtr&& >( rhs ) );
+     swap( temp );
+     return *this;
+   }
+#endif
+
    /**
      @brief 
        Szablonowa wersja konstruktora kopiujacego
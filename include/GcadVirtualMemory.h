@@ -0,0 +1,109 @@
+/***************************************************************************
+ *   Copyright (C) 2005 by Eryk Klebanski                                  *
+ *   rixment@gmail.com                                                     *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef _GCAD_VIRTUALMEMORY_H_
+#define _GCAD_VIRTUALMEMORY_H_
+
+#include "GcadBase.h"
+#include <cstddef>
+
+namespace Gcad {
+namespace Platform {
+
+/**
+  @brief
+    Rodzaj stron pamieci wykorzystywanych przez zarezerwowany obszar
+
+  @remark
+    Jesli system nie udostepnia zadanego rodzaju stron (lub pula jawnych
+    duzych stron zostala wyczerpana), wowczas zatwierdzany fragment
+    otrzymuje strony standardowe. Adresy, oraz rozmiary fragmentow
+    zatwierdzanych z duzymi stronami powinny byc wielokrotnoscia
+    hugePageSize()
+*/
+enum PageMode {
+  STANDARD_PAGES,          /**< Strony o domyslnym rozmiarze */
+  TRANSPARENT_HUGE_PAGES,  /**< Sugestia uzycia duzych stron (madvise) */
+  EXPLICIT_HUGE_PAGES      /**< Jawne duze strony (MAP_HUGETLB) */
+};
+
+/**
+  @brief
+    Rozmiar standardowej strony pamieci wirtualnej wyrazony w bajtach
+*/
+GCAD_EXPORT size_t virtualPageSize();
+
+/**
+  @brief
+    Rozmiar duzej strony pamieci wirtualnej wyrazony w bajtach. Wartosc
+    jest zgodna z virtualPageSize(), gdy system nie obsluguje duzych stron
+*/
+GCAD_EXPORT size_t hugePageSize();
+
+/**
+  @brief
+    Rezerwacja ciaglego zakresu przestrzeni adresowej, bez przydzialu
+    pamieci fizycznej. Dostep do zarezerwowanego obszaru jest niemozliwy,
+    dopoki jego fragmenty nie zostana zatwierdzone funkcja commitMemory()
+
+  @param bytesCount Wielkosc zakresu (wielokrotnosc rozmiaru strony)
+  @param pageMode Rodzaj stron wykorzystywanych przez zakres
+
+  @return
+    Adres poczatku zakresu, badz zero w przypadku niepowodzenia
+
+  @remark
+    Kolejne funkcje operujace na zakresie musza otrzymac ten sam tryb stron
+*/
+GCAD_EXPORT void* reserveAddressRange( size_t    bytesCount,
+                                       PageMode  pageMode );
+
+/**
+  @brief
+    Zatwierdzenie fragmentu zarezerwowanego zakresu - obszar staje sie
+    dostepny do zapisu i odczytu
+
+  @return
+    Wartosc false w przypadku braku pamieci fizycznej
+*/
+GCAD_EXPORT bool commitMemory( void*     address,
+                               size_t    bytesCount,
+                               PageMode  pageMode );
+
+/**
+  @brief
+    Zwrot pamieci fizycznej fragmentu zakresu do systemu. Zakres adresow
+    pozostaje zarezerwowany i moze zostac ponownie zatwierdzony
+*/
+GCAD_EXPORT void decommitMemory( void*     address,
+                                 size_t    bytesCount,
+                                 PageMode  pageMode );
+
+/**
+  @brief
+    Zwolnienie calego zakresu zarezerwowanego funkcja reserveAddressRange()
+*/
+GCAD_EXPORT void releaseAddressRange( void*   address,
+                                      size_t  bytesCount );
+
+} // namespace Platform
+} // namespace Gcad
+
+#endif
@@ -0,0 +1,161 @@
+/***************************************************************************
+ *   Copyright (C) 2005 by Eryk Klebanski                                  *
+ *   rixment@gmail.com                                                     *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef _GCAD_WEAKREFPTR_H_
+#define _GCAD_WEAKREFPTR_H_
+
+#include "GcadAtomicRefCountPtr.h"
+
+namespace Gcad {
+namespace Utilities {
+
+/**
+  @brief
+    Slabe (nie posiadajace) odniesienie do obiektu kontrolowanego
+    przez AtomicRefCountPtr
+
+    Istnienie slabego odniesienia nie przedluza czasu zycia obiektu.
+    Dostep do obiektu wymaga uzyskania silnego odniesienia metoda lock(),
+    ktora zwraca wskaznik pusty, jesli obiekt zostal juz zniszczony.
+    Pamiec podreczna zasobow (np. DataFileResourceManager,
+    AssociativeManager) moze w ten sposob wskazywac zaladowane modele,
+    nie wstrzymujac ich zwolnienia
+
+  @remark
+    Metoda lock() jest bezpieczna wzgledem watkow zwalniajacych ostatnie
+    silne odniesienie - zwiekszenie licznika odbywa sie tylko wtedy, gdy
+    jego wartosc jest niezerowa
+*/
+template< typename T,
+          typename DELETER = DeleteObject< T > >
+class WeakRefPtr {
+ public:
+   typedef AtomicRefCountPtr< T, DELETER >  StrongPtr;
+
+   WeakRefPtr()
+     : ptr_( 0 )
+     , counts_( 0 )
+   {}
+
+   WeakRefPtr( const StrongPtr& strong )
+     : ptr_( strong.ptr_ )
+     , counts_( strong.counts_ )
+   {
+     if( counts_ )
+       atomicIncrement( &counts_->weak_ );
+   }
+
+   WeakRefPtr( const WeakRefPtr& that )
+     : ptr_( that.ptr_ )
+     , counts_( that.counts_ )
+   {
+     if( counts_ )
+       atomicIncrement( &counts_->weak_ );
+   }
+
+   ~WeakRefPtr() { reset(); }
+
+   WeakRefPtr& operator =( const WeakRefPtr& rhs )
+   {
+     WeakRefPtr( rhs ).swap( *this );
+     return *this;
+   }
+
+   WeakRefPtr& operator =( const StrongPtr& rhs )
+   {
+     WeakRefPtr( rhs ).swap( *this );
+     return *this;
+   }
+
+   /**
+     @brief
+       Uzyskanie silnego odniesienia. Wskaznik jest pusty, gdy obiekt
+       zostal juz zniszczony
+   */
+   StrongPtr lock() const;
+
+   /**
+     @brief
+       Czy obiekt zostal juz zniszczony
+   */
+   bool expired() const
+   {
+     return counts_ == 0 || atomicLoad( &counts_->strong_ ) == 0;
+   }
+
+   /**
+     @brief
+       Zerwanie odniesienia
+   */
+   void reset();
+
+   void swap( WeakRefPtr& that )
+   {
+     std::swap( ptr_, that.ptr_ );
+     std::swap( counts_, that.counts_ );
+   }
+
+ private:
+   T*                ptr_;
+   AtomicRefCounts*  counts_;
+};
+
+
+//
+template< typename T, typename DELETER > 
+typename WeakRefPtr< T, DELETER >::StrongPtr
+WeakRefPtr< T, DELETER >
+::lock() const
+{
+  if( counts_ == 0 )
+    return StrongPtr();
+
+  // Inkrementacja warunkowa - licznik rowny zeru oznacza, iz obiekt
+  // jest wlasnie niszczony (badz zostal juz zniszczony)
+  long strong = atomicLoad( &counts_->strong_ );
+  while( strong != 0 ) {
+    const long PREVIOUS = 
+      atomicCompareExchange( &counts_->strong_, strong + 1, strong );
+
+    if( PREVIOUS == strong )
+      return StrongPtr( ptr_, counts_ );
+
+    strong = PREVIOUS;
+  }
+  return StrongPtr();
+}
+
+//
+template< typename T, typename DELETER > 
+void
+WeakRefPtr< T, DELETER >
+::reset()
+{
+  if( counts_ && atomicDecrement( &counts_->weak_ ) == 0 )
+    delete counts_;
+
+  ptr_    = 0;
+  counts_ = 0;
+}
+
+} // namespace Utilities
+} // namespace Gcad
+
+#endif
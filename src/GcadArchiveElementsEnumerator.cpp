@@ -0,0 +1,143 @@
+/***************************************************************************
+ *   Copyright (C) 2005 by Eryk Klebanski                                  *
+ *   rixment@gmail.com                                                     *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+
+#include "GcadArchiveElementsEnumerator.h"
+#include "GcadAssertion.h"
+
+namespace Gcad {
+namespace Platform {
+
+  // IMPLEMENTACJA ITERATORA GLOWNEJ STRUKTURY
+
+ArchiveElementsEnumerator::Itor 
+::Itor(const ArchiveElementsEnumerator& owner)
+  : owner_(owner)
+  , entry_(0)
+  , directory_(false)
+  , valid_(false)
+{
+  moveToBegin();
+}
+
+bool
+ArchiveElementsEnumerator::Itor 
+::isDirectory() const
+{
+  return directory_;
+}
+
+std::string
+ArchiveElementsEnumerator::Itor 
+::getElementName() const
+{
+  return element_;
+}
+
+bool
+ArchiveElementsEnumerator::Itor 
+::moveToNextElement()
+{
+  // Wpisy podkatalogu zajmuja ciagly zakres posortowanego spisu, wiec 
+  // sa pomijane jednym wyszukiwaniem binarnym - znak ']' nastepuje 
+  // bezposrednio po '\\', zatem nazwa "katalog]" jest wieksza od nazw
+  // wszystkich wpisow podkatalogu
+
+  Utilities::assertion(valid_, "Iterator nie ustawiony!");
+
+  if( directory_ )
+    entry_ = owner_.archive_->lowerBound(prefix_ + element_ + "]");
+  else
+    ++entry_;
+
+  readElement();
+  return valid_;
+}
+
+bool
+ArchiveElementsEnumerator::Itor 
+::isValid() const
+{
+  return valid_;
+}
+
+void
+ArchiveElementsEnumerator::Itor 
+::moveToBegin()
+{
+  prefix_ = owner_.baseDir_.empty() ? std::string() : owner_.baseDir_ + "\\";
+  entry_  = owner_.archive_->lowerBound(prefix_);
+  readElement();
+}
+
+void
+ArchiveElementsEnumerator::Itor 
+::readElement()
+{
+  valid_ = false;
+
+  if( entry_ >= owner_.archive_->entriesCount() )
+    return;
+
+  const std::string NAME = owner_.archive_->entryName(entry_);
+  if( NAME.compare(0, prefix_.size(), prefix_) != 0 )
+    return;
+
+  const std::string::size_type SEPARATOR = NAME.find('\\', prefix_.size());
+
+  directory_ = SEPARATOR != std::string::npos;
+  element_   = NAME.substr(prefix_.size(), directory_ ? 
+    SEPARATOR - prefix_.size() : std::string::npos);
+  valid_     = true;
+}
+
+  // IMPLEMENTACJA GLOWNEGO OBIEKTU ZARZADZAJACEGO
+    
+ArchiveElementsEnumerator
+::ArchiveElementsEnumerator(const ResourceArchive&  archive,
+                            const std::string&      directory) 
+  : archive_(&archive)
+  , baseDir_(directory)
+{
+}
+
+ArchiveElementsEnumerator* 
+ArchiveElementsEnumerator
+::clone() const
+{
+  return new ArchiveElementsEnumerator(*archive_, baseDir_);
+}
+
+ArchiveElementsEnumerator::ItorAutoPtr 
+ArchiveElementsEnumerator
+::getItor() const
+{
+  return ItorAutoPtr( new Itor(*this) );
+}
+
+void 
+ArchiveElementsEnumerator
+::setDirectory(const std::string& newDirectory) 
+{
+  baseDir_ = newDirectory;
+}
+   
+} // namespace Platform
+} // namespace Gcad
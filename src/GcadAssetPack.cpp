@@ -0,0 +1,246 @@
+/***************************************************************************
+ *   Copyright (C) 2005 by Eryk Klebanski                                  *
+ *   rixment@gmail.com                                                     *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+
+#include "GcadAssetPack.h"
+#include <algorithm>
+#include <cstring>
+
+namespace Gcad {
+namespace Platform {
+
+//
+AssetPack::UInt32
+AssetPack::hashName(const char* name, size_t length)
+{
+  UInt32 hash = 2166136261u;
+  for(size_t i = 0; i < length; ++i) {
+    hash ^= static_cast<unsigned char>(name[i]);
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+//
+AssetPack::AssetPack()
+  : header_(0)
+  , entries_(0)
+  , slots_(0)
+  , names_(0)
+{
+}
+
+//
+bool
+AssetPack::open(const std::string& path)
+{
+  close();
+
+  if( !file_.map(path) )
+    return false;
+
+  if( !validate() ) {
+    close();
+    return false;
+  }
+
+  return true;
+}
+
+//
+void
+AssetPack::close()
+{
+  file_.unmap();
+  header_  = 0;
+  entries_ = 0;
+  slots_   = 0;
+  names_   = 0;
+}
+
+//
+bool
+AssetPack::validate()
+{
+  // Wartosci naglowka i wpisow pochodza z pliku, wiec kazde przesuniecie
+  // jest sprawdzane przed pierwszym uzyciem. Po pomyslnej weryfikacji
+  // find() oraz entryBytes() nie wykonuja juz zadnych sprawdzen
+
+  const Utilities::ByteSpan BYTES = file_.bytes();
+
+  if( sizeof(UInt32) != 4 || !BYTES.contains(0, sizeof(Header)) )
+    return false;
+
+  const Header* header = reinterpret_cast<const Header*>(BYTES.data());
+
+  if( std::memcmp(header->magic_, "GPAK", 4) != 0 ||
+    header->version_ != VERSION )
+  {
+    return false;
+  }
+
+  const size_t ENTRIES_COUNT = header->entriesCount_;
+  const size_t SLOTS_COUNT   = header->slotsCount_;
+
+  // Tablica musi zawierac co najmniej jedno wolne pole (zakonczenie
+  // sondowania), a jej rozmiar byc potega dwojki (maskowanie indeksu)
+  if( SLOTS_COUNT <= ENTRIES_COUNT || (SLOTS_COUNT & (SLOTS_COUNT - 1)) != 0 )
+    return false;
+
+  if( header->entriesOffset_ % sizeof(UInt32) != 0 ||
+    header->slotsOffset_ % sizeof(UInt32) != 0 ||
+    ENTRIES_COUNT > BYTES.size() / sizeof(Entry) ||
+    SLOTS_COUNT > BYTES.size() / sizeof(UInt32) ||
+    !BYTES.contains(header->entriesOffset_, ENTRIES_COUNT * sizeof(Entry)) ||
+    !BYTES.contains(header->slotsOffset_, SLOTS_COUNT * sizeof(UInt32)) ||
+    !BYTES.contains(header->namesOffset_, header->namesSize_) )
+  {
+    return false;
+  }
+
+  const Entry* entries = reinterpret_cast<const Entry*>(
+    BYTES.data() + header->entriesOffset_ );
+  const UInt32* slots = reinterpret_cast<const UInt32*>(
+    BYTES.data() + header->slotsOffset_ );
+  const Utilities::ByteSpan NAMES =
+    BYTES.subspan(header->namesOffset_, header->namesSize_);
+
+  for(size_t entry = 0; entry < ENTRIES_COUNT; ++entry)
+  {
+    const Entry& ENTRY = entries[entry];
+    if( !NAMES.contains(ENTRY.nameOffset_, ENTRY.nameLength_) ||
+      !BYTES.contains(ENTRY.dataOffset_, ENTRY.dataSize_) )
+    {
+      return false;
+    }
+  }
+
+  for(size_t slot = 0; slot < SLOTS_COUNT; ++slot)
+    if( slots[slot] > ENTRIES_COUNT )
+      return false;
+
+  header_  = header;
+  entries_ = entries;
+  slots_   = slots;
+  names_   = reinterpret_cast<const char*>(NAMES.data());
+
+  // Wyliczanie katalogow (lowerBound) wymaga posortowanego spisu
+  for(size_t entry = 1; entry < ENTRIES_COUNT; ++entry)
+    if( compareName(entry, entryName(entry - 1)) <= 0 )
+      return false;
+
+  return true;
+}
+
+//
+size_t
+AssetPack::entriesCount() const
+{
+  return isOpen() ? header_->entriesCount_ : 0;
+}
+
+//
+int
+AssetPack::compareName(size_t index, const std::string& name) const
+{
+  const Entry& ENTRY = entries_[index];
+  const size_t COMMON = std::min<size_t>(ENTRY.nameLength_, name.size());
+
+  const int RESULT = std::memcmp(names_ + ENTRY.nameOffset_, name.data(),
+    COMMON);
+  if( RESULT != 0 )
+    return RESULT;
+
+  if( ENTRY.nameLength_ == name.size() )
+    return 0;
+
+  return ENTRY.nameLength_ < name.size() ? -1 : 1;
+}
+
+//
+bool
+AssetPack::find(const std::string& name, Utilities::ByteSpan* bytes) const
+{
+  if( !isOpen() )
+    return false;
+
+  const UInt32 HASH = hashName(name.data(), name.size());
+  const UInt32 MASK = header_->slotsCount_ - 1;
+
+  for(UInt32 probe = 0, slot = HASH & MASK;
+    probe <= MASK;
+    ++probe, slot = (slot + 1) & MASK)
+  {
+    if( slots_[slot] == 0 )
+      return false;
+
+    const size_t ENTRY = slots_[slot] - 1;
+    if( entries_[ENTRY].nameHash_ == HASH && compareName(ENTRY, name) == 0 ) {
+      *bytes = entryBytes(ENTRY);
+      return true;
+    }
+  }
+
+  return false;
+}
+
+//
+std::string
+AssetPack::entryName(size_t index) const
+{
+  Utilities::assertion( index < entriesCount(), "Niepoprawny indeks wpisu!" );
+
+  const Entry& ENTRY = entries_[index];
+  return std::string(names_ + ENTRY.nameOffset_, ENTRY.nameLength_);
+}
+
+//
+Utilities::ByteSpan
+AssetPack::entryBytes(size_t index) const
+{
+  Utilities::assertion( index < entriesCount(), "Niepoprawny indeks wpisu!" );
+
+  const Entry& ENTRY = entries_[index];
+  return file_.bytes().subspan(ENTRY.dataOffset_, ENTRY.dataSize_);
+}
+
+//
+size_t
+AssetPack::lowerBound(const std::string& name) const
+{
+  size_t first = 0;
+  size_t count = entriesCount();
+
+  while( count > 0 )
+  {
+    const size_t HALF = count / 2;
+    if( compareName(first + HALF, name) < 0 ) {
+      first += HALF + 1;
+      count -= HALF + 1;
+    }
+    else
+      count = HALF;
+  }
+
+  return first;
+}
+
+} // namespace Platform
+} // namespace Gcad
@@ -0,0 +1,330 @@
+/***************************************************************************
+ *   Copyright (C) 2005 by Eryk Klebanski                                  *
+ *   rixment@gmail.com                                                     *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+
+#include "GcadBatchFileReader.h"
+#include "GcadThread.h"
+#include <deque>
+#include <fstream>
+
+namespace Gcad {
+namespace Platform {
+
+namespace {
+
+/**
+  @brief
+    Czytnik zastepczy - pliki partii sa rozdzielane pomiedzy watki puli,
+    ktore odczytuja je blokujacymi strumieniami std::ifstream. Liczba
+    buforow jest ograniczona do BUFFERS_PER_THREAD na watek: bufor 
+    przekazanego wyniku wraca do puli przy kolejnym wywolaniu 
+    waitCompleted, a watek bez wolnego bufora czeka z odczytem kolejnego
+    pliku. Bufory zachowuja pojemnosc, wiec kolejne pliki korzystaja 
+    z juz przydzielonej pamieci
+*/
+class ThreadedBatchFileReader : public BatchFileReader {
+ public:
+   explicit ThreadedBatchFileReader( unsigned int threadsCount );
+   ~ThreadedBatchFileReader();
+
+   void submit( const Paths& paths );
+   bool waitCompleted( Completion* completion );
+   const char* backendName() const { return "threads"; }
+
+ private:
+   typedef std::vector< char >  Buffer;
+
+   struct Finished {
+     size_t   request_;
+     Buffer*  buffer_;
+     bool     succeeded_;
+   };
+
+   static void workerRoutine( void* reader );
+
+   void work();
+   void stop();
+
+   /**
+     @brief
+       Pobranie wolnego bufora, badz wartosc 0, gdy wszystkie bufory
+       sa zajete (wymaga zajetego muteksu)
+   */
+   Buffer* acquireBuffer();
+
+   /**
+     @brief
+       Zwrot bufora do puli (wymaga zajetego muteksu)
+   */
+   void recycleBuffer( Buffer* buffer );
+
+   /**
+     @brief
+       Odczyt pliku path do bufora (bez zajetego muteksu)
+   */
+   static bool readFile( const std::string&  path,
+                         Buffer*             buffer );
+
+ private:
+   Mutex                       mutex_;
+   ConditionVariable           wakeUp_;     /**< Nowa partia, badz koniec */
+   ConditionVariable           completed_;  /**< Zakonczenie odczytu pliku */
+   Paths                       paths_;      /**< Pliki biezacej partii */
+   std::deque< Buffer >        buffers_;    /**< Wszystkie bufory */
+   std::vector< Buffer* >      idleBuffers_;
+   Buffer*                     deliveredBuffer_; /**< Bufor odebranego wyniku */
+   size_t                      maxBuffers_;
+   std::deque< Finished >      finished_;   /**< Nieodebrane wyniki */
+   size_t                      nextRequest_;
+   size_t                      activeCount_;
+   size_t                      delivered_;
+   bool                        stopping_;
+   std::vector< Thread* >      threads_;
+};
+
+//
+ThreadedBatchFileReader
+::ThreadedBatchFileReader( unsigned int threadsCount )
+  : deliveredBuffer_( 0 )
+  , maxBuffers_( 0 )
+  , nextRequest_( 0 )
+  , activeCount_( 0 )
+  , delivered_( 0 )
+  , stopping_( false )
+{
+  // Dodatkowy bufor kazdego watku pozwala odczytywac kolejny plik
+  // w trakcie przetwarzania poprzedniego przez odbiorce wynikow
+  const size_t BUFFERS_PER_THREAD = 2;
+
+  if( threadsCount == 0 )
+    threadsCount = Thread::hardwareConcurrency();
+
+  maxBuffers_ = BUFFERS_PER_THREAD * threadsCount;
+  idleBuffers_.reserve( maxBuffers_ );
+  threads_.reserve( threadsCount );
+
+  try {
+    for( unsigned int thread = 0; thread < threadsCount; ++thread )
+      threads_.push_back( new Thread( &workerRoutine, this ) );
+  }
+  catch( ... ) {
+    stop();
+    throw;
+  }
+}
+
+//
+ThreadedBatchFileReader
+::~ThreadedBatchFileReader()
+{
+  stop();
+}
+
+//
+void ThreadedBatchFileReader
+::stop()
+{
+  {
+    MutexLock lock( mutex_ );
+    stopping_ = true;
+    wakeUp_.notifyAll();
+  }
+
+  for( size_t thread = 0; thread < threads_.size(); ++thread )
+    delete threads_[ thread ];
+  threads_.clear();
+}
+
+//
+void ThreadedBatchFileReader
+::submit( const Paths& paths )
+{
+  // Watki zapisuja bufory bez zajetego muteksu, dlatego przed zwrotem
+  // buforow do puli nalezy zaczekac na zakonczenie odczytow poprzedniej
+  // partii. Pozostale jej pliki nie sa juz przydzielane watkom
+
+  MutexLock lock( mutex_ );
+
+  nextRequest_ = paths_.size();
+  while( activeCount_ != 0 )
+    completed_.wait( mutex_ );
+
+  for( ; !finished_.empty(); finished_.pop_front() )
+    recycleBuffer( finished_.front().buffer_ );
+  recycleBuffer( deliveredBuffer_ );
+  deliveredBuffer_ = 0;
+
+  paths_ = paths;
+  nextRequest_ = 0;
+  delivered_ = 0;
+
+  wakeUp_.notifyAll();
+}
+
+//
+bool ThreadedBatchFileReader
+::waitCompleted( Completion* completion )
+{
+  // Odbiorca zakonczyl przetwarzanie poprzedniego wyniku - jego bufor
+  // moze przyjac kolejny plik
+
+  MutexLock lock( mutex_ );
+
+  recycleBuffer( deliveredBuffer_ );
+  deliveredBuffer_ = 0;
+
+  if( delivered_ == paths_.size() )
+    return false;
+
+  while( finished_.empty() )
+    completed_.wait( mutex_ );
+
+  const Finished FINISHED = finished_.front();
+  finished_.pop_front();
+  ++delivered_;
+  deliveredBuffer_ = FINISHED.buffer_;
+
+  const Buffer& BUFFER = *FINISHED.buffer_;
+  completion->request_   = FINISHED.request_;
+  completion->data_      = BUFFER.empty() ? 0 : &BUFFER[ 0 ];
+  completion->size_      = BUFFER.size();
+  completion->succeeded_ = FINISHED.succeeded_;
+  return true;
+}
+
+//
+void ThreadedBatchFileReader
+::workerRoutine( void* reader )
+{
+  static_cast< ThreadedBatchFileReader* >( reader )->work();
+}
+
+//
+void ThreadedBatchFileReader
+::work()
+{
+  for( ;; )
+  {
+    size_t request = 0;
+    std::string path;
+    Buffer* buffer = 0;
+
+    {
+      MutexLock lock( mutex_ );
+      while( !stopping_ && 
+        ( nextRequest_ >= paths_.size() || ( buffer = acquireBuffer() ) == 0 ) )
+      {
+        wakeUp_.wait( mutex_ );
+      }
+
+      if( stopping_ ) {
+        recycleBuffer( buffer );
+        return;
+      }
+
+      request = nextRequest_++;
+      path = paths_[ request ];
+      ++activeCount_;
+    }
+
+    const bool SUCCEEDED = readFile( path, buffer );
+
+    MutexLock lock( mutex_ );
+    Finished finished;
+    finished.request_   = request;
+    finished.buffer_    = buffer;
+    finished.succeeded_ = SUCCEEDED;
+    finished_.push_back( finished );
+    --activeCount_;
+    completed_.notifyAll();
+  }
+}
+
+//
+ThreadedBatchFileReader::Buffer* 
+ThreadedBatchFileReader
+::acquireBuffer()
+{
+  if( !idleBuffers_.empty() ) {
+    Buffer* buffer = idleBuffers_.back();
+    idleBuffers_.pop_back();
+    return buffer;
+  }
+
+  if( buffers_.size() < maxBuffers_ ) {
+    buffers_.push_back( Buffer() );
+    return &buffers_.back();
+  }
+
+  return 0;
+}
+
+//
+void ThreadedBatchFileReader
+::recycleBuffer( Buffer* buffer )
+{
+  if( buffer == 0 )
+    return;
+
+  idleBuffers_.push_back( buffer );
+  wakeUp_.notifyOne();
+}
+
+//
+bool ThreadedBatchFileReader
+::readFile( const std::string&  path,
+            Buffer*             buffer )
+{
+  buffer->clear();
+
+  try {
+    std::ifstream input( path.c_str(), std::ios_base::binary );
+    if( !input )
+      return false;
+
+    input.seekg( 0, std::ios_base::end );
+    const std::streamoff FILE_SIZE = input.tellg();
+    input.seekg( 0, std::ios_base::beg );
+    if( FILE_SIZE < 0 )
+      return false;
+
+    buffer->resize( static_cast< size_t >( FILE_SIZE ) );
+    if( !buffer->empty() )
+      input.read( &( *buffer )[ 0 ], FILE_SIZE );
+
+    return input.gcount() == FILE_SIZE || buffer->empty();
+  }
+  catch( ... ) {
+    buffer->clear();
+    return false;
+  }
+}
+
+} // namespace
+
+//
+BatchFileReader*
+createThreadedBatchFileReader( unsigned int threadsCount )
+{
+  return new ThreadedBatchFileReader( threadsCount );
+}
+
+} // namespace Platform
+} // namespace Gcad
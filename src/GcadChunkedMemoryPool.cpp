@@ -0,0 +1,408 @@
+/***************************************************************************
+ *   Copyright (C) 2005 by Eryk Klebanski                                  *
+ *   rixment@gmail.com                                                     *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include "GcadChunkedMemoryPool.h"
+#include "GcadAssertion.h"
+#include "GcadTimeInformation.h"
+#include <climits>
+#include <new>
+
+namespace Gcad {
+namespace Utilities {
+
+namespace {
+
+  const size_t NO_CHUNK        = static_cast< size_t >( -1 );
+  const size_t DATA_ALIGNMENT  = 16;
+
+  size_t
+  roundUp( size_t value,
+           size_t multiple )
+  {
+    return ( value + multiple - 1 ) / multiple * multiple;
+  }
+
+} // anonymous namespace
+
+ChunkedMemoryPool
+::ChunkedMemoryPool( size_t              bytesPerSegment,
+                     size_t              segmentsPerChunk,
+                     size_t              maxChunks,
+                     Platform::PageMode  pageMode )
+  : bytesPerSegment_( bytesPerSegment )
+  , segmentsPerChunk_( segmentsPerChunk )
+  , chunkBytes_( 0 )
+  , dataOffset_( 0 )
+  , pageMode_( pageMode )
+  , reservation_( 0 )
+  , reservationBytes_( 0 )
+  , chunksBegin_( 0 )
+  , committedChunks_( 0 )
+  , emptyChunks_( 0 )
+  , lastChunk_( 0 )
+  , timeInformation_( 0 )
+  , idleTicks_( 0 )
+{
+  assertion( bytesPerSegment != 0 && segmentsPerChunk != 0 && maxChunks != 0,
+    "ChunkedMemoryPool: Rozmiary puli musza byc rozne od zera!" );
+  assertion( segmentsPerChunk <= static_cast< size_t >( INT_MAX ),
+    "ChunkedMemoryPool: Zbyt duza liczba segmentow fragmentu!" );
+
+  // Uklad fragmentu: listy wolnych obszarow, opisy segmentow, dane
+  const size_t LINKS_OFFSET = roundUp( sizeof( FreeLists ), DATA_ALIGNMENT );
+  dataOffset_ = roundUp( LINKS_OFFSET + segmentsPerChunk * sizeof( InfoNode ),
+    DATA_ALIGNMENT );
+
+  const size_t GRANULARITY = pageMode == Platform::STANDARD_PAGES ?
+    Platform::virtualPageSize() :
+    Platform::hugePageSize();
+
+  chunkBytes_ = roundUp( dataOffset_ + segmentsPerChunk * bytesPerSegment,
+    GRANULARITY );
+
+  ChunkState uncommitted = { false, false, 0 };
+  chunks_.assign( maxChunks, uncommitted );
+}
+
+ChunkedMemoryPool
+::~ChunkedMemoryPool()
+{
+  if( reservation_ != 0 )
+    Platform::releaseAddressRange( reservation_, reservationBytes_ );
+}
+
+void
+ChunkedMemoryPool
+::reserve() throw( std::bad_alloc )
+{
+  // Nadmiarowa rezerwacja pozwala wyrownac poczatek pierwszego fragmentu
+  // do granicy duzej strony, co jest warunkiem ich wykorzystania
+  const size_t ALIGNMENT = pageMode_ == Platform::STANDARD_PAGES ?
+    Platform::virtualPageSize() :
+    Platform::hugePageSize();
+
+  reservationBytes_ = reservedBytes() + ALIGNMENT;
+  reservation_ = static_cast< char* >(
+    Platform::reserveAddressRange( reservationBytes_, pageMode_ ) );
+
+  if( reservation_ == 0 )
+    throw std::bad_alloc();
+
+  const size_t MISALIGNMENT =
+    reinterpret_cast< size_t >( reservation_ ) % ALIGNMENT;
+  chunksBegin_ = MISALIGNMENT == 0 ?
+    reservation_ :
+    reservation_ + ( ALIGNMENT - MISALIGNMENT );
+}
+
+char*
+ChunkedMemoryPool
+::chunkBase( size_t chunkIndex ) const
+{
+  return chunksBegin_ + chunkIndex * chunkBytes_;
+}
+
+char*
+ChunkedMemoryPool
+::chunkData( size_t chunkIndex ) const
+{
+  return chunkBase( chunkIndex ) + dataOffset_;
+}
+
+ChunkedMemoryPool::FreeLists&
+ChunkedMemoryPool
+::chunkFreeLists( size_t chunkIndex ) const
+{
+  return *reinterpret_cast< FreeLists* >( chunkBase( chunkIndex ) );
+}
+
+size_t
+ChunkedMemoryPool
+::currentTime() const
+{
+  return timeInformation_ != 0 ? timeInformation_->getSystemTime() : 0;
+}
+
+bool
+ChunkedMemoryPool
+::commitChunk( size_t chunkIndex )
+{
+  char* base = chunkBase( chunkIndex );
+  if( !Platform::commitMemory( base, chunkBytes_, pageMode_ ) )
+    return false;
+
+  InfoNode* links = reinterpret_cast< InfoNode* >(
+    base + roundUp( sizeof( FreeLists ), DATA_ALIGNMENT ) );
+
+  FreeLists* freeLists = new( base ) FreeLists;
+  freeLists->reset( links, static_cast< int >( segmentsPerChunk_ ) );
+
+  ChunkState& state = chunks_[ chunkIndex ];
+  state.committed_  = true;
+  state.empty_      = true;
+  state.emptySince_ = currentTime();
+
+  ++committedChunks_;
+  ++emptyChunks_;
+  return true;
+}
+
+void
+ChunkedMemoryPool
+::decommitChunk( size_t chunkIndex )
+{
+  ChunkState& state = chunks_[ chunkIndex ];
+  if( !state.committed_ )
+    return;
+
+  Platform::decommitMemory( chunkBase( chunkIndex ), chunkBytes_, pageMode_ );
+
+  if( state.empty_ )
+    --emptyChunks_;
+
+  state.committed_ = false;
+  state.empty_     = false;
+  --committedChunks_;
+}
+
+void*
+ChunkedMemoryPool
+::takeFromChunk( size_t  chunkIndex,
+                 int     blockCount )
+{
+  const int FOUNDED_BLOCK = chunkFreeLists( chunkIndex ).take( blockCount );
+  if( FOUNDED_BLOCK == FreeLists::NO_BLOCK )
+    return 0;
+
+  ChunkState& state = chunks_[ chunkIndex ];
+  if( state.empty_ ) {
+    state.empty_ = false;
+    --emptyChunks_;
+  }
+
+  lastChunk_ = chunkIndex;
+  return chunkData( chunkIndex ) + FOUNDED_BLOCK * bytesPerSegment_;
+}
+
+void*
+ChunkedMemoryPool
+::allocate( size_t bytesCount ) throw( std::bad_alloc )
+{
+  if( reservation_ == 0 )
+    reserve();
+
+  size_t blockCount = ( bytesCount + bytesPerSegment_ - 1 ) / bytesPerSegment_;
+  if( blockCount == 0 )
+    blockCount = 1;
+
+  if( blockCount > segmentsPerChunk_ ) {
+    counters_.recordFailure( bytesCount );
+    throw std::bad_alloc();
+  }
+
+  const int BLOCK_COUNT = static_cast< int >( blockCount );
+  const size_t GRANTED_BYTES = blockCount * bytesPerSegment_;
+
+  // Fragment, z ktorego pochodzil ostatni przydzial ma najwieksza
+  // szanse na zaspokojenie kolejnego zadania
+  if( chunks_[ lastChunk_ ].committed_ ) {
+    if( void* memory = takeFromChunk( lastChunk_, BLOCK_COUNT ) ) {
+      counters_.recordAllocation( bytesCount, GRANTED_BYTES );
+      return memory;
+    }
+  }
+
+  // Wolne fragmenty sa wykorzystywane w ostatniej kolejnosci, aby mogly
+  // zostac zwrocone do systemu po uplywie czasu bezczynnosci
+  size_t emptyChunk       = NO_CHUNK;
+  size_t uncommittedChunk = NO_CHUNK;
+
+  for( size_t chunkIndex = 0; chunkIndex < chunks_.size(); ++chunkIndex ) {
+    const ChunkState& state = chunks_[ chunkIndex ];
+
+    if( !state.committed_ ) {
+      if( uncommittedChunk == NO_CHUNK )
+        uncommittedChunk = chunkIndex;
+    } else if( state.empty_ ) {
+      if( emptyChunk == NO_CHUNK )
+        emptyChunk = chunkIndex;
+    } else if( chunkIndex != lastChunk_ ) {
+      if( void* memory = takeFromChunk( chunkIndex, BLOCK_COUNT ) ) {
+        counters_.recordAllocation( bytesCount, GRANTED_BYTES );
+        return memory;
+      }
+    }
+  }
+
+  if( emptyChunk == NO_CHUNK &&
+    uncommittedChunk != NO_CHUNK &&
+    commitChunk( uncommittedChunk ) )
+  {
+    emptyChunk = uncommittedChunk;
+  }
+
+  if( emptyChunk != NO_CHUNK ) {
+    counters_.recordAllocation( bytesCount, GRANTED_BYTES );
+    return takeFromChunk( emptyChunk, BLOCK_COUNT );
+  }
+
+  counters_.recordFailure( bytesCount );
+  throw std::bad_alloc();
+}
+
+void
+ChunkedMemoryPool
+::deallocate( void* memoryToRelease ) throw()
+{
+  if( !owns( memoryToRelease ) )
+    return;
+
+  const size_t OFFSET =
+    static_cast< const char* >( memoryToRelease ) - chunksBegin_;
+  const size_t CHUNK_INDEX  = OFFSET / chunkBytes_;
+  const size_t CHUNK_OFFSET = OFFSET % chunkBytes_;
+
+  ChunkState& state = chunks_[ CHUNK_INDEX ];
+  if( !state.committed_ ||
+    CHUNK_OFFSET < dataOffset_ ||
+    ( CHUNK_OFFSET - dataOffset_ ) % bytesPerSegment_ != 0 )
+  {
+    return;
+  }
+
+  FreeLists& freeLists = chunkFreeLists( CHUNK_INDEX );
+  const int RELEASED_SEGMENTS = freeLists.give(
+    static_cast< int >( ( CHUNK_OFFSET - dataOffset_ ) / bytesPerSegment_ ) );
+  if( RELEASED_SEGMENTS == 0 )
+    return;
+
+  counters_.recordDeallocation( RELEASED_SEGMENTS * bytesPerSegment_ );
+
+  // Przeglad fragmentow (oraz odczyt czasu) odbywa sie jedynie wtedy,
+  // gdy zwolnienie oproznilo fragment - pozostale zwolnienia nie moga
+  // zmienic zbioru fragmentow do zwrotu
+  if( freeLists.freeSegmentsCount() == static_cast< int >( segmentsPerChunk_ ) &&
+    !state.empty_ )
+  {
+    state.empty_      = true;
+    state.emptySince_ = currentTime();
+    ++emptyChunks_;
+
+    releaseIdleChunks();
+  }
+}
+
+bool
+ChunkedMemoryPool
+::owns( const void* memory ) const
+{
+  const char* address = static_cast< const char* >( memory );
+  return reservation_ != 0 &&
+    address >= chunksBegin_ &&
+    address < chunksBegin_ + reservedBytes();
+}
+
+void
+ChunkedMemoryPool
+::setIdleRelease( const Platform::TimeInformation*  timeInformation,
+                  size_t                            idleMilliseconds )
+{
+  timeInformation_ = timeInformation;
+  idleTicks_ = timeInformation == 0 ? 0 : static_cast< size_t >(
+    static_cast< double >( idleMilliseconds ) *
+    timeInformation->getTicksCountPerSec() / 1000.0 );
+
+  // Fragmenty wolne w chwili zmiany zrodla czasu zaczynaja odliczanie
+  // od poczatku
+  const size_t NOW = currentTime();
+  for( size_t chunkIndex = 0; chunkIndex < chunks_.size(); ++chunkIndex )
+    chunks_[ chunkIndex ].emptySince_ = NOW;
+}
+
+void
+ChunkedMemoryPool
+::releaseIdleChunks()
+{
+  if( timeInformation_ == 0 || emptyChunks_ == 0 )
+    return;
+
+  const size_t NOW = currentTime();
+  for( size_t chunkIndex = 0; chunkIndex < chunks_.size(); ++chunkIndex ) {
+    const ChunkState& state = chunks_[ chunkIndex ];
+    if( state.committed_ && state.empty_ &&
+      NOW - state.emptySince_ >= idleTicks_ )
+    {
+      decommitChunk( chunkIndex );
+    }
+  }
+}
+
+void
+ChunkedMemoryPool
+::trimEmptyChunks()
+{
+  for( size_t chunkIndex = 0; chunkIndex < chunks_.size(); ++chunkIndex ) {
+    if( chunks_[ chunkIndex ].empty_ )
+      decommitChunk( chunkIndex );
+  }
+}
+
+void
+ChunkedMemoryPool
+::purge()
+{
+  for( size_t chunkIndex = 0; chunkIndex < chunks_.size(); ++chunkIndex )
+    decommitChunk( chunkIndex );
+
+  lastChunk_ = 0;
+  counters_.reset();
+}
+
+MemoryAllocStats
+ChunkedMemoryPool
+::statistics() const
+{
+  MemoryAllocStats stats;
+  counters_.fill( &stats );
+
+  size_t largestRun = 0;
+  size_t freeRuns   = 0;
+
+  for( size_t chunkIndex = 0; chunkIndex < chunks_.size(); ++chunkIndex ) {
+    if( !chunks_[ chunkIndex ].committed_ ) {
+      largestRun = segmentsPerChunk_;
+      continue;
+    }
+
+    const FreeLists& freeLists = chunkFreeLists( chunkIndex );
+    const size_t CHUNK_LARGEST_RUN = freeLists.largestFreeRun();
+    if( CHUNK_LARGEST_RUN > largestRun )
+      largestRun = CHUNK_LARGEST_RUN;
+
+    freeRuns += freeLists.freeRunsCount();
+  }
+
+  stats.largestFreeRun_ = largestRun * bytesPerSegment_;
+  stats.freeRuns_       = freeRuns;
+  return stats;
+}
+
+} // namespace Utilities
+} // namespace Gcad
@@ -19,6 +19,7 @@
  ***************************************************************************/
 
 #include "GcadDataFileResourceManagerBase.h"
+#include <algorithm>
 
 namespace Gcad {
 namespace Platform {
@@ -68,5 +69,105 @@ DataFileResourceManagerBase::NullElementMatcher
   return true;
 }
 
+DataFileResourceManagerBase::MemoryBudget
+::MemoryBudget(size_t maxMemory)
+  : maxMemory_(maxMemory)
+  , lastAccessStamp_(0)
+{
+}
+
+DataFileResourceManagerBase::MemoryBudget
+::~MemoryBudget()
+{
+  for(Managers::iterator managerItor = managers_.begin();
+    managerItor != managers_.end();
+    ++managerItor)
+  {
+    (*managerItor)->budget_ = 0;
+  }
+}
+
+void
+DataFileResourceManagerBase::MemoryBudget
+::setMemoryMaximum(size_t memorySize)
+{
+  maxMemory_ = memorySize;
+  reserve(0, 0);
+}
+
+size_t
+DataFileResourceManagerBase::MemoryBudget
+::getUsedMemory() const
+{
+  size_t usedMemory = 0;
+  for(Managers::const_iterator managerItor = managers_.begin();
+    managerItor != managers_.end();
+    ++managerItor)
+  {
+    usedMemory += (*managerItor)->getBudgetedMemory();
+  }
+
+  return usedMemory;
+}
+
+void
+DataFileResourceManagerBase::MemoryBudget
+::reserve(size_t       bytesNeeded,
+          const void*  keep)
+{
+  // Menadzerow jest niewielu (po jednym na typ zasobu), dlatego kazde
+  // zwolnienie poprzedza wybor menadzera, ktorego zasob danego
+  // priorytetu byl uzyty najdawniej. Zwolniony zasob nie jest juz
+  // kandydatem, wiec petla priorytetu konczy sie po wyczerpaniu zasobow
+  // mozliwych do zwolnienia
+
+  for(int priority = LOW_PRIORITY; priority <= HIGH_PRIORITY; ++priority)
+  {
+    for(;;)
+    {
+      if( getUsedMemory() + bytesNeeded <= maxMemory_ )
+        return;
+
+      DataFileResourceManagerBase* oldest = 0;
+      AccessStamp oldestStamp = 0;
+
+      for(Managers::const_iterator managerItor = managers_.begin();
+        managerItor != managers_.end();
+        ++managerItor)
+      {
+        AccessStamp stamp = 0;
+        if( (*managerItor)->findEvictable(
+              static_cast<ResourcePriority>(priority), keep, &stamp) &&
+            ( oldest == 0 || stamp < oldestStamp ) )
+        {
+          oldest      = *managerItor;
+          oldestStamp = stamp;
+        }
+      }
+
+      if( oldest == 0 )
+        break;
+
+      oldest->evictOldest( static_cast<ResourcePriority>(priority), keep );
+    }
+  }
+}
+
+void
+DataFileResourceManagerBase::MemoryBudget
+::attach(DataFileResourceManagerBase* manager)
+{
+  managers_.push_back(manager);
+  reserve(0, 0);
+}
+
+void
+DataFileResourceManagerBase::MemoryBudget
+::detach(DataFileResourceManagerBase* manager)
+{
+  managers_.erase( std::remove(managers_.begin(), managers_.end(), manager),
+    managers_.end() );
+}
+
 } // namespace Platform
 } // namespace Gcad
@@ -28,6 +28,13 @@ DriveElementsEnumerator
 {
 }
 
+char
+DriveElementsEnumerator
+::getPathSeparator() const
+{
+  return '\\';
+}
+
 DriveElementsEnumerator::Itor
 ::~Itor()
 {
@@ -0,0 +1,106 @@
+/***************************************************************************
+ *   Copyright (C) 2005 by Eryk Klebanski                                  *
+ *   rixment@gmail.com                                                     *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include "GcadFrameArena.h"
+#include "GcadAssertion.h"
+
+namespace Gcad {
+namespace Utilities {
+
+namespace {
+
+  // Przesuniecie, po ktorym adres base + offset spelnia wymog wyrownania
+  size_t
+  alignOffset( const char*  base,
+               size_t       offset,
+               size_t       alignment )
+  {
+    const size_t ADDRESS = reinterpret_cast< size_t >( base ) + offset;
+    return offset + ( ( alignment - ADDRESS % alignment ) % alignment );
+  }
+
+} // anonymous namespace
+
+FrameArena
+::FrameArena( size_t initialBytes )
+  : block_( new char[ initialBytes ] )
+  , capacity_( initialBytes )
+  , offset_( 0 )
+  , usedBytes_( 0 )
+{
+}
+
+FrameArena
+::~FrameArena()
+{
+  reset();
+  delete [] block_;
+}
+
+void*
+FrameArena
+::allocate( size_t  bytesCount,
+            size_t  alignment ) throw( std::bad_alloc )
+{
+  assertion( alignment != 0 && ( alignment & ( alignment - 1 ) ) == 0,
+    "FrameArena::allocate(): Wyrownanie musi byc potega dwojki!" );
+
+  usedBytes_ += bytesCount + alignment - 1;
+
+  const size_t ALIGNED = alignOffset( block_, offset_, alignment );
+  if( ALIGNED + bytesCount <= capacity_ ) {
+    offset_ = ALIGNED + bytesCount;
+    return block_ + ALIGNED;
+  }
+
+  // Blok glowny zostal wyczerpany - blok dodatkowy zyje do resetu.
+  // Miejsce na wskaznik bloku jest rezerwowane przed jego przydzialem,
+  // aby wyjatek push_back nie pozostawil bloku bez wlasciciela
+  overflow_.reserve( overflow_.size() + 1 );
+  char* overflowBlock = new char[ bytesCount + alignment - 1 ];
+  overflow_.push_back( overflowBlock );
+  return overflowBlock + alignOffset( overflowBlock, 0, alignment );
+}
+
+void
+FrameArena
+::reset()
+{
+  if( !overflow_.empty() ) {
+    for( size_t block = 0; block < overflow_.size(); ++block )
+      delete [] overflow_[ block ];
+    overflow_.clear();
+
+    // Kolejna klatka o podobnym zapotrzebowaniu zmiesci sie w bloku glownym
+    if( usedBytes_ > capacity_ ) {
+      delete [] block_;
+      block_    = 0;
+      capacity_ = 0;
+      block_    = new char[ usedBytes_ ];
+      capacity_ = usedBytes_;
+    }
+  }
+
+  offset_    = 0;
+  usedBytes_ = 0;
+}
+
+} // namespace Utilities
+} // namespace Gcad
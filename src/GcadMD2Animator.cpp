@@ -77,6 +77,30 @@ md2EndSequence( Gcad::Framework::MD2Animator::AnimSequence sequence )
   return md2ArraySequences( sequence, SS_FINISH );
 }
 
+// Interpolacja liniowa pomiedzy dwoma klatkami kluczowymi
+template< typename FRAME_ITOR, typename FRAME >
+void
+interpolateKeyFrames( FRAME_ITOR  firstFrameItor,
+                      FRAME_ITOR  secondFrameItor,
+                      int         verticesCount,
+                      float       interpolateValue,
+                      FRAME*      interpolatedFrame )
+{
+  interpolatedFrame->clear();
+  interpolatedFrame->reserve( verticesCount );
+
+  for( int verticeIndex = 0;
+    verticeIndex < verticesCount;
+    ++verticeIndex )
+  {
+    interpolatedFrame->push_back( *firstFrameItor +
+      ( *secondFrameItor - *firstFrameItor ) * interpolateValue );
+
+    ++firstFrameItor;
+    ++secondFrameItor;
+  }
+}
+
 } // anonymous
 
 namespace Gcad {
@@ -139,29 +163,8 @@ void MD2Animator
 MD2Animator::VerticesKeyFrameAutoPtr MD2Animator
 ::interpolatedVertices() const
 {
-  const int VERTICES_COUNT = meshData_.attributes().numVerts();
-
   VerticesKeyFrameAutoPtr  vertices( new VerticesKeyFrame );
-
-  vertices->reserve( VERTICES_COUNT );
-
-  MD2Data::VerticesFrameConstItor  firstFrameItor =
-    meshData_.beginVerticesKeyFrame( firstInterpolatedFrame_ );
-
-  MD2Data::VerticesFrameConstItor  secondFrameItor =
-    meshData_.beginVerticesKeyFrame( secondInterpolatedFrame_ );
-
-  for( int verticeIndex = 0;
-    verticeIndex < VERTICES_COUNT;
-    ++verticeIndex )
-  {
-    vertices->push_back( *firstFrameItor +
-      ( *secondFrameItor - *firstFrameItor ) * interpolateValue_ );
-
-    ++firstFrameItor;
-    ++secondFrameItor;
-  }
-
+  interpolatedVertices( vertices.get() );
   return vertices;
 }
 
@@ -169,30 +172,57 @@ MD2Animator::VerticesKeyFrameAutoPtr MD2Animator
 MD2Animator::NormalsKeyFrameAutoPtr MD2Animator
 ::interpolatedNormals() const
 {
-  const int VERTICES_COUNT = meshData_.attributes().numVerts();
-
   NormalsKeyFrameAutoPtr  normals( new NormalsKeyFrame );
+  interpolatedNormals( normals.get() );
+  return normals;
+}
 
-  normals->reserve( VERTICES_COUNT );
-  
-  MD2Data::NormalsFrameConstItor  firstFrameItor =
-    meshData_.beginNormalsKeyFrame( firstInterpolatedFrame_ );
-
-  MD2Data::NormalsFrameConstItor  secondFrameItor =
-    meshData_.beginNormalsKeyFrame( secondInterpolatedFrame_ );
+//
+void MD2Animator
+::interpolatedVertices( TransientKeyFrame* vertices ) const
+{
+  interpolateKeyFrames(
+    meshData_.beginVerticesKeyFrame( firstInterpolatedFrame_ ),
+    meshData_.beginVerticesKeyFrame( secondInterpolatedFrame_ ),
+    meshData_.attributes().numVerts(),
+    interpolateValue_,
+    vertices );
+}
 
-  for( int verticeIndex = 0;
-    verticeIndex < VERTICES_COUNT;
-    ++verticeIndex )
-  {
-    normals->push_back( *firstFrameItor +
-      ( *secondFrameItor - *firstFrameItor ) * interpolateValue_ );
+//
+void MD2Animator
+::interpolatedNormals( TransientKeyFrame* normals ) const
+{
+  interpolateKeyFrames(
+    meshData_.beginNormalsKeyFrame( firstInterpolatedFrame_ ),
+    meshData_.beginNormalsKeyFrame( secondInterpolatedFrame_ ),
+    meshData_.attributes().numVerts(),
+    interpolateValue_,
+    normals );
+}
 
-    ++firstFrameItor;
-    ++secondFrameItor;
-  }
+//
+void MD2Animator
+::interpolatedVertices( VerticesKeyFrame* vertices ) const
+{
+  interpolateKeyFrames(
+    meshData_.beginVerticesKeyFrame( firstInterpolatedFrame_ ),
+    meshData_.beginVerticesKeyFrame( secondInterpolatedFrame_ ),
+    meshData_.attributes().numVerts(),
+    interpolateValue_,
+    vertices );
+}
 
-  return normals;
+//
+void MD2Animator
+::interpolatedNormals( NormalsKeyFrame* normals ) const
+{
+  interpolateKeyFrames(
+    meshData_.beginNormalsKeyFrame( firstInterpolatedFrame_ ),
+    meshData_.beginNormalsKeyFrame( secondInterpolatedFrame_ ),
+    meshData_.attributes().numVerts(),
+    interpolateValue_,
+    normals );
 }
 
 } // namespace Framework
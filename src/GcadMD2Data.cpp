@@ -21,12 +21,52 @@
 #include "GcadMD2Data.h"
 #include "GcadMD2Animator.h"
 #include "GcadComputeModelNormals.h"
+#include <algorithm>
 #include <fstream>
 #include <memory>
 
 namespace Gcad {
 namespace Framework {
 
+namespace {
+
+  // Sprawdzenie, czy count elementow o rozmiarze elementSize, poczawszy
+  // od przesuniecia offset, miesci sie w pliku o rozmiarze fileSize.
+  // Wartosci naglowka pochodza z pliku i moga byc dowolne - iloczyn nie
+  // jest obliczany, aby uniknac przepelnienia
+  bool
+  sectionInsideFile( int  offset,
+                     int  count,
+                     int  elementSize,
+                     int  fileSize )
+  {
+    if( offset < 0 || count < 0 || offset > fileSize )
+      return false;
+
+    return count == 0 || count <= ( fileSize - offset ) / elementSize;
+  }
+
+  // Znacznik, oraz wersja formatu przetworzonego modelu (writeProcessed).
+  // Zmiana ukladu danych wymaga zmiany wersji - dane zapisane wczesniej
+  // zostana wowczas odrzucone przez createFromProcessed
+  const char  PROCESSED_MAGIC[ 4 ] = { 'G', 'M', '2', 'P' };
+  const int   PROCESSED_VERSION    = 1;
+
+  // Naglowek przetworzonego modelu - po nim nastepuje kopia naglowka
+  // pliku MD2, a nastepnie ciagle tablice: wierzcholki wszystkich klatek,
+  // normalne wszystkich klatek, koordynaty tekstur, oraz poligony
+  struct ProcessedHeader {
+    char  magic_[ 4 ];
+    int   version_;
+    int   framesCount_;
+    int   verticesPerFrame_;
+    int   normalsPerFrame_;
+    int   texCoordsCount_;
+    int   polygonsCount_;
+  };
+
+} // anonymous namespace
+
 //
 MD2Data
 ::MD2Data( const std::string& fileName )
@@ -40,43 +80,349 @@ MD2Data
 
 //
 MD2Data
-::MD2Data( std::ifstream& inputData )
+::MD2Data( std::istream& inputData )
   : fileHeader_( 0 )
 {
   loadDataFromInput(inputData);
 }
 
+//
+MD2Data
+::MD2Data( const Utilities::ByteSpan& md2Data )
+  : fileHeader_( 0 )
+{
+  fileHeader_ = MD2HeaderAutoPtr( new MD2FileHeader( md2Data ) );
+  checkSectionsBounds();
+
+  // Plik moze byc dluzszy od rozmiaru zapisanego w naglowku - pozostale
+  // bajty sa pomijane, podobnie jak w przypadku odczytu ze strumienia
+  if( static_cast< size_t >( fileHeader_->offsetEnd() ) > md2Data.size() ) {
+    throw FileReadError( "MD2Data: Obszar danych krotszy od rozmiaru pliku "
+      "zapisanego w naglowku" );
+  }
+
+  loadDataFromMemory( md2Data.data() );
+}
+
+//
+MD2Data
+::MD2Data( const MD2FileHeader& header )
+  : fileHeader_( new MD2FileHeader( header ) )
+{
+}
+
+#ifdef GCAD_HAS_RVALUE_REFERENCES
+//
+MD2Data
+::MD2Data( MD2Data&& that )
+  : fileHeader_( 0 )
+{
+  swap( that );
+}
+
+//
+MD2Data&
+MD2Data
+::operator =( MD2Data&& rhs )
+{
+  MD2Data( static_cast< MD2Data&& >( rhs ) ).swap( *this );
+  return *this;
+}
+#endif
+
 //
 void
 MD2Data
-::loadDataFromInput( std::ifstream& inputData )
+::swap( MD2Data& that )
+{
+  fileName_.swap( that.fileName_ );
+
+  MD2HeaderAutoPtr  header( fileHeader_ );
+  fileHeader_ = that.fileHeader_;
+  that.fileHeader_ = header;
+
+  vertFrames_.swap( that.vertFrames_ );
+  normFrames_.swap( that.normFrames_ );
+  texCoords_.swap( that.texCoords_ );
+  polyIndices_.swap( that.polyIndices_ );
+}
+
+//
+void
+MD2Data
+::writeProcessed( std::ostream& output ) const
+{
+  using Utilities::writeIntoStdStream;
+
+  ProcessedHeader header;
+  memcpy( header.magic_, PROCESSED_MAGIC, sizeof( header.magic_ ) );
+  header.version_          = PROCESSED_VERSION;
+  header.framesCount_      = static_cast< int >( keyFramesCount() );
+  header.verticesPerFrame_ = vertFrames_.empty() ? 0 :
+    static_cast< int >( vertFrames_.front()->size() );
+  header.normalsPerFrame_  = normFrames_.empty() ? 0 :
+    static_cast< int >( normFrames_.front()->size() );
+  header.texCoordsCount_   = static_cast< int >( texCoords_.size() );
+  header.polygonsCount_    = static_cast< int >( polyIndices_.size() );
+
+  writeIntoStdStream( output, header, 1 );
+  writeIntoStdStream( output, *fileHeader_, 1 );
+
+  // Wszystkie klatki danego rodzaju posiadaja jednakowa liczbe elementow
+  // (wynika ona z naglowka pliku), wiec sa zapisywane bez rozmiarow
+
+  for( VerticesKeyFramesConstItor frameItor = vertFrames_.begin();
+    frameItor != vertFrames_.end();
+    ++frameItor )
+  {
+    if( !( *frameItor )->empty() )
+      writeIntoStdStream( output, ( *frameItor )->front(), 
+        ( *frameItor )->size() );
+  }
+
+  for( NormalsKeyFramesConstItor frameItor = normFrames_.begin();
+    frameItor != normFrames_.end();
+    ++frameItor )
+  {
+    if( !( *frameItor )->empty() )
+      writeIntoStdStream( output, ( *frameItor )->front(), 
+        ( *frameItor )->size() );
+  }
+
+  if( !texCoords_.empty() )
+    writeIntoStdStream( output, texCoords_.front(), texCoords_.size() );
+
+  if( !polyIndices_.empty() )
+    writeIntoStdStream( output, polyIndices_.front(), polyIndices_.size() );
+}
+
+//
+MD2Data*
+MD2Data
+::createFromProcessed( const Utilities::ByteSpan& processed )
+{
+  Utilities::ByteSpanReader reader( processed );
+
+  try {
+    ProcessedHeader header;
+    reader.read( &header );
+
+    if( memcmp( header.magic_, PROCESSED_MAGIC, sizeof( header.magic_ ) ) != 0 ||
+      header.version_ != PROCESSED_VERSION )
+    {
+      throw FileReadError( "MD2Data: Niepoprawny format przetworzonego "
+        "modelu" );
+    }
+
+    const MD2FileHeader FILE_HEADER( 
+      reader.view( sizeof( MD2FileHeader ) ) );
+
+    std::auto_ptr< MD2Data > model( new MD2Data( FILE_HEADER ) );
+    model->readProcessed( reader );
+    return model.release();
+  }
+  catch( Utilities::ByteSpanReader::Overrun& ) {
+    throw FileReadError( "MD2Data: Niepelne dane przetworzonego modelu" );
+  }
+}
+
+//
+void
+MD2Data
+::readProcessed( Utilities::ByteSpanReader& processed )
+{
+  ProcessedHeader header;
+  processed.seek( 0 );
+  processed.read( &header );
+  processed.skip( sizeof( MD2FileHeader ) );
+
+  // Liczby elementow sa porownywane z rozmiarem pozostalych danych przed
+  // przydzialem pamieci - uszkodzony naglowek nie moze wymusic
+  // przydzialu wiekszego od samych danych. Klatka bez wierzcholkow
+  // i normalnych nie zajmuje danych, dlatego takie klatki sa odrzucane -
+  // inaczej liczba przydzielanych klatek bylaby nieograniczona
+
+  const size_t REMAINING   = processed.remaining();
+  const size_t MAX_VECTORS = REMAINING / sizeof( Vector3 );
+
+  if( header.framesCount_ < 0 || header.verticesPerFrame_ < 0 ||
+    header.normalsPerFrame_ < 0 || header.texCoordsCount_ < 0 ||
+    header.polygonsCount_ < 0 ||
+    static_cast< size_t >( header.verticesPerFrame_ ) > MAX_VECTORS ||
+    static_cast< size_t >( header.normalsPerFrame_ ) > MAX_VECTORS ||
+    ( header.framesCount_ != 0 && 
+      header.verticesPerFrame_ == 0 && header.normalsPerFrame_ == 0 ) ||
+    ( header.framesCount_ != 0 && 
+      static_cast< size_t >( header.verticesPerFrame_ ) + 
+      header.normalsPerFrame_ > MAX_VECTORS / header.framesCount_ ) ||
+    static_cast< size_t >( header.texCoordsCount_ ) > 
+      REMAINING / sizeof( Vector2 ) ||
+    static_cast< size_t >( header.polygonsCount_ ) > 
+      REMAINING / sizeof( PolygonIndices ) )
+  {
+    throw FileReadError( "MD2Data: Niepoprawne rozmiary przetworzonego "
+      "modelu" );
+  }
+
+  vertFrames_.reserve( header.framesCount_ );
+  for( int frame = 0; frame < header.framesCount_; ++frame )
+  {
+    vertFrames_.push_back( new VerticesFrame( header.verticesPerFrame_ ) );
+    if( header.verticesPerFrame_ != 0 )
+      processed.read( &vertFrames_.back()->front(), 
+        header.verticesPerFrame_ );
+  }
+
+  normFrames_.reserve( header.framesCount_ );
+  for( int frame = 0; frame < header.framesCount_; ++frame )
+  {
+    normFrames_.push_back( new NormalsFrame( header.normalsPerFrame_ ) );
+    if( header.normalsPerFrame_ != 0 )
+      processed.read( &normFrames_.back()->front(), 
+        header.normalsPerFrame_ );
+  }
+
+  texCoords_.resize( header.texCoordsCount_ );
+  if( !texCoords_.empty() )
+    processed.read( &texCoords_.front(), texCoords_.size() );
+
+  polyIndices_.resize( header.polygonsCount_ );
+  if( !polyIndices_.empty() )
+    processed.read( &polyIndices_.front(), polyIndices_.size() );
+
+  checkPolygonsIndices( 
+    std::min( header.verticesPerFrame_, header.normalsPerFrame_ ),
+    header.texCoordsCount_ );
+}
+
+//
+void
+MD2Data
+::loadDataFromInput( std::istream& inputData )
 {
   if( !inputData ) {
     throw FileReadError( "Blad podczas otwierania pliku " +  fileName_ );
   }
 
   fileHeader_ = MD2HeaderAutoPtr( new MD2FileHeader( inputData ) );
+  checkSectionsBounds();
+
+  BytesVector dataFileBuffer;
+  createBuffer( inputData, &dataFileBuffer );
 
-  BytesVectorAutoPtr dataFileBuffer( createBuffer( inputData ) );
+  loadDataFromMemory( &dataFileBuffer.front() );
+}
 
-  readVerticesKeyFrames( &dataFileBuffer->front() );
-  readTextureCoords( &dataFileBuffer->front() );
-  readPolygonsIndices( &dataFileBuffer->front() );    
+//
+void
+MD2Data
+::loadDataFromMemory( const Byte* fileData )
+{
+  readVerticesKeyFrames( fileData );
+  readTextureCoords( fileData );
+  readPolygonsIndices( fileData );    
 
   computeNormalsKeyFrames();
 }
 
+//
+void
+MD2Data
+::checkSectionsBounds() const
+{
+  const int FILE_SIZE = fileHeader_->offsetEnd();
+
+  // Naglowek klatki: skala, przesuniecie (po 3 wartosci float) i nazwa
+  const int FRAME_HEADER_SIZE =
+    ( CB_SCALE + CB_TRANSL ) * sizeof( float ) + CB_STRING;
+
+  // Po naglowku klatki nastepuja dane wierzcholkow (x, y, z, indeks
+  // normalnej) - rozmiar klatki musi odpowiadac liczbie wierzcholkow
+  const int VERTEX_SIZE = 4;
+
+  if( FILE_SIZE < static_cast< int >( sizeof( MD2FileHeader ) ) ||
+    fileHeader_->frameSize() < FRAME_HEADER_SIZE ||
+    ( fileHeader_->frameSize() - FRAME_HEADER_SIZE ) % VERTEX_SIZE != 0 ||
+    fileHeader_->numVerts() != 
+      ( fileHeader_->frameSize() - FRAME_HEADER_SIZE ) / VERTEX_SIZE ||
+    !sectionInsideFile( fileHeader_->offsetFrames(),
+      fileHeader_->numFrames(), fileHeader_->frameSize(), FILE_SIZE ) ||
+    !sectionInsideFile( fileHeader_->offsetTexCoords(),
+      fileHeader_->numTexCoords(), 2 * sizeof( short ), FILE_SIZE ) ||
+    !sectionInsideFile( fileHeader_->offsetPolys(),
+      fileHeader_->numPolys(), sizeof( PolygonIndices ), FILE_SIZE ) )
+  {
+    throw FileReadError( "MD2Data: Sekcje danych wykraczaja poza plik " +
+      fileName_ );
+  }
+}
+
+//
+void
+MD2Data
+::checkPolygonsIndices( size_t  verticesCount,
+                        size_t  texCoordsCount ) const
+{
+  for( PolygonsIndicesConstItor polyIndexItor = polyIndices_.begin();
+    polyIndexItor != polyIndices_.end();
+    ++polyIndexItor )
+  {
+    for( int vertex = 0; vertex < 3; ++vertex )
+    {
+      if( polyIndexItor->indexToVerticesArray( vertex ) >= verticesCount ||
+        polyIndexItor->indexToTexCoordsArray( vertex ) >= texCoordsCount )
+      {
+        throw FileReadError( "MD2Data: Indeksy poligonu wykraczaja poza "
+          "tablice wierzcholkow, badz koordynat tekstur " + fileName_ );
+      }
+    }
+  }
+}
+
 //
 size_t 
 MD2Data
 ::getByteSize() const
 {
-  return fileName_.size() + 
-    sizeof(MD2FileHeader) + 
-    vertFrames_.size() * sizeof(VerticesKeyFrames::value_type) +
-    normFrames_.size() * sizeof(NormalsKeyFrames::value_type) +
-    texCoords_.size() * sizeof(TextureCoords::value_type) +
-    polyIndices_.size() * sizeof(PolygonsIndices::value_type);
+  // Klatki animacji sa przechowywane poza obiektem modelu - kazda z nich
+  // sklada sie z obiektu wektora, danych wierzcholkow (badz normalnych),
+  // oraz bloku licznikow odniesien wskaznika AtomicRefCountPtr. Klatki
+  // udostepnione na zewnatrz (sharedVerticesKeyFrame) sa liczone w calosci,
+  // poniewaz model utrzymuje je w pamieci
+
+  using Utilities::dynamicByteSize;
+
+  size_t byteSize = sizeof( MD2Data ) + 
+    dynamicByteSize( fileName_ ) +
+    dynamicByteSize( vertFrames_ ) +
+    dynamicByteSize( normFrames_ ) +
+    dynamicByteSize( texCoords_ ) +
+    dynamicByteSize( polyIndices_ );
+
+  if( fileHeader_.get() != 0 )
+    byteSize += sizeof( MD2FileHeader );
+
+  for( VerticesKeyFramesConstItor frameItor = vertFrames_.begin();
+    frameItor != vertFrames_.end();
+    ++frameItor )
+  {
+    if( frameItor->get() != 0 )
+      byteSize += sizeof( VerticesFrame ) + 
+        sizeof( Utilities::AtomicRefCounts ) +
+        dynamicByteSize( **frameItor );
+  }
+
+  for( NormalsKeyFramesConstItor frameItor = normFrames_.begin();
+    frameItor != normFrames_.end();
+    ++frameItor )
+  {
+    if( frameItor->get() != 0 )
+      byteSize += sizeof( NormalsFrame ) + 
+        sizeof( Utilities::AtomicRefCounts ) +
+        dynamicByteSize( **frameItor );
+  }
+
+  return byteSize;
 }
 
 //
@@ -127,11 +473,12 @@ void MD2Data
 }
 
 //
-MD2Data::BytesVectorAutoPtr MD2Data
-::createBuffer( std::istream& dataSrc ) 
+void MD2Data
+::createBuffer( std::istream&  dataSrc,
+                BytesVector*   dataFromFile ) 
 {
   const int FILE_SIZE = fileHeader_->offsetEnd();
-  BytesVectorAutoPtr dataFromFile( new BytesVector(FILE_SIZE) );
+  dataFromFile->resize( FILE_SIZE );
 
   const int MOVE_TO_BEGIN = 0;
   dataSrc.seekg( MOVE_TO_BEGIN, std::ios_base::beg );
@@ -144,13 +491,11 @@ MD2Data::BytesVectorAutoPtr MD2Data
   if( dataSrc.gcount() != FILE_SIZE ) {
     throw FileReadError("MD2Data: Blad podczas odczytu pliku " +  fileName_);
   }
-  
-  return dataFromFile;
 }
 
 //
 void MD2Data
-::readFrameVert( Byte*           verticesData,
+::readFrameVert( const Byte*     verticesData,
                  VerticesFrame&  frameVert ) 
 {
   // Wspolczynniki skalowania skompresowanych danych wierzcholkow 
@@ -164,6 +509,9 @@ void MD2Data
   int headerFrameOffset = sizeof( scale ) + sizeof( translate ) + sizeof( name );
   
   const int BLOCK_STEP = 4; // x, y, z, normal index
+  frameVert.reserve( 
+    ( fileHeader_->frameSize() - headerFrameOffset ) / BLOCK_STEP );
+
   for( int i = headerFrameOffset; 
     i < fileHeader_->frameSize(); 
     i += BLOCK_STEP ) 
@@ -177,19 +525,23 @@ void MD2Data
 
 //
 void MD2Data
-::readPolygonsIndices( Byte* fileData ) 
+::readPolygonsIndices( const Byte* fileData ) 
 {
   const int POLYGON_DATA_SIZE = 
     fileHeader_->numPolys() * sizeof( PolygonIndices );
 
-  Byte* polyData = fileData + fileHeader_->offsetPolys();
+  const Byte* polyData = fileData + fileHeader_->offsetPolys();
   polyIndices_.resize( fileHeader_->numPolys() );
-  memcpy( &polyIndices_.front(), polyData, POLYGON_DATA_SIZE );
+  if( !polyIndices_.empty() )
+    memcpy( &polyIndices_.front(), polyData, POLYGON_DATA_SIZE );
+
+  checkPolygonsIndices( fileHeader_->numVerts(), 
+    fileHeader_->numTexCoords() );
 }
   
 //
 void MD2Data
-::readTextureCoords( Byte* fileData ) 
+::readTextureCoords( const Byte* fileData ) 
 {
   const int   TEX_COORD_NUM = fileHeader_->numTexCoords();
   const float SKIN_WIDTH    = static_cast< float >( fileHeader_->skinWidth() );
@@ -197,30 +549,36 @@ void MD2Data
 
   texCoords_.resize( TEX_COORD_NUM );
 
-  short* texCoordsOffset =
-    reinterpret_cast< short* >( fileData + fileHeader_->offsetTexCoords() );
+  // Odwzorowany plik nie gwarantuje wyrownania danych do rozmiaru short,
+  // wiec kazda para wspolrzednych jest kopiowana
+  const Byte* texCoordsData = fileData + fileHeader_->offsetTexCoords();
 
-  int currTexIndex = 0;
-  for( short* currTex = texCoordsOffset;
-    currTex < texCoordsOffset + ( TEX_COORD_NUM * 2 );
-    ++currTex )
+  for( int currTexIndex = 0;
+    currTexIndex < TEX_COORD_NUM;
+    ++currTexIndex )
   {
-    texCoords_[ currTexIndex ].setX( *currTex++ / SKIN_WIDTH );
-    texCoords_[ currTexIndex ].setY( *currTex / SKIN_HEIGHT );
-    ++currTexIndex;
+    short texCoord[ 2 ];
+    memcpy( texCoord, texCoordsData + currTexIndex * sizeof( texCoord ),
+      sizeof( texCoord ) );
+
+    texCoords_[ currTexIndex ].setX( texCoord[ 0 ] / SKIN_WIDTH );
+    texCoords_[ currTexIndex ].setY( texCoord[ 1 ] / SKIN_HEIGHT );
   }
 }
 
 //
 void MD2Data
-::readVerticesKeyFrames( Byte* fileData ) 
+::readVerticesKeyFrames( const Byte* fileData ) 
 {
+  vertFrames_.reserve( fileHeader_->numFrames() );
+
   for( int frmeCount = 0; 
     frmeCount < fileHeader_->numFrames(); 
     ++frmeCount ) 
   {
     int frameOffset    = frmeCount * fileHeader_->frameSize();
-    Byte* frmVertData  = fileData + fileHeader_->offsetFrames() + frameOffset;
+    const Byte* frmVertData  = 
+      fileData + fileHeader_->offsetFrames() + frameOffset;
     
     std::auto_ptr< VerticesFrame >  verticesFrame( new VerticesFrame );
     readFrameVert( frmVertData, *verticesFrame );
@@ -230,14 +588,14 @@ void MD2Data
 
 //
 void MD2Data
-::readFrameHeader( Byte* headerData,
+::readFrameHeader( const Byte* headerData,
                    float ( &scale )[ CB_SCALE ],
                    float ( &translate )[ CB_TRANSL ],
                    Byte ( &name ) [ CB_STRING ] ) 
 {
-  float* scaleData = reinterpret_cast< float* >( headerData );
-  float* trnslData = scaleData + CB_SCALE;
-  unsigned char* nameData   = reinterpret_cast< Byte* >( trnslData + CB_TRANSL );
+  const Byte* scaleData = headerData;
+  const Byte* trnslData = scaleData + sizeof( scale );
+  const Byte* nameData  = trnslData + sizeof( translate );
 
   // Odczytanie danych naglowka klatki animacji
   memcpy( scale, scaleData, sizeof( scale ) );
@@ -19,6 +19,7 @@
  ***************************************************************************/
 
 #include "GcadMD2FileHeader.h"
+#include <cstring>
 
 namespace Gcad {
 namespace Framework {
@@ -38,19 +39,40 @@ MD2FileHeader
     reinterpret_cast< char* >( this ),
     sizeof( MD2FileHeader ) );
 
-  const int MD2_VERSION   = 8;
-  const int MD2_ID_FORMAT = 'I' | ( 'D' << 8 ) | ( 'P' << 16 ) | ( '2' << 24 );
-
   if( !inputMD2HeaderData ) {
     throw InputStreamInBadState(
       "MD2FileHeader::MD2FileHeader(std::istream&): Strumien w stanie bledu!",
       inputMD2HeaderData );
   } 
-  else if( identifier_ != MD2_ID_FORMAT ||
+
+  validate();
+}
+
+//
+MD2FileHeader
+::MD2FileHeader( const Utilities::ByteSpan& md2Data )
+{
+  if( md2Data.size() < sizeof( MD2FileHeader ) ) {
+    throw BadHeaderData( "MD2FileHeader::MD2FileHeader(const ByteSpan&): "
+      "Obszar danych krotszy od naglowka!" );
+  }
+
+  memcpy( this, md2Data.data(), sizeof( MD2FileHeader ) );
+  validate();
+}
+
+//
+void
+MD2FileHeader
+::validate() const
+{
+  const int MD2_VERSION   = 8;
+  const int MD2_ID_FORMAT = 'I' | ( 'D' << 8 ) | ( 'P' << 16 ) | ( '2' << 24 );
+
+  if( identifier_ != MD2_ID_FORMAT ||
     version_ != MD2_VERSION ) 
   {
-    throw BadHeaderData( "MD2FileHeader::MD2FileHeader(std::istream&): "
-      "Nieprawidlowy format pliku!" );
+    throw BadHeaderData( "MD2FileHeader: Nieprawidlowy format pliku!" );
   }
 }
 
@@ -26,6 +26,21 @@ namespace Framework {
 //
 MD3BoneFrame
 ::MD3BoneFrame( std::istream& boneFrameData )
+{
+  readFrom( boneFrameData );
+}
+
+//
+MD3BoneFrame
+::MD3BoneFrame( Utilities::ByteSpanReader& boneFrameData )
+{
+  readFrom( boneFrameData );
+}
+
+//
+template< typename SOURCE >
+void MD3BoneFrame
+::readFrom( SOURCE& boneFrameData )
 {
   // Oryginalna reprezentacja danych skladowych komponentu modelu,
   // odpowiadajaca formatowi danych wejsciowych - MD3
@@ -36,7 +51,8 @@ MD3BoneFrame
     float radius;
   } readedFrameData;
 
-  boneFrameData.read( 
+  Utilities::readFromSource( 
+    boneFrameData,
     reinterpret_cast< char* >( &readedFrameData ), 
     sizeof( readedFrameData ) );
 
@@ -54,7 +70,7 @@ MD3BoneFrame
 
   sphereRadius_ = readedFrameData.radius;
    
-  boneFrameData.read( name_, sizeof( name_ ) ); 
+  Utilities::readFromSource( boneFrameData, name_, sizeof( name_ ) ); 
 }
 
 } // namespace Framework
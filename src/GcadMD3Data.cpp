@@ -39,8 +39,48 @@ MD3Data
 }
 
 //
+MD3Data
+::MD3Data( const Utilities::ByteSpan& md3Data )
+{
+  fileHeader_ = new MD3FileHeader( md3Data );
+
+  // Liczby elementow sa ograniczone rozmiarem danych, zanim posluza
+  // do przydzialu pamieci kolekcji (rekord klatki zajmuje 56 bajtow,
+  // lacznika 112 bajtow)
+  const size_t BYTES_COUNT  = md3Data.size();
+  const size_t FRAME_BYTES  = 56;
+  const size_t TAG_BYTES    = 112;
+
+  const int FRAMES_NUM = fileHeader_->framesNum();
+  const int TAGS_NUM   = fileHeader_->tagsNum();
+  const int MESHES_NUM = fileHeader_->meshesNum();
+
+  if( FRAMES_NUM < 0 || TAGS_NUM < 0 || MESHES_NUM < 0 ||
+    static_cast< size_t >( FRAMES_NUM ) > BYTES_COUNT / FRAME_BYTES ||
+    static_cast< size_t >( TAGS_NUM ) > BYTES_COUNT / TAG_BYTES ||
+    ( TAGS_NUM != 0 && static_cast< size_t >( FRAMES_NUM ) >
+      BYTES_COUNT / ( TAG_BYTES * TAGS_NUM ) ) ||
+    static_cast< size_t >( MESHES_NUM ) > 
+      BYTES_COUNT / sizeof( MD3MeshHeader ) )
+  {
+    throw MD3FileHeader::BadHeaderData(
+      "MD3Data::MD3Data(const ByteSpan&): Nieprawidlowe wartosci naglowka!" );
+  }
+
+  // Kolejnosc odczytu zgodna z odczytem ze strumienia - sekcje
+  // nastepuja bezposrednio po naglowku
+  Utilities::ByteSpanReader  inputData( md3Data );
+  inputData.skip( sizeof( MD3FileHeader ) );
+
+  readBoneFrames( inputData );
+  readTags( inputData );
+  readMeshes( inputData );
+}
+
+//
+template< typename SOURCE >
 void MD3Data
-::readBoneFrames( std::istream& boneFrameData )
+::readBoneFrames( SOURCE& boneFrameData )
 {
   boneFrames_.resize( fileHeader_->framesNum() );
  
@@ -53,8 +93,9 @@ void MD3Data
 }
 
 //
+template< typename SOURCE >
 void MD3Data
-::readTags( std::istream& tagsData )
+::readTags( SOURCE& tagsData )
 {
   const int TAGS_COUNT = fileHeader_->framesNum() * fileHeader_->tagsNum();
   
@@ -89,6 +130,58 @@ void MD3Data
   }
 }
 
+//
+void MD3Data
+::readMeshes( Utilities::ByteSpanReader& meshesData )
+{
+  meshes_.resize( fileHeader_->meshesNum() );
+  
+  for( int meshesCount = 0; 
+    meshesCount < fileHeader_->meshesNum(); 
+    ++meshesCount )
+  {
+    // Przesuniecia sekcji siatki sa liczone od poczatku jej naglowka
+    const size_t MESH_OFFSET = meshesData.position();
+
+    meshes_[ meshesCount ] = new MD3Mesh( 
+      meshesData.span().subspan( MESH_OFFSET, meshesData.remaining() ) );
+
+    meshesData.skip( 
+      static_cast< size_t >( meshes_[ meshesCount ]->meshHeader().meshSize() ) );
+  }
+}
+
+//
+size_t MD3Data
+::getByteSize() const
+{
+  using Utilities::dynamicByteSize;
+
+  // Kazdy element przydzielony w stercie posiada dodatkowo licznik
+  // odniesien wskaznika RefCountPtr (wartosc typu int)
+
+  size_t byteSize = sizeof( MD3Data ) +
+    dynamicByteSize( boneFrames_ ) +
+    dynamicByteSize( tags_ ) +
+    dynamicByteSize( meshes_ );
+
+  if( fileHeader_.get() != 0 )
+    byteSize += sizeof( MD3FileHeader ) + sizeof( int );
+
+  byteSize += boneFrames_.size() * ( sizeof( MD3BoneFrame ) + sizeof( int ) );
+  byteSize += tags_.size() * ( sizeof( MD3Tag ) + sizeof( int ) );
+
+  for( Meshes::const_iterator meshItor = meshes_.begin();
+    meshItor != meshes_.end();
+    ++meshItor )
+  {
+    if( meshItor->get() != 0 )
+      byteSize += ( *meshItor )->getByteSize() + sizeof( int );
+  }
+
+  return byteSize;
+}
+
 
 } // namespace Framework
 } // namespace Gcad
@@ -19,6 +19,7 @@
  ***************************************************************************/
 
 #include "GcadMD3FileHeader.h"
+#include <cstring>
 #include <string>
 
 namespace Gcad {
@@ -33,18 +34,39 @@ MD3FileHeader
     reinterpret_cast< char* >( this ),
     sizeof( MD3FileHeader ) );
 
-  const std::string  idFileHeaderChecker( id_, sizeof( id_ ) );
-  const int          validVersion = 15;
-
-  if( !inputHeaderData || 
-    idFileHeaderChecker != std::string( "IDP3" ) ||
-    version_ != validVersion ) 
-  {
+  if( !inputHeaderData || !isValid() ) {
     throw BadHeaderData( 
       inputHeaderData, 
       "MD3FileHeader::MD3FileHeader(std::istream&): Nieprawidlowy format pliku!" );
   }
 }
 
+MD3FileHeader
+::MD3FileHeader( const Utilities::ByteSpan& md3Data )
+{
+  if( md3Data.size() < sizeof( MD3FileHeader ) ) {
+    throw BadHeaderData( "MD3FileHeader::MD3FileHeader(const ByteSpan&): "
+      "Obszar danych krotszy od naglowka!" );
+  }
+
+  memcpy( this, md3Data.data(), sizeof( MD3FileHeader ) );
+
+  if( !isValid() ) {
+    throw BadHeaderData( "MD3FileHeader::MD3FileHeader(const ByteSpan&): "
+      "Nieprawidlowy format pliku!" );
+  }
+}
+
+bool
+MD3FileHeader
+::isValid() const
+{
+  const std::string  idFileHeaderChecker( id_, sizeof( id_ ) );
+  const int          validVersion = 15;
+
+  return idFileHeaderChecker == std::string( "IDP3" ) &&
+    version_ == validVersion;
+}
+
 } // namespace Framework
 } // namespace Gcad
@@ -19,7 +19,9 @@
  ***************************************************************************/
 
 #include "GcadMD3Mesh.h"
+#include "GcadMD3FileHeader.h"
 #include "GcadComputeModelNormals.h"
+#include <cstring>
 
 namespace {
   // Oryginalna reprezentacja struktury formatu MD3, wykorzystywana
@@ -28,6 +30,21 @@ namespace {
     signed short  vertex[ 3 ]; // wspolrzedne wierzcholka
     unsigned char normal[ 2 ]; // nie uzywane wartosci
   };
+
+  // Sprawdzenie, czy count elementow o rozmiarze elementSize, poczawszy
+  // od przesuniecia start, miesci sie w obszarze bytesCount bajtow
+  bool
+  sectionInside( int     start,
+                 int     count,
+                 size_t  elementSize,
+                 size_t  bytesCount )
+  {
+    if( start < 0 || count < 0 || static_cast< size_t >( start ) > bytesCount )
+      return false;
+
+    return elementSize == 0 || static_cast< size_t >( count ) <=
+      ( bytesCount - start ) / elementSize;
+  }
 } // anonymous
 
 namespace Gcad {
@@ -48,6 +65,80 @@ MD3Mesh
   computeVerticesNormals();
 }
 
+//
+MD3Mesh
+::MD3Mesh( const Utilities::ByteSpan& meshData )
+{
+  Utilities::ByteSpanReader meshReader( meshData );
+  meshHeader_ = new MD3MeshHeader( meshReader );
+
+  checkSectionsBounds( meshData.size() );
+
+  // Dane sekcji sa kopiowane bezposrednio z obszaru pamieci, bez
+  // posrednich buforow
+  const Utilities::ByteSpan::Byte* meshBytes = meshData.data();
+
+  facesIndices_.resize( meshHeader_->trianglesNum() );
+  if( !facesIndices_.empty() )
+    memcpy( &facesIndices_.front(),
+      meshBytes + meshHeader_->trianglesStart(),
+      sizeof( FacesIndices::value_type ) * facesIndices_.size() );
+
+  texCoords_.resize( meshHeader_->verticesNum() );
+  if( !texCoords_.empty() )
+    memcpy( &texCoords_.front(),
+      meshBytes + meshHeader_->uvStart(),
+      sizeof( TexCoords::value_type ) * texCoords_.size() );
+
+  convertVerticesKeyFrames( meshBytes + meshHeader_->vertexStart() );
+
+  computeVerticesNormals();
+}
+
+//
+void MD3Mesh
+::swap( MD3Mesh& that )
+{
+  meshHeader_.swap( that.meshHeader_ );
+  vertKeyFrames_.swap( that.vertKeyFrames_ );
+  normKeyFrames_.swap( that.normKeyFrames_ );
+  texCoords_.swap( that.texCoords_ );
+  facesIndices_.swap( that.facesIndices_ );
+}
+
+//
+size_t MD3Mesh
+::getByteSize() const
+{
+  using Utilities::dynamicByteSize;
+
+  size_t byteSize = sizeof( MD3Mesh ) +
+    dynamicByteSize( vertKeyFrames_ ) +
+    dynamicByteSize( normKeyFrames_ ) +
+    dynamicByteSize( texCoords_ ) +
+    dynamicByteSize( facesIndices_ );
+
+  // Naglowek wraz z licznikiem odniesien wskaznika RefCountPtr
+  if( meshHeader_.get() != 0 )
+    byteSize += sizeof( MD3MeshHeader ) + sizeof( int );
+
+  for( VerticesKeyFrames::const_iterator frameItor = vertKeyFrames_.begin();
+    frameItor != vertKeyFrames_.end();
+    ++frameItor )
+  {
+    byteSize += dynamicByteSize( *frameItor );
+  }
+
+  for( NormalsKeyFrames::const_iterator frameItor = normKeyFrames_.begin();
+    frameItor != normKeyFrames_.end();
+    ++frameItor )
+  {
+    byteSize += dynamicByteSize( *frameItor );
+  }
+
+  return byteSize;
+}
+
 //
 void MD3Mesh
 ::readFacesIndices( std::istream&           facesIndicesStream,
@@ -87,22 +178,31 @@ void MD3Mesh
 ::readVerticesKeyFrames( std::istream&           framesStream,
                          std::istream::pos_type  meshOffset )
 {
-  vertKeyFrames_.resize( meshHeader_->framesNum() );
-
-  const int VERTICES_COUNT = meshHeader_->framesNum() * 
-    meshHeader_->verticesNum();
+  const size_t VERTICES_BYTES = sizeof( Q3Vertice ) *
+    meshHeader_->framesNum() * meshHeader_->verticesNum();
   
-  std::vector< Q3Vertice >            q3Vertices( VERTICES_COUNT );
-  std::vector< Q3Vertice >::iterator  q3VertItor = q3Vertices.begin();
+  std::vector< Utilities::ByteSpan::Byte >  framesData( VERTICES_BYTES );
 
   framesStream.seekg( meshOffset );
   framesStream.seekg( 
     meshHeader_->vertexStart(), 
     std::ios_base::cur );
   
-  framesStream.read(
-    reinterpret_cast< char* >( &q3Vertices.front() ),
-    sizeof( Q3Vertice ) * q3Vertices.size() );
+  if( VERTICES_BYTES != 0 )
+    framesStream.read(
+      reinterpret_cast< char* >( &framesData.front() ),
+      VERTICES_BYTES );
+
+  convertVerticesKeyFrames( framesData.empty() ? 0 : &framesData.front() );
+}
+
+//
+void MD3Mesh
+::convertVerticesKeyFrames( const Utilities::ByteSpan::Byte* framesData )
+{
+  vertKeyFrames_.resize( meshHeader_->framesNum() );
+
+  const Utilities::ByteSpan::Byte* q3VertData = framesData;
 
   for( size_t frameIndex = 0;
     frameIndex < vertKeyFrames_.size();
@@ -118,15 +218,43 @@ void MD3Mesh
 
       Vertices& currFrame = vertKeyFrames_[ frameIndex ];
 
-      currFrame[vertexIndex].setX( q3VertItor->vertex[ 0 ] / Q3_SCALE_FACTOR );
-      currFrame[vertexIndex].setY( q3VertItor->vertex[ 1 ] / Q3_SCALE_FACTOR );
-      currFrame[vertexIndex].setZ( q3VertItor->vertex[ 2 ] / Q3_SCALE_FACTOR );
+      // Dane odwzorowanego pliku nie musza byc wyrownane
+      Q3Vertice q3Vertice;
+      memcpy( &q3Vertice, q3VertData, sizeof( q3Vertice ) );
 
-      ++q3VertItor;
+      currFrame[vertexIndex].setX( q3Vertice.vertex[ 0 ] / Q3_SCALE_FACTOR );
+      currFrame[vertexIndex].setY( q3Vertice.vertex[ 1 ] / Q3_SCALE_FACTOR );
+      currFrame[vertexIndex].setZ( q3Vertice.vertex[ 2 ] / Q3_SCALE_FACTOR );
+
+      q3VertData += sizeof( Q3Vertice );
     }   
   }
 }
 
+//
+void MD3Mesh
+::checkSectionsBounds( size_t meshBytesCount ) const
+{
+  const int VERTICES_NUM = meshHeader_->verticesNum();
+
+  const bool VALID_VERTICES = VERTICES_NUM >= 0 &&
+    static_cast< size_t >( VERTICES_NUM ) <= 
+      meshBytesCount / sizeof( Q3Vertice );
+
+  if( !VALID_VERTICES ||
+    !sectionInside( meshHeader_->trianglesStart(), 
+      meshHeader_->trianglesNum(), sizeof( Face ), meshBytesCount ) ||
+    !sectionInside( meshHeader_->uvStart(), 
+      VERTICES_NUM, sizeof( Vector2 ), meshBytesCount ) ||
+    !sectionInside( meshHeader_->vertexStart(), 
+      meshHeader_->framesNum(), sizeof( Q3Vertice ) * VERTICES_NUM,
+      meshBytesCount ) )
+  {
+    throw MD3FileHeader::BadHeaderData( 
+      "MD3Mesh: Sekcje siatki wykraczaja poza obszar danych!" );
+  }
+}
+
 //
 void MD3Mesh
 ::computeVerticesNormals()
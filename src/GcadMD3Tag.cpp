@@ -23,10 +23,26 @@
 namespace Gcad {
 namespace Framework {
 
+//
 MD3Tag
 ::MD3Tag( std::istream& tagDataStream )
 {
-  tagDataStream.read( name_, sizeof( name_ ) );
+  readFrom( tagDataStream );
+}
+
+//
+MD3Tag
+::MD3Tag( Utilities::ByteSpanReader& tagData )
+{
+  readFrom( tagData );
+}
+
+//
+template< typename SOURCE >
+void MD3Tag
+::readFrom( SOURCE& tagDataSource )
+{
+  Utilities::readFromSource( tagDataSource, name_, sizeof( name_ ) );
 
   // Oryginalna struktura organizacyjna danych pobieranych z wejscia
   struct {
@@ -34,7 +50,8 @@ MD3Tag
     float orient[ 3 ][ 3 ];
   } tagData;
   
-  tagDataStream.read(
+  Utilities::readFromSource(
+    tagDataSource,
     reinterpret_cast< char* >( &tagData ),
     sizeof( tagData ) );
 
@@ -90,21 +90,36 @@ struct MS3DKeyFrame {
   float param[3];
 };
 
+// Stan bledu zrodla danych. Odczyt z widoku ByteSpan zglasza wyjatek
+// ByteSpanReader::Overrun, wiec nigdy nie pozostawia zrodla w stanie bledu
+bool
+sourceFailed(std::istream& inputData)
+{
+  return !inputData;
+}
+
+bool
+sourceFailed(ByteSpanReader&)
+{
+  return false;
+}
+
+template<typename SOURCE>
 void
-formatValidation(std::istream& inputData)
+formatValidation(SOURCE& inputData)
 {
   char strIdentifier[10] = {0};
-  readFromStdStream( inputData,
+  readFromSource( inputData,
     strIdentifier,
     sizeof(strIdentifier) );
   
   int versionInfo = 0;
-  readFromStdStream( inputData,
+  readFromSource( inputData,
     &versionInfo,
     1 );
   
   if( string(strIdentifier, 10) != "MS3D000000" ||
-    !inputData ||
+    sourceFailed(inputData) ||
     !(versionInfo == 3 || versionInfo == 4) )
   {
     throw MS3DModel::BadDataFormat( 
@@ -112,12 +127,13 @@ formatValidation(std::istream& inputData)
   }
 }
 
+template<typename SOURCE>
 void
-extractVertices(istream& inputData,
+extractVertices(SOURCE& inputData,
                 MS3DModel::Vertices& vertices)
 {
   WORD verticesNum;
-  readFromStdStream( inputData,
+  readFromSource( inputData,
     &verticesNum,
     1 );
 
@@ -127,16 +143,16 @@ extractVertices(istream& inputData,
   RefArrayCntPtr<MS3DVertex> verticesDataChunk(new MS3DVertex[verticesNum]);
   
   for(int i = 0; i < verticesNum; ++i) {
-    readFromStdStream( inputData,
+    readFromSource( inputData,
       &verticesDataChunk[i].editorFlags, 
       1);
-    readFromStdStream( inputData,
+    readFromSource( inputData,
       &verticesDataChunk[i].position, 
       1);
-    readFromStdStream( inputData,
+    readFromSource( inputData,
       &verticesDataChunk[i].boneIndice,
       1);
-    readFromStdStream( inputData,
+    readFromSource( inputData,
       &verticesDataChunk[i].referenceCount,
       1);
   }
@@ -157,34 +173,35 @@ extractVertices(istream& inputData,
   }
 }
 
+template<typename SOURCE>
 void
-extractFaces(istream& inputData,
+extractFaces(SOURCE& inputData,
              MS3DModel::Faces& faces)
 {
   WORD facesNum;
-  readFromStdStream( inputData,
+  readFromSource( inputData,
     &facesNum,
     1 );
 
   RefArrayCntPtr<MS3DFace> facesDataChunk(new MS3DFace[facesNum]);
 
   for(int i = 0; i < facesNum; ++i) {
-    readFromStdStream( inputData,
+    readFromSource( inputData,
       &facesDataChunk[i].editorFlags, 
       1);
-    readFromStdStream( inputData,
+    readFromSource( inputData,
       &facesDataChunk[i].verticesIndices, 
       1);
-    readFromStdStream( inputData,
+    readFromSource( inputData,
       &facesDataChunk[i].verticesNormals, 
       1);
-    readFromStdStream( inputData,
+    readFromSource( inputData,
       &facesDataChunk[i].textureCoords, 
       1);
-    readFromStdStream( inputData,
+    readFromSource( inputData,
       &facesDataChunk[i].smoothingGroup, 
       1);
-    readFromStdStream( inputData,
+    readFromSource( inputData,
       &facesDataChunk[i].groupIndex, 
       1);  
   }
@@ -220,12 +237,13 @@ extractFaces(istream& inputData,
   }
 }
 
+template<typename SOURCE>
 void
-extractMeshes(istream& inputData,
+extractMeshes(SOURCE& inputData,
               MS3DModel::Meshes& meshes)
 {
   WORD meshesNum;
-  readFromStdStream( inputData,
+  readFromSource( inputData,
     &meshesNum,
     1 ); 
 
@@ -234,13 +252,13 @@ extractMeshes(istream& inputData,
   for(int meshCnt = 0; meshCnt < meshesNum; ++meshCnt) {
     MS3DMesh ms3dMesh;
 
-    readFromStdStream(inputData,
+    readFromSource(inputData,
       &ms3dMesh.editorFlags,
       1);
-    readFromStdStream(inputData,
+    readFromSource(inputData,
       &ms3dMesh.name,
       1);
-    readFromStdStream(inputData,
+    readFromSource(inputData,
       &ms3dMesh.triNum,
       1);
   
@@ -250,14 +268,14 @@ extractMeshes(istream& inputData,
 
     typedef WORD MS3DTriIndex;
     RefArrayCntPtr<MS3DTriIndex> triIndices(new MS3DTriIndex[ms3dMesh.triNum]);
-    readFromStdStream(inputData,
+    readFromSource(inputData,
       triIndices.get(),
       ms3dMesh.triNum);
 
     meshes[meshCnt].setTriangleIndices(ms3dMesh.triNum, triIndices.get());
 
     char materialIndex;
-    readFromStdStream(inputData,
+    readFromSource(inputData,
       &materialIndex,
       1);
 
@@ -265,46 +283,47 @@ extractMeshes(istream& inputData,
   }
 }
 
+template<typename SOURCE>
 void
-extractMaterials(istream& inputData,
+extractMaterials(SOURCE& inputData,
                  MS3DModel::Materials& materials)
 {
   WORD materialsNum;
-  readFromStdStream( inputData,
+  readFromSource( inputData,
     &materialsNum,
     1 );
 
   RefArrayCntPtr<MS3DMaterial>  ms3dMaterials(new MS3DMaterial[materialsNum]);
   
   for(int i = 0; i < materialsNum; ++i) {
-    readFromStdStream( inputData,
+    readFromSource( inputData,
       &ms3dMaterials[i].name,
       1);
-    readFromStdStream( inputData,
+    readFromSource( inputData,
       &ms3dMaterials[i].ambient,
       1);
-    readFromStdStream( inputData,
+    readFromSource( inputData,
       &ms3dMaterials[i].diffuse,
       1);
-    readFromStdStream( inputData,
+    readFromSource( inputData,
       &ms3dMaterials[i].specular,
       1);
-    readFromStdStream( inputData,
+    readFromSource( inputData,
       &ms3dMaterials[i].emissive,
       1);
-    readFromStdStream( inputData,
+    readFromSource( inputData,
       &ms3dMaterials[i].shininess,
       1);
-    readFromStdStream( inputData,
+    readFromSource( inputData,
       &ms3dMaterials[i].transparency,
       1);
-    readFromStdStream( inputData,
+    readFromSource( inputData,
       &ms3dMaterials[i].mode,
       1);
-    readFromStdStream( inputData,
+    readFromSource( inputData,
       &ms3dMaterials[i].texture,
       1);
-    readFromStdStream( inputData,
+    readFromSource( inputData,
       &ms3dMaterials[i].alpha,
       1);
   }
@@ -334,12 +353,13 @@ extractMaterials(istream& inputData,
   }
 }
 
+template<typename SOURCE>
 void
-extractJoints(istream& inputData,
+extractJoints(SOURCE& inputData,
               MS3DModel::Joints& joints)
 {
   WORD jointsNum;
-  readFromStdStream( inputData,
+  readFromSource( inputData,
     &jointsNum,
     1 );
   
@@ -349,25 +369,25 @@ extractJoints(istream& inputData,
   {
     RefCountPtr<MS3DJoint> ms3dJoint(new MS3DJoint);
 
-    readFromStdStream(inputData,
+    readFromSource(inputData,
       &ms3dJoint->editorFlags,
       1);
-    readFromStdStream(inputData,
+    readFromSource(inputData,
       &ms3dJoint->name,
       1);
-    readFromStdStream(inputData,
+    readFromSource(inputData,
       &ms3dJoint->parentName,
       1);
-    readFromStdStream(inputData,
+    readFromSource(inputData,
       &ms3dJoint->initialRotation,
       1);
-    readFromStdStream(inputData,
+    readFromSource(inputData,
       &ms3dJoint->initialPosition,
       1);
-    readFromStdStream(inputData,
+    readFromSource(inputData,
       &ms3dJoint->numOfKeyFramesRotation,
       1);
-    readFromStdStream(inputData,
+    readFromSource(inputData,
       &ms3dJoint->numOfKeyFramesTranslation,
       1);
 
@@ -410,6 +430,65 @@ MS3DModel
   extractJoints(inputData, joints_);
 }
 
+MS3DModel
+::MS3DModel(const Utilities::ByteSpan& ms3dData)
+{
+  ByteSpanReader inputData(ms3dData);
+
+  formatValidation(inputData);
+  extractVertices(inputData, vertices_);
+  extractFaces(inputData, faces_);
+  extractMeshes(inputData, meshes_);
+  extractMaterials(inputData, materials_);
+  extractJoints(inputData, joints_);
+}
+
+void
+MS3DModel
+::swap(MS3DModel& that)
+{
+  vertices_.swap(that.vertices_);
+  faces_.swap(that.faces_);
+  meshes_.swap(that.meshes_);
+  materials_.swap(that.materials_);
+  joints_.swap(that.joints_);
+}
+
+size_t
+MS3DModel
+::getByteSize() const
+{
+  size_t byteSize = sizeof(MS3DModel) +
+    dynamicByteSize(vertices_) +
+    dynamicByteSize(faces_) +
+    dynamicByteSize(meshes_) +
+    dynamicByteSize(materials_) +
+    dynamicByteSize(joints_);
+
+  for(MeshesConstItor meshItor = meshes_.begin();
+    meshItor != meshes_.end();
+    ++meshItor)
+  {
+    byteSize += meshItor->getDynamicByteSize();
+  }
+
+  for(MaterialsConstItor materialItor = materials_.begin();
+    materialItor != materials_.end();
+    ++materialItor)
+  {
+    byteSize += materialItor->getDynamicByteSize();
+  }
+
+  for(JointsConstItor jointItor = joints_.begin();
+    jointItor != joints_.end();
+    ++jointItor)
+  {
+    byteSize += jointItor->getDynamicByteSize();
+  }
+
+  return byteSize;
+}
+
 MS3DModel::Face::Normal 
 MS3DModel::Face
 ::getNormal(int whichVertex) const 
@@ -490,6 +569,20 @@ MS3DModel::Mesh
     &triIndexes_.front());
 }
 
+size_t
+MS3DModel::Mesh
+::getDynamicByteSize() const
+{
+  return dynamicByteSize(triIndexes_);
+}
+
+size_t
+MS3DModel::Material
+::getDynamicByteSize() const
+{
+  return dynamicByteSize(textureName_) + dynamicByteSize(alphaTexName_);
+}
+
 
 MS3DModel::Joint
 ::Joint(std::istream& input,
@@ -503,16 +596,42 @@ MS3DModel::Joint
   , parentName_(parentName)
   , initialRotation_(initialRotation)
   , initialPosition_(initialPosition)
+{
+  readKeyFrames(input, numKeyFrameRotations, numKeyFrameTranslations);
+}
+
+MS3DModel::Joint
+::Joint(Utilities::ByteSpanReader& input,
+        const std::string& name,
+        const std::string& parentName,
+        const Vector3& initialRotation,
+        const Vector3& initialPosition,
+        int numKeyFrameRotations,
+        int numKeyFrameTranslations)
+  : name_(name)
+  , parentName_(parentName)
+  , initialRotation_(initialRotation)
+  , initialPosition_(initialPosition)
+{
+  readKeyFrames(input, numKeyFrameRotations, numKeyFrameTranslations);
+}
+
+template<typename SOURCE>
+void
+MS3DModel::Joint
+::readKeyFrames(SOURCE& input,
+                int numKeyFrameRotations,
+                int numKeyFrameTranslations)
 {
   const int KFR = numKeyFrameRotations;
   
   RefArrayCntPtr<MS3DKeyFrame>  ms3dKeyFrameRotate(new MS3DKeyFrame[KFR]);
 
   for(int i = 0; i < KFR; ++i) {
-    readFromStdStream(input,
+    readFromSource(input,
       &ms3dKeyFrameRotate[i].time,
       1);
-    readFromStdStream(input,
+    readFromSource(input,
       &ms3dKeyFrameRotate[i].param,
       1);
   }
@@ -546,13 +665,13 @@ MS3DModel::Joint
 
   const int KFT = numKeyFrameTranslations;
 
-  RefArrayCntPtr<MS3DKeyFrame>  ms3dKeyFrameTransl(new MS3DKeyFrame[KFR]);
+  RefArrayCntPtr<MS3DKeyFrame>  ms3dKeyFrameTransl(new MS3DKeyFrame[KFT]);
 
-  for(int i = 0; i < KFR; ++i) {
-    readFromStdStream(input,
+  for(int i = 0; i < KFT; ++i) {
+    readFromSource(input,
       &ms3dKeyFrameTransl[i].time,
       1);
-    readFromStdStream(input,
+    readFromSource(input,
       &ms3dKeyFrameTransl[i].param,
       1);
   }
@@ -581,6 +700,19 @@ MS3DModel::Joint
   eulerToQuaternion(initialRotation_, &initQuatRotation_);
 }
 
+size_t
+MS3DModel::Joint
+::getDynamicByteSize() const
+{
+  return dynamicByteSize(name_) +
+    dynamicByteSize(parentName_) +
+    dynamicByteSize(keyFrameTimeForRotation_) +
+    dynamicByteSize(keyFrameRotation_) +
+    dynamicByteSize(keyFrameQuaternion_) +
+    dynamicByteSize(keyFrameTimeForPosition_) +
+    dynamicByteSize(keyFramePosition_);
+}
+
 float 
 MS3DModel::Joint
 ::getRotationFrameTimeMember(size_t whichFrame) const 
@@ -0,0 +1,119 @@
+/***************************************************************************
+ *   Copyright (C) 2005 by Eryk Klebanski                                  *
+ *   rixment@gmail.com                                                     *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+
+#include "GcadModelDataAllocator.h"
+
+#ifdef GCAD_MODEL_DATA_POOL
+
+#include "GcadThread.h"
+
+using namespace Gcad::Platform;
+using namespace Gcad::Utilities;
+
+namespace Gcad {
+namespace Framework {
+
+namespace {
+
+  const size_t  SEGMENT_BYTES      = 256;
+  const size_t  SEGMENTS_PER_CHUNK = 16384;  // 4MB
+  const size_t  MAX_CHUNKS         = 64;
+
+  ChunkedMemoryPool&
+  modelDataPool()
+  {
+    static ChunkedMemoryPool pool( SEGMENT_BYTES, SEGMENTS_PER_CHUNK, 
+      MAX_CHUNKS );
+    return pool;
+  }
+
+  Mutex&
+  modelDataMutex()
+  {
+    static Mutex mutex;
+    return mutex;
+  }
+
+  // Utworzenie puli i muteksu podczas inicjalizacji biblioteki - pierwsze
+  // uzycie moze nastapic jednoczesnie w kilku watkach roboczych
+  struct PoolInitializer {
+    PoolInitializer() 
+    {
+      modelDataMutex();
+      modelDataPool();
+    }
+  } poolInitializer;
+
+} // anonymous namespace
+
+void*
+ModelDataPool
+::operator new( size_t bytesCount ) throw( std::bad_alloc )
+{
+  MutexLock lock( modelDataMutex() );
+  return modelDataPool().allocate( bytesCount );
+}
+
+void
+ModelDataPool
+::operator delete( void* memoryToRelease ) throw()
+{
+  MutexLock lock( modelDataMutex() );
+  modelDataPool().deallocate( memoryToRelease );
+}
+
+void
+ModelDataPool
+::purgeMemory()
+{
+  MutexLock lock( modelDataMutex() );
+  modelDataPool().purge();
+}
+
+MemoryAllocStats
+ModelDataPool
+::statistics()
+{
+  MutexLock lock( modelDataMutex() );
+  return modelDataPool().statistics();
+}
+
+void
+ModelDataPool
+::setIdleRelease( const TimeInformation*  timeInformation,
+                  size_t                  idleMilliseconds )
+{
+  MutexLock lock( modelDataMutex() );
+  modelDataPool().setIdleRelease( timeInformation, idleMilliseconds );
+}
+
+void
+ModelDataPool
+::releaseIdleChunks()
+{
+  MutexLock lock( modelDataMutex() );
+  modelDataPool().releaseIdleChunks();
+}
+
+} // namespace Framework
+} // namespace Gcad
+
+#endif
@@ -0,0 +1,168 @@
+/***************************************************************************
+ *   Copyright (C) 2005 by Eryk Klebanski                                  *
+ *   rixment@gmail.com                                                     *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+
+#include "GcadProcessedCache.h"
+#include "GcadAtomic.h"
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <sstream>
+
+namespace Gcad {
+namespace Platform {
+
+namespace {
+
+  const char MAGIC[4] = { 'G', 'P', 'C', 'E' };
+
+  ContentHash
+  makeHash(ProcessedCache::UInt32 high, ProcessedCache::UInt32 low)
+  {
+    return (static_cast<ContentHash>(high) << 32) | low;
+  }
+
+} // anonymous namespace
+
+//
+ProcessedCache::ProcessedCache(const std::string& directory)
+  : directory_(directory)
+  , temporaryCounter_(0)
+{
+}
+
+//
+ContentHash
+ProcessedCache::hashContent(const Utilities::ByteSpan& bytes)
+{
+  // Stale FNV-1a 64 sa skladane z polowek - literaly 64 bitowe nie sa
+  // czescia C++98
+  const ContentHash OFFSET_BASIS = makeHash(0xcbf29ce4u, 0x84222325u);
+  const ContentHash PRIME        = makeHash(0x00000100u, 0x000001b3u);
+
+  ContentHash hash = OFFSET_BASIS;
+  for(const Utilities::ByteSpan::Byte* byte = bytes.begin(); 
+    byte != bytes.end();
+    ++byte)
+  {
+    hash ^= *byte;
+    hash *= PRIME;
+  }
+  return hash;
+}
+
+//
+std::string
+ProcessedCache::entryPath(ContentHash hash) const
+{
+  char name[32];
+  std::sprintf(name, "%08x%08x.gpc", 
+    static_cast<UInt32>(hash >> 32), static_cast<UInt32>(hash));
+  return directory_ + "/" + name;
+}
+
+//
+bool
+ProcessedCache::find(ContentHash           hash,
+                     MappedFile*           entry,
+                     Utilities::ByteSpan*  payload) const
+{
+  if( !entry->map( entryPath(hash) ) )
+    return false;
+
+  const Utilities::ByteSpan BYTES = entry->bytes();
+
+  Header header;
+  if( !BYTES.contains(0, sizeof(header)) ) {
+    entry->unmap();
+    return false;
+  }
+  std::memcpy(&header, BYTES.data(), sizeof(header));
+
+  // Porownanie skrotu chroni przed wpisem podmienionym recznie, a rozmiar
+  // przed wpisem niekompletnym
+  if( std::memcmp(header.magic_, MAGIC, sizeof(MAGIC)) != 0 ||
+    header.version_ != VERSION ||
+    makeHash(header.hashHigh_, header.hashLow_) != hash ||
+    !BYTES.contains(sizeof(header), header.payloadSize_) )
+  {
+    entry->unmap();
+    return false;
+  }
+
+  *payload = BYTES.subspan(sizeof(header), header.payloadSize_);
+  return true;
+}
+
+//
+bool
+ProcessedCache::store(ContentHash         hash,
+                      const std::string&  payload) const
+{
+  // Plik tymczasowy posiada nazwe unikalna w ramach procesu (licznik),
+  // oraz - z duzym prawdopodobienstwem - pomiedzy procesami (czas)
+
+  Header header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic_, MAGIC, sizeof(MAGIC));
+  header.version_     = VERSION;
+  header.hashLow_     = static_cast<UInt32>(hash);
+  header.hashHigh_    = static_cast<UInt32>(hash >> 32);
+  header.payloadSize_ = static_cast<UInt32>(payload.size());
+
+  if( payload.size() != header.payloadSize_ )
+    return false;
+
+  const std::string PATH = entryPath(hash);
+
+  std::ostringstream temporaryPath;
+  temporaryPath << PATH << '.' << std::time(0) << '.' <<
+    Utilities::atomicIncrement(&temporaryCounter_) << ".tmp";
+  const std::string TEMPORARY = temporaryPath.str();
+
+  {
+    std::ofstream output(TEMPORARY.c_str(), std::ios_base::binary);
+    output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    output.write(payload.data(), payload.size());
+    output.close();
+
+    if( !output ) {
+      std::remove(TEMPORARY.c_str());
+      return false;
+    }
+  }
+
+  // Pod Win32 rename nie zastepuje istniejacego pliku - wpis (o tej samej
+  // zawartosci) mogl zostac zapisany przez inny watek, badz byc
+  // niepoprawny, wiec jest usuwany
+  if( std::rename(TEMPORARY.c_str(), PATH.c_str()) != 0 ) {
+    std::remove(PATH.c_str());
+    if( std::rename(TEMPORARY.c_str(), PATH.c_str()) != 0 ) {
+      std::remove(TEMPORARY.c_str());
+      return false;
+    }
+  }
+
+  return true;
+}
+
+} // namespace Platform
+} // namespace Gcad
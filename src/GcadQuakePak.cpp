@@ -0,0 +1,198 @@
+/***************************************************************************
+ *   Copyright (C) 2005 by Eryk Klebanski                                  *
+ *   rixment@gmail.com                                                     *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+
+#include "GcadQuakePak.h"
+#include "GcadAssertion.h"
+#include <algorithm>
+#include <cstring>
+
+namespace Gcad {
+namespace Platform {
+
+//
+struct QuakePak::NameLess {
+  NameLess(const std::vector<std::string>& names)
+    : names_(&names)
+  {}
+
+  bool operator ()(size_t lhs, size_t rhs) const {
+    return (*names_)[lhs] < (*names_)[rhs];
+  }
+
+  const std::vector<std::string>*  names_;
+};
+
+//
+QuakePak::QuakePak()
+{
+}
+
+//
+bool
+QuakePak::open(const std::string& path)
+{
+  close();
+
+  if( !file_.map(path) )
+    return false;
+
+  if( !indexDirectory() ) {
+    close();
+    return false;
+  }
+
+  return true;
+}
+
+//
+void
+QuakePak::close()
+{
+  file_.unmap();
+  NameToEntry().swap(nameToEntry_);
+  std::vector<Utilities::ByteSpan>().swap(bytes_);
+  std::vector<std::string>().swap(names_);
+  std::vector<size_t>().swap(sorted_);
+}
+
+//
+bool
+QuakePak::indexDirectory()
+{
+  // Nazwy wpisow sa odwzorowywane na kolejne uchwyty drzewa TST, wiec
+  // uchwyt nowej nazwy jest rowny liczbie dotychczas zindeksowanych
+  // wpisow. Mniejsza wartosc oznacza powtorzona nazwe - wpis zostaje
+  // pominiety. Widoki danych sa tworzone jednokrotnie, a kolejne
+  // wyszukiwania nie odwoluja sie juz do katalogu archiwum
+
+  const Utilities::ByteSpan BYTES = file_.bytes();
+
+  Header header;
+  if( sizeof(UInt32) != 4 || !BYTES.contains(0, sizeof(header)) )
+    return false;
+
+  std::memcpy(&header, BYTES.data(), sizeof(header));
+
+  if( std::memcmp(header.magic_, "PACK", 4) != 0 ||
+    header.directoryLength_ % sizeof(Entry) != 0 ||
+    !BYTES.contains(header.directoryOffset_, header.directoryLength_) )
+  {
+    return false;
+  }
+
+  const size_t ENTRIES_COUNT = header.directoryLength_ / sizeof(Entry);
+  const Utilities::ByteSpan::Byte* DIRECTORY = 
+    BYTES.data() + header.directoryOffset_;
+
+  bytes_.reserve(ENTRIES_COUNT);
+  names_.reserve(ENTRIES_COUNT);
+
+  for(size_t entryIndex = 0; entryIndex < ENTRIES_COUNT; ++entryIndex)
+  {
+    Entry entry;
+    std::memcpy(&entry, DIRECTORY + entryIndex * sizeof(Entry), sizeof(entry));
+
+    if( !BYTES.contains(entry.filePosition_, entry.fileLength_) )
+      return false;
+
+    const char* NAME_BEGIN = entry.name_;
+    std::string name(NAME_BEGIN,
+      std::find(NAME_BEGIN, NAME_BEGIN + NAME_LENGTH, '\0'));
+    if( name.empty() )
+      continue;
+
+    std::replace(name.begin(), name.end(), '/', '\\');
+
+    if( nameToEntry_.getHandle(name) != bytes_.size() )
+      continue;
+
+    bytes_.push_back( BYTES.subspan(entry.filePosition_, entry.fileLength_) );
+    names_.push_back(name);
+  }
+
+  nameToEntry_.freeze();
+
+  sorted_.resize(names_.size());
+  for(size_t handle = 0; handle < sorted_.size(); ++handle)
+    sorted_[handle] = handle;
+  std::sort(sorted_.begin(), sorted_.end(), NameLess(names_));
+
+  return true;
+}
+
+//
+size_t
+QuakePak::entriesCount() const
+{
+  return sorted_.size();
+}
+
+//
+std::string
+QuakePak::entryName(size_t index) const
+{
+  Utilities::assertion( index < entriesCount(), "Niepoprawny indeks wpisu!" );
+  return names_[ sorted_[index] ];
+}
+
+//
+Utilities::ByteSpan
+QuakePak::entryBytes(size_t index) const
+{
+  Utilities::assertion( index < entriesCount(), "Niepoprawny indeks wpisu!" );
+  return bytes_[ sorted_[index] ];
+}
+
+//
+size_t
+QuakePak::lowerBound(const std::string& name) const
+{
+  size_t first = 0;
+  size_t count = sorted_.size();
+
+  while( count > 0 )
+  {
+    const size_t HALF = count / 2;
+    if( names_[ sorted_[first + HALF] ] < name ) {
+      first += HALF + 1;
+      count -= HALF + 1;
+    }
+    else
+      count = HALF;
+  }
+
+  return first;
+}
+
+//
+bool
+QuakePak::find(const std::string& name, Utilities::ByteSpan* bytes) const
+{
+  NameToEntry::Handle handle;
+  if( !nameToEntry_.findHandle(name, &handle) )
+    return false;
+
+  *bytes = bytes_[handle];
+  return true;
+}
+
+} // namespace Platform
+} // namespace Gcad
@@ -0,0 +1,270 @@
+/***************************************************************************
+ *   Copyright (C) 2005 by Eryk Klebanski                                  *
+ *   rixment@gmail.com                                                     *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+
+#include "GcadResourceManagerStats.h"
+#include <algorithm>
+
+namespace Gcad {
+namespace Platform {
+
+namespace {
+
+  const char* const PRIORITY_NAMES[ ResourceManagerStats::PRIORITIES_COUNT ] =
+    { "low", "medium", "high" };
+
+  bool 
+  isMoreExpensive( const ResourceManagerStats::ExpensiveResource&  lhs,
+                   const ResourceManagerStats::ExpensiveResource&  rhs )
+  {
+    return lhs.loadMicroseconds_ > rhs.loadMicroseconds_;
+  }
+
+  void
+  writeHistogram( std::ostream&  out,
+                  const char*    name,
+                  const size_t*  histogram )
+  {
+    for( int bucket = 0; 
+      bucket < ResourceManagerStats::HISTOGRAM_BUCKETS; 
+      ++bucket )
+    {
+      if( histogram[ bucket ] == 0 )
+        continue;
+
+      out << name << ".us_ge_" << ( static_cast< size_t >( 1 ) << bucket ) 
+          << ' ' << histogram[ bucket ] << '\n';
+    }
+  }
+
+  /** Numer kolejnego watku rejestrujacego trafienia */
+  volatile long  threadsCount = 0;
+
+  /** Numer biezacego watku (0 - jeszcze nie przydzielony) */
+  GCAD_THREAD_LOCAL long  threadNumber = 0;
+
+} // anonymous namespace
+
+//
+void
+ResourceManagerCounters::reset()
+{
+  for( int priority = 0; 
+    priority < ResourceManagerStats::PRIORITIES_COUNT; 
+    ++priority )
+  {
+    hits_[ priority ]   = 0;
+    misses_[ priority ] = 0;
+
+    // Zerowanie moze przebiegac rownolegle z dereferencjami bez muteksu -
+    // odejmowana jest wartosc odczytana, a nie zapisywane zero
+    for( int shard = 0; shard < SHARED_HIT_SHARDS; ++shard )
+    {
+      volatile long* const HITS = &sharedHits_[ shard ].hits_[ priority ];
+      Utilities::atomicExchangeAdd( HITS, -Utilities::atomicLoad( HITS ) );
+    }
+  }
+
+  loads_        = 0;
+  failedLoads_  = 0;
+  bytesLoaded_  = 0;
+  evictions_    = 0;
+  bytesEvicted_ = 0;
+
+  for( int bucket = 0; 
+    bucket < ResourceManagerStats::HISTOGRAM_BUCKETS; 
+    ++bucket )
+  {
+    readHistogram_[ bucket ]  = 0;
+    parseHistogram_[ bucket ] = 0;
+  }
+
+  expensiveCount_ = 0;
+}
+
+//
+void
+ResourceManagerCounters::recordSharedHit( ResourcePriority priority )
+{
+  if( threadNumber == 0 )
+    threadNumber = Utilities::atomicIncrement( &threadsCount );
+
+  Utilities::atomicIncrement( 
+    &sharedHits_[ threadNumber & ( SHARED_HIT_SHARDS - 1 ) ].hits_[ priority ] );
+}
+
+//
+void
+ResourceManagerCounters::recordTime( size_t*  histogram,
+                                     size_t   microseconds )
+{
+  int bucket = 0;
+  while( microseconds > 1 &&
+    bucket < ResourceManagerStats::HISTOGRAM_BUCKETS - 1 )
+  {
+    microseconds >>= 1;
+    ++bucket;
+  }
+
+  ++histogram[ bucket ];
+}
+
+//
+void
+ResourceManagerCounters::recordRead( size_t microseconds )
+{
+  recordTime( readHistogram_, microseconds );
+}
+
+//
+void
+ResourceManagerCounters::recordParse( size_t microseconds )
+{
+  recordTime( parseHistogram_, microseconds );
+}
+
+//
+void
+ResourceManagerCounters::recordLoad( const std::string&  path,
+                                     size_t              byteSize,
+                                     size_t              loadMicroseconds )
+{
+  // Lista najkosztowniejszych zasobow posiada stala dlugosc, wiec jest
+  // przegladana liniowo - zasob juz obecny jest aktualizowany, a nowy
+  // zastepuje najtanszy element pelnej listy
+
+  ++loads_;
+  bytesLoaded_ += byteSize;
+
+  ResourceManagerStats::ExpensiveResource* cheapest = 0;
+
+  for( size_t entry = 0; entry < expensiveCount_; ++entry )
+  {
+    ResourceManagerStats::ExpensiveResource& expensive = expensive_[ entry ];
+
+    if( expensive.path_ == path ) {
+      expensive.loadMicroseconds_ = 
+        std::max( expensive.loadMicroseconds_, loadMicroseconds );
+      expensive.byteSize_ = byteSize;
+      return;
+    }
+
+    if( cheapest == 0 || 
+      expensive.loadMicroseconds_ < cheapest->loadMicroseconds_ )
+    {
+      cheapest = &expensive;
+    }
+  }
+
+  if( expensiveCount_ < ResourceManagerStats::EXPENSIVE_COUNT )
+    cheapest = &expensive_[ expensiveCount_++ ];
+  else if( cheapest->loadMicroseconds_ >= loadMicroseconds )
+    return;
+
+  cheapest->path_             = path;
+  cheapest->loadMicroseconds_ = loadMicroseconds;
+  cheapest->byteSize_         = byteSize;
+}
+
+//
+void
+ResourceManagerCounters::recordEviction( size_t byteSize )
+{
+  ++evictions_;
+  bytesEvicted_ += byteSize;
+}
+
+//
+void
+ResourceManagerCounters::fill( ResourceManagerStats* stats ) const
+{
+  for( int priority = 0; 
+    priority < ResourceManagerStats::PRIORITIES_COUNT; 
+    ++priority )
+  {
+    stats->hits_[ priority ]   = hits_[ priority ];
+    stats->misses_[ priority ] = misses_[ priority ];
+
+    for( int shard = 0; shard < SHARED_HIT_SHARDS; ++shard )
+      stats->hits_[ priority ] += 
+        Utilities::atomicLoadAcquire( &sharedHits_[ shard ].hits_[ priority ] );
+  }
+
+  stats->loads_        = loads_;
+  stats->failedLoads_  = failedLoads_;
+  stats->bytesLoaded_  = bytesLoaded_;
+  stats->evictions_    = evictions_;
+  stats->bytesEvicted_ = bytesEvicted_;
+
+  for( int bucket = 0; 
+    bucket < ResourceManagerStats::HISTOGRAM_BUCKETS; 
+    ++bucket )
+  {
+    stats->readHistogram_[ bucket ]  = readHistogram_[ bucket ];
+    stats->parseHistogram_[ bucket ] = parseHistogram_[ bucket ];
+  }
+
+  stats->expensiveCount_ = expensiveCount_;
+  std::copy( expensive_, expensive_ + expensiveCount_, stats->expensive_ );
+  std::sort( stats->expensive_, stats->expensive_ + expensiveCount_, 
+    isMoreExpensive );
+}
+
+//
+std::ostream&
+operator <<( std::ostream&                out,
+             const ResourceManagerStats&  stats )
+{
+  for( int priority = 0; 
+    priority < ResourceManagerStats::PRIORITIES_COUNT; 
+    ++priority )
+  {
+    out << "hits." << PRIORITY_NAMES[ priority ] << ' ' 
+        << stats.hits_[ priority ] << '\n'
+        << "misses." << PRIORITY_NAMES[ priority ] << ' ' 
+        << stats.misses_[ priority ] << '\n';
+  }
+
+  out << "loads "          << stats.loads_          << '\n'
+      << "failed_loads "   << stats.failedLoads_    << '\n'
+      << "bytes_loaded "   << stats.bytesLoaded_    << '\n'
+      << "evictions "      << stats.evictions_      << '\n'
+      << "bytes_evicted "  << stats.bytesEvicted_   << '\n'
+      << "used_memory "    << stats.usedMemory_     << '\n'
+      << "max_memory "     << stats.maxMemory_      << '\n'
+      << "resources "      << stats.resourcesCount_ << '\n';
+
+  writeHistogram( out, "read", stats.readHistogram_ );
+  writeHistogram( out, "parse", stats.parseHistogram_ );
+
+  for( size_t entry = 0; entry < stats.expensiveCount_; ++entry )
+  {
+    const ResourceManagerStats::ExpensiveResource& EXPENSIVE = 
+      stats.expensive_[ entry ];
+    out << "expensive." << entry << ' ' << EXPENSIVE.path_ << ' ' 
+        << EXPENSIVE.loadMicroseconds_ << "us " 
+        << EXPENSIVE.byteSize_ << "B\n";
+  }
+
+  return out;
+}
+
+} // namespace Platform
+} // namespace Gcad
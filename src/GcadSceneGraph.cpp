@@ -21,7 +21,8 @@
 #include "GcadSceneGraph.h"
 #include "GcadMatrixGenerateUtil.h"
 #include "GcadMatrixUtil.h"
-#include <stack>
+#include "GcadArenaAllocator.h"
+#include <vector>
 #include <algorithm>
 
 using namespace Gcad::Math;
@@ -150,7 +151,7 @@ SceneGraph::Node
 
 void 
 SceneGraph::Node
-::setMesh(MeshId meshId)
+::setMesh(const MeshId& meshId)
 {
   meshId_ = meshId;
 }
@@ -162,21 +163,21 @@ SceneGraph::Node
   return *parent_;
 }
 
-SceneGraph::Node::Id
+const SceneGraph::Node::Id&
 SceneGraph::Node
 ::getId() const
 {
   return id_;
 }
 
-SceneGraph::Node::Id
+const SceneGraph::Node::Id&
 SceneGraph::Node
 ::getParentId() const
 {
   return parent_->getId();
 }
 
-SceneGraph::Node::MeshId
+const SceneGraph::Node::MeshId&
 SceneGraph::Node
 ::getMeshId() const
 {
@@ -219,6 +220,7 @@ SceneGraph::Node
 SceneGraph::Viewer
 ::Viewer()
   : nodeView_(0)
+  , frameArena_(0)
 {
   MatrixGenerateUtil::identity(&relativeView_);
 }
@@ -243,16 +245,33 @@ SceneGraph::Viewer::Matrix4x4
 SceneGraph::Viewer
 ::getMatrixCompound() const
 {
-  stack<const Node*> nodesPatch;
+  // Patch lives only during this call, so it is kept in the frame arena.
+  // Viewer without a scene (no arena) falls back to the heap
+
+  if(frameArena_ == 0)
+    return compoundMatrix(allocator<const Node*>());
+
+  return compoundMatrix(ArenaAllocator<const Node*>(*frameArena_));
+}
+
+template<typename NODES_PATCH_ALLOCATOR>
+SceneGraph::Viewer::Matrix4x4 
+SceneGraph::Viewer
+::compoundMatrix(const NODES_PATCH_ALLOCATOR& allocator) const
+{
+  // The patch is built directly in its own storage - the stack adaptor
+  // would copy a prepared container on every call
+
+  vector<const Node*, NODES_PATCH_ALLOCATOR> nodesPatch(allocator);
   const Node* viewerActualNode( getNode() );
-  nodesPatch.push(viewerActualNode);
+  nodesPatch.push_back(viewerActualNode);
   
   // We are creating an patch that runs from root node
   // to node actually assigned to the viewer
 
-  while(nodesPatch.top()->getId() != "ROOT")
+  while(nodesPatch.back()->getId() != "ROOT")
   {
-    nodesPatch.push(&nodesPatch.top()->getParent());
+    nodesPatch.push_back(&nodesPatch.back()->getParent());
   }
 
   // After that we are ready to compute view matrix form
@@ -266,11 +285,11 @@ SceneGraph::Viewer
     Matrix4x4 matrixConcatention(compoundViewMatrix);
     
     MatrixUtil::mul(
-      nodesPatch.top()->getMatrix(),
+      nodesPatch.back()->getMatrix(),
       matrixConcatention,
       &compoundViewMatrix);      
 
-    nodesPatch.pop();
+    nodesPatch.pop_back();
   }  
   
   Matrix4x4 viewMatrix;
@@ -303,7 +322,9 @@ SceneGraph::Viewer
 SceneGraph
 ::SceneGraph()
   : root_(new Node("ROOT"))
+  , frameStarted_(false)
 {
+  viewer_.frameArena_ = &frameArena_;
   anagrams_.add("ROOT", root_.get());
   viewer_.attach(getNode("ROOT"));
 }
@@ -351,6 +372,9 @@ void
 SceneGraph
 ::update(float elapsedTime)
 {
+  // Data of the previous frame is no longer referenced
+  frameArena_.reset();
+  frameStarted_ = true;
   getNode("ROOT").update(elapsedTime);
 }
 
@@ -358,10 +382,23 @@ void
 SceneGraph
 ::render()
 {
+  // Rendering without a preceding update starts a new frame as well,
+  // otherwise data of the update is still used by this frame
+  if(!frameStarted_)
+    frameArena_.reset();
+  frameStarted_ = false;
+
   // visiblity algorithm right here
   getNode("ROOT").render();
 }
 
+Gcad::Utilities::FrameArena&
+SceneGraph
+::getFrameArena()
+{
+  return frameArena_;
+}
+
 bool
 operator ==(const SceneGraph::Node& lhs,
             const SceneGraph::Node& rhs)
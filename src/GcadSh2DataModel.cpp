@@ -22,6 +22,7 @@
 #include "GcadStdIos.h"
 #include "GcadMD2Data.h"
 #include "GcadAssertion.h"
+#include <algorithm>
 
 namespace Gcad {
 namespace Framework {
@@ -52,26 +53,90 @@ int Sh2DataModel
   return texturesCoordinatesCount_;
 }
 
+size_t Sh2DataModel
+::getByteSize() const
+{
+  // Kazda klatka to obiekt wektora przydzielony w stercie, jego dane,
+  // oraz licznik odniesien wskaznika RefCountPtr
+
+  size_t byteSize = sizeof(Sh2DataModel) +
+    dynamicByteSize(verticesFrames_) +
+    dynamicByteSize(normalsFrames_) +
+    dynamicByteSize(texturesCoordinates_);
+
+  for(VerticesKeyFrames::const_iterator frameItor = verticesFrames_.begin();
+    frameItor != verticesFrames_.end();
+    ++frameItor)
+  {
+    if(frameItor->get() != 0)
+      byteSize += sizeof(FrameVertices) + sizeof(int) + 
+        dynamicByteSize(**frameItor);
+  }
+
+  for(NormalsKeyFrames::const_iterator frameItor = normalsFrames_.begin();
+    frameItor != normalsFrames_.end();
+    ++frameItor)
+  {
+    if(frameItor->get() != 0)
+      byteSize += sizeof(FrameNormals) + sizeof(int) + 
+        dynamicByteSize(**frameItor);
+  }
+
+  return byteSize;
+}
+
 Sh2DataModel
 ::Sh2DataModel(const std::string& fileName)
 {
   std::ifstream inputSh2(fileName.c_str(), std::ios_base::binary);
-  loadDataFromStream(inputSh2);
+  loadData(inputSh2);
 }
 
 Sh2DataModel
 ::Sh2DataModel(std::istream& sh2Data)
 {
-  loadDataFromStream(sh2Data);
+  loadData(sh2Data);
+}
+
+Sh2DataModel
+::Sh2DataModel(const ByteSpan& sh2Data)
+{
+  // Liczby elementow sa porownywane z rozmiarem danych przed przydzialem
+  // pamieci - wartosci z uszkodzonego pliku moga byc dowolne
+  int counts[4];
+  ByteSpanReader sh2input(sh2Data);
+  sh2input.read(counts, 4);
+
+  const int FRAMES    = counts[0];
+  const int VERTICES  = counts[1];
+  const int TEXCOORDS = counts[3];
+
+  // Klatka sklada sie z wierzcholkow i normalnych
+  const size_t FRAME_VERTEX_BYTES = 2 * sizeof(Vec3);
+  const size_t DATA_BYTES = sh2input.remaining();
+
+  const bool VALID_COUNTS = FRAMES >= 0 && VERTICES >= 0 && TEXCOORDS >= 0 &&
+    static_cast<size_t>(TEXCOORDS) <= DATA_BYTES / sizeof(Vec2) &&
+    static_cast<size_t>(VERTICES) <= DATA_BYTES / FRAME_VERTEX_BYTES &&
+    (VERTICES == 0 || static_cast<size_t>(FRAMES) <=
+      (DATA_BYTES - TEXCOORDS * sizeof(Vec2)) / (FRAME_VERTEX_BYTES * VERTICES));
+
+  if(!VALID_COUNTS)
+    throw BadDataFormat("Sh2DataModel: Dane krotsze od zapisanych w naglowku!");
+
+  sh2input.seek(0);
+  loadData(sh2input);
 }
 
-void Sh2DataModel
-::loadDataFromStream(std::istream& sh2input)
+template<typename SOURCE>
+void
+Sh2DataModel
+::loadData(SOURCE& sh2input)
 {
-  readFromStdStream( sh2input, &framesCount_, 1 );
-  readFromStdStream( sh2input, &verticesPerFrameCount_, 1 );
-  readFromStdStream( sh2input, &polygonsCount_, 1 );
-  readFromStdStream( sh2input, &texturesCoordinatesCount_, 1 );
+  readFromSource( sh2input, &framesCount_, 1 );
+  readFromSource( sh2input, &verticesPerFrameCount_, 1 );
+  readFromSource( sh2input, &polygonsCount_, 1 );
+  readFromSource( sh2input, &texturesCoordinatesCount_, 1 );
 
   verticesFrames_.resize(framesCount());
   normalsFrames_.resize(framesCount());
@@ -82,7 +147,8 @@ void Sh2DataModel
     ++frameIndex)
   {
     FrameVerticesRefPtr frame( new FrameVertices(verticesPerFrameCount()) );
-    readFromStdStream( sh2input, &frame->front(), verticesPerFrameCount() );
+    if(!frame->empty())
+      readFromSource( sh2input, &frame->front(), verticesPerFrameCount() );
     verticesFrames_[frameIndex] = frame;
   }
 
@@ -91,14 +157,30 @@ void Sh2DataModel
     ++frameIndex)
   {
     FrameVerticesRefPtr frame( new FrameNormals(verticesPerFrameCount()) );
-    readFromStdStream( sh2input, &frame->front(), verticesPerFrameCount() );
+    if(!frame->empty())
+      readFromSource( sh2input, &frame->front(), verticesPerFrameCount() );
     normalsFrames_[frameIndex] = frame;
   }
 
-  readFromStdStream( 
-    sh2input, 
-    &texturesCoordinates_.front(),
-    texturesCoordinatesCount() );
+  if(!texturesCoordinates_.empty())
+    readFromSource( 
+      sh2input, 
+      &texturesCoordinates_.front(),
+      texturesCoordinatesCount() );
+}
+
+void
+Sh2DataModel
+::swap(Sh2DataModel& that)
+{
+  verticesFrames_.swap(that.verticesFrames_);
+  normalsFrames_.swap(that.normalsFrames_);
+  texturesCoordinates_.swap(that.texturesCoordinates_);
+
+  std::swap(framesCount_, that.framesCount_);
+  std::swap(verticesPerFrameCount_, that.verticesPerFrameCount_);
+  std::swap(polygonsCount_, that.polygonsCount_);
+  std::swap(texturesCoordinatesCount_, that.texturesCoordinatesCount_);
 }
 
 Sh2DataModel::BeginEndItorVerticesFrame 
@@ -27,6 +27,26 @@ TimeInformation
 ::~TimeInformation()
 {
 }
+
+//
+size_t
+TimeInformation
+::getElapsedMicroseconds(size_t  startTime,
+                         size_t  endTime) const
+{
+  // Iloczyn liczby taktow i miliona latwo przekracza zakres size_t,
+  // dlatego calkowite sekundy i reszta sa przeliczane osobno
+
+  const size_t TICKS         = endTime - startTime;
+  const size_t TICKS_PER_SEC = getTicksCountPerSec();
+  const size_t MICROSECONDS  = 1000000;
+
+  if( TICKS_PER_SEC == 0 )
+    return 0;
+
+  return TICKS / TICKS_PER_SEC * MICROSECONDS +
+         TICKS % TICKS_PER_SEC * MICROSECONDS / TICKS_PER_SEC;
+}
       
 } // namespace Platform
 } // namespace Gcad
\ No newline at end of file
@@ -0,0 +1,596 @@
+#include "GcadBatchFileReader.h"
+
+#if defined( __linux__ ) && defined( GCAD_IO_URING )
+  #include <linux/io_uring.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <sys/syscall.h>
+  #include <cerrno>
+  #include <cstring>
+  #include <deque>
+  #include <fcntl.h>
+  #include <unistd.h>
+#endif
+
+namespace Gcad {
+namespace Platform {
+
+#if defined( __linux__ ) && defined( GCAD_IO_URING )
+
+namespace {
+
+  // Liczba wpisow kolejki zlecen - jednoczesnie otwartych plikow partii
+  const unsigned int RING_ENTRIES = 256;
+
+  // Laczna wielkosc buforow plikow w kolejce zlecen i nieodebranych
+  // wynikow. Plik wiekszy od limitu jest odczytywany samodzielnie
+  const size_t STAGING_BYTES = 16 * 1024 * 1024;
+
+  // Bufory o wiekszej pojemnosci sa zwalniane przy zwrocie do puli, 
+  // dzieki czemu pula nie przekracza okolo STAGING_BYTES
+  const size_t RETAINED_BUFFER_SIZE = STAGING_BYTES / RING_ENTRIES;
+
+/**
+  @brief
+    Czytnik zlecajacy odczyty plikow partii przez io_uring
+
+    Wielkosci plikow sa ustalane (stat) w chwili zlecenia partii. Pliki 
+    sa otwierane, a ich bufory pobierane z puli, dopiero przed 
+    umieszczeniem odczytu w kolejce zlecen, dzieki czemu liczba otwartych
+    deskryptorow nie przekracza RING_ENTRIES, a wielkosc buforow 
+    STAGING_BYTES, niezaleznie od wielkosci partii. Bufor wraca do puli 
+    przy kolejnym wywolaniu waitCompleted. Jedno wywolanie io_uring_enter
+    przekazuje jadru wszystkie przygotowane zlecenia i oczekuje na 
+    zakonczenie odczytow
+
+  @remark
+    Interfejs jest wykorzystywany bezposrednio (bez biblioteki liburing).
+    Jadra nie obslugujace operacji IORING_OP_READ (starsze niz 5.6) koncza
+    zlecenie bledem EINVAL - wowczas pliki sa odczytywane funkcja pread
+*/
+class IoUringBatchFileReader : public BatchFileReader {
+ public:
+   /**
+     @brief
+       Utworzenie czytnika, badz wartosc 0, gdy io_uring jest niedostepny
+   */
+   static IoUringBatchFileReader* create();
+
+   ~IoUringBatchFileReader();
+
+   void submit( const Paths& paths );
+   bool waitCompleted( Completion* completion );
+   const char* backendName() const { return "io_uring"; }
+
+ private:
+   typedef std::vector< char >  Buffer;
+
+   struct Request {
+     std::string  path_;
+     int          descriptor_;
+     bool         regular_;    /**< Plik istnieje i jest plikiem zwyklym */
+     Buffer*      buffer_;     /**< Bufor pliku w kolejce, badz wyniku */
+     size_t       size_;
+     size_t       readBytes_;
+   };
+
+   struct Finished {
+     size_t  request_;
+     bool    succeeded_;
+   };
+
+   IoUringBatchFileReader();
+
+   bool setup();
+
+   /**
+     @brief
+       Umieszczenie w kolejce zlecen kolejnych plikow partii
+   */
+   void fillQueue();
+
+   /**
+     @brief
+       Przygotowanie zlecenia odczytu pozostalej czesci pliku
+   */
+   void prepareRead( size_t request );
+
+   /**
+     @brief
+       Pobranie bufora o wielkosci size z puli
+   */
+   Buffer* acquireBuffer( size_t size );
+
+   /**
+     @brief
+       Zwrot bufora do puli
+   */
+   void recycleBuffer( Buffer* buffer );
+
+   /**
+     @brief
+       Przekazanie zlecen jadru, oraz oczekiwanie na minComplete wynikow.
+       Jesli jadro odrzuci zlecenia, sa one wycofywane z kolejki, a pliki
+       zostaja odczytane funkcja pread
+   */
+   void enter( unsigned int minComplete );
+
+   /**
+     @brief
+       Wycofanie zlecen nieprzekazanych jadru
+   */
+   void rollbackSubmissions();
+
+   /**
+     @brief
+       Odebranie wynikow z kolejki zakonczen
+   */
+   void reapCompletions();
+
+   void finish( size_t request, bool succeeded );
+
+   /**
+     @brief
+       Oczekiwanie na zakonczenie wszystkich zlecen przekazanych jadru
+   */
+   void drain();
+
+ private:
+   int            ringDescriptor_;
+   void*          sqRing_;
+   size_t         sqRingSize_;
+   void*          cqRing_;
+   size_t         cqRingSize_;
+   io_uring_sqe*  sqes_;
+   size_t         sqesSize_;
+
+   unsigned*      sqTail_;
+   unsigned*      sqMask_;
+   unsigned*      sqArray_;
+   unsigned*      cqHead_;
+   unsigned*      cqTail_;
+   unsigned*      cqMask_;
+   io_uring_cqe*  cqes_;
+   unsigned int   entries_;
+
+   std::vector< Request >   requests_;
+   std::deque< Buffer >     buffers_;      /**< Wszystkie bufory */
+   std::vector< Buffer* >   idleBuffers_;
+   Buffer*                  deliveredBuffer_; /**< Bufor odebranego wyniku */
+   size_t                   stagedBytes_;  /**< Wielkosc zajetych buforow */
+   std::deque< Finished >   finished_;     /**< Nieodebrane wyniki */
+   size_t                   nextRequest_;  /**< Pierwszy plik poza kolejka */
+   unsigned int             inFlight_;     /**< Zlecenia przekazane jadru */
+   unsigned int             toSubmit_;     /**< Zlecenia przygotowane */
+   size_t                   delivered_;
+   bool                     readUnsupported_;
+};
+
+//
+IoUringBatchFileReader*
+IoUringBatchFileReader::create()
+{
+  IoUringBatchFileReader* reader = new IoUringBatchFileReader;
+  if( !reader->setup() ) {
+    delete reader;
+    return 0;
+  }
+  return reader;
+}
+
+//
+IoUringBatchFileReader::IoUringBatchFileReader()
+  : ringDescriptor_( -1 )
+  , sqRing_( MAP_FAILED )
+  , sqRingSize_( 0 )
+  , cqRing_( MAP_FAILED )
+  , cqRingSize_( 0 )
+  , sqes_( 0 )
+  , sqesSize_( 0 )
+  , entries_( 0 )
+  , deliveredBuffer_( 0 )
+  , stagedBytes_( 0 )
+  , nextRequest_( 0 )
+  , inFlight_( 0 )
+  , toSubmit_( 0 )
+  , delivered_( 0 )
+  , readUnsupported_( false )
+{
+}
+
+//
+IoUringBatchFileReader::~IoUringBatchFileReader()
+{
+  if( ringDescriptor_ >= 0 )
+    drain();
+
+  for( size_t request = 0; request < requests_.size(); ++request )
+    if( requests_[ request ].descriptor_ >= 0 )
+      close( requests_[ request ].descriptor_ );
+
+  if( sqes_ != 0 )
+    munmap( sqes_, sqesSize_ );
+  if( cqRing_ != MAP_FAILED && cqRing_ != sqRing_ )
+    munmap( cqRing_, cqRingSize_ );
+  if( sqRing_ != MAP_FAILED )
+    munmap( sqRing_, sqRingSize_ );
+  if( ringDescriptor_ >= 0 )
+    close( ringDescriptor_ );
+}
+
+//
+bool IoUringBatchFileReader::setup()
+{
+  io_uring_params params;
+  std::memset( &params, 0, sizeof( params ) );
+
+  ringDescriptor_ = static_cast< int >(
+    syscall( __NR_io_uring_setup, RING_ENTRIES, &params ) );
+  if( ringDescriptor_ < 0 )
+    return false;
+
+  sqRingSize_ = params.sq_off.array + params.sq_entries * sizeof( unsigned );
+  cqRingSize_ = params.cq_off.cqes + params.cq_entries * sizeof( io_uring_cqe );
+
+  // Jadra z IORING_FEAT_SINGLE_MMAP udostepniaja obie kolejki jednym
+  // odwzorowaniem
+  const bool SINGLE_MMAP = ( params.features & IORING_FEAT_SINGLE_MMAP ) != 0;
+  if( SINGLE_MMAP && cqRingSize_ > sqRingSize_ )
+    sqRingSize_ = cqRingSize_;
+
+  sqRing_ = mmap( 0, sqRingSize_, PROT_READ | PROT_WRITE,
+    MAP_SHARED | MAP_POPULATE, ringDescriptor_, IORING_OFF_SQ_RING );
+  if( sqRing_ == MAP_FAILED )
+    return false;
+
+  if( SINGLE_MMAP ) {
+    cqRing_ = sqRing_;
+  }
+  else {
+    cqRing_ = mmap( 0, cqRingSize_, PROT_READ | PROT_WRITE,
+      MAP_SHARED | MAP_POPULATE, ringDescriptor_, IORING_OFF_CQ_RING );
+    if( cqRing_ == MAP_FAILED )
+      return false;
+  }
+
+  sqesSize_ = params.sq_entries * sizeof( io_uring_sqe );
+  void* sqes = mmap( 0, sqesSize_, PROT_READ | PROT_WRITE,
+    MAP_SHARED | MAP_POPULATE, ringDescriptor_, IORING_OFF_SQES );
+  if( sqes == MAP_FAILED )
+    return false;
+  sqes_ = static_cast< io_uring_sqe* >( sqes );
+
+  char* sq = static_cast< char* >( sqRing_ );
+  char* cq = static_cast< char* >( cqRing_ );
+
+  sqTail_  = reinterpret_cast< unsigned* >( sq + params.sq_off.tail );
+  sqMask_  = reinterpret_cast< unsigned* >( sq + params.sq_off.ring_mask );
+  sqArray_ = reinterpret_cast< unsigned* >( sq + params.sq_off.array );
+  cqHead_  = reinterpret_cast< unsigned* >( cq + params.cq_off.head );
+  cqTail_  = reinterpret_cast< unsigned* >( cq + params.cq_off.tail );
+  cqMask_  = reinterpret_cast< unsigned* >( cq + params.cq_off.ring_mask );
+  cqes_    = reinterpret_cast< io_uring_cqe* >( cq + params.cq_off.cqes );
+  entries_ = params.sq_entries;
+
+  return true;
+}
+
+//
+void IoUringBatchFileReader::submit( const Paths& paths )
+{
+  // Jadro moze jeszcze zapisywac bufory poprzedniej partii
+  drain();
+
+  for( size_t request = 0; request < requests_.size(); ++request ) {
+    Request& req = requests_[ request ];
+    if( req.descriptor_ >= 0 )
+      close( req.descriptor_ );
+    recycleBuffer( req.buffer_ );
+  }
+  recycleBuffer( deliveredBuffer_ );
+  deliveredBuffer_ = 0;
+
+  requests_.resize( paths.size() );
+  finished_.clear();
+  nextRequest_ = 0;
+  delivered_ = 0;
+
+  for( size_t request = 0; request < paths.size(); ++request )
+  {
+    Request& req = requests_[ request ];
+    req.path_       = paths[ request ];
+    req.descriptor_ = -1;
+    req.regular_    = false;
+    req.buffer_     = 0;
+    req.size_       = 0;
+    req.readBytes_  = 0;
+
+    struct stat fileStat;
+    if( stat( req.path_.c_str(), &fileStat ) == 0 && S_ISREG( fileStat.st_mode ) ) {
+      req.regular_ = true;
+      req.size_ = static_cast< size_t >( fileStat.st_size );
+    }
+  }
+}
+
+//
+bool IoUringBatchFileReader::waitCompleted( Completion* completion )
+{
+  // Odbiorca zakonczyl przetwarzanie poprzedniego wyniku - jego bufor
+  // moze przyjac kolejny plik
+  recycleBuffer( deliveredBuffer_ );
+  deliveredBuffer_ = 0;
+
+  if( delivered_ == requests_.size() )
+    return false;
+
+  while( finished_.empty() )
+  {
+    fillQueue();
+    if( !finished_.empty() )
+      break;
+
+    enter( 1 );
+    reapCompletions();
+  }
+
+  const Finished FINISHED = finished_.front();
+  finished_.pop_front();
+  ++delivered_;
+
+  Request& req = requests_[ FINISHED.request_ ];
+  deliveredBuffer_ = req.buffer_;
+  req.buffer_ = 0;
+
+  completion->request_   = FINISHED.request_;
+  completion->data_      = FINISHED.succeeded_ && req.size_ != 0 ? 
+                             &( *deliveredBuffer_ )[ 0 ] : 0;
+  completion->size_      = FINISHED.succeeded_ ? req.size_ : 0;
+  completion->succeeded_ = FINISHED.succeeded_;
+  return true;
+}
+
+//
+void IoUringBatchFileReader::fillQueue()
+{
+  while( inFlight_ < entries_ && nextRequest_ < requests_.size() )
+  {
+    Request& req = requests_[ nextRequest_ ];
+
+    // Kolejny plik czeka na zwolnienie buforow odebranych wynikow
+    if( req.regular_ && stagedBytes_ != 0 && 
+      stagedBytes_ + req.size_ > STAGING_BYTES )
+    {
+      return;
+    }
+
+    const size_t REQUEST = nextRequest_++;
+
+    if( !req.regular_ ) {
+      finish( REQUEST, false );
+      continue;
+    }
+
+    if( req.size_ == 0 ) {
+      finish( REQUEST, true );
+      continue;
+    }
+
+    req.descriptor_ = open( req.path_.c_str(), O_RDONLY | O_CLOEXEC );
+    if( req.descriptor_ < 0 ) {
+      finish( REQUEST, false );
+      continue;
+    }
+
+    req.buffer_ = acquireBuffer( req.size_ );
+    prepareRead( REQUEST );
+  }
+}
+
+//
+void IoUringBatchFileReader::prepareRead( size_t request )
+{
+  Request& req = requests_[ request ];
+
+  if( readUnsupported_ ) {
+    while( req.readBytes_ < req.size_ ) {
+      const ssize_t READ = pread( req.descriptor_,
+        &( *req.buffer_ )[ req.readBytes_ ],
+        req.size_ - req.readBytes_, static_cast< off_t >( req.readBytes_ ) );
+      if( READ < 0 && errno == EINTR )
+        continue;
+      if( READ <= 0 )
+        break;
+      req.readBytes_ += static_cast< size_t >( READ );
+    }
+    finish( request, req.readBytes_ == req.size_ );
+    return;
+  }
+
+  // Jedynym zapisujacym koniec kolejki zlecen jest ten watek - odczyt
+  // nie wymaga bariery, zapis nowej wartosci musi nastapic po wypelnieniu
+  // wpisu
+  const unsigned TAIL = *sqTail_;
+  const unsigned INDEX = TAIL & *sqMask_;
+
+  io_uring_sqe* sqe = &sqes_[ INDEX ];
+  std::memset( sqe, 0, sizeof( *sqe ) );
+  sqe->opcode    = IORING_OP_READ;
+  sqe->fd        = req.descriptor_;
+  sqe->addr      = reinterpret_cast< unsigned long >(
+                     &( *req.buffer_ )[ req.readBytes_ ] );
+  sqe->len       = static_cast< unsigned >( req.size_ - req.readBytes_ );
+  sqe->off       = req.readBytes_;
+  sqe->user_data = request;
+
+  sqArray_[ INDEX ] = INDEX;
+  __atomic_store_n( sqTail_, TAIL + 1, __ATOMIC_RELEASE );
+
+  ++inFlight_;
+  ++toSubmit_;
+}
+
+//
+IoUringBatchFileReader::Buffer* 
+IoUringBatchFileReader::acquireBuffer( size_t size )
+{
+  if( idleBuffers_.empty() ) {
+    buffers_.push_back( Buffer() );
+    idleBuffers_.push_back( &buffers_.back() );
+  }
+
+  Buffer* buffer = idleBuffers_.back();
+  idleBuffers_.pop_back();
+
+  buffer->resize( size );
+  stagedBytes_ += size;
+  return buffer;
+}
+
+//
+void IoUringBatchFileReader::recycleBuffer( Buffer* buffer )
+{
+  if( buffer == 0 )
+    return;
+
+  stagedBytes_ -= buffer->size();
+  if( buffer->capacity() > RETAINED_BUFFER_SIZE )
+    Buffer().swap( *buffer );
+  else
+    buffer->clear();
+
+  idleBuffers_.push_back( buffer );
+}
+
+//
+void IoUringBatchFileReader::enter( unsigned int minComplete )
+{
+  for( ;; )
+  {
+    const long SUBMITTED = syscall( __NR_io_uring_enter, ringDescriptor_,
+      toSubmit_, minComplete, minComplete != 0 ? IORING_ENTER_GETEVENTS : 0,
+      0, 0 );
+
+    if( SUBMITTED >= 0 ) {
+      toSubmit_ -= static_cast< unsigned int >( SUBMITTED );
+      return;
+    }
+
+    if( errno != EINTR && errno != EAGAIN && errno != EBUSY ) {
+      rollbackSubmissions();
+      return;
+    }
+  }
+}
+
+//
+void IoUringBatchFileReader::rollbackSubmissions()
+{
+  // Bez watku SQPOLL jadro pobiera zlecenia jedynie w trakcie
+  // io_uring_enter, wiec nieprzekazane wpisy mozna usunac przesuwajac
+  // koniec kolejki. Dalsze odczyty partii sa wykonywane synchronicznie
+
+  readUnsupported_ = true;
+
+  const unsigned TAIL = *sqTail_ - toSubmit_;
+  std::vector< size_t > rejected;
+  for( unsigned entry = TAIL; entry != *sqTail_; ++entry )
+    rejected.push_back( static_cast< size_t >(
+      sqes_[ sqArray_[ entry & *sqMask_ ] ].user_data ) );
+
+  __atomic_store_n( sqTail_, TAIL, __ATOMIC_RELEASE );
+  inFlight_ -= toSubmit_;
+  toSubmit_ = 0;
+
+  for( size_t request = 0; request < rejected.size(); ++request )
+    prepareRead( rejected[ request ] );
+}
+
+//
+void IoUringBatchFileReader::reapCompletions()
+{
+  unsigned head = *cqHead_;
+  const unsigned TAIL = __atomic_load_n( cqTail_, __ATOMIC_ACQUIRE );
+
+  for( ; head != TAIL; ++head )
+  {
+    const io_uring_cqe& CQE = cqes_[ head & *cqMask_ ];
+    const size_t REQUEST = static_cast< size_t >( CQE.user_data );
+    Request& req = requests_[ REQUEST ];
+    --inFlight_;
+
+    if( CQE.res == -EINVAL && req.readBytes_ == 0 ) {
+      readUnsupported_ = true;
+      prepareRead( REQUEST );
+    }
+    else if( CQE.res == -EINTR || CQE.res == -EAGAIN ) {
+      prepareRead( REQUEST );
+    }
+    else if( CQE.res <= 0 ) {
+      finish( REQUEST, false );
+    }
+    else {
+      // Niepelny odczyt jest kontynuowany od miejsca zakonczenia
+      req.readBytes_ += static_cast< size_t >( CQE.res );
+      if( req.readBytes_ < req.size_ )
+        prepareRead( REQUEST );
+      else
+        finish( REQUEST, true );
+    }
+  }
+
+  __atomic_store_n( cqHead_, head, __ATOMIC_RELEASE );
+}
+
+//
+void IoUringBatchFileReader::finish( size_t  request,
+                                     bool    succeeded )
+{
+  Request& req = requests_[ request ];
+  if( req.descriptor_ >= 0 ) {
+    close( req.descriptor_ );
+    req.descriptor_ = -1;
+  }
+
+  Finished finished;
+  finished.request_   = request;
+  finished.succeeded_ = succeeded;
+  finished_.push_back( finished );
+}
+
+//
+void IoUringBatchFileReader::drain()
+{
+  // Zlecenia nieodebranych plikow nie sa ponawiane
+  nextRequest_ = requests_.size();
+
+  while( inFlight_ != 0 ) {
+    enter( 1 );
+
+    unsigned head = *cqHead_;
+    const unsigned TAIL = __atomic_load_n( cqTail_, __ATOMIC_ACQUIRE );
+    inFlight_ -= TAIL - head;
+    head = TAIL;
+    __atomic_store_n( cqHead_, head, __ATOMIC_RELEASE );
+  }
+}
+
+} // namespace
+
+#endif
+
+//
+BatchFileReader*
+createBatchFileReader( unsigned int threadsCount )
+{
+#if defined( __linux__ ) && defined( GCAD_IO_URING )
+  BatchFileReader* reader = IoUringBatchFileReader::create();
+  if( reader != 0 )
+    return reader;
+#endif
+
+  return createThreadedBatchFileReader( threadsCount );
+}
+
+} // namespace Platform
+} // namespace Gcad
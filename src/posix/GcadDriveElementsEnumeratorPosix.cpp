@@ -0,0 +1,236 @@
+#include "GcadDriveElementsEnumeratorPosix.h"
+#include "GcadAssertion.h"
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#if defined( __linux__ )
+  #include <stdint.h>
+  #include <sys/syscall.h>
+  #include <unistd.h>
+#endif
+
+namespace Gcad {
+namespace Platform {
+
+namespace {
+
+#if defined( __linux__ )
+
+  /**
+    @brief
+      Uklad rekordu zwracanego przez getdents64 (linux_dirent64) -
+      biblioteka C nie udostepnia go w naglowkach. Rekordy sa wyrownane
+      do 8 bajtow, a nazwa jest zakonczona znakiem zerowym
+  */
+  struct LinuxDirent64 {
+    uint64_t        inode_;
+    int64_t         offset_;
+    unsigned short  recordLength_;
+    unsigned char   type_;
+    char            name_[1];
+  };
+
+  // Porcja miesci kilkaset wpisow typowych nazw plikow zasobow
+  const size_t ENTRIES_BUFFER_SIZE = 64 * 1024;
+
+#endif
+
+  /**
+    @brief
+      Sprawdzenie rodzaju elementu wywolaniem stat. Dowiazanie symboliczne
+      jest katalogiem, jesli wskazuje na katalog (tak jak w Win32, gdzie
+      punkt dowiazania posiada atrybut katalogu)
+  */
+  bool
+  statIsDirectory( DIR* directory, const char* name )
+  {
+    struct stat status;
+    return fstatat( dirfd( directory ), name, &status, 0 ) == 0 &&
+      S_ISDIR( status.st_mode );
+  }
+
+#if defined( DT_UNKNOWN )
+
+  bool
+  isDirectoryEntry( DIR* directory, const char* name, unsigned char type )
+  {
+    if( type == DT_DIR )
+      return true;
+
+    if( type == DT_UNKNOWN || type == DT_LNK )
+      return statIsDirectory( directory, name );
+
+    return false;
+  }
+
+#endif
+
+} // anonymous namespace
+
+  // IMPLEMENTACJA ITERATORA GLOWNEJ STRUKTURY
+
+DriveElementsEnumeratorPosix::Itor 
+::Itor( const DriveElementsEnumeratorPosix& owner )
+  : owner_( owner )
+  , currDir_( 0 )
+  , filled_( 0 )
+  , position_( 0 )
+  , name_( 0 )
+  , isDirectory_( false )
+{
+  moveToBegin();
+}
+
+DriveElementsEnumeratorPosix::Itor
+::~Itor()
+{
+  closeDirectory();
+}
+
+bool
+DriveElementsEnumeratorPosix::Itor 
+::isDirectory() const
+{
+  return isDirectory_;
+}
+
+std::string
+DriveElementsEnumeratorPosix::Itor 
+::getElementName() const
+{
+  return name_ != 0 ? std::string( name_ ) : std::string();
+}
+
+bool
+DriveElementsEnumeratorPosix::Itor 
+::moveToNextElement()
+{
+  // Po ostatnim wpisie katalog jest zamykany, a iterator staje sie
+  // niewazny - tak jak w realizacji Win32
+
+  Utilities::assertion( currDir_ != 0, "Iterator nie ustawiony!" );
+
+  if( readEntry() )
+    return true;
+
+  closeDirectory();
+  return false;
+}
+
+bool
+DriveElementsEnumeratorPosix::Itor 
+::isValid() const
+{
+  return currDir_ != 0;
+}
+
+void
+DriveElementsEnumeratorPosix::Itor 
+::moveToBegin()
+{
+  // Iterator wskazuje pierwszy wpis katalogu (odpowiednik FindFirstFile).
+  // Katalog pusty, badz niedostepny daje iterator niewazny
+
+  closeDirectory();
+
+  currDir_ = opendir( owner_.baseDir_.c_str() );
+  if( currDir_ != 0 && !readEntry() )
+    closeDirectory();
+}
+
+bool
+DriveElementsEnumeratorPosix::Itor 
+::readEntry()
+{
+#if defined( __linux__ )
+  // Deskryptor strumienia DIR jest odczytywany bezposrednio - strumien
+  // nie jest uzywany przez readdir, wiec nie posiada wlasnego stanu
+
+  if( position_ >= filled_ )
+  {
+    if( buffer_.empty() )
+      buffer_.resize( ENTRIES_BUFFER_SIZE );
+
+    const long READ = syscall( SYS_getdents64, dirfd( currDir_ ), 
+      &buffer_[0], buffer_.size() );
+    if( READ <= 0 )
+      return false;
+
+    filled_   = static_cast< size_t >( READ );
+    position_ = 0;
+  }
+
+  const LinuxDirent64* entry = 
+    reinterpret_cast< const LinuxDirent64* >( &buffer_[position_] );
+  position_ += entry->recordLength_;
+
+  name_        = entry->name_;
+  isDirectory_ = isDirectoryEntry( currDir_, name_, entry->type_ );
+  return true;
+#else
+  const dirent* entry = readdir( currDir_ );
+  if( entry == 0 )
+    return false;
+
+  name_ = entry->d_name;
+  #if defined( DT_UNKNOWN )
+    isDirectory_ = isDirectoryEntry( currDir_, name_, entry->d_type );
+  #else
+    isDirectory_ = statIsDirectory( currDir_, name_ );
+  #endif
+  return true;
+#endif
+}
+
+void
+DriveElementsEnumeratorPosix::Itor 
+::closeDirectory()
+{
+  if( currDir_ != 0 )
+    closedir( currDir_ );
+
+  currDir_     = 0;
+  filled_      = 0;
+  position_    = 0;
+  name_        = 0;
+  isDirectory_ = false;
+}
+
+  // IMPLEMENTACJA GLOWNEGO OBIEKTU ZARZADZAJACEGO
+    
+DriveElementsEnumeratorPosix
+::DriveElementsEnumeratorPosix( const std::string& directory ) 
+  : baseDir_( directory )
+{
+}
+
+DriveElementsEnumeratorPosix* 
+DriveElementsEnumeratorPosix
+::clone() const
+{
+  return new DriveElementsEnumeratorPosix( baseDir_ );
+}
+
+DriveElementsEnumeratorPosix::ItorAutoPtr 
+DriveElementsEnumeratorPosix
+::getItor() const
+{
+  return ItorAutoPtr( new Itor( *this ) );
+}
+
+void 
+DriveElementsEnumeratorPosix
+::setDirectory( const std::string& newDirectory ) 
+{
+  baseDir_ = newDirectory;
+}
+
+char
+DriveElementsEnumeratorPosix
+::getPathSeparator() const
+{
+  return '/';
+}
+   
+} // namespace Platform
+} // namespace Gcad
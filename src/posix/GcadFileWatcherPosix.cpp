@@ -0,0 +1,226 @@
+#include "GcadFileWatcher.h"
+
+#if defined( __linux__ )
+  #include <sys/inotify.h>
+  #include <cerrno>
+  #include <map>
+  #include <fcntl.h>
+  #include <unistd.h>
+#endif
+
+namespace Gcad {
+namespace Platform {
+
+#if defined( __linux__ )
+
+namespace {
+
+  // Zdarzenia zglaszane jako zmiany. Utworzenie pliku (IN_CREATE) nie
+  // jest zglaszane - plik jest wowczas pusty, a zakonczenie zapisu
+  // zglasza IN_CLOSE_WRITE. Katalogi nie sa zapisywane, wiec ich
+  // utworzenie jest zglaszane natychmiast
+  const unsigned int WATCH_MASK = IN_CLOSE_WRITE | IN_MOVED_TO | 
+    IN_MOVED_FROM | IN_DELETE | IN_CREATE | IN_ONLYDIR;
+
+/**
+  @brief
+    Obserwator korzystajacy z inotify. Deskryptor jest nieblokujacy,
+    wiec odbior zmian (poll) konczy sie po odczytaniu zdarzen
+    zgromadzonych przez jadro
+*/
+class InotifyFileWatcher : public FileWatcher {
+ public:
+   /**
+     @brief
+       Utworzenie obserwatora, badz wartosc 0, gdy inotify jest niedostepny
+   */
+   static InotifyFileWatcher* create();
+
+   ~InotifyFileWatcher();
+
+   bool watch( const std::string& directory );
+   void unwatch( const std::string& directory );
+   size_t poll( Changes* changes );
+   const char* backendName() const { return "inotify"; }
+
+ private:
+   typedef std::map< int, std::string >  WatchToDirectory;
+   typedef std::map< std::string, int >  DirectoryToWatch;
+
+   explicit InotifyFileWatcher( int descriptor );
+
+   /**
+     @brief
+       Zamiana zdarzenia na zmiane (false - zdarzenie pomijane)
+   */
+   bool translate( const inotify_event& event, Change* change );
+
+ private:
+   int               descriptor_;
+   WatchToDirectory  watchToDirectory_;
+   DirectoryToWatch  directoryToWatch_;
+
+ private:
+   // nie zaimplementowane
+   InotifyFileWatcher( const InotifyFileWatcher& );
+   InotifyFileWatcher& operator =( const InotifyFileWatcher& );
+};
+
+//
+InotifyFileWatcher*
+InotifyFileWatcher::create()
+{
+  const int DESCRIPTOR = inotify_init();
+  if( DESCRIPTOR < 0 )
+    return 0;
+
+  // inotify_init1 (IN_NONBLOCK, IN_CLOEXEC) jest niedostepna w jadrach
+  // starszych niz 2.6.27, dlatego flagi sa ustawiane osobno
+  fcntl( DESCRIPTOR, F_SETFL, fcntl( DESCRIPTOR, F_GETFL ) | O_NONBLOCK );
+  fcntl( DESCRIPTOR, F_SETFD, FD_CLOEXEC );
+
+  return new InotifyFileWatcher( DESCRIPTOR );
+}
+
+//
+InotifyFileWatcher::InotifyFileWatcher( int descriptor )
+  : descriptor_( descriptor )
+{
+}
+
+//
+InotifyFileWatcher::~InotifyFileWatcher()
+{
+  close( descriptor_ );
+}
+
+//
+bool
+InotifyFileWatcher::watch( const std::string& directory )
+{
+  if( directoryToWatch_.find( directory ) != directoryToWatch_.end() )
+    return true;
+
+  // Jadro zwraca ten sam deskryptor obserwacji dla roznych sciezek tego
+  // samego katalogu (np. "data" i "./data") - obowiazuje ostatnia sciezka
+  const int WATCH = inotify_add_watch( descriptor_, directory.c_str(),
+    WATCH_MASK );
+  if( WATCH < 0 )
+    return false;
+
+  WatchToDirectory::iterator previous = watchToDirectory_.find( WATCH );
+  if( previous != watchToDirectory_.end() )
+    directoryToWatch_.erase( previous->second );
+
+  watchToDirectory_[ WATCH ] = directory;
+  directoryToWatch_[ directory ] = WATCH;
+  return true;
+}
+
+//
+void
+InotifyFileWatcher::unwatch( const std::string& directory )
+{
+  DirectoryToWatch::iterator watchItor = directoryToWatch_.find( directory );
+  if( watchItor == directoryToWatch_.end() )
+    return;
+
+  inotify_rm_watch( descriptor_, watchItor->second );
+  watchToDirectory_.erase( watchItor->second );
+  directoryToWatch_.erase( watchItor );
+}
+
+//
+size_t
+InotifyFileWatcher::poll( Changes* changes )
+{
+  // Bufor jest wyrownany do struktury inotify_event - zdarzenia sa
+  // odczytywane wprost z niego (naglowek i nazwa zmiennej dlugosci)
+
+  union Buffer {
+    inotify_event  event_;
+    char           bytes_[ 4096 ];
+  };
+
+  Buffer buffer;
+  const size_t PREVIOUS_COUNT = changes->size();
+
+  for( ;; )
+  {
+    const ssize_t READ = read( descriptor_, buffer.bytes_,
+      sizeof( buffer.bytes_ ) );
+    if( READ < 0 && errno == EINTR )
+      continue;
+    if( READ <= 0 )
+      break;
+
+    for( ssize_t offset = 0; offset < READ; )
+    {
+      const inotify_event& EVENT = 
+        *reinterpret_cast< const inotify_event* >( buffer.bytes_ + offset );
+      offset += sizeof( inotify_event ) + EVENT.len;
+
+      Change change;
+      if( translate( EVENT, &change ) )
+        changes->push_back( change );
+    }
+  }
+
+  return changes->size() - PREVIOUS_COUNT;
+}
+
+//
+bool
+InotifyFileWatcher::translate( const inotify_event&  event,
+                               Change*               change )
+{
+  if( event.mask & IN_Q_OVERFLOW ) {
+    change->kind_ = Change::OVERFLOWED;
+    change->isDirectory_ = false;
+    return true;
+  }
+
+  WatchToDirectory::iterator watchItor = watchToDirectory_.find( event.wd );
+  if( watchItor == watchToDirectory_.end() )
+    return false;
+
+  // Usuniecie katalogu (badz unwatch) konczy obserwacje - deskryptor
+  // moze zostac pozniej przydzielony innemu katalogowi
+  if( event.mask & IN_IGNORED ) {
+    directoryToWatch_.erase( watchItor->second );
+    watchToDirectory_.erase( watchItor );
+    return false;
+  }
+
+  if( event.len == 0 )
+    return false;
+
+  const bool IS_DIRECTORY = ( event.mask & IN_ISDIR ) != 0;
+  if( ( event.mask & IN_CREATE ) && !IS_DIRECTORY )
+    return false;
+
+  change->directory_   = watchItor->second;
+  change->name_        = event.name;
+  change->isDirectory_ = IS_DIRECTORY;
+  change->kind_        = ( event.mask & ( IN_DELETE | IN_MOVED_FROM ) ) ? 
+    Change::REMOVED : Change::CHANGED;
+  return true;
+}
+
+} // anonymous namespace
+
+#endif
+
+//
+FileWatcher*
+createFileWatcher()
+{
+#if defined( __linux__ )
+  return InotifyFileWatcher::create();
+#else
+  return 0;
+#endif
+}
+
+} // namespace Platform
+} // namespace Gcad
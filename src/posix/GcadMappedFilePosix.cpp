@@ -0,0 +1,91 @@
+#include "GcadMappedFile.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Gcad {
+namespace Platform {
+
+MappedFile
+::MappedFile()
+  : address_( 0 )
+  , size_( 0 )
+  , mapped_( false )
+{
+}
+
+MappedFile
+::~MappedFile()
+{
+  unmap();
+}
+
+bool
+MappedFile
+::map( const std::string& path )
+{
+  unmap();
+
+  const int DESCRIPTOR = open( path.c_str(), O_RDONLY );
+  if( DESCRIPTOR < 0 )
+    return false;
+
+  struct stat status;
+  if( fstat( DESCRIPTOR, &status ) != 0 || !S_ISREG( status.st_mode ) ) {
+    close( DESCRIPTOR );
+    return false;
+  }
+
+  const size_t FILE_SIZE = static_cast< size_t >( status.st_size );
+  if( FILE_SIZE != 0 ) {
+    // MAP_SHARED bez prawa zapisu - strony pochodza bezposrednio
+    // z pamieci podrecznej jadra i sa wspolne dla wszystkich procesow
+    void* address = mmap( 0, FILE_SIZE, PROT_READ, MAP_SHARED, DESCRIPTOR, 0 );
+    if( address == MAP_FAILED ) {
+      close( DESCRIPTOR );
+      return false;
+    }
+
+    // Parsery odczytuja plik w calosci - wczesne pobranie stron
+    // zastepuje pojedyncze bledy strony przy pierwszym dostepie
+    madvise( address, FILE_SIZE, MADV_WILLNEED );
+    address_ = address;
+  }
+
+  // Odwzorowanie pozostaje wazne po zamknieciu deskryptora
+  close( DESCRIPTOR );
+
+  size_ = FILE_SIZE;
+  mapped_ = true;
+  return true;
+}
+
+void
+MappedFile
+::unmap()
+{
+  if( address_ != 0 )
+    munmap( address_, size_ );
+
+  address_ = 0;
+  size_ = 0;
+  mapped_ = false;
+}
+
+bool
+MappedFile
+::isMapped() const
+{
+  return mapped_;
+}
+
+Utilities::ByteSpan
+MappedFile
+::bytes() const
+{
+  return Utilities::ByteSpan( address_, size_ );
+}
+
+} // namespace Platform
+} // namespace Gcad
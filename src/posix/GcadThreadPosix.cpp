@@ -0,0 +1,200 @@
+#include "GcadThread.h"
+#include <pthread.h>
+#include <unistd.h>
+
+namespace Gcad {
+namespace Platform {
+
+namespace {
+
+  pthread_mutex_t*
+  nativeMutex( void* handle )
+  {
+    return static_cast< pthread_mutex_t* >( handle );
+  }
+
+  pthread_cond_t*
+  nativeCondition( void* handle )
+  {
+    return static_cast< pthread_cond_t* >( handle );
+  }
+
+  // Parametry wywolania funkcji watku, przekazywane przez pthread_create.
+  // Obiekt jest zwalniany przez rozpoczynajacy sie watek
+  struct ThreadStart {
+    Thread::Routine  routine_;
+    void*            argument_;
+  };
+
+  extern "C" void*
+  threadEntry( void* start )
+  {
+    const ThreadStart START = *static_cast< ThreadStart* >( start );
+    delete static_cast< ThreadStart* >( start );
+
+    START.routine_( START.argument_ );
+    return 0;
+  }
+
+  // Funkcje zarejestrowane przez atThreadExit tworza liste jednokierunkowa,
+  // ktorej poczatek jest wartoscia klucza watku
+  struct ExitHandler {
+    ThreadExitRoutine  routine_;
+    void*              argument_;
+    ExitHandler*       next_;
+  };
+
+  pthread_key_t   exitHandlersKey;
+  pthread_once_t  exitHandlersOnce = PTHREAD_ONCE_INIT;
+
+  extern "C" void
+  runExitHandlers( void* handlers )
+  {
+    ExitHandler* handler = static_cast< ExitHandler* >( handlers );
+    while( handler != 0 ) {
+      handler->routine_( handler->argument_ );
+
+      ExitHandler* next = handler->next_;
+      delete handler;
+      handler = next;
+    }
+  }
+
+  extern "C" void
+  createExitHandlersKey()
+  {
+    pthread_key_create( &exitHandlersKey, &runExitHandlers );
+  }
+
+} // namespace
+
+//
+Mutex::Mutex()
+  : handle_( new pthread_mutex_t )
+{
+  if( pthread_mutex_init( nativeMutex( handle_ ), 0 ) != 0 ) {
+    delete nativeMutex( handle_ );
+    throw ThreadException( "Nie mozna utworzyc muteksu" );
+  }
+}
+
+//
+Mutex::~Mutex()
+{
+  pthread_mutex_destroy( nativeMutex( handle_ ) );
+  delete nativeMutex( handle_ );
+}
+
+//
+void Mutex::lock()
+{
+  pthread_mutex_lock( nativeMutex( handle_ ) );
+}
+
+//
+void Mutex::unlock()
+{
+  pthread_mutex_unlock( nativeMutex( handle_ ) );
+}
+
+//
+ConditionVariable::ConditionVariable()
+  : handle_( new pthread_cond_t )
+{
+  if( pthread_cond_init( nativeCondition( handle_ ), 0 ) != 0 ) {
+    delete nativeCondition( handle_ );
+    throw ThreadException( "Nie mozna utworzyc zmiennej warunkowej" );
+  }
+}
+
+//
+ConditionVariable::~ConditionVariable()
+{
+  pthread_cond_destroy( nativeCondition( handle_ ) );
+  delete nativeCondition( handle_ );
+}
+
+//
+void ConditionVariable::wait( Mutex& mutex )
+{
+  pthread_cond_wait( nativeCondition( handle_ ), nativeMutex( mutex.handle_ ) );
+}
+
+//
+void ConditionVariable::notifyOne()
+{
+  pthread_cond_signal( nativeCondition( handle_ ) );
+}
+
+//
+void ConditionVariable::notifyAll()
+{
+  pthread_cond_broadcast( nativeCondition( handle_ ) );
+}
+
+//
+Thread::Thread( Routine  routine,
+                void*    argument )
+  : handle_( new pthread_t )
+  , joined_( false )
+{
+  ThreadStart* start = new ThreadStart;
+  start->routine_  = routine;
+  start->argument_ = argument;
+
+  if( pthread_create( static_cast< pthread_t* >( handle_ ), 0,
+    &threadEntry, start ) != 0 )
+  {
+    delete start;
+    delete static_cast< pthread_t* >( handle_ );
+    throw ThreadException( "Nie mozna utworzyc watku" );
+  }
+}
+
+//
+Thread::~Thread()
+{
+  join();
+  delete static_cast< pthread_t* >( handle_ );
+}
+
+//
+void Thread::join()
+{
+  if( !joined_ ) {
+    pthread_join( *static_cast< pthread_t* >( handle_ ), 0 );
+    joined_ = true;
+  }
+}
+
+//
+unsigned int Thread::hardwareConcurrency()
+{
+#ifdef _SC_NPROCESSORS_ONLN
+  const long PROCESSORS = sysconf( _SC_NPROCESSORS_ONLN );
+  if( PROCESSORS > 0 )
+    return static_cast< unsigned int >( PROCESSORS );
+#endif
+  return 1;
+}
+
+//
+void atThreadExit( ThreadExitRoutine  routine,
+                   void*              argument )
+{
+  pthread_once( &exitHandlersOnce, &createExitHandlersKey );
+
+  // Destruktor klucza jest wywolywany jedynie dla wartosci niezerowej.
+  // Funkcja zarejestrowana w trakcie wywolywania pozostalych (ponowne
+  // ustawienie wartosci) zostanie wywolana w kolejnym przebiegu
+  ExitHandler* handler = new ExitHandler;
+  handler->routine_  = routine;
+  handler->argument_ = argument;
+  handler->next_     = 
+    static_cast< ExitHandler* >( pthread_getspecific( exitHandlersKey ) );
+
+  pthread_setspecific( exitHandlersKey, handler );
+}
+
+} // namespace Platform
+} // namespace Gcad
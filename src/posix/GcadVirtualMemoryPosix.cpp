@@ -0,0 +1,128 @@
+/***************************************************************************
+ *   Copyright (C) 2005 by Eryk Klebanski                                  *
+ *   rixment@gmail.com                                                     *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+
+
+#include "GcadVirtualMemory.h"
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace Gcad {
+namespace Platform {
+
+namespace {
+
+  const int RESERVE_FLAGS = MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE;
+
+  int
+  hugeFlags( PageMode pageMode )
+  {
+  #ifdef MAP_HUGETLB
+    return pageMode == EXPLICIT_HUGE_PAGES ? MAP_HUGETLB : 0;
+  #else
+    return 0;
+  #endif
+  }
+
+} // anonymous namespace
+
+size_t
+virtualPageSize()
+{
+  return static_cast< size_t >( sysconf( _SC_PAGESIZE ) );
+}
+
+size_t
+hugePageSize()
+{
+#if defined( __linux__ ) && defined( MAP_HUGETLB )
+  // Domyslny rozmiar duzej strony architektur x86-64 i AArch64
+  return 2 * 1024 * 1024;
+#else
+  return virtualPageSize();
+#endif
+}
+
+void*
+reserveAddressRange( size_t    bytesCount,
+                     PageMode  /* pageMode */ )
+{
+  // Duze strony jawne sa przydzielane dopiero podczas zatwierdzania
+  // fragmentow - rezerwacja MAP_HUGETLB z MAP_NORESERVE konczy sie
+  // sygnalem SIGBUS przy pierwszym dostepie, gdy pula stron jest pusta
+  void* address = mmap( 0, bytesCount, PROT_NONE, RESERVE_FLAGS, -1, 0 );
+  return address == MAP_FAILED ? 0 : address;
+}
+
+bool
+commitMemory( void*     address,
+              size_t    bytesCount,
+              PageMode  pageMode )
+{
+  const int COMMIT_FLAGS = MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED;
+
+  // Bez MAP_NORESERVE jadro odmawia odwzorowania, gdy brakuje duzych
+  // stron - wowczas fragment otrzymuje strony standardowe
+  if( hugeFlags( pageMode ) != 0 &&
+    mmap( address, bytesCount, PROT_READ | PROT_WRITE,
+      COMMIT_FLAGS | hugeFlags( pageMode ), -1, 0 ) != MAP_FAILED )
+  {
+    return true;
+  }
+
+  if( mmap( address, bytesCount, PROT_READ | PROT_WRITE,
+    COMMIT_FLAGS, -1, 0 ) == MAP_FAILED )
+  {
+    return false;
+  }
+
+#ifdef MADV_HUGEPAGE
+  if( pageMode != STANDARD_PAGES )
+    madvise( address, bytesCount, MADV_HUGEPAGE );
+#endif
+
+  return true;
+}
+
+void
+decommitMemory( void*     address,
+                size_t    bytesCount,
+                PageMode  /* pageMode */ )
+{
+  // Ponowne odwzorowanie obszaru w miejscu zwalnia strony fizyczne
+  // (rowniez duze strony jawne) i przywraca stan rezerwacji
+  void* remapped = mmap( address, bytesCount, PROT_NONE,
+    RESERVE_FLAGS | MAP_FIXED, -1, 0 );
+
+  if( remapped == MAP_FAILED ) {
+    madvise( address, bytesCount, MADV_DONTNEED );
+    mprotect( address, bytesCount, PROT_NONE );
+  }
+}
+
+void
+releaseAddressRange( void*   address,
+                     size_t  bytesCount )
+{
+  munmap( address, bytesCount );
+}
+
+} // namespace Platform
+} // namespace Gcad
@@ -0,0 +1,16 @@
+#include "GcadBatchFileReader.h"
+
+namespace Gcad {
+namespace Platform {
+
+BatchFileReader*
+createBatchFileReader( unsigned int threadsCount )
+{
+  // Odczyty nakladane (OVERLAPPED) wymagaja otwarcia plikow z flaga
+  // FILE_FLAG_OVERLAPPED i portu zakonczen - do tego czasu stosowany
+  // jest czytnik korzystajacy z puli watkow
+  return createThreadedBatchFileReader( threadsCount );
+}
+
+} // namespace Platform
+} // namespace Gcad
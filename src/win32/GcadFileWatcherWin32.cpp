@@ -0,0 +1,16 @@
+#include "GcadFileWatcher.h"
+
+namespace Gcad {
+namespace Platform {
+
+FileWatcher*
+createFileWatcher()
+{
+  // Obserwacja wymaga funkcji ReadDirectoryChangesW z odczytem nakladanym
+  // (OVERLAPPED) dla kazdego katalogu - do tego czasu obserwacja jest
+  // niedostepna, a klient odswieza zasoby samodzielnie
+  return 0;
+}
+
+} // namespace Platform
+} // namespace Gcad
@@ -0,0 +1,90 @@
+#include "GcadMappedFile.h"
+#include <windows.h>
+
+namespace Gcad {
+namespace Platform {
+
+MappedFile
+::MappedFile()
+  : address_( 0 )
+  , size_( 0 )
+  , mapped_( false )
+{
+}
+
+MappedFile
+::~MappedFile()
+{
+  unmap();
+}
+
+bool
+MappedFile
+::map( const std::string& path )
+{
+  unmap();
+
+  HANDLE file = CreateFileA( path.c_str(), GENERIC_READ, FILE_SHARE_READ,
+    0, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, 0 );
+  if( file == INVALID_HANDLE_VALUE )
+    return false;
+
+  LARGE_INTEGER fileSize;
+  if( !GetFileSizeEx( file, &fileSize ) ) {
+    CloseHandle( file );
+    return false;
+  }
+
+  if( fileSize.QuadPart != 0 ) {
+    // Obiekt odwzorowania i widok utrzymuja plik po zamknieciu uchwytow
+    HANDLE mapping = CreateFileMappingA( file, 0, PAGE_READONLY, 0, 0, 0 );
+    if( mapping == 0 ) {
+      CloseHandle( file );
+      return false;
+    }
+
+    void* address = MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 );
+    CloseHandle( mapping );
+    if( address == 0 ) {
+      CloseHandle( file );
+      return false;
+    }
+
+    address_ = address;
+  }
+
+  CloseHandle( file );
+
+  size_ = static_cast< size_t >( fileSize.QuadPart );
+  mapped_ = true;
+  return true;
+}
+
+void
+MappedFile
+::unmap()
+{
+  if( address_ != 0 )
+    UnmapViewOfFile( address_ );
+
+  address_ = 0;
+  size_ = 0;
+  mapped_ = false;
+}
+
+bool
+MappedFile
+::isMapped() const
+{
+  return mapped_;
+}
+
+Utilities::ByteSpan
+MappedFile
+::bytes() const
+{
+  return Utilities::ByteSpan( address_, size_ );
+}
+
+} // namespace Platform
+} // namespace Gcad
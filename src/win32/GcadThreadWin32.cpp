@@ -0,0 +1,196 @@
+#include "GcadThread.h"
+#include <windows.h>
+#include <process.h>
+
+namespace Gcad {
+namespace Platform {
+
+namespace {
+
+  CRITICAL_SECTION*
+  nativeMutex( void* handle )
+  {
+    return static_cast< CRITICAL_SECTION* >( handle );
+  }
+
+  CONDITION_VARIABLE*
+  nativeCondition( void* handle )
+  {
+    return static_cast< CONDITION_VARIABLE* >( handle );
+  }
+
+  // Parametry wywolania funkcji watku, przekazywane przez _beginthreadex.
+  // Obiekt jest zwalniany przez rozpoczynajacy sie watek
+  struct ThreadStart {
+    Thread::Routine  routine_;
+    void*            argument_;
+  };
+
+  unsigned __stdcall
+  threadEntry( void* start )
+  {
+    const ThreadStart START = *static_cast< ThreadStart* >( start );
+    delete static_cast< ThreadStart* >( start );
+
+    START.routine_( START.argument_ );
+    return 0;
+  }
+
+  // Funkcje zarejestrowane przez atThreadExit tworza liste jednokierunkowa,
+  // ktorej poczatek jest wartoscia indeksu FLS watku
+  struct ExitHandler {
+    ThreadExitRoutine  routine_;
+    void*              argument_;
+    ExitHandler*       next_;
+  };
+
+  DWORD      exitHandlersIndex = FLS_OUT_OF_INDEXES;
+  INIT_ONCE  exitHandlersOnce  = INIT_ONCE_STATIC_INIT;
+
+  VOID WINAPI
+  runExitHandlers( PVOID handlers )
+  {
+    ExitHandler* handler = static_cast< ExitHandler* >( handlers );
+    while( handler != 0 ) {
+      handler->routine_( handler->argument_ );
+
+      ExitHandler* next = handler->next_;
+      delete handler;
+      handler = next;
+    }
+  }
+
+  BOOL CALLBACK
+  createExitHandlersIndex( PINIT_ONCE, PVOID, PVOID* )
+  {
+    exitHandlersIndex = FlsAlloc( &runExitHandlers );
+    return TRUE;
+  }
+
+} // namespace
+
+//
+Mutex::Mutex()
+  : handle_( new CRITICAL_SECTION )
+{
+  InitializeCriticalSection( nativeMutex( handle_ ) );
+}
+
+//
+Mutex::~Mutex()
+{
+  DeleteCriticalSection( nativeMutex( handle_ ) );
+  delete nativeMutex( handle_ );
+}
+
+//
+void Mutex::lock()
+{
+  EnterCriticalSection( nativeMutex( handle_ ) );
+}
+
+//
+void Mutex::unlock()
+{
+  LeaveCriticalSection( nativeMutex( handle_ ) );
+}
+
+//
+ConditionVariable::ConditionVariable()
+  : handle_( new CONDITION_VARIABLE )
+{
+  // Zmienne warunkowe sa dostepne od systemu Windows Vista
+  InitializeConditionVariable( nativeCondition( handle_ ) );
+}
+
+//
+ConditionVariable::~ConditionVariable()
+{
+  // Zmienna warunkowa systemu Windows nie wymaga zwolnienia
+  delete nativeCondition( handle_ );
+}
+
+//
+void ConditionVariable::wait( Mutex& mutex )
+{
+  SleepConditionVariableCS( nativeCondition( handle_ ),
+    nativeMutex( mutex.handle_ ), INFINITE );
+}
+
+//
+void ConditionVariable::notifyOne()
+{
+  WakeConditionVariable( nativeCondition( handle_ ) );
+}
+
+//
+void ConditionVariable::notifyAll()
+{
+  WakeAllConditionVariable( nativeCondition( handle_ ) );
+}
+
+//
+Thread::Thread( Routine  routine,
+                void*    argument )
+  : handle_( 0 )
+  , joined_( false )
+{
+  ThreadStart* start = new ThreadStart;
+  start->routine_  = routine;
+  start->argument_ = argument;
+
+  // _beginthreadex (w odroznieniu od CreateThread) inicjalizuje
+  // dane biblioteki CRT dla nowego watku
+  handle_ = reinterpret_cast< void* >(
+    _beginthreadex( 0, 0, &threadEntry, start, 0, 0 ) );
+
+  if( handle_ == 0 ) {
+    delete start;
+    throw ThreadException( "Nie mozna utworzyc watku" );
+  }
+}
+
+//
+Thread::~Thread()
+{
+  join();
+  CloseHandle( static_cast< HANDLE >( handle_ ) );
+}
+
+//
+void Thread::join()
+{
+  if( !joined_ ) {
+    WaitForSingleObject( static_cast< HANDLE >( handle_ ), INFINITE );
+    joined_ = true;
+  }
+}
+
+//
+unsigned int Thread::hardwareConcurrency()
+{
+  SYSTEM_INFO systemInfo;
+  GetSystemInfo( &systemInfo );
+  return systemInfo.dwNumberOfProcessors > 0 ?
+    static_cast< unsigned int >( systemInfo.dwNumberOfProcessors ) : 1;
+}
+
+//
+void atThreadExit( ThreadExitRoutine  routine,
+                   void*              argument )
+{
+  InitOnceExecuteOnce( &exitHandlersOnce, &createExitHandlersIndex, 0, 0 );
+  if( exitHandlersIndex == FLS_OUT_OF_INDEXES )
+    return;
+
+  ExitHandler* handler = new ExitHandler;
+  handler->routine_  = routine;
+  handler->argument_ = argument;
+  handler->next_     = 
+    static_cast< ExitHandler* >( FlsGetValue( exitHandlersIndex ) );
+
+  FlsSetValue( exitHandlersIndex, handler );
+}
+
+} // namespace Platform
+} // namespace Gcad
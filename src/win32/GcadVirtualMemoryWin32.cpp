@@ -0,0 +1,58 @@
+#include "GcadVirtualMemory.h"
+#include <windows.h>
+
+namespace Gcad {
+namespace Platform {
+
+size_t
+virtualPageSize()
+{
+  SYSTEM_INFO systemInfo;
+  GetSystemInfo( &systemInfo );
+  return systemInfo.dwPageSize;
+}
+
+size_t
+hugePageSize()
+{
+  // Duze strony systemu Windows wymagaja zatwierdzenia calego obszaru
+  // juz w chwili rezerwacji, wiec nie nadaja sie do stopniowego
+  // zatwierdzania fragmentow - wykorzystywane sa strony standardowe
+  return virtualPageSize();
+}
+
+void*
+reserveAddressRange( size_t    bytesCount,
+                     PageMode  pageMode )
+{
+  if( pageMode == EXPLICIT_HUGE_PAGES )
+    return 0;
+
+  return VirtualAlloc( 0, bytesCount, MEM_RESERVE, PAGE_NOACCESS );
+}
+
+bool
+commitMemory( void*     address,
+              size_t    bytesCount,
+              PageMode  pageMode )
+{
+  return VirtualAlloc( address, bytesCount, MEM_COMMIT, PAGE_READWRITE ) != 0;
+}
+
+void
+decommitMemory( void*     address,
+                size_t    bytesCount,
+                PageMode  pageMode )
+{
+  VirtualFree( address, bytesCount, MEM_DECOMMIT );
+}
+
+void
+releaseAddressRange( void*   address,
+                     size_t  bytesCount )
+{
+  VirtualFree( address, 0, MEM_RELEASE );
+}
+
+} // namespace Platform
+} // namespace Gcad
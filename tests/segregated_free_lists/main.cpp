@@ -0,0 +1,153 @@
+/***************************************************************************
+ *   Copyright (C) 2005 by Eryk Klebanski                                  *
+ *   rixment@gmail.com                                                     *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+
+
+#include "GcadSegregatedFreeLists.h"
+#include "GcadSegregatedMemoryAlloc.h"
+#include <iostream>
+
+using namespace std;
+using namespace Gcad::Utilities;
+
+typedef SegregatedFreeLists<>  FreeLists;
+
+int failures = 0;
+
+void
+check(bool statement, const char* description)
+{
+  if( !statement ) {
+    cout << "FAILED: " << description << endl;
+    ++failures;
+  }
+}
+
+/**
+  @brief
+    Ponowne zwolnienie obszaru scalonego z lewym sasiadem musi zostac
+    zignorowane - pozostawiony naglowek zajetego obszaru psul listy
+*/
+void
+testDoubleGiveAfterLeftMerge()
+{
+  const int SEGMENTS = 64;
+  FreeLists::InfoNode links[ SEGMENTS ];
+  FreeLists freeLists;
+  freeLists.reset( links, SEGMENTS );
+
+  const int FIRST  = freeLists.take( 3 );
+  const int SECOND = freeLists.take( 5 );
+  const int THIRD  = freeLists.take( 2 );
+
+  check( freeLists.give( FIRST ) == 3, "give(FIRST)" );
+  check( freeLists.give( SECOND ) == 5, "give(SECOND) merged left" );
+  check( freeLists.give( SECOND ) == 0, "second give(SECOND) ignored" );
+  check( freeLists.give( FIRST ) == 0, "second give(FIRST) ignored" );
+  check( !freeLists.isTaken( SECOND ), "isTaken(SECOND)" );
+  check( freeLists.freeSegmentsCount() == SEGMENTS - 2, 
+    "free segments after double give" );
+  check( freeLists.freeRunsCount() == 2, "free runs after double give" );
+
+  check( freeLists.give( THIRD ) == 2, "give(THIRD) merged both sides" );
+  check( freeLists.give( THIRD ) == 0, "second give(THIRD) ignored" );
+  check( freeLists.freeRunsCount() == 1 &&
+    freeLists.largestFreeRun() == SEGMENTS, "whole area free" );
+
+  // Struktura musi pozostac spojna dla kolejnych przydzialow
+  check( freeLists.take( SEGMENTS ) == 0, "take(SEGMENTS)" );
+  check( freeLists.give( 0 ) == SEGMENTS, "give(0)" );
+}
+
+/**
+  @brief
+    Zwolnienie jednosegmentowego obszaru (naglowek jest jednoczesnie 
+    stopka), scalonego z prawym sasiadem
+*/
+void
+testDoubleGiveAfterRightMerge()
+{
+  const int SEGMENTS = 16;
+  FreeLists::InfoNode links[ SEGMENTS ];
+  FreeLists freeLists;
+  freeLists.reset( links, SEGMENTS );
+
+  const int FIRST  = freeLists.take( 1 );
+  const int SECOND = freeLists.take( 1 );
+
+  check( freeLists.give( SECOND ) == 1, "give(SECOND) merged right" );
+  check( freeLists.give( SECOND ) == 0, "second give(SECOND) ignored" );
+  check( freeLists.give( FIRST ) == 1, "give(FIRST)" );
+  check( freeLists.freeRunsCount() == 1 &&
+    freeLists.freeSegmentsCount() == SEGMENTS, "whole area free" );
+}
+
+struct Node : public SegregatedMemoryAlloc< 256, 16 > {
+  char data_[ 40 ];
+};
+
+/**
+  @brief
+    Podwojne zwolnienie obiektu puli jest ignorowane przez operator delete
+*/
+void
+testDoubleDeleteThroughAllocator()
+{
+  Node* first  = new Node;
+  Node* second = new Node;
+  Node* third  = new Node;
+
+  // Adres jest zapamietany jako liczba, gdyz ponowne zwolnienie jest
+  // zamierzone
+  const size_t SECOND_ADDRESS = reinterpret_cast< size_t >( second );
+
+  Node::operator delete( first );
+  Node::operator delete( second );
+  Node::operator delete( reinterpret_cast< void* >( SECOND_ADDRESS ) );
+  delete third;
+
+  // Uklad wolnej pamieci jest wyznaczany niezaleznie od GCAD_MEMORY_STATS
+  const MemoryAllocStats STATS = Node::statistics();
+  check( STATS.freeRuns_ == 1 &&
+    STATS.largestFreeRun_ == static_cast< size_t >( Node::size() ),
+    "whole pool free after double delete" );
+
+  Node* whole = static_cast< Node* >( 
+    Node::operator new( Node::size() ) );
+  check( whole != 0, "whole pool allocated after double delete" );
+  Node::operator delete( whole );
+  Node::purgeMemory();
+}
+
+int
+main()
+{
+  testDoubleGiveAfterLeftMerge();
+  testDoubleGiveAfterRightMerge();
+  testDoubleDeleteThroughAllocator();
+
+  if( failures != 0 ) {
+    cout << failures << " check(s) failed" << endl;
+    return 1;
+  }
+
+  cout << "All checks passed" << endl;
+  return 0;
+}